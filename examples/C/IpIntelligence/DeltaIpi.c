@@ -0,0 +1,168 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+/**
+@example IpIntelligence/DeltaIpi.c
+Command line tool which creates and applies deltas between consecutive
+versions of an IP Intelligence data file.
+
+Consecutive data files share most of their contents, so distributing a
+delta instead of the whole data file means an update only transfers the
+bytes which changed. To create a delta from the previous and new data files:
+
+`DeltaIpi create previous.ipi new.ipi update.delta [block size]`
+
+To rebuild the new data file from the previous one and the delta:
+
+`DeltaIpi apply previous.ipi update.delta new.ipi`
+
+A running engine can apply the delta and reload in one step with
+fiftyoneDegreesIpiReloadManagerFromDelta.
+
+A delta reduces the size of the update transferred only. The new data file is
+always rebuilt in full, and reloading from it needs as much memory as
+reloading from a data file which was downloaded whole.
+
+This example is available in full on [GitHub](https://github.com/51Degrees/ip-intelligence-cxx/tree/main/examples/C/IpIntelligence/DeltaIpi.c).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../../src/ipi.h"
+#include "../../../src/fiftyone.h"
+
+/**
+ * Reports the status of the operation.
+ * @param status code to be displayed
+ * @param fileName to be used in any messages
+ */
+static void reportStatus(
+	fiftyoneDegreesStatusCode status,
+	const char* fileName) {
+	const char* message = StatusGetMessage(status, fileName);
+	printf("%s\n", message);
+	Free((void*)message);
+}
+
+static void reportStats(const fiftyoneDegreesIpiDeltaStats* stats) {
+	printf("Previous data file: %llu bytes\n",
+		(unsigned long long)stats->sourceLength);
+	printf("New data file: %llu bytes\n",
+		(unsigned long long)stats->targetLength);
+	printf("Copied from previous: %llu bytes\n",
+		(unsigned long long)stats->copied);
+	printf("Added in delta: %llu bytes (%.2f%%)\n",
+		(unsigned long long)stats->added,
+		stats->targetLength == 0 ? 0.0 :
+			(double)stats->added * 100.0 / (double)stats->targetLength);
+	printf("Operations: %u\n", stats->operations);
+}
+
+/**
+ * Creates a delta from the previous and new data files.
+ * @param sourceFilePath path to the previous data file
+ * @param targetFilePath path to the new data file
+ * @param deltaFilePath path to write the delta to
+ * @param blockSize number of bytes compared at a time, or zero for the
+ * default
+ * @return the status of creating the delta
+ */
+fiftyoneDegreesStatusCode fiftyoneDegreesDeltaIpiCreate(
+	const char* sourceFilePath,
+	const char* targetFilePath,
+	const char* deltaFilePath,
+	uint32_t blockSize) {
+	IpiDeltaStats stats;
+	StatusCode status = IpiDeltaCreate(
+		sourceFilePath,
+		targetFilePath,
+		deltaFilePath,
+		blockSize,
+		&stats);
+	if (status != SUCCESS) {
+		reportStatus(status, deltaFilePath);
+	}
+	else {
+		reportStats(&stats);
+	}
+	return status;
+}
+
+/**
+ * Rebuilds the new data file from the previous data file and a delta.
+ * @param sourceFilePath path to the previous data file
+ * @param deltaFilePath path to the delta
+ * @param targetFilePath path to write the new data file to
+ * @return the status of applying the delta
+ */
+fiftyoneDegreesStatusCode fiftyoneDegreesDeltaIpiApply(
+	const char* sourceFilePath,
+	const char* deltaFilePath,
+	const char* targetFilePath) {
+	StatusCode status = IpiDeltaApply(
+		sourceFilePath,
+		deltaFilePath,
+		targetFilePath);
+	if (status != SUCCESS) {
+		reportStatus(status, deltaFilePath);
+	}
+	else {
+		printf("Written '%s'\n", targetFilePath);
+	}
+	return status;
+}
+
+#ifndef TEST
+
+/**
+ * Only included if the example is being used from the console. Not included
+ * when part of a test framework where the main method is not required.
+ * @arg1 create or apply
+ * @arg2 previous data file path
+ * @arg3 new data file path for create, or delta path for apply
+ * @arg4 delta path for create, or new data file path for apply
+ * @arg5 optional block size for create
+ */
+int main(int argc, char* argv[]) {
+	StatusCode status;
+	if (argc > 4 && strcmp(argv[1], "create") == 0) {
+		status = fiftyoneDegreesDeltaIpiCreate(
+			argv[2],
+			argv[3],
+			argv[4],
+			argc > 5 ? (uint32_t)strtoul(argv[5], NULL, 10) : 0);
+	}
+	else if (argc > 4 && strcmp(argv[1], "apply") == 0) {
+		status = fiftyoneDegreesDeltaIpiApply(argv[2], argv[3], argv[4]);
+	}
+	else {
+		printf("Usage:\n");
+		printf("  %s create previous.ipi new.ipi update.delta "
+			"[block size]\n", argv[0]);
+		printf("  %s apply previous.ipi update.delta new.ipi\n", argv[0]);
+		return 1;
+	}
+	return status == SUCCESS ? 0 : 1;
+}
+
+#endif
@@ -0,0 +1,260 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+/**
+@example IpIntelligence/KeyIpi.c
+Command line benchmark which compares searching sorted IP ranges by
+comparing the bytes of the IP addresses with searching them using integer IP
+address keys.
+
+The range cache and the IPv6 table hold the bounds of their ranges as
+fiftyoneDegreesIpiIpKey values which compare with at most two integer
+comparisons rather than a loop over up to 16 bytes. The benchmark creates
+random sorted range starts, and random IP addresses to look up, then times a
+binary search over the starts for every IP address using each comparison.
+Both searches must find the same range for every IP address.
+
+`KeyIpi [number of ranges]`
+
+This example is available in full on [GitHub](https://github.com/51Degrees/ip-intelligence-cxx/tree/main/examples/C/IpIntelligence/KeyIpi.c).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../../../src/ipi.h"
+#include "../../../src/fiftyone.h"
+
+// Default number of range starts searched.
+#define RANGES 100000
+
+// Number of IP addresses looked up.
+#define LOOKUPS 1000000
+
+/**
+ * Random IP addresses and the sorted range starts they are searched for in.
+ */
+typedef struct t_key_state {
+	IpType type; // Type of the IP addresses
+	int length; // Number of bytes in each IP address
+	IpAddress* starts; // Sorted range starts
+	IpiIpKey* startKeys; // Keys for the range starts
+	uint32_t startsCount; // Number of range starts
+	IpAddress* targets; // IP addresses to look up
+	uint32_t* byteIndexes; // Range found for each target with bytes
+	uint32_t* keyIndexes; // Range found for each target with keys
+	uint32_t seed; // Seed for the random IP addresses
+} keyState;
+
+/**
+ * Length of the IP addresses being sorted by compareStarts.
+ */
+static int sortLength = 0;
+
+static void createIpAddress(keyState* state, IpAddress* ipAddress) {
+	memset(ipAddress, 0, sizeof(IpAddress));
+	ipAddress->type = state->type;
+	for (int i = 0; i < state->length; i++) {
+		state->seed = state->seed * 1103515245U + 12345U;
+		ipAddress->value[i] = (byte)(state->seed >> 16);
+	}
+}
+
+/**
+ * Compares the IP addresses byte by byte in the same way as the lookup
+ * path did before integer keys were used.
+ */
+static int compareBytes(const IpAddress* address1, const IpAddress* address2) {
+	const int length = address1->type == IP_TYPE_IPV4 ?
+		IPV4_LENGTH : IPV6_LENGTH;
+	for (int i = 0; i < length; i++) {
+		const int difference = (int)address1->value[i] -
+			(int)address2->value[i];
+		if (difference != 0) {
+			return difference;
+		}
+	}
+	return 0;
+}
+
+static int compareStarts(const void* a, const void* b) {
+	return memcmp(
+		((const IpAddress*)a)->value,
+		((const IpAddress*)b)->value,
+		sortLength);
+}
+
+/**
+ * Returns the index of the last range start which is not greater than the
+ * target using the byte comparison, or 0 if every start is greater.
+ */
+static uint32_t findBytes(const keyState* state, const IpAddress* target) {
+	uint32_t lower = 0, upper = state->startsCount - 1;
+	while (lower < upper) {
+		const uint32_t middle = lower + (upper - lower + 1) / 2;
+		if (compareBytes(&state->starts[middle], target) <= 0) {
+			lower = middle;
+		}
+		else {
+			upper = middle - 1;
+		}
+	}
+	return lower;
+}
+
+/**
+ * Returns the index of the last range start which is not greater than the
+ * target using the keys, or 0 if every start is greater.
+ */
+static uint32_t findKeys(const keyState* state, const IpiIpKey* target) {
+	uint32_t lower = 0, upper = state->startsCount - 1;
+	while (lower < upper) {
+		const uint32_t middle = lower + (upper - lower + 1) / 2;
+		if (IpiIpKeyCompare(&state->startKeys[middle], target) <= 0) {
+			lower = middle;
+		}
+		else {
+			upper = middle - 1;
+		}
+	}
+	return lower;
+}
+
+/**
+ * Returns the time in seconds from a monotonic clock.
+ */
+static double getSeconds() {
+#ifdef _MSC_VER
+	return GetTickCount() / (double)1000;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + now.tv_nsec / 1.0e9;
+#endif
+}
+
+/**
+ * Times the lookups for the IP type using the bytes and then the keys, and
+ * reports the time per lookup of each.
+ * @return true if both found the same range for every IP address
+ */
+static bool runKeys(keyState* state, IpType type, const char* name) {
+	uint32_t i;
+	double start, byteNs, keyNs;
+	state->type = type;
+	state->length = type == IP_TYPE_IPV4 ? IPV4_LENGTH : IPV6_LENGTH;
+	state->seed = 42;
+	for (i = 0; i < state->startsCount; i++) {
+		createIpAddress(state, &state->starts[i]);
+	}
+	sortLength = state->length;
+	qsort(state->starts, state->startsCount, sizeof(IpAddress), compareStarts);
+	for (i = 0; i < state->startsCount; i++) {
+		state->startKeys[i] = IpiIpKeyFromIpAddress(&state->starts[i]);
+	}
+	for (i = 0; i < LOOKUPS; i++) {
+		createIpAddress(state, &state->targets[i]);
+	}
+
+	start = getSeconds();
+	for (i = 0; i < LOOKUPS; i++) {
+		state->byteIndexes[i] = findBytes(state, &state->targets[i]);
+	}
+	byteNs = (getSeconds() - start) * 1.0e9 / LOOKUPS;
+
+	// The target is converted to a key once per lookup as it would be at the
+	// API boundary.
+	start = getSeconds();
+	for (i = 0; i < LOOKUPS; i++) {
+		const IpiIpKey key = IpiIpKeyFromIpAddress(&state->targets[i]);
+		state->keyIndexes[i] = findKeys(state, &key);
+	}
+	keyNs = (getSeconds() - start) * 1.0e9 / LOOKUPS;
+
+	printf("%s\t%.1f\t%.1f\t%.1f\n", name, byteNs, keyNs, byteNs - keyNs);
+	return memcmp(
+		state->byteIndexes,
+		state->keyIndexes,
+		sizeof(uint32_t) * LOOKUPS) == 0;
+}
+
+/**
+ * Run the key benchmark from either the tests or the main method.
+ * @param rangesCount number of range starts to search
+ */
+void fiftyoneDegreesKeyIpiRun(uint32_t rangesCount) {
+	keyState state;
+	state.startsCount = rangesCount > 0 ? rangesCount : 1;
+	state.starts = (IpAddress*)Malloc(sizeof(IpAddress) * state.startsCount);
+	state.startKeys = (IpiIpKey*)Malloc(sizeof(IpiIpKey) * state.startsCount);
+	state.targets = (IpAddress*)Malloc(sizeof(IpAddress) * LOOKUPS);
+	state.byteIndexes = (uint32_t*)Malloc(sizeof(uint32_t) * LOOKUPS);
+	state.keyIndexes = (uint32_t*)Malloc(sizeof(uint32_t) * LOOKUPS);
+	if (state.starts != NULL &&
+		state.startKeys != NULL &&
+		state.targets != NULL &&
+		state.byteIndexes != NULL &&
+		state.keyIndexes != NULL) {
+		printf("Searching %u ranges %d times\n\n",
+			state.startsCount,
+			LOOKUPS);
+		printf("Type\tBytes ns\tKeys ns\tSaving ns\n");
+		if (runKeys(&state, IP_TYPE_IPV4, "IPv4") == false ||
+			runKeys(&state, IP_TYPE_IPV6, "IPv6") == false) {
+			printf("The keys found different ranges to the bytes\n");
+		}
+	}
+	else {
+		printf("Insufficient memory\n");
+	}
+	if (state.starts != NULL) {
+		Free(state.starts);
+	}
+	if (state.startKeys != NULL) {
+		Free(state.startKeys);
+	}
+	if (state.targets != NULL) {
+		Free(state.targets);
+	}
+	if (state.byteIndexes != NULL) {
+		Free(state.byteIndexes);
+	}
+	if (state.keyIndexes != NULL) {
+		Free(state.keyIndexes);
+	}
+}
+
+#ifndef TEST
+
+/**
+ * Only included if the example is being used from the console. Not included
+ * when part of a test framework where the main method is not required.
+ * @arg1 number of range starts to search
+ */
+int main(int argc, char* argv[]) {
+	fiftyoneDegreesKeyIpiRun(
+		argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : RANGES);
+	return 0;
+}
+
+#endif
@@ -38,6 +38,17 @@ does not do any actual detections and one does. The difference
 is then taken to calculate the actual performance of the detection
 work.
 
+Two further measurements then get the Latitude and Longitude values of each
+result. One formats the values as strings and parses them back to doubles,
+and the other uses the typed accessor which converts the stored values
+directly. The time over the detection test is the cost of getting the values.
+
+The last two measurements serialize all the required properties of each
+result as JSON. The reference serializer formats each value into a separate
+buffer and then escapes it into the output, one property at a time. The other
+uses ResultsIpiGetValuesJson which writes straight into the output and
+formats points from their ordinates. Both produce the same JSON.
+
 Expected output:
 ```
 ...
@@ -56,6 +67,12 @@ Detection test pass 1 of 1:
 Total seconds for 80000 IP Addresses over 4 thread(s): 0.** s
 Average matching per second: ***
 ...
+String values: 0.** s (0.** s over detection)
+Typed values: 0.** s (0.** s over detection)
+...
+Reference JSON: 0.** s (0.** s over detection)
+JSON: 0.** s (0.** s over detection)
+...
 ```
 
 */
@@ -93,6 +110,23 @@ static const char* dataFileName = "51Degrees-LiteV41.ipi";
 
 static const char* ipAddressFileName = "evidence.yml";
 
+/**
+ * How the values are got from each result during a test.
+ */
+typedef enum e_value_access {
+	VALUE_ACCESS_NONE, // Values are not got
+	VALUE_ACCESS_STRING, // Values are formatted as strings and parsed
+	VALUE_ACCESS_TYPED, // Values are converted directly to doubles
+	VALUE_ACCESS_JSON_REFERENCE, // All values serialized one at a time
+	VALUE_ACCESS_JSON // All values serialized with ResultsIpiGetValuesJson
+} valueAccess;
+
+// Number of typed values to get for a property in one call.
+#define TYPED_VALUES 8
+
+// Size of the buffer each thread serializes the results to as JSON.
+#define JSON_BUFFER 65536
+
 /**
  * CHOOSE THE DEFAULT MEMORY CONFIGURATION BY UNCOMMENTING ONE OF THE FOLLOWING
  * MACROS.
@@ -112,6 +146,9 @@ typedef struct t_performance_state {
 	int ipAddressesCount; // Total number of IP Addresses
 	int progress; // Number of IP Addresses to process for each = marker
 	bool calibration; // True if calibrating, otherwise false
+	valueAccess access; // How values are got from the results
+	int latitudeIndex; // Required property index for Latitude
+	int longitudeIndex; // Required property index for Longitude
 	const char* ipAddressFilePath; // Filename for the IP Address file
 	int numberOfThreads; // Number of parallel threads
 	fiftyoneDegreesResourceManager* manager; // Manager resource for detection
@@ -128,6 +165,9 @@ typedef struct t_thread_performance_state {
 	long count; // Number of IP Addresses the thread has processed
 	bool reportProgress; // True if this thread should report progress
 	fiftyoneDegreesResultsIpi* results; // The results used by the thread
+	double checksum; // Sum of the values got so that they are used
+	char* json; // Buffer the results are serialized to as JSON
+	char* value; // Buffer each value is formatted in by the reference
 } performanceThreadState;
 
 /**
@@ -200,6 +240,189 @@ static void reportProgress(performanceThreadState* state) {
 	}
 }
 
+/**
+ * Gets the values of the property as a string and parses each one back to a
+ * double, which is the work a caller needing a number must do when using the
+ * string accessors.
+ * @param state of the performance test thread
+ * @param requiredPropertyIndex of the property to get
+ */
+static void getStringValues(
+	performanceThreadState* state,
+	int requiredPropertyIndex) {
+	EXCEPTION_CREATE;
+	char buffer[BUFFER] = "";
+	char* next;
+	ResultsIpiGetValuesStringByRequiredPropertyIndex(
+		state->results,
+		requiredPropertyIndex,
+		buffer,
+		sizeof(buffer),
+		"|",
+		exception);
+	EXCEPTION_THROW;
+
+	// Each value is formatted as "value":weight.
+	next = buffer;
+	while (*next == '"') {
+		state->checksum += strtod(next + 1, &next);
+		if (*next == '"') next++;
+		if (*next == ':') next++;
+		state->checksum += strtod(next, &next);
+		if (*next == '|') next++;
+	}
+}
+
+/**
+ * Gets the values of the property directly as doubles.
+ * @param state of the performance test thread
+ * @param requiredPropertyIndex of the property to get
+ */
+static void getTypedValues(
+	performanceThreadState* state,
+	int requiredPropertyIndex) {
+	EXCEPTION_CREATE;
+	WeightedDouble values[TYPED_VALUES];
+	uint32_t i, count = ResultsIpiGetValuesAsWeightedDoubles(
+		state->results,
+		requiredPropertyIndex,
+		values,
+		TYPED_VALUES,
+		exception);
+	EXCEPTION_THROW;
+	for (i = 0; i < count && i < TYPED_VALUES; i++) {
+		state->checksum += values[i].value;
+		state->checksum += values[i].header.rawWeighting /
+			(double)FIFTYONE_DEGREES_WEIGHTED_ITEM_MAX_WEIGHT;
+	}
+}
+
+/**
+ * Adds the characters to the builder escaping any which can not appear in a
+ * JSON string.
+ */
+static void addJsonChars(
+	StringBuilder* builder,
+	const char* chars,
+	size_t length) {
+	static const char hex[] = "0123456789abcdef";
+	size_t i;
+	for (i = 0; i < length; i++) {
+		const unsigned char c = (unsigned char)chars[i];
+		if (c == '"' || c == '\\') {
+			StringBuilderAddChar(builder, '\\');
+			StringBuilderAddChar(builder, (char)c);
+		}
+		else if (c < 0x20) {
+			StringBuilderAddChars(builder, "\\u00", 4);
+			StringBuilderAddChar(builder, hex[c >> 4]);
+			StringBuilderAddChar(builder, hex[c & 0x0F]);
+		}
+		else {
+			StringBuilderAddChar(builder, (char)c);
+		}
+	}
+}
+
+/**
+ * Serializes all the required properties of the results as JSON one value at
+ * a time. Each value is formatted into a separate buffer with the common
+ * string builder and then escaped into the output, which is how a caller
+ * would build the JSON without ResultsIpiGetValuesJson.
+ * @param state of the performance test thread
+ */
+static void getReferenceJson(performanceThreadState* state) {
+	EXCEPTION_CREATE;
+	char weight[32];
+	uint32_t v;
+	int p, length;
+	const DataSetIpi* dataSet = (DataSetIpi*)state->results->b.dataSet;
+	StringBuilder builder = { state->json, JSON_BUFFER };
+	StringBuilderInit(&builder);
+	StringBuilderAddChar(&builder, '{');
+	for (p = 0; p < (int)dataSet->b.b.available->count; p++) {
+		const char* name = STRING(PropertiesGetNameFromRequiredIndex(
+			dataSet->b.b.available,
+			p));
+		const PropertyValueType type = PropertyGetStoredTypeByIndex(
+			dataSet->propertyTypes,
+			PropertiesGetPropertyIndexFromRequiredIndex(
+				dataSet->b.b.available,
+				p),
+			exception);
+		EXCEPTION_THROW;
+		if (p) {
+			StringBuilderAddChar(&builder, ',');
+		}
+		StringBuilderAddChar(&builder, '"');
+		addJsonChars(&builder, name, strlen(name));
+		StringBuilderAddChars(&builder, "\":[", 3);
+		const WeightedItem* items = ResultsIpiGetValues(
+			state->results,
+			p,
+			exception);
+		EXCEPTION_THROW;
+		const uint32_t count = items == NULL ? 0 : state->results->values.count;
+		for (v = 0; v < count; v++) {
+			StringBuilder valueBuilder = { state->value, JSON_BUFFER };
+			StringBuilderInit(&valueBuilder);
+			StringBuilderAddStringValue(
+				&valueBuilder,
+				(const StoredBinaryValue*)items[v].item.data.ptr,
+				type,
+				DefaultWktDecimalPlaces,
+				exception);
+			EXCEPTION_THROW;
+			StringBuilderComplete(&valueBuilder);
+
+			// Weights are rounded without trailing zeros.
+			length = snprintf(
+				weight,
+				sizeof(weight),
+				"%.*f",
+				(int)DefaultWktDecimalPlaces,
+				(double)items[v].rawWeighting /
+				(double)FIFTYONE_DEGREES_WEIGHTED_ITEM_MAX_WEIGHT);
+			if (strchr(weight, '.') != NULL) {
+				while (length > 0 && weight[length - 1] == '0') {
+					weight[--length] = '\0';
+				}
+				if (length > 0 && weight[length - 1] == '.') {
+					weight[--length] = '\0';
+				}
+			}
+			if (v) {
+				StringBuilderAddChar(&builder, ',');
+			}
+			StringBuilderAddChars(&builder, "{\"value\":\"", 10);
+			addJsonChars(&builder, state->value, strlen(state->value));
+			StringBuilderAddChars(&builder, "\",\"weight\":", 11);
+			StringBuilderAddChars(&builder, weight, strlen(weight));
+			StringBuilderAddChar(&builder, '}');
+		}
+		StringBuilderAddChar(&builder, ']');
+	}
+	StringBuilderAddChar(&builder, '}');
+	StringBuilderComplete(&builder);
+	state->checksum += (double)builder.added;
+}
+
+/**
+ * Serializes all the required properties of the results as JSON with
+ * ResultsIpiGetValuesJson.
+ * @param state of the performance test thread
+ */
+static void getJson(performanceThreadState* state) {
+	EXCEPTION_CREATE;
+	const size_t added = ResultsIpiGetValuesJson(
+		state->results,
+		state->json,
+		JSON_BUFFER,
+		exception);
+	EXCEPTION_THROW;
+	state->checksum += (double)added;
+}
+
 /**
  * Runs the performance test for the IP Address provided. Called from the text
  * file iterator.
@@ -229,6 +452,27 @@ static void executeTest(const char* ipAddress, void* state) {
 				(IpType)eIpAddress.type,
 				exception);
 			EXCEPTION_THROW;
+
+			// Get the location values if the test requires them.
+			switch (threadState->main->access) {
+			case VALUE_ACCESS_STRING:
+				getStringValues(threadState, threadState->main->latitudeIndex);
+				getStringValues(threadState, threadState->main->longitudeIndex);
+				break;
+			case VALUE_ACCESS_TYPED:
+				getTypedValues(threadState, threadState->main->latitudeIndex);
+				getTypedValues(threadState, threadState->main->longitudeIndex);
+				break;
+			case VALUE_ACCESS_JSON_REFERENCE:
+				getReferenceJson(threadState);
+				break;
+			case VALUE_ACCESS_JSON:
+				getJson(threadState);
+				break;
+			case VALUE_ACCESS_NONE:
+			default:
+				break;
+			}
 		}
 	}
 	else {
@@ -269,11 +513,24 @@ static void runPerformanceThread(void* mainState) {
 		threadState.reportProgress = 1;
 	}
 	threadState.count = 0;
+	threadState.checksum = 0;
+	threadState.json = NULL;
+	threadState.value = NULL;
 
 	if (threadState.main->calibration == 0) {
 		// Create an instance of results to access the returned values.
 		threadState.results = ResultsIpiCreate(
 			threadState.main->manager);
+		if (threadState.main->access == VALUE_ACCESS_JSON_REFERENCE ||
+			threadState.main->access == VALUE_ACCESS_JSON) {
+			threadState.json = (char*)Malloc(JSON_BUFFER);
+			threadState.value = (char*)Malloc(JSON_BUFFER);
+			if (threadState.json == NULL || threadState.value == NULL) {
+				EXCEPTION_CREATE;
+				EXCEPTION_SET(INSUFFICIENT_MEMORY);
+				EXCEPTION_THROW;
+			}
+		}
 	}
 	else {
 		threadState.results = NULL;
@@ -290,6 +547,12 @@ static void runPerformanceThread(void* mainState) {
 	if (threadState.main->calibration == 0) {
 		// Free the memory used by the results instance.
 		ResultsIpiFree(threadState.results);
+		if (threadState.json != NULL) {
+			Free(threadState.json);
+		}
+		if (threadState.value != NULL) {
+			Free(threadState.value);
+		}
 	}
 
 	if (ThreadingGetIsThreadSafe()) {
@@ -414,11 +677,24 @@ static void run(
 	fiftyoneDegreesResourceManager* manager,
 	const char* ipAddressFilePath) {
 	performanceState state;
-	double total, test, calibration;
+	double total, test, calibration, stringValues, typedValues;
+	double referenceJson, json;
+	DataSetIpi* dataSet;
 
 	// Set the file name and manager.
 	state.ipAddressFilePath = ipAddressFilePath;
 	state.manager = manager;
+	state.access = VALUE_ACCESS_NONE;
+
+	// Get the indexes of the properties used by the value access tests.
+	dataSet = DataSetIpiGet(manager);
+	state.latitudeIndex = PropertiesGetRequiredPropertyIndexFromName(
+		dataSet->b.b.available,
+		"Latitude");
+	state.longitudeIndex = PropertiesGetRequiredPropertyIndexFromName(
+		dataSet->b.b.available,
+		"Longitude");
+	DataSetIpiRelease(dataSet);
 
 	// Count the number of IP Addresses in the source file.
 	state.ipAddressesCount = getIpAddressesCount(ipAddressFilePath);
@@ -451,6 +727,32 @@ static void run(
 		total);
 	printf("Average matching per second: %.0f\n",
 		(double)(state.ipAddressesCount * state.numberOfThreads) / total);
+
+	// Compare getting the location values as strings with getting them as
+	// typed values.
+	state.access = VALUE_ACCESS_STRING;
+	stringValues = runTests(&state, PASSES, "String values test");
+	state.access = VALUE_ACCESS_TYPED;
+	typedValues = runTests(&state, PASSES, "Typed values test");
+	printf("String values: %.2fs (%.2fs over detection)\n",
+		stringValues,
+		stringValues - test);
+	printf("Typed values: %.2fs (%.2fs over detection)\n",
+		typedValues,
+		typedValues - test);
+
+	// Compare serializing all the values one at a time with serializing them
+	// directly into the output.
+	state.access = VALUE_ACCESS_JSON_REFERENCE;
+	referenceJson = runTests(&state, PASSES, "Reference JSON test");
+	state.access = VALUE_ACCESS_JSON;
+	json = runTests(&state, PASSES, "JSON test");
+	printf("Reference JSON: %.2fs (%.2fs over detection)\n",
+		referenceJson,
+		referenceJson - test);
+	printf("JSON: %.2fs (%.2fs over detection)\n",
+		json,
+		json - test);
 }
 
 /**
@@ -466,6 +768,27 @@ static void reportStatus(
 	Free((void*)message);
 }
 
+/**
+ * Reports the time spent in each stage of initialising the data set.
+ */
+static void reportInitTimings(ResourceManager* manager) {
+	IpiInitTimings timings = IpiGetInitTimings(manager);
+	printf("Data set initialised in %.0fms\n", timings.total);
+	printf("\tCollections: %.0fms\n", timings.collections);
+	printf("\tGraphs: %.0fms\n", timings.graphs);
+	printf("\tProperties: %.0fms\n", timings.properties);
+	printf("\tIndexes: %.0fms (IPv4 table %.0fms, IPv6 table %.0fms, "
+		"IPv6 index %.0fms, range cache %.0fms, value index %.0fms, "
+		"profile groups %.0fms)\n\n",
+		timings.indexes,
+		timings.ipv4Table,
+		timings.ipv6Table,
+		timings.ipv6Index,
+		timings.rangeCache,
+		timings.valueIndex,
+		timings.profileGroupsTable);
+}
+
 /**
  * Run the performance test from either the tests or the main method.
  * @param dataFilePath full file path to the IP intelligence data file
@@ -486,9 +809,12 @@ void fiftyoneDegreesPerfIpiRun(
 		config.strings.concurrency = THREAD_COUNT;
 	config.strings.capacity = 100;
 
-	// Configure to return the Country property.
+	// Build the independent parts of the data set in parallel.
+	config.initThreads = THREAD_COUNT;
+
+	// Configure to return the properties used by the tests.
 	PropertiesRequired properties = PropertiesDefault;
-	properties.string = "RegisteredName,areas";
+	properties.string = "RegisteredName,areas,Latitude,Longitude";
 
 	ResourceManager manager;
 	EXCEPTION_CREATE;
@@ -505,6 +831,9 @@ void fiftyoneDegreesPerfIpiRun(
 	}
 	else {
 
+		// Report where the time initialising the data set was spent.
+		reportInitTimings(&manager);
+
 		// Run the performance tests.
 		run(&manager, ipAddressFilePath);
 
@@ -53,6 +53,10 @@
 // the default number of tests to execute.
 #define DEFAULT_ITERATIONS 10000
 
+// Widths of the batches used when measuring batch processing.
+static const uint32_t batchWidths[] = { 1, 4, 16, 64, 256 };
+#define BATCH_WIDTHS_COUNT (sizeof(batchWidths) / sizeof(uint32_t))
+
 // Parameters used for allocating memory when reading evidence. 
 #define SIZE_OF_KEY 500
 #define SIZE_OF_VALUE 1000
@@ -186,6 +190,8 @@ typedef struct performanceState_t {
 	threadState* threadStates;
 	// Index in threadStates that should be used when preparing evidence.
 	int threadIndex;
+	// Lookups per second on a single thread for each of the batch widths.
+	double batchLookupsPerSecond[BATCH_WIDTHS_COUNT];
 } performanceState;
 
 static const char* getOrAddSharedString(
@@ -458,6 +464,81 @@ double runTests(performanceState *state) {
 	return TIMER_ELAPSED;
 }
 
+/**
+ * Execute lookups on a single thread using batches of IP addresses for each
+ * of the batch widths and record the lookups per second for each width.
+ * The IP addresses are parsed before the timer starts so that only the
+ * lookups are measured.
+ * @param state containing the dataset and evidence to use
+ */
+void runBatchTests(performanceState *state) {
+	EXCEPTION_CREATE;
+	uint32_t count = 0, offset, width, i, w;
+	unsigned long long checkSum = 0;
+	evidenceNode* node;
+	for (w = 0; w < BATCH_WIDTHS_COUNT; w++) {
+		state->batchLookupsPerSecond[w] = 0;
+	}
+
+	// Parse the first item of evidence from every node into an array.
+	IpAddress* ipAddresses = (IpAddress*)Malloc(
+		sizeof(IpAddress) * state->evidenceCount);
+	if (ipAddresses == NULL) {
+		return;
+	}
+	for (int t = 0; t < state->numberOfThreads; t++) {
+		for (node = state->threadStates[t].evidenceFirst;
+			node != NULL;
+			node = node->next) {
+			const EvidenceKeyValuePair* pair = &node->array->items[0];
+			if (node->array->count > 0 && IpAddressParse(
+				(const char*)pair->parsedValue,
+				(const char*)pair->parsedValue + pair->parsedLength,
+				&ipAddresses[count])) {
+				count++;
+			}
+		}
+	}
+
+	for (w = 0; w < BATCH_WIDTHS_COUNT; w++) {
+		ResultsIpiBatch* batch = ResultsIpiBatchCreate(
+			&state->manager,
+			batchWidths[w]);
+		if (batch == NULL) {
+			break;
+		}
+
+		TIMER_CREATE;
+		TIMER_START;
+		for (offset = 0; offset < count; offset += batchWidths[w]) {
+			width = count - offset < batchWidths[w] ?
+				count - offset : batchWidths[w];
+			ResultsIpiFromIpAddressBatch(
+				batch,
+				ipAddresses + offset,
+				width,
+				exception);
+			EXCEPTION_THROW;
+
+			// Use the results to ensure the compiler doesn't optimise out the
+			// lookups.
+			for (i = 0; i < batch->count; i++) {
+				if (batch->items[i]->count > 0) {
+					checkSum += batch->items[i]->items[0].graphResult.rawOffset;
+				}
+			}
+		}
+		TIMER_END;
+
+		state->batchLookupsPerSecond[w] =
+			round((double)count * 1000.0 / TIMER_ELAPSED);
+		ResultsIpiBatchFree(batch);
+	}
+
+	fprintf(state->output, "Batch checksum: %llu\n", checkSum);
+	Free(ipAddresses);
+}
+
 /**
  * Report per thread and overall detection performance.
  * @param state contains benchmarking results for each thread
@@ -490,11 +571,23 @@ void doReport(performanceState *state) {
 	fprintf(state->output,
 		"Properties retrieved %d\n",
 		state->availableProperties);
+	for (uint32_t w = 0; w < BATCH_WIDTHS_COUNT; w++) {
+		fprintf(state->output,
+			"Batch width %u, Lookups per second (single thread): %.0lf\n",
+			batchWidths[w],
+			state->batchLookupsPerSecond[w]);
+	}
 	fprintf(state->output, "\n");
 
 	if (state->resultsOutput != NULL) {
 		fprintf(state->resultsOutput, "  \"DetectionsPerSecond\": %.2f,\n", round(1000.0 / millisPerTest));
 		fprintf(state->resultsOutput, "  \"StartupMs\": %.0lf,\n", state->startUpMillis);
+		for (uint32_t w = 0; w < BATCH_WIDTHS_COUNT; w++) {
+			fprintf(state->resultsOutput,
+				"  \"BatchWidth%uLookupsPerSecond\": %.2f,\n",
+				batchWidths[w],
+				state->batchLookupsPerSecond[w]);
+		}
 	}
 }
 
@@ -582,6 +675,10 @@ void executeBenchmark(
 		"Finished - Execution time was %lf ms\n",
 		state->elapsedMilliSeconds);
 
+	// Measure the effect of the batch width on lookup throughput.
+	fprintf(state->output, "Running batches\n");
+	runBatchTests(state);
+
 	ResourceManagerFree(&state->manager);
 	Free(state->threads);
 
@@ -0,0 +1,323 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+/**
+@example IpIntelligence/ReadIpi.c
+Command line benchmark which compares reading random items from a data file
+through the file pool with positional reads from a single handle.
+
+When the data set is not all in memory, every item which is not loaded or
+cached is read from the data file. The file pool gives each reading thread a
+handle of its own, and has as many handles as the concurrency configured. The
+positional reader shares one handle between any number of threads, which is
+what ConfigIpi::setPositionalRead and the positionalRead field of the
+configuration enable.
+
+The benchmark reads from random offsets in the data file with 1 to 64
+threads, first through a file pool and then through the positional reader,
+and reports the reads per second of each. Where there are more threads than
+handles in the pool, the threads have to wait for a handle to be released.
+
+`ReadIpi [data file] [pool size]`
+
+This example is available in full on [GitHub](https://github.com/51Degrees/ip-intelligence-cxx/tree/main/examples/C/IpIntelligence/ReadIpi.c).
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+#include "../../../src/ipi.h"
+#include "../../../src/fiftyone.h"
+
+// Number of reads made by each thread.
+#define READS_PER_THREAD 100000
+
+// Number of bytes in each read, which is similar to the items of the fixed
+// width collections.
+#define READ_LENGTH 32
+
+// Most threads used by the benchmark.
+#define MAX_THREADS 64
+
+// Default number of handles in the file pool.
+#define POOL_SIZE 4
+
+static const char* dataDir = "ip-intelligence-data";
+
+static const char* dataFileName = "51Degrees-LiteV41.ipi";
+
+/**
+ * State of each thread reading from the data file.
+ */
+typedef struct t_read_thread_state {
+	FilePool* pool; // Pool to read from, or NULL to use the reader
+	IpiFileReader* reader; // Reader for positional reads
+	FileOffset length; // Number of bytes reads can start within
+	uint32_t seed; // Seed for the random offsets
+	uint64_t waits; // Number of times a handle was not available
+	uint32_t failures; // Number of reads which failed
+} readThreadState;
+
+/**
+ * Returns the next random offset to read from.
+ */
+static FileOffset nextOffset(readThreadState* state) {
+	state->seed = state->seed * 1103515245U + 12345U;
+	const uint64_t random = ((uint64_t)state->seed << 16) ^ (state->seed >> 8);
+	return (FileOffset)(random % (uint64_t)state->length);
+}
+
+static void readFromPool(readThreadState* state) {
+	EXCEPTION_CREATE;
+	int i;
+	byte buffer[READ_LENGTH];
+	for (i = 0; i < READS_PER_THREAD; i++) {
+		const FileOffset offset = nextOffset(state);
+
+		// Wait for a handle where they are all being used by other threads.
+		FileHandle* handle = FileHandleGet(state->pool, exception);
+		while (handle == NULL) {
+			EXCEPTION_CLEAR;
+			state->waits++;
+			handle = FileHandleGet(state->pool, exception);
+		}
+		if (fseek(handle->file, (long)offset, SEEK_SET) != 0 ||
+			fread(buffer, READ_LENGTH, 1, handle->file) != 1) {
+			state->failures++;
+		}
+		FileHandleRelease(handle);
+	}
+}
+
+static void readFromReader(readThreadState* state) {
+	int i;
+	byte buffer[READ_LENGTH];
+	for (i = 0; i < READS_PER_THREAD; i++) {
+		if (IpiFileReaderRead(
+			state->reader,
+			nextOffset(state),
+			buffer,
+			READ_LENGTH) != SUCCESS) {
+			state->failures++;
+		}
+	}
+}
+
+static void runReadThread(void* state) {
+	readThreadState* const thread = (readThreadState*)state;
+	if (thread->pool != NULL) {
+		readFromPool(thread);
+	}
+	else {
+		readFromReader(thread);
+	}
+	if (ThreadingGetIsThreadSafe()) {
+		THREAD_EXIT;
+	}
+}
+
+/**
+ * Runs the reads in the number of threads provided.
+ * @return the number of reads per second
+ */
+static double runReads(
+	FilePool* pool,
+	IpiFileReader* reader,
+	int threadCount,
+	uint64_t* waits) {
+	int i;
+	FIFTYONE_DEGREES_THREAD threads[MAX_THREADS];
+	readThreadState states[MAX_THREADS];
+#ifdef _MSC_VER
+	double start, end, seconds;
+#else
+	struct timespec start, end;
+	double seconds;
+#endif
+	for (i = 0; i < threadCount; i++) {
+		states[i].pool = pool;
+		states[i].reader = reader;
+
+		// Offsets are passed to fseek by the pool so are limited to the
+		// range of a long.
+		states[i].length = reader->length - READ_LENGTH > (FileOffset)LONG_MAX ?
+			(FileOffset)LONG_MAX : reader->length - READ_LENGTH;
+		states[i].seed = (uint32_t)i + 1;
+		states[i].waits = 0;
+		states[i].failures = 0;
+	}
+#ifdef _MSC_VER
+	start = GetTickCount();
+#else
+	clock_gettime(CLOCK_MONOTONIC, &start);
+#endif
+	if (ThreadingGetIsThreadSafe()) {
+		for (i = 0; i < threadCount; i++) {
+			THREAD_CREATE(
+				threads[i],
+				(THREAD_ROUTINE)&runReadThread,
+				&states[i]);
+		}
+		for (i = 0; i < threadCount; i++) {
+			THREAD_JOIN(threads[i]);
+			THREAD_CLOSE(threads[i]);
+		}
+	}
+	else {
+		for (i = 0; i < threadCount; i++) {
+			runReadThread(&states[i]);
+		}
+	}
+#ifdef _MSC_VER
+	end = GetTickCount();
+	seconds = (end - start) / (double)1000;
+#else
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	seconds = (double)(end.tv_sec - start.tv_sec) +
+		(end.tv_nsec - start.tv_nsec) / 1.0e9;
+#endif
+	*waits = 0;
+	for (i = 0; i < threadCount; i++) {
+		*waits += states[i].waits;
+		if (states[i].failures > 0) {
+			printf("Thread %d failed %u reads\n", i, states[i].failures);
+		}
+	}
+	return seconds > 0 ?
+		(double)threadCount * READS_PER_THREAD / seconds : 0;
+}
+
+/**
+ * Reports the status of the data file initialization.
+ * @param status code to be displayed
+ * @param fileName to be used in any messages
+ */
+static void reportStatus(
+	fiftyoneDegreesStatusCode status,
+	const char* fileName) {
+	const char* message = StatusGetMessage(status, fileName);
+	printf("%s\n", message);
+	Free((void*)message);
+}
+
+/**
+ * Run the read benchmark from either the tests or the main method.
+ * @param dataFilePath full file path to the IP intelligence data file
+ * @param poolSize number of handles in the file pool
+ */
+void fiftyoneDegreesReadIpiRun(const char* dataFilePath, uint16_t poolSize) {
+	EXCEPTION_CREATE;
+	int threadCount;
+	uint64_t poolWaits, readerWaits;
+	FilePool pool;
+	IpiFileReader reader;
+	StatusCode status = IpiFileReaderOpen(dataFilePath, &reader);
+	if (status != SUCCESS) {
+		reportStatus(status, dataFilePath);
+		return;
+	}
+	if (reader.length <= READ_LENGTH) {
+		reportStatus(CORRUPT_DATA, dataFilePath);
+		IpiFileReaderClose(&reader);
+		return;
+	}
+	status = FilePoolInit(&pool, dataFilePath, poolSize, exception);
+	if (status != SUCCESS || EXCEPTION_FAILED) {
+		reportStatus(status, dataFilePath);
+		IpiFileReaderClose(&reader);
+		return;
+	}
+
+	printf("Reading %d bytes %d times per thread with a pool of %d "
+		"handles\n\n",
+		READ_LENGTH,
+		READS_PER_THREAD,
+		(int)poolSize);
+	printf("Threads\tPool reads/s\tPool waits\tPositional reads/s\n");
+	for (threadCount = 1; threadCount <= MAX_THREADS; threadCount *= 2) {
+		const double poolReads = runReads(
+			&pool,
+			&reader,
+			threadCount,
+			&poolWaits);
+		const double readerReads = runReads(
+			NULL,
+			&reader,
+			threadCount,
+			&readerWaits);
+		printf("%d\t%.0f\t%llu\t%.0f\n",
+			threadCount,
+			poolReads,
+			(unsigned long long)poolWaits,
+			readerReads);
+	}
+
+	FilePoolRelease(&pool);
+	IpiFileReaderClose(&reader);
+}
+
+#ifndef TEST
+
+/**
+ * Only included if the example is being used from the console. Not included
+ * when part of a test framework where the main method is not required.
+ * @arg1 data file path
+ * @arg2 number of handles in the file pool
+ */
+int main(int argc, char* argv[]) {
+	char dataFilePath[FILE_MAX_PATH];
+	StatusCode status = SUCCESS;
+	// An explicit data file path can be supplied in the 51DEGREES_IPI_PATH
+	// environment variable, otherwise the parent folder structure is searched.
+	const char* envDataFilePath = getenv("51DEGREES_IPI_PATH");
+	if (argc > 1) {
+		strcpy(dataFilePath, argv[1]);
+	}
+	else if (envDataFilePath != NULL && envDataFilePath[0] != '\0') {
+		if (strlen(envDataFilePath) >= sizeof(dataFilePath)) {
+			status = INSUFFICIENT_MEMORY;
+		}
+		else {
+			strcpy(dataFilePath, envDataFilePath);
+		}
+	}
+	else {
+		status = FileGetPath(
+			dataDir,
+			dataFileName,
+			dataFilePath,
+			sizeof(dataFilePath));
+	}
+	if (status != SUCCESS) {
+		reportStatus(status, dataFileName);
+		return 1;
+	}
+
+	fiftyoneDegreesReadIpiRun(
+		dataFilePath,
+		argc > 2 ? (uint16_t)atoi(argv[2]) : POOL_SIZE);
+	return 0;
+}
+
+#endif
@@ -26,13 +26,14 @@
 using namespace std;
 using namespace FiftyoneDegrees::IpIntelligence;
 
-ConfigIpi::ConfigIpi() : ConfigBase(&this->config.b) {
+ConfigIpi::ConfigIpi() : ConfigBase(&this->config.b),
+	valuesCacheCapacity(0) {
 	config = fiftyoneDegreesIpiInMemoryConfig;
 	initCollectionConfig();
 }
 
 ConfigIpi::ConfigIpi(fiftyoneDegreesConfigIpi *config) :
-	ConfigBase(&config->b) {
+	ConfigBase(&config->b), valuesCacheCapacity(0) {
 	this->config = config != nullptr ?
 		*config : fiftyoneDegreesIpiInMemoryConfig;
 	initCollectionConfig();
@@ -41,9 +42,29 @@ ConfigIpi::ConfigIpi(fiftyoneDegreesConfigIpi *config) :
 void ConfigIpi::setPerformanceFromExistingConfig(
 	const fiftyoneDegreesConfigIpi &existing) {
 	const fiftyoneDegreesConfigBase b = config.b;
+	const bool ipv4Table = config.ipv4Table;
+	const uint8_t ipv6PrefixBits = config.ipv6PrefixBits;
+	const bool ipv6Table = config.ipv6Table;
+	const uint32_t rangeCacheCapacity = config.rangeCacheCapacity;
+	const bool valueIndex = config.valueIndex;
+	const bool profileGroupsTable = config.profileGroupsTable;
+	const bool mapFile = config.mapFile;
+	const uint8_t mapHints = config.mapHints;
+	const uint16_t initThreads = config.initThreads;
+	const bool positionalRead = config.positionalRead;
 	config = existing;
 	config.b = b;
 	config.b.allInMemory = existing.b.allInMemory;
+	config.ipv4Table = ipv4Table;
+	config.ipv6PrefixBits = ipv6PrefixBits;
+	config.ipv6Table = ipv6Table;
+	config.rangeCacheCapacity = rangeCacheCapacity;
+	config.valueIndex = valueIndex;
+	config.profileGroupsTable = profileGroupsTable;
+	config.mapFile = mapFile;
+	config.mapHints = mapHints;
+	config.initThreads = initThreads;
+	config.positionalRead = positionalRead;
 }
 
 void ConfigIpi::setHighPerformance() {
@@ -166,4 +187,92 @@ void ConfigIpi::setConcurrency(uint16_t concurrency) {
 	profileOffsets.setConcurrency(concurrency);
 	propertyTypes.setConcurrency(concurrency);
 	graph.setConcurrency(concurrency);
+}
+
+void ConfigIpi::setIpv4Table(bool ipv4Table) {
+	config.ipv4Table = ipv4Table;
+}
+
+bool ConfigIpi::getIpv4Table() const {
+	return config.ipv4Table;
+}
+
+void ConfigIpi::setIpv6PrefixBits(uint8_t ipv6PrefixBits) {
+	config.ipv6PrefixBits = ipv6PrefixBits;
+}
+
+uint8_t ConfigIpi::getIpv6PrefixBits() const {
+	return config.ipv6PrefixBits;
+}
+
+void ConfigIpi::setIpv6Table(bool ipv6Table) {
+	config.ipv6Table = ipv6Table;
+}
+
+bool ConfigIpi::getIpv6Table() const {
+	return config.ipv6Table;
+}
+
+void ConfigIpi::setRangeCacheCapacity(uint32_t capacity) {
+	config.rangeCacheCapacity = capacity;
+}
+
+uint32_t ConfigIpi::getRangeCacheCapacity() const {
+	return config.rangeCacheCapacity;
+}
+
+void ConfigIpi::setValueIndex(bool valueIndex) {
+	config.valueIndex = valueIndex;
+}
+
+bool ConfigIpi::getValueIndex() const {
+	return config.valueIndex;
+}
+
+void ConfigIpi::setProfileGroupsTable(bool profileGroupsTable) {
+	config.profileGroupsTable = profileGroupsTable;
+}
+
+bool ConfigIpi::getProfileGroupsTable() const {
+	return config.profileGroupsTable;
+}
+
+void ConfigIpi::setMapFile(bool mapFile) {
+	config.mapFile = mapFile;
+}
+
+bool ConfigIpi::getMapFile() const {
+	return config.mapFile;
+}
+
+void ConfigIpi::setMapHints(uint8_t mapHints) {
+	config.mapHints = mapHints;
+}
+
+uint8_t ConfigIpi::getMapHints() const {
+	return config.mapHints;
+}
+
+void ConfigIpi::setInitThreads(uint16_t initThreads) {
+	config.initThreads = initThreads;
+}
+
+uint16_t ConfigIpi::getInitThreads() const {
+	return config.initThreads;
+}
+
+void ConfigIpi::setPositionalRead(bool positionalRead) {
+	config.positionalRead = positionalRead;
+}
+
+bool ConfigIpi::getPositionalRead() const {
+	return config.positionalRead;
+}
+
+void ConfigIpi::setValuesCacheCapacity(uint32_t capacity) {
+	valuesCacheCapacity = capacity;
+}
+
+uint32_t ConfigIpi::getValuesCacheCapacity() const {
+	return valuesCacheCapacity;
 }
\ No newline at end of file
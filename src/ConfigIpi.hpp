@@ -132,6 +132,121 @@ namespace FiftyoneDegrees {
 			 */
 			void setConcurrency(uint16_t concurrency);
 
+			/**
+			 * Set whether a flattened table of the IPv4 ranges should be
+			 * built when an in memory data set is loaded. The table is
+			 * used in place of the graphs for IPv4 addresses.
+			 * See #fiftyoneDegreesIpiIpv4Table
+			 * @param ipv4Table true if the table should be built
+			 */
+			void setIpv4Table(bool ipv4Table);
+
+			/**
+			 * Set the number of leading bits of IPv6 addresses used to key
+			 * the prefix index built for each component when an in memory
+			 * data set is loaded. Prefixes which contain a single result
+			 * are returned from the index without evaluating the graph.
+			 * See #fiftyoneDegreesIpiIpv6Index
+			 * @param ipv6PrefixBits number of bits between 1 and 64, or 0
+			 * if no index should be built
+			 */
+			void setIpv6PrefixBits(uint8_t ipv6PrefixBits);
+
+			/**
+			 * Set whether a flattened table of the IPv6 ranges should be
+			 * built when an in memory data set is loaded. The table is
+			 * used in place of the graphs for IPv6 addresses.
+			 * See #fiftyoneDegreesIpiIpv6Table
+			 * @param ipv6Table true if the table should be built
+			 */
+			void setIpv6Table(bool ipv6Table);
+
+			/**
+			 * Set the number of IP ranges held in the range cache of each
+			 * data set. IP addresses within a cached range are returned
+			 * without evaluating the graphs.
+			 * See #fiftyoneDegreesIpiRangeCache
+			 * @param capacity number of ranges, or 0 if no cache should be
+			 * used
+			 */
+			void setRangeCacheCapacity(uint32_t capacity);
+
+			/**
+			 * Set whether an index of the values of the required properties
+			 * for each profile should be built when an in memory data set
+			 * is loaded. Values are then returned from the index without
+			 * searching the profile.
+			 * See #fiftyoneDegreesIpiValueIndex
+			 * @param valueIndex true if the index should be built
+			 */
+			void setValueIndex(bool valueIndex);
+
+			/**
+			 * Set whether the profile groups should be resolved into a table
+			 * of profiles and weights when an in memory data set is loaded.
+			 * Values for profile groups are then returned without reading
+			 * or checking the profile groups collection.
+			 * See #fiftyoneDegreesIpiProfileGroupsTable
+			 * @param profileGroupsTable true if the table should be built
+			 */
+			void setProfileGroupsTable(bool profileGroupsTable);
+
+			/**
+			 * Set whether an all in memory data set should be created from a
+			 * read only mapping of the data file rather than by reading the
+			 * file into allocated memory. Only used when all the data is in
+			 * memory. The temporary copy of the data file is mapped so a temp
+			 * file must also be used, see setUseTempFile. Updates must
+			 * replace the data file by renaming a new file over it rather
+			 * than writing over it.
+			 * See #fiftyoneDegreesIpiMappedFile
+			 * @param mapFile true if the data file should be mapped
+			 */
+			void setMapFile(bool mapFile);
+
+			/**
+			 * Set the hints used when the data file is mapped.
+			 * @param mapHints combination of the FIFTYONE_DEGREES_IPI_MAP_*
+			 * flags, or 0 for no hints
+			 */
+			void setMapHints(uint8_t mapHints);
+
+			/**
+			 * Set the number of threads used to build the independent parts
+			 * of the data set when it is initialised. The collections are
+			 * created in parallel when they are read from file, and the
+			 * tables, indexes and caches enabled in the configuration are
+			 * built in parallel. The time spent in each stage is available
+			 * from EngineIpi::getInitTimings.
+			 * @param initThreads number of threads including the calling
+			 * thread, or 0 or 1 to initialise in sequence
+			 */
+			void setInitThreads(uint16_t initThreads);
+
+			/**
+			 * Set whether items of the collections which are read from file
+			 * use positional reads from a single handle shared by every
+			 * thread, rather than a handle from the file pool. Reads are
+			 * then not limited by the concurrency, except for the graphs
+			 * which still use the file pool. Has no effect when the data set
+			 * is all in memory.
+			 * @param positionalRead true to use positional reads
+			 */
+			void setPositionalRead(bool positionalRead);
+
+			/**
+			 * Set the number of entries in the cache of property values
+			 * held by the engine. Values for IP addresses which map to the
+			 * same profile, or profile group, as an earlier request are
+			 * returned from the cache. Only the string values returned by
+			 * the value accessors of ResultsBase are cached, not the
+			 * weighted values.
+			 * See ValuesCacheIpi
+			 * @param capacity number of entries, or 0 if no cache should be
+			 * used
+			 */
+			void setValuesCacheCapacity(uint32_t capacity);
+
 
 			/**
 			 * @}
@@ -211,6 +326,83 @@ namespace FiftyoneDegrees {
 			 */
 			uint16_t getConcurrency() const override;
 
+			/**
+			 * Get whether a flattened table of the IPv4 ranges is built
+			 * when an in memory data set is loaded.
+			 * @return true if the table is built
+			 */
+			bool getIpv4Table() const;
+
+			/**
+			 * Get the number of leading bits of IPv6 addresses used to key
+			 * the prefix index built when an in memory data set is loaded.
+			 * @return number of bits, or 0 if no index is built
+			 */
+			uint8_t getIpv6PrefixBits() const;
+
+			/**
+			 * Get whether a flattened table of the IPv6 ranges is built
+			 * when an in memory data set is loaded.
+			 * @return true if the table is built
+			 */
+			bool getIpv6Table() const;
+
+			/**
+			 * Get the number of IP ranges held in the range cache of each
+			 * data set.
+			 * @return number of ranges, or 0 if no cache is used
+			 */
+			uint32_t getRangeCacheCapacity() const;
+
+			/**
+			 * Get whether an index of the values of the required properties
+			 * for each profile is built when an in memory data set is
+			 * loaded.
+			 * @return true if the index is built
+			 */
+			bool getValueIndex() const;
+
+			/**
+			 * Get whether the profile groups are resolved into a table when
+			 * an in memory data set is loaded.
+			 * @return true if the table is built
+			 */
+			bool getProfileGroupsTable() const;
+
+			/**
+			 * Get whether an all in memory data set is created from a
+			 * mapping of the data file.
+			 * @return true if the data file is mapped
+			 */
+			bool getMapFile() const;
+
+			/**
+			 * Get the hints used when the data file is mapped.
+			 * @return combination of the FIFTYONE_DEGREES_IPI_MAP_* flags
+			 */
+			uint8_t getMapHints() const;
+
+			/**
+			 * Get the number of threads used to build the independent parts
+			 * of the data set when it is initialised.
+			 * @return number of threads, or 0 or 1 if initialised in sequence
+			 */
+			uint16_t getInitThreads() const;
+
+			/**
+			 * Get whether items of the collections which are read from file
+			 * use positional reads.
+			 * @return true if positional reads are used
+			 */
+			bool getPositionalRead() const;
+
+			/**
+			 * Get the number of entries in the cache of property values held
+			 * by the engine.
+			 * @return number of entries, or 0 if no cache is used
+			 */
+			uint32_t getValuesCacheCapacity() const;
+
 			 /**
 			  * Gets the configuration data structure for use in C code.
 			  * Used internally.
@@ -226,6 +418,13 @@ namespace FiftyoneDegrees {
 			/** The underlying configuration structure */
 			fiftyoneDegreesConfigIpi config;
 
+			/**
+			 * Number of entries in the engine's cache of property values.
+			 * Held here rather than in the C structure as only the C++
+			 * engine has the cache.
+			 */
+			uint32_t valuesCacheCapacity;
+
 			/** The underlying strings configuration structure */
 			CollectionConfig strings;
 
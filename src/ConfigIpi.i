@@ -38,6 +38,17 @@ public:
     void setLowMemory();
     void setMaxPerformance();
     void setConcurrency(uint16_t concurrency);
+    void setIpv4Table(bool ipv4Table);
+    void setIpv6PrefixBits(uint8_t ipv6PrefixBits);
+    void setIpv6Table(bool ipv6Table);
+    void setRangeCacheCapacity(uint32_t capacity);
+    void setValueIndex(bool valueIndex);
+    void setProfileGroupsTable(bool profileGroupsTable);
+    void setMapFile(bool mapFile);
+    void setMapHints(uint8_t mapHints);
+    void setInitThreads(uint16_t initThreads);
+    void setPositionalRead(bool positionalRead);
+    void setValuesCacheCapacity(uint32_t capacity);
     const CollectionConfig &getStrings() const;
     const CollectionConfig &getComponents() const;
     const CollectionConfig &getMaps() const;
@@ -50,4 +61,15 @@ public:
     const CollectionConfig &getPropertyTypes() const;
     const CollectionConfig &getGraph() const;
     uint16_t getConcurrency() const;
+    bool getIpv4Table() const;
+    uint8_t getIpv6PrefixBits() const;
+    bool getIpv6Table() const;
+    uint32_t getRangeCacheCapacity() const;
+    bool getValueIndex() const;
+    bool getProfileGroupsTable() const;
+    bool getMapFile() const;
+    uint8_t getMapHints() const;
+    uint16_t getInitThreads() const;
+    bool getPositionalRead() const;
+    uint32_t getValuesCacheCapacity() const;
 };
@@ -21,6 +21,7 @@
  * ********************************************************************* */
 
 #include <iostream>
+#include <thread>
 #include "EngineIpi.hpp"
 #include "fiftyone.h"
 
@@ -45,7 +46,7 @@ EngineIpi::EngineIpi(
 		return;
 	}
 	EXCEPTION_THROW;
-	init();
+	init(config);
 }
 
 EngineIpi::EngineIpi(
@@ -78,7 +79,7 @@ EngineIpi::EngineIpi(
 		throw StatusCodeException(status);
 	}
 	EXCEPTION_THROW;
-	init();
+	init(config);
 }
 
 EngineIpi::EngineIpi(
@@ -89,11 +90,39 @@ EngineIpi::EngineIpi(
 	: EngineIpi((void*)data, length, config, properties) {
 }
 
-void EngineIpi::init() {
+EngineIpi::~EngineIpi() {
+	std::lock_guard<std::mutex> lock(asyncRefreshLock);
+	if (asyncRefresh != nullptr) {
+		IpiReloadWait(&asyncRefresh->reload, nullptr);
+	}
+}
+
+void EngineIpi::init(ConfigIpi *config) {
 	DataSetIpi *dataSet = DataSetIpiGet(manager.get());
 	initHttpHeaderKeys(dataSet->b.b.uniqueHeaders);
 	initMetaData();
 	DataSetIpiRelease(dataSet);
+
+	// Size the results pool for the expected number of concurrent requests.
+	uint32_t capacity = config->getConcurrency();
+	if (capacity == 0) {
+		capacity = std::thread::hardware_concurrency();
+	}
+	pool = std::make_shared<ResultsPoolIpi>(
+		manager,
+		capacity == 0 ? 1 : capacity);
+
+	// Create the values cache if enabled in the configuration.
+	if (config->getValuesCacheCapacity() > 0) {
+		valuesCache = std::make_shared<ValuesCacheIpi>(
+			manager,
+			config->getValuesCacheCapacity(),
+			capacity == 0 ? 1 : capacity);
+	}
+}
+
+IpIntelligence::ResultsIpi* EngineIpi::createResults() const {
+	return new ResultsIpi(pool->get(), manager, pool, valuesCache);
 }
 
 void* EngineIpi::copyData(void * const data, const FileOffset length) const {
@@ -181,6 +210,8 @@ void EngineIpi::refreshData() const {
 	StatusCode status = IpiReloadManagerFromOriginalFile(
 		manager.get(),
 		exception);
+
+	clearReplacedDataSet();
 	if (status != SUCCESS) {
 		throw StatusCodeException(status);
 	}
@@ -193,6 +224,8 @@ void EngineIpi::refreshData(const char *fileName) const {
 		manager.get(),
 		fileName,
 		exception);
+
+	clearReplacedDataSet();
 	if (status != SUCCESS) {
 		throw StatusCodeException(status);
 	}
@@ -207,6 +240,8 @@ void EngineIpi::refreshData(void *data, fiftyoneDegreesFileOffset length) const
 		dataCopy,
 		length,
 		exception);
+
+	clearReplacedDataSet();
 	if (status != SUCCESS) {
 		throw StatusCodeException(status);
 	}
@@ -219,30 +254,121 @@ void EngineIpi::refreshData(
 	refreshData((void*)data, length);
 }
 
+void EngineIpi::refreshDataFromDelta(
+	const char *deltaFileName,
+	const char *newFileName) const {
+	EXCEPTION_CREATE;
+	StatusCode status = IpiReloadManagerFromDelta(
+		manager.get(),
+		deltaFileName,
+		newFileName,
+		exception);
+
+	clearReplacedDataSet();
+	if (status != SUCCESS) {
+		throw StatusCodeException(status, deltaFileName);
+	}
+	EXCEPTION_THROW;
+}
+
+void EngineIpi::refreshDataAsync(
+	const char *fileName,
+	const vector<string> &warmIpAddresses,
+	bool touchPages,
+	function<void(const fiftyoneDegreesIpiReloadResult&)> complete) {
+	std::lock_guard<std::mutex> lock(asyncRefreshLock);
+	if (asyncRefresh != nullptr) {
+		IpiReloadWait(&asyncRefresh->reload, nullptr);
+		asyncRefresh.reset();
+	}
+	unique_ptr<AsyncRefresh> refresh(new AsyncRefresh());
+	refresh->ipAddresses = warmIpAddresses;
+	for (const string &ipAddress : refresh->ipAddresses) {
+		refresh->ipAddressPointers.push_back(ipAddress.c_str());
+	}
+	refresh->complete = complete;
+	refresh->engine = this;
+	IpiReloadWarm warm;
+	warm.ipAddresses = refresh->ipAddressPointers.data();
+	warm.count = (uint32_t)refresh->ipAddressPointers.size();
+	warm.touchPages = touchPages;
+	StatusCode status = IpiReloadManagerFromFileAsync(
+		&refresh->reload,
+		manager.get(),
+		fileName,
+		&warm,
+		&asyncRefreshComplete,
+		refresh.get());
+	if (status != SUCCESS) {
+		IpiReloadWait(&refresh->reload, nullptr);
+		throw StatusCodeException(status);
+	}
+	asyncRefresh = std::move(refresh);
+}
+
+void EngineIpi::waitForRefresh() {
+	std::lock_guard<std::mutex> lock(asyncRefreshLock);
+	if (asyncRefresh == nullptr) {
+		return;
+	}
+	EXCEPTION_CREATE;
+	StatusCode status = IpiReloadWait(&asyncRefresh->reload, exception);
+	std::exception_ptr completeException = asyncRefresh->completeException;
+	asyncRefresh.reset();
+	if (status != SUCCESS) {
+		throw StatusCodeException(status);
+	}
+	EXCEPTION_THROW;
+	if (completeException != nullptr) {
+		std::rethrow_exception(completeException);
+	}
+}
+
+void EngineIpi::asyncRefreshComplete(
+	void *state,
+	const fiftyoneDegreesIpiReloadResult *result) {
+	AsyncRefresh *refresh = (AsyncRefresh*)state;
+	if (result->status == SUCCESS) {
+		refresh->engine->clearReplacedDataSet();
+	}
+	if (refresh->complete) {
+		try {
+			refresh->complete(*result);
+		}
+		catch (...) {
+			refresh->completeException = std::current_exception();
+		}
+	}
+}
+
+void EngineIpi::clearReplacedDataSet() const {
+	pool->clear();
+	if (valuesCache != nullptr) {
+		valuesCache->clear();
+	}
+}
+
 IpIntelligence::ResultsIpi* EngineIpi::process(
 	IpIntelligence::EvidenceIpi *evidence) {
 	EXCEPTION_CREATE;
-	fiftyoneDegreesResultsIpi *results = ResultsIpiCreate(
-		manager.get());
+	ResultsIpi *results = createResults();
 	ResultsIpiFromEvidence(
-		results, 
+		results->results, 
 		evidence == nullptr ? nullptr : evidence->get(),
 		exception);
 	if (exception->status != 
 		FIFTYONE_DEGREES_STATUS_INCORRECT_IP_ADDRESS_FORMAT) {
 		EXCEPTION_THROW;
 	}
-
-	return new ResultsIpi(results, manager);
+	return results;
 }
 
 IpIntelligence::ResultsIpi* EngineIpi::process(
 	const char *ipAddress) {
 	EXCEPTION_CREATE;
-	fiftyoneDegreesResultsIpi *results = ResultsIpiCreate(
-		manager.get());
+	ResultsIpi *results = createResults();
 	ResultsIpiFromIpAddressString(
-		results,
+		results->results,
 		ipAddress,
 		ipAddress == nullptr ? 0 : strlen(ipAddress),
 		exception);
@@ -250,7 +376,7 @@ IpIntelligence::ResultsIpi* EngineIpi::process(
 		FIFTYONE_DEGREES_STATUS_INCORRECT_IP_ADDRESS_FORMAT) {
 		EXCEPTION_THROW;
 	}
-	return new ResultsIpi(results, manager);
+	return results;
 }
 
 IpIntelligence::ResultsIpi *EngineIpi::process(
@@ -258,9 +384,9 @@ IpIntelligence::ResultsIpi *EngineIpi::process(
 	long length,
 	fiftyoneDegreesIpType type) {
 	EXCEPTION_CREATE;
-	fiftyoneDegreesResultsIpi *results = ResultsIpiCreate(manager.get());
+	ResultsIpi *results = createResults();
 	ResultsIpiFromIpAddress(
-		results, 
+		results->results, 
 		ipAddress,
 		length,
         type,
@@ -269,23 +395,112 @@ IpIntelligence::ResultsIpi *EngineIpi::process(
 		FIFTYONE_DEGREES_STATUS_INCORRECT_IP_ADDRESS_FORMAT) {
 		EXCEPTION_THROW;
 	}
-	return new ResultsIpi(results, manager);
+	return results;
+}
+
+vector<IpIntelligence::ResultsIpi*> EngineIpi::processBatch(
+	const vector<string> &ipAddresses) {
+	EXCEPTION_CREATE;
+	vector<ResultsIpi*> results;
+	vector<fiftyoneDegreesIpAddress> parsed(ipAddresses.size());
+	for (size_t i = 0; i < ipAddresses.size(); i++) {
+		const char *ipAddress = ipAddresses[i].c_str();
+		if (IpAddressParse(
+			ipAddress,
+			ipAddress + ipAddresses[i].size(),
+			&parsed[i]) == false) {
+			parsed[i].type = FIFTYONE_DEGREES_IP_TYPE_INVALID;
+		}
+	}
+	fiftyoneDegreesResultsIpiBatch *batchPtr = ResultsIpiBatchCreate(
+		manager.get(),
+		(uint32_t)parsed.size());
+	if (batchPtr == nullptr) {
+		throw StatusCodeException(INSUFFICIENT_MEMORY);
+	}
+	shared_ptr<fiftyoneDegreesResultsIpiBatch> batch(
+		batchPtr,
+		ResultsIpiBatchFree);
+	ResultsIpiFromIpAddressBatch(
+		batch.get(),
+		parsed.data(),
+		(uint32_t)parsed.size(),
+		exception);
+	EXCEPTION_THROW;
+
+	// Hold the results until they have all been created so that none are
+	// leaked if creating one of them throws.
+	vector<unique_ptr<ResultsIpi>> created;
+	created.reserve(batch->count);
+	for (uint32_t i = 0; i < batch->count; i++) {
+		created.push_back(unique_ptr<ResultsIpi>(
+			new ResultsIpi(batch->items[i], manager, batch)));
+	}
+	results.reserve(created.size());
+	for (size_t i = 0; i < created.size(); i++) {
+		results.push_back(created[i].release());
+	}
+	return results;
+}
+
+IpIntelligence::ResultsIpi* EngineIpi::processInto(
+	IpIntelligence::ResultsIpi *results,
+	const char *ipAddress) {
+	EXCEPTION_CREATE;
+	if (results == nullptr ||
+		results->batch != nullptr ||
+		ResultsIpiGetIsActive(results->results, manager.get()) == false) {
+		delete results;
+		results = createResults();
+	}
+
+	// Clear the previous IP address's results in case this one is invalid.
+	results->results->count = 0;
+	ResultsIpiFromIpAddressString(
+		results->results,
+		ipAddress,
+		ipAddress == nullptr ? 0 : strlen(ipAddress),
+		exception);
+	if (exception->status != 
+		FIFTYONE_DEGREES_STATUS_INCORRECT_IP_ADDRESS_FORMAT) {
+		EXCEPTION_THROW;
+	}
+	return results;
+}
+
+fiftyoneDegreesIpiRangeCacheStats EngineIpi::getRangeCacheStats() const {
+	return IpiGetRangeCacheStats(manager.get());
+}
+
+fiftyoneDegreesIpiInitTimings EngineIpi::getInitTimings() const {
+	return IpiGetInitTimings(manager.get());
+}
+
+ResultsPoolIpi::Stats EngineIpi::getResultsPoolStats() const {
+	return pool->getStats();
+}
+
+ValuesCacheIpi::Stats EngineIpi::getValuesCacheStats() const {
+	if (valuesCache == nullptr) {
+		ValuesCacheIpi::Stats stats = { 0, 0, 0 };
+		return stats;
+	}
+	return valuesCache->getStats();
 }
 
 Common::ResultsBase* EngineIpi::processBase(
 	Common::EvidenceBase *evidence) const {
 	EXCEPTION_CREATE;
-	fiftyoneDegreesResultsIpi *results = ResultsIpiCreate(
-		manager.get());
+	ResultsIpi *results = createResults();
 	ResultsIpiFromEvidence(
-		results, 
+		results->results, 
 		evidence == nullptr ? nullptr : evidence->get(),
 		exception);
 	if (exception->status != 
 		FIFTYONE_DEGREES_STATUS_INCORRECT_IP_ADDRESS_FORMAT) {
 		EXCEPTION_THROW;
 	}
-	return new ResultsIpi(results, manager);
+	return results;
 }
 
 void EngineIpi::initHttpHeaderKeys(fiftyoneDegreesHeaders *uniqueHeaders) {
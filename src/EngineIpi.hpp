@@ -30,6 +30,10 @@
 #include <stdlib.h>
 #include <sstream>
 #include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <exception>
 #include "common-cxx/ip.h"
 #include "common-cxx/EngineBase.hpp"
 #include "common-cxx/resource.h"
@@ -38,6 +42,8 @@
 #include "EvidenceIpi.hpp"
 #include "ConfigIpi.hpp"
 #include "ResultsIpi.hpp"
+#include "ResultsPoolIpi.hpp"
+#include "ValuesCacheIpi.hpp"
 #include "MetaDataIpi.hpp"
 
 
@@ -46,6 +52,8 @@ namespace FiftyoneDegrees {
 		using FiftyoneDegrees::Common::EngineBase;
 		using FiftyoneDegrees::Common::Date;
 		using FiftyoneDegrees::Common::RequiredPropertiesConfig;
+		using std::function;
+		using std::unique_ptr;
 
 		/**
 		 * Encapsulates the IP Intelligence engine class which implements
@@ -158,6 +166,12 @@ namespace FiftyoneDegrees {
 				ConfigIpi *config,
 				RequiredPropertiesConfig *properties);
 
+			/**
+			 * Waits for any refresh started by refreshDataAsync before the
+			 * data set is freed.
+			 */
+			virtual ~EngineIpi();
+
 			/**
 			 * @}
 			 * @name Engine Methods
@@ -200,6 +214,122 @@ namespace FiftyoneDegrees {
 				long length,
 				fiftyoneDegreesIpType type);
 
+			/**
+			 * Processes the IP address strings provided and returns the
+			 * results for each in the same order. All the results share a
+			 * single reference to the data set and a single allocation, so
+			 * the fixed cost of processing is paid once per batch rather than
+			 * once per IP address. Each of the results must be deleted by the
+			 * caller. IP addresses which can not be parsed result in results
+			 * with no values rather than an exception.
+			 * @param ipAddresses the IP address strings to process
+			 * @return a new results instance for each IP address
+			 */
+			vector<ResultsIpi*> processBatch(
+				const vector<string> &ipAddresses);
+
+			/**
+			 * Processes the IP address string provided reusing results
+			 * previously returned by this engine, avoiding the allocation
+			 * of new results and the reference counting of the data set for
+			 * every IP address. The results are only replaced when they are
+			 * null, part of a batch, or reference a data set which has since
+			 * been reloaded, in which case the results provided are deleted.
+			 * The caller must use the results returned in place of those
+			 * provided, and delete them when finished.
+			 * @param results previously returned by this engine, or nullptr
+			 * @param ipAddress the IP address string to process
+			 * @return results with the values for all requested properties
+			 */
+			ResultsIpi* processInto(
+				ResultsIpi *results,
+				const char *ipAddress);
+
+			/**
+			 * Gets the counters from the range cache of the active data set.
+			 * The counters start from zero whenever the data set is
+			 * reloaded.
+			 * See ConfigIpi::setRangeCacheCapacity
+			 * @return the range cache counters
+			 */
+			fiftyoneDegreesIpiRangeCacheStats getRangeCacheStats() const;
+
+			/**
+			 * Gets the time spent in each stage of initialising the active
+			 * data set. The timings are replaced whenever the data set is
+			 * reloaded.
+			 * See ConfigIpi::setInitThreads
+			 * @return the init timings in milliseconds
+			 */
+			fiftyoneDegreesIpiInitTimings getInitTimings() const;
+
+			/**
+			 * Gets the counters from the pool of results reused by the
+			 * process methods. The pool is sized from the concurrency in the
+			 * configuration, or the number of hardware threads if no
+			 * concurrency is set.
+			 * @return the results pool counters
+			 */
+			ResultsPoolIpi::Stats getResultsPoolStats() const;
+
+			/**
+			 * Gets the counters from the cache of property values. The
+			 * capacity is zero if the configuration did not enable the
+			 * cache.
+			 * @return the values cache counters
+			 */
+			ValuesCacheIpi::Stats getValuesCacheStats() const;
+
+			/**
+			 * Refreshes the data set on a background thread. The new data
+			 * set is warmed with the IP addresses provided before it
+			 * replaces the active one, so processing continues with warm
+			 * caches throughout. Any refresh still in progress is waited
+			 * for first.
+			 * See fiftyoneDegreesIpiReloadManagerFromFileAsync
+			 * @param fileName path to the new data file, or nullptr to
+			 * refresh from the data file the engine was created with
+			 * @param warmIpAddresses sample of recent IP addresses to process
+			 * with the new data set before it becomes active
+			 * @param touchPages true to read every page of a mapped data file
+			 * before it becomes active
+			 * @param complete called on the refresh thread once the refresh
+			 * has completed, or nullptr. Must not call refreshDataAsync or
+			 * waitForRefresh. Any exception it throws is thrown by
+			 * waitForRefresh
+			 */
+			void refreshDataAsync(
+				const char *fileName,
+				const vector<string> &warmIpAddresses,
+				bool touchPages,
+				function<void(const fiftyoneDegreesIpiReloadResult&)> complete);
+
+			/**
+			 * Refreshes the data set from a delta between the active data
+			 * file and a new one. The new data file is written from the
+			 * active data set and the delta, and then the data set is
+			 * refreshed from it. The delta only reduces the size of the
+			 * update transferred, and the refresh uses as much memory as
+			 * refreshData.
+			 * See fiftyoneDegreesIpiReloadManagerFromDelta
+			 * @param deltaFileName path to the delta
+			 * @param newFileName path to write the new data file to, which
+			 * must not be the active data file
+			 */
+			void refreshDataFromDelta(
+				const char *deltaFileName,
+				const char *newFileName) const;
+
+			/**
+			 * Waits for the refresh started by refreshDataAsync to complete.
+			 * Returns immediately if no refresh has been started.
+			 * @throws StatusCodeException if the refresh failed, in which
+			 * case the active data set has not been replaced
+			 * @throws the exception thrown by the complete callback passed to
+			 * refreshDataAsync, if any
+			 */
+			void waitForRefresh();
+
 			/**
 			 * @}
 			 * @name Common::EngineBase Implementation
@@ -243,9 +373,68 @@ namespace FiftyoneDegrees {
 		private:
 			void initMetaData();
 
-			void init();
+			void init(ConfigIpi *config);
 
 			void* copyData(void *data, fiftyoneDegreesFileOffset length) const;
+
+			/**
+			 * State of a refresh started by refreshDataAsync which must
+			 * remain valid until it has been waited for.
+			 */
+			struct AsyncRefresh {
+				fiftyoneDegreesIpiReload reload;
+				vector<string> ipAddresses;
+				vector<const char*> ipAddressPointers;
+				function<void(const fiftyoneDegreesIpiReloadResult&)> complete;
+				std::exception_ptr completeException;
+				const EngineIpi *engine;
+			};
+
+			/**
+			 * Called on the refresh thread when the refresh has completed.
+			 * Exceptions from the complete callback are kept for
+			 * waitForRefresh as they must not unwind into the C reload.
+			 */
+			static void asyncRefreshComplete(
+				void *state,
+				const fiftyoneDegreesIpiReloadResult *result);
+
+			/**
+			 * Frees the pooled results and cached values which reference the
+			 * replaced data set.
+			 */
+			void clearReplacedDataSet() const;
+
+			/**
+			 * Takes results from the pool and wraps them in a new instance
+			 * which returns them to the pool when deleted.
+			 * @return new results ready to process an IP address
+			 */
+			ResultsIpi* createResults() const;
+
+			/**
+			 * Pool of results shared with the results taken from it.
+			 */
+			shared_ptr<ResultsPoolIpi> pool;
+
+			/**
+			 * Cache of property values shared with the results, or nullptr
+			 * if not enabled in the configuration.
+			 */
+			shared_ptr<ValuesCacheIpi> valuesCache;
+
+			/**
+			 * Refresh started by refreshDataAsync which has not been waited
+			 * for, or nullptr.
+			 */
+			unique_ptr<AsyncRefresh> asyncRefresh;
+
+			/**
+			 * Lock held while asyncRefresh is started, waited for or
+			 * replaced so that concurrent callers never wait for the same
+			 * reload twice.
+			 */
+			std::mutex asyncRefreshLock;
 		};
 	}
 }
@@ -39,9 +39,33 @@ IpIntelligence::ResultsIpi::ResultsIpi(
 	this->results = results;
 }
 
+IpIntelligence::ResultsIpi::ResultsIpi(
+	fiftyoneDegreesResultsIpi *results,
+	shared_ptr<fiftyoneDegreesResourceManager> manager,
+	shared_ptr<fiftyoneDegreesResultsIpiBatch> batch)
+	: ResultsBase(&results->b, manager), batch(batch) {
+	this->results = results;
+}
+
+IpIntelligence::ResultsIpi::ResultsIpi(
+	fiftyoneDegreesResultsIpi *results,
+	shared_ptr<fiftyoneDegreesResourceManager> manager,
+	shared_ptr<ResultsPoolIpi> pool,
+	shared_ptr<ValuesCacheIpi> valuesCache)
+	: ResultsBase(&results->b, manager), pool(pool), valuesCache(valuesCache) {
+	this->results = results;
+}
+
 
 IpIntelligence::ResultsIpi::~ResultsIpi() {
-	ResultsIpiFree(results);
+	// Results within a batch are freed with the batch, and results from a
+	// pool are returned to it.
+	if (pool != nullptr) {
+		pool->release(results);
+	}
+	else if (batch == nullptr) {
+		ResultsIpiFree(results);
+	}
 }
 
 /* 
@@ -65,6 +89,21 @@ IpIntelligence::ResultsIpi::getValuesInternal(int requiredPropertyIndex, vector<
     EXCEPTION_CREATE;
 	const WeightedItem *valuesItems;
 
+	// Values are the same for every IP address with the same result for
+	// the property's component, so may already be in the cache.
+	const ResultIpi *propertyResult = valuesCache != nullptr ?
+		getPropertyResult(requiredPropertyIndex) : nullptr;
+	if (propertyResult != nullptr) {
+		shared_ptr<const vector<string>> cached = valuesCache->get(
+			results,
+			requiredPropertyIndex,
+			propertyResult);
+		if (cached != nullptr) {
+			values.insert(values.end(), cached->begin(), cached->end());
+			return;
+		}
+	}
+
     // We should not have any undefined data type in the data file
     // If there is, the data file is not good to use so terminates.
     getPropertyValueType(requiredPropertyIndex, exception);
@@ -93,7 +132,8 @@ IpIntelligence::ResultsIpi::getValuesInternal(int requiredPropertyIndex, vector<
 
 	// Set enough space in the vector for all the strings that will be 
 	// inserted.
-	values.reserve(results->values.count);
+	const size_t first = values.size();
+	values.reserve(first + results->values.count);
 
     stringstream stream;
 	// Add the values in their original form to the result.
@@ -122,6 +162,55 @@ IpIntelligence::ResultsIpi::getValuesInternal(int requiredPropertyIndex, vector<
     // in incorrect. If it happens the data file or
     // the memory is corrupted and we should terminate
     EXCEPTION_THROW
+
+	if (propertyResult != nullptr) {
+		valuesCache->add(
+			results,
+			requiredPropertyIndex,
+			propertyResult,
+			std::make_shared<const vector<string>>(
+				values.begin() + first,
+				values.end()));
+	}
+}
+
+const fiftyoneDegreesResultIpi*
+IpIntelligence::ResultsIpi::getPropertyResult(int requiredPropertyIndex) {
+	EXCEPTION_CREATE;
+	Item propertyItem;
+	const DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
+	const int propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
+		dataSet->b.b.available,
+		requiredPropertyIndex);
+	if (propertyIndex < 0) {
+		return nullptr;
+	}
+	DataReset(&propertyItem.data);
+	const Property *property = PropertyGet(
+		dataSet->properties,
+		propertyIndex,
+		&propertyItem,
+		exception);
+	if (property == nullptr || EXCEPTION_FAILED) {
+		return nullptr;
+	}
+	const uint32_t componentIndex = property->componentIndex;
+	COLLECTION_RELEASE(dataSet->properties, &propertyItem);
+
+	// The results contain one result for each component with available
+	// properties in the order of the components.
+	if (componentIndex >= dataSet->componentsList.count ||
+		dataSet->componentsAvailable[componentIndex] == false) {
+		return nullptr;
+	}
+	uint32_t resultIndex = 0;
+	for (uint32_t i = 0; i < componentIndex; i++) {
+		if (dataSet->componentsAvailable[i]) {
+			resultIndex++;
+		}
+	}
+	return resultIndex < results->count ?
+		&results->items[resultIndex] : nullptr;
 }
 
 fiftyoneDegreesPropertyValueType
@@ -156,69 +245,63 @@ IpIntelligence::ResultsIpi::getPropertyValueType(
 Common::Value<IpIntelligence::IpAddress>
 IpIntelligence::ResultsIpi::getValueAsIpAddress(int requiredPropertyIndex) {
     EXCEPTION_CREATE;
-    const WeightedItem *valuesItems;
+    fiftyoneDegreesResultsNoValueReason reason;
     Common::Value<IpAddress> result;
-    if (!(hasValuesInternal(requiredPropertyIndex)))
-    {
-        fiftyoneDegreesResultsNoValueReason reason =
-			getNoValueReasonInternal(requiredPropertyIndex);
-		result.setNoValueReason(
-			reason,
-			getNoValueMessageInternal(reason));
+
+    // Get the values, or the reason there are none, with a single traversal
+    // of the profiles.
+    const WeightedItem * const valuesItems = ResultsIpiGetValuesWithReason(
+        results,
+        requiredPropertyIndex,
+        &reason,
+        exception);
+    EXCEPTION_THROW;
+    if (valuesItems == nullptr) {
+        result.setNoValueReason(
+            reason,
+            getNoValueMessageInternal(reason));
+        return result;
     }
-    else {
-        getPropertyValueType(requiredPropertyIndex, exception);
-        if (EXCEPTION_OKAY) {
-            const DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
-            const int propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
-                dataSet->b.b.available,
-                requiredPropertyIndex);
-            const PropertyValueType storedValueType = PropertyGetStoredTypeByIndex(
-                dataSet->propertyTypes,
-                propertyIndex,
-                exception);
-            EXCEPTION_THROW;
 
-            if (storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_IP_ADDRESS) {
-                // Get a pointer to the first value item for the property.
-                valuesItems = ResultsIpiGetValues(results, requiredPropertyIndex, exception);
-                EXCEPTION_THROW;
-                
-                if (valuesItems == NULL) {
-                    // No pointer to values was returned.
-                    throw NoValuesAvailableException();
-                }
-                
-                // Add the values in their original form to the result.
-                if (results->values.count > 1) {
-                    result.setNoValueReason(
-                        FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_TOO_MANY_VALUES,
-                        nullptr);
-                }
-                else {
-                    IpAddress ipAddress;
-                    const VarLengthByteArray * const rawIpAddress = (const VarLengthByteArray *)valuesItems->item.data.ptr;
-                    const unsigned char * const ipAddressBytes =
-                        &rawIpAddress->firstByte;
-                    const IpType rawIpType = (rawIpAddress->size == IPV4_LENGTH) ? IP_TYPE_IPV4 :
-                    ((rawIpAddress->size == IPV6_LENGTH) ? IP_TYPE_IPV6
-                        : IP_TYPE_INVALID);
-                    if (ipAddressBytes != NULL) {
-                        ipAddress = IpAddress(
-                            ipAddressBytes, rawIpType);
-                    }
-                    result.setValue(ipAddress);
-                }
-            }
-            else {
-                // Default to the smallest IP address
-                if (results->items[0].type == IP_TYPE_IPV4) {
-                    result.setValue(IpAddress("0.0.0.0"));
-                }
-                else {
-                    result.setValue(IpAddress("0000:0000:0000:0000:0000:0000:0000:0000"));
-                }
+    const DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
+    const int propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
+        dataSet->b.b.available,
+        requiredPropertyIndex);
+    const PropertyValueType storedValueType = PropertyGetStoredTypeByIndex(
+        dataSet->propertyTypes,
+        propertyIndex,
+        exception);
+    EXCEPTION_THROW;
+
+    if (storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_IP_ADDRESS) {
+        // Add the values in their original form to the result.
+        if (results->values.count > 1) {
+            result.setNoValueReason(
+                FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_TOO_MANY_VALUES,
+                nullptr);
+        }
+        else {
+            IpAddress ipAddress;
+            const VarLengthByteArray * const rawIpAddress = (const VarLengthByteArray *)valuesItems->item.data.ptr;
+            const unsigned char * const ipAddressBytes =
+                &rawIpAddress->firstByte;
+            const IpType rawIpType = (rawIpAddress->size == IPV4_LENGTH) ? IP_TYPE_IPV4 :
+            ((rawIpAddress->size == IPV6_LENGTH) ? IP_TYPE_IPV6
+                : IP_TYPE_INVALID);
+            if (ipAddressBytes != NULL) {
+                ipAddress = IpAddress(
+                    ipAddressBytes, rawIpType);
             }
+            result.setValue(ipAddress);
+        }
+    }
+    else {
+        // Default to the smallest IP address
+        if (results->items[0].type == IP_TYPE_IPV4) {
+            result.setValue(IpAddress("0.0.0.0"));
+        }
+        else {
+            result.setValue(IpAddress("0000:0000:0000:0000:0000:0000:0000:0000"));
         }
     }
     return result;
@@ -242,61 +325,111 @@ IpIntelligence::ResultsIpi::getValueAsIpAddress(const string *propertyName) {
         ResultsBase::getRequiredPropertyIndex(propertyName->c_str()));
 }
 
-Common::Value<vector<WeightedValue<bool>>>
-IpIntelligence::ResultsIpi::getValuesAsWeightedBoolList(
-    int requiredPropertyIndex) {
+Common::Value<IpIntelligence::IpAddress>
+IpIntelligence::ResultsIpi::getRangeBound(bool first) {
     EXCEPTION_CREATE;
-    uint32_t i;
-    const WeightedItem *valuesItems;
-    Common::Value<vector<WeightedValue<bool>>> result;
-    vector<WeightedValue<bool>> values;
-    if (!(hasValuesInternal(requiredPropertyIndex)))
-    {
-        fiftyoneDegreesResultsNoValueReason reason =
-			getNoValueReasonInternal(requiredPropertyIndex);
-		result.setNoValueReason(
-			reason,
-			getNoValueMessageInternal(reason));
+    fiftyoneDegreesIpAddress start, end;
+    Common::Value<IpAddress> result;
+    const bool found = fiftyoneDegreesResultsIpiGetRange(
+        results,
+        &start,
+        &end,
+        nullptr,
+        exception);
+    EXCEPTION_THROW;
+    if (found == false) {
+        result.setNoValueReason(
+            FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_NO_RESULTS,
+            nullptr);
     }
     else {
-        getPropertyValueType(requiredPropertyIndex, exception);
-        if (EXCEPTION_OKAY) {
-            // Get a pointer to the first value item for the property.
-            valuesItems = ResultsIpiGetValues(results, requiredPropertyIndex, exception);
-            EXCEPTION_THROW;
+        const fiftyoneDegreesIpAddress &bound = first ? start : end;
+        result.setValue(IpAddress(bound.value, bound.type));
+    }
+    return result;
+}
 
-            if (valuesItems == NULL) {
-                // No pointer to values was returned.
-                throw NoValuesAvailableException();
-            }
+Common::Value<IpIntelligence::IpAddress>
+IpIntelligence::ResultsIpi::getRangeStart() {
+    return getRangeBound(true);
+}
 
-            const DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
-            const int propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
-                dataSet->b.b.available,
-                requiredPropertyIndex);
-            const PropertyValueType storedValueType = PropertyGetStoredTypeByIndex(
-                dataSet->propertyTypes,
-                propertyIndex,
-                exception);
-            EXCEPTION_THROW;
+Common::Value<IpIntelligence::IpAddress>
+IpIntelligence::ResultsIpi::getRangeEnd() {
+    return getRangeBound(false);
+}
 
-            // Set enough space in the vector for all the strings that will be
-            // inserted.
-            values.reserve(results->values.count);
+uint32_t IpIntelligence::ResultsIpi::getRangeId() {
+    EXCEPTION_CREATE;
+    uint32_t rangeId;
+    fiftyoneDegreesIpAddress start, end;
+    fiftyoneDegreesResultsIpiGetRange(
+        results,
+        &start,
+        &end,
+        &rangeId,
+        exception);
+    EXCEPTION_THROW;
+    return rangeId;
+}
 
-            // Add the values in their original form to the result.
-            for (i = 0; i < results->values.count; i++) {
-                WeightedValue<bool> weightedBool;
-                weightedBool.setValue(StoredBinaryValueToBoolOrDefault(
-                    (const StoredBinaryValue *)valuesItems[i].item.data.ptr,
-                    storedValueType,
-                    false));
-                weightedBool.setRawWeight(valuesItems[i].rawWeighting);
-                values.push_back(weightedBool);
-            }
-            result.setValue(values);
-        }
+size_t IpIntelligence::ResultsIpi::getValuesAsJson(
+    char *buffer,
+    size_t bufferLength) {
+    EXCEPTION_CREATE;
+    const size_t added = fiftyoneDegreesResultsIpiGetValuesJson(
+        results,
+        buffer,
+        bufferLength,
+        exception);
+    EXCEPTION_THROW;
+    return added;
+}
+
+string IpIntelligence::ResultsIpi::getValuesAsJson() {
+    // Most results fit in the initial buffer. If not the buffer is
+    // resized to the length needed and the JSON written again.
+    vector<char> buffer(4096);
+    const size_t added = getValuesAsJson(buffer.data(), buffer.size());
+    if (added >= buffer.size()) {
+        buffer.resize(added + 2);
+        getValuesAsJson(buffer.data(), buffer.size());
     }
+    return string(buffer.data());
+}
+
+Common::Value<vector<WeightedValue<bool>>>
+IpIntelligence::ResultsIpi::getValuesAsWeightedBoolList(
+    int requiredPropertyIndex) {
+    vector<WeightedValue<bool>> values;
+    Common::Value<vector<WeightedValue<bool>>> result;
+    iterateWeightedValues(
+        requiredPropertyIndex,
+        [&result](const fiftyoneDegreesResultsNoValueReason reason, const char * const reasonStr) {
+            result.setNoValueReason(reason, reasonStr);
+        },
+        [&values](const uint32_t count) {
+            values.reserve(count);
+        },
+        [&values](
+            const StoredBinaryValue * const binaryValue,
+            const PropertyValueType storedValueType,
+            const uint32_t rawWeighting,
+            Exception * const exception) {
+#       	ifdef _MSC_VER
+            UNREFERENCED_PARAMETER(exception);
+#       	endif
+            WeightedValue<bool> weightedBool;
+            weightedBool.setValue(StoredBinaryValueToBoolOrDefault(
+                binaryValue,
+                storedValueType,
+                false));
+            weightedBool.setRawWeight(rawWeighting);
+            values.push_back(weightedBool);
+        },
+        [&result, &values] {
+            result.setValue(values);
+        });
     return result;
 }
 
@@ -361,6 +494,57 @@ IpIntelligence::ResultsIpi::getValuesAsWeightedStringList(
     return result;
 }
 
+Common::Value<vector<WeightedStringView>>
+IpIntelligence::ResultsIpi::getValuesAsWeightedStringViewList(
+    int requiredPropertyIndex) {
+    vector<WeightedStringView> values;
+    Common::Value<vector<WeightedStringView>> result;
+
+    // Values in memory remain valid while the results hold the data set,
+    // otherwise they are only valid until the results are next used.
+    const bool copy = !((DataSetIpi*)results->b.dataSet)->b.b.isInMemory;
+    iterateWeightedValues(
+        requiredPropertyIndex,
+        [&result](const fiftyoneDegreesResultsNoValueReason reason, const char * const reasonStr) {
+            result.setNoValueReason(reason, reasonStr);
+        },
+        [&values](const uint32_t count) {
+            values.reserve(count);
+        },
+        [&values, copy](
+            const StoredBinaryValue * const binaryValue,
+            const PropertyValueType storedValueType,
+            const uint32_t rawWeighting,
+            Exception * const exception) {
+#       	ifdef _MSC_VER
+            UNREFERENCED_PARAMETER(exception);
+#       	endif
+            values.emplace_back(
+                binaryValue,
+                storedValueType,
+                rawWeighting,
+                copy);
+        },
+        [&result, &values] {
+            result.setValue(values);
+        });
+    return result;
+}
+
+Common::Value<vector<WeightedStringView>>
+IpIntelligence::ResultsIpi::getValuesAsWeightedStringViewList(
+    const char *propertyName) {
+    return getValuesAsWeightedStringViewList(
+        ResultsBase::getRequiredPropertyIndex(propertyName));
+}
+
+Common::Value<vector<WeightedStringView>>
+IpIntelligence::ResultsIpi::getValuesAsWeightedStringViewList(
+    const string &propertyName) {
+    return getValuesAsWeightedStringViewList(
+        ResultsBase::getRequiredPropertyIndex(propertyName.c_str()));
+}
+
 void IpIntelligence::ResultsIpi::iterateWeightedValues(
     int requiredPropertyIndex,
     const std::function<void(
@@ -376,48 +560,44 @@ void IpIntelligence::ResultsIpi::iterateWeightedValues(
 
     EXCEPTION_CREATE;
     uint32_t i;
-    if (!(hasValuesInternal(requiredPropertyIndex)))
-    {
-        fiftyoneDegreesResultsNoValueReason reason =
-			getNoValueReasonInternal(requiredPropertyIndex);
-		onNoValue(reason, getNoValueMessageInternal(reason));
+    fiftyoneDegreesResultsNoValueReason reason;
+
+    // Get the values, or the reason there are none, with a single traversal
+    // of the profiles.
+    const WeightedItem * const valuesItems = ResultsIpiGetValuesWithReason(
+        results,
+        requiredPropertyIndex,
+        &reason,
+        exception);
+    EXCEPTION_THROW;
+    if (valuesItems == nullptr) {
+        onNoValue(reason, getNoValueMessageInternal(reason));
+        return;
     }
-    else {
-        const DataSetIpi * const dataSet = static_cast<DataSetIpi *>(results->b.dataSet);
-        const uint32_t propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
-            dataSet->b.b.available,
-            requiredPropertyIndex);
-        fiftyoneDegreesPropertyValueType storedValueType = PropertyGetStoredTypeByIndex(
-            dataSet->propertyTypes,
-            propertyIndex,
-            exception);
-        EXCEPTION_THROW;
-        // Get a pointer to the first value item for the property.
-        const WeightedItem * const valuesItems = ResultsIpiGetValues(
-            results,
-            requiredPropertyIndex,
-            exception);
-        EXCEPTION_THROW;
 
-        if (valuesItems == nullptr) {
-            // No pointer to values was returned.
-            throw NoValuesAvailableException();
-        }
+    const DataSetIpi * const dataSet = static_cast<DataSetIpi *>(results->b.dataSet);
+    const uint32_t propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
+        dataSet->b.b.available,
+        requiredPropertyIndex);
+    fiftyoneDegreesPropertyValueType storedValueType = PropertyGetStoredTypeByIndex(
+        dataSet->propertyTypes,
+        propertyIndex,
+        exception);
+    EXCEPTION_THROW;
 
-        // Set enough space in the vector for all the strings that will be
-        // inserted.
-        onValuesCount(results->values.count);
+    // Set enough space in the vector for all the strings that will be
+    // inserted.
+    onValuesCount(results->values.count);
 
-        // Add the values in their original form to the result.
-        for (i = 0; i < results->values.count; i++) {
-            onEachValue(
-                reinterpret_cast<const StoredBinaryValue *>(valuesItems[i].item.data.ptr),
-                storedValueType,
-                valuesItems[i].rawWeighting,
-                exception);
-        }
-        onAfterValues();
+    // Add the values in their original form to the result.
+    for (i = 0; i < results->values.count; i++) {
+        onEachValue(
+            reinterpret_cast<const StoredBinaryValue *>(valuesItems[i].item.data.ptr),
+            storedValueType,
+            valuesItems[i].rawWeighting,
+            exception);
     }
+    onAfterValues();
 }
 
 Common::Value<vector<WeightedValue<string>>>
@@ -605,56 +785,42 @@ Common::Value<vector<WeightedValue<string>>>
 IpIntelligence::ResultsIpi::getValuesAsWeightedWKTStringList(
     const int requiredPropertyIndex,
     const byte decimalPlaces) {
-    EXCEPTION_CREATE;
-    uint32_t i;
-    const WeightedItem *valuesItems;
-    Common::Value<vector<WeightedValue<string>>> result;
     vector<WeightedValue<string>> values;
-    if (!(hasValuesInternal(requiredPropertyIndex)))
-    {
-        fiftyoneDegreesResultsNoValueReason reason =
-			getNoValueReasonInternal(requiredPropertyIndex);
-		result.setNoValueReason(
-			reason,
-			getNoValueMessageInternal(reason));
-    }
-    else {
-        getPropertyValueType(requiredPropertyIndex, exception);
-        if (EXCEPTION_OKAY) {
-            // Get a pointer to the first value item for the property.
-            valuesItems = ResultsIpiGetValues(results, requiredPropertyIndex, exception);
+    Common::Value<vector<WeightedValue<string>>> result;
+    stringstream stream;
+    iterateWeightedValues(
+        requiredPropertyIndex,
+        [&result](const fiftyoneDegreesResultsNoValueReason reason, const char * const reasonStr) {
+            result.setNoValueReason(reason, reasonStr);
+        },
+        [&values](const uint32_t count) {
+            values.reserve(count);
+        },
+        [&values, &stream, decimalPlaces](
+            const StoredBinaryValue * const binaryValue,
+            const PropertyValueType storedValueType,
+            const uint32_t rawWeighting,
+            Exception * const exception) {
+#       	ifdef _MSC_VER
+            UNREFERENCED_PARAMETER(storedValueType);
+#       	endif
+            WeightedValue<string> weightedString;
+            // Clear stream before the construction
+            stream.str("");
+            writeStoredBinaryValueToStringStream(
+                binaryValue,
+                FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB,
+                stream,
+                decimalPlaces,
+                exception);
             EXCEPTION_THROW;
-
-            if (valuesItems == nullptr) {
-                // No pointer to values was returned.
-                throw NoValuesAvailableException();
-            }
-
-            // Set enough space in the vector for all the strings that will be
-            // inserted.
-            values.reserve(results->values.count);
-
-            stringstream stream;
-            // Add the values in their original form to the result.
-            for (i = 0; i < results->values.count; i++) {
-                WeightedValue<string> weightedString;
-                // Clear stream before the construction
-                stream.str("");
-                const StoredBinaryValue * const binaryValue = (StoredBinaryValue *)valuesItems[i].item.data.ptr;
-                writeStoredBinaryValueToStringStream(
-                    binaryValue,
-                    FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB,
-                    stream,
-                    decimalPlaces,
-                    exception);
-                EXCEPTION_THROW;
-                weightedString.setValue(stream.str());
-                weightedString.setRawWeight(valuesItems[i].rawWeighting);
-                values.push_back(weightedString);
-            }
+            weightedString.setValue(stream.str());
+            weightedString.setRawWeight(rawWeighting);
+            values.push_back(weightedString);
+        },
+        [&result, &values] {
             result.setValue(values);
-        }
-    }
+        });
     return result;
 }
 
@@ -688,58 +854,35 @@ byte decimalPlaces) {
 Common::Value<vector<WeightedValue<int>>>
 IpIntelligence::ResultsIpi::getValuesAsWeightedIntegerList(
     int requiredPropertyIndex) {
-    EXCEPTION_CREATE;
-    uint32_t i;
-    const WeightedItem *valuesItems;
-    Common::Value<vector<WeightedValue<int>>> result;
     vector<WeightedValue<int>> values;
-    if (!(hasValuesInternal(requiredPropertyIndex)))
-    {
-        fiftyoneDegreesResultsNoValueReason reason =
-			getNoValueReasonInternal(requiredPropertyIndex);
-		result.setNoValueReason(
-			reason,
-			getNoValueMessageInternal(reason));
-    }
-    else {
-        getPropertyValueType(requiredPropertyIndex, exception);
-        if (EXCEPTION_OKAY) {
-            // Get a pointer to the first value item for the property.
-            valuesItems = ResultsIpiGetValues(results, requiredPropertyIndex, exception);
-            EXCEPTION_THROW;
-
-            if (valuesItems == NULL) {
-                // No pointer to values was returned.
-                throw NoValuesAvailableException();
-            }
-
-            const DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
-            const int propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
-                dataSet->b.b.available,
-                requiredPropertyIndex);
-            const PropertyValueType storedValueType = PropertyGetStoredTypeByIndex(
-                dataSet->propertyTypes,
-                propertyIndex,
-                exception);
-            EXCEPTION_THROW;
-
-            // Set enough space in the vector for all the strings that will be
-            // inserted.
-            values.reserve(results->values.count);
-
-            // Add the values in their original form to the result.
-            for (i = 0; i < results->values.count; i++) {
-                WeightedValue<int> weightedInteger;
-                weightedInteger.setValue(StoredBinaryValueToIntOrDefault(
-                    (const StoredBinaryValue *)valuesItems[i].item.data.ptr,
-                    storedValueType,
-                    0));
-                weightedInteger.setRawWeight(valuesItems[i].rawWeighting);
-                values.push_back(weightedInteger);
-            }
+    Common::Value<vector<WeightedValue<int>>> result;
+    iterateWeightedValues(
+        requiredPropertyIndex,
+        [&result](const fiftyoneDegreesResultsNoValueReason reason, const char * const reasonStr) {
+            result.setNoValueReason(reason, reasonStr);
+        },
+        [&values](const uint32_t count) {
+            values.reserve(count);
+        },
+        [&values](
+            const StoredBinaryValue * const binaryValue,
+            const PropertyValueType storedValueType,
+            const uint32_t rawWeighting,
+            Exception * const exception) {
+#       	ifdef _MSC_VER
+            UNREFERENCED_PARAMETER(exception);
+#       	endif
+            WeightedValue<int> weightedInteger;
+            weightedInteger.setValue(StoredBinaryValueToIntOrDefault(
+                binaryValue,
+                storedValueType,
+                0));
+            weightedInteger.setRawWeight(rawWeighting);
+            values.push_back(weightedInteger);
+        },
+        [&result, &values] {
             result.setValue(values);
-        }
-    }
+        });
     return result;
 }
 
@@ -767,58 +910,35 @@ IpIntelligence::ResultsIpi::getValuesAsWeightedIntegerList(
 Common::Value<vector<WeightedValue<double>>>
 IpIntelligence::ResultsIpi::getValuesAsWeightedDoubleList(
     int requiredPropertyIndex) {
-    EXCEPTION_CREATE;
-    uint32_t i;
-    const WeightedItem *valuesItems;
-    Common::Value<vector<WeightedValue<double>>> result;
     vector<WeightedValue<double>> values;
-    if (!(hasValuesInternal(requiredPropertyIndex)))
-    {
-        fiftyoneDegreesResultsNoValueReason reason =
-			getNoValueReasonInternal(requiredPropertyIndex);
-		result.setNoValueReason(
-			reason,
-			getNoValueMessageInternal(reason));
-    }
-    else {
-        getPropertyValueType(requiredPropertyIndex, exception);
-        if (EXCEPTION_OKAY) {
-            // Get a pointer to the first value item for the property.
-            valuesItems = ResultsIpiGetValues(results, requiredPropertyIndex, exception);
-            EXCEPTION_THROW;
-
-            if (valuesItems == NULL) {
-                // No pointer to values was returned.
-                throw NoValuesAvailableException();
-            }
-
-            const DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
-            const int propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
-                dataSet->b.b.available,
-                requiredPropertyIndex);
-            const PropertyValueType storedValueType = PropertyGetStoredTypeByIndex(
-                dataSet->propertyTypes,
-                propertyIndex,
-                exception);
-            EXCEPTION_THROW;
-
-            // Set enough space in the vector for all the strings that will be
-            // inserted.
-            values.reserve(results->values.count);
-
-            // Add the values in their original form to the result.
-            for (i = 0; i < results->values.count; i++) {
-                WeightedValue<double> weightedDouble;
-                weightedDouble.setValue(StoredBinaryValueToDoubleOrDefault(
-                    (const StoredBinaryValue *)valuesItems[i].item.data.ptr,
-                    storedValueType,
-                    0));
-                weightedDouble.setRawWeight(valuesItems[i].rawWeighting);
-                values.push_back(weightedDouble);
-            }
+    Common::Value<vector<WeightedValue<double>>> result;
+    iterateWeightedValues(
+        requiredPropertyIndex,
+        [&result](const fiftyoneDegreesResultsNoValueReason reason, const char * const reasonStr) {
+            result.setNoValueReason(reason, reasonStr);
+        },
+        [&values](const uint32_t count) {
+            values.reserve(count);
+        },
+        [&values](
+            const StoredBinaryValue * const binaryValue,
+            const PropertyValueType storedValueType,
+            const uint32_t rawWeighting,
+            Exception * const exception) {
+#       	ifdef _MSC_VER
+            UNREFERENCED_PARAMETER(exception);
+#       	endif
+            WeightedValue<double> weightedDouble;
+            weightedDouble.setValue(StoredBinaryValueToDoubleOrDefault(
+                binaryValue,
+                storedValueType,
+                0));
+            weightedDouble.setRawWeight(rawWeighting);
+            values.push_back(weightedDouble);
+        },
+        [&result, &values] {
             result.setValue(values);
-        }
-    }
+        });
     return result;
 }
 
@@ -843,9 +963,72 @@ IpIntelligence::ResultsIpi::getValuesAsWeightedDoubleList(
         ResultsBase::getRequiredPropertyIndex(propertyName->c_str()));
 }
 
+Common::Value<vector<WeightedValue<fiftyoneDegreesIpiCoordinate>>>
+IpIntelligence::ResultsIpi::getValuesAsWeightedCoordinateList(
+    int requiredPropertyIndex) {
+    vector<WeightedValue<fiftyoneDegreesIpiCoordinate>> values;
+    Common::Value<vector<WeightedValue<fiftyoneDegreesIpiCoordinate>>> result;
+    iterateWeightedValues(
+        requiredPropertyIndex,
+        [&result](const fiftyoneDegreesResultsNoValueReason reason, const char * const reasonStr) {
+            result.setNoValueReason(reason, reasonStr);
+        },
+        [&values](const uint32_t count) {
+            values.reserve(count);
+        },
+        [&values](
+            const StoredBinaryValue * const binaryValue,
+            const PropertyValueType storedValueType,
+            const uint32_t rawWeighting,
+            Exception * const exception) {
+#       	ifdef _MSC_VER
+            UNREFERENCED_PARAMETER(exception);
+#       	endif
+            fiftyoneDegreesIpiCoordinate coordinate;
+            fiftyoneDegreesIpiGetCoordinate(
+                binaryValue,
+                storedValueType,
+                &coordinate);
+            WeightedValue<fiftyoneDegreesIpiCoordinate> weightedCoordinate;
+            weightedCoordinate.setValue(coordinate);
+            weightedCoordinate.setRawWeight(rawWeighting);
+            values.push_back(weightedCoordinate);
+        },
+        [&result, &values] {
+            result.setValue(values);
+        });
+    return result;
+}
+
+Common::Value<vector<WeightedValue<fiftyoneDegreesIpiCoordinate>>>
+IpIntelligence::ResultsIpi::getValuesAsWeightedCoordinateList(
+    const char *propertyName) {
+    return getValuesAsWeightedCoordinateList(
+        ResultsBase::getRequiredPropertyIndex(propertyName));
+}
+
+Common::Value<vector<WeightedValue<fiftyoneDegreesIpiCoordinate>>>
+IpIntelligence::ResultsIpi::getValuesAsWeightedCoordinateList(
+    const string &propertyName) {
+    return getValuesAsWeightedCoordinateList(
+        ResultsBase::getRequiredPropertyIndex(propertyName.c_str()));
+}
+
 bool IpIntelligence::ResultsIpi::hasValuesInternal(
 	int requiredPropertyIndex) {
 	EXCEPTION_CREATE;
+
+	// Only values which were found are added to the values cache.
+	if (valuesCache != nullptr) {
+		const ResultIpi *propertyResult = getPropertyResult(
+			requiredPropertyIndex);
+		if (propertyResult != nullptr && valuesCache->contains(
+			results,
+			requiredPropertyIndex,
+			propertyResult)) {
+			return true;
+		}
+	}
 	bool hasValues = fiftyoneDegreesResultsIpiGetHasValues(
 		results,
 		requiredPropertyIndex,
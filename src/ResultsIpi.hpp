@@ -27,8 +27,12 @@
 #include <vector>
 #include "common-cxx/ResultsBase.hpp"
 #include "WeightedValue.hpp"
+#include "WeightedStringView.hpp"
 #include "common-cxx/IpAddress.hpp"
 #include "ipi.h"
+#include "ipi_weighted_results.h"
+#include "ResultsPoolIpi.hpp"
+#include "ValuesCacheIpi.hpp"
 #include <functional>
 
 
@@ -70,8 +74,11 @@ namespace FiftyoneDegrees {
 		 * delete results;
 		 * ```
 		 */
+		class EngineIpi;
+
 		class ResultsIpi : public ResultsBase {
 			friend class ::EngineIpIntelligenceTests;
+			friend class EngineIpi;
 		public:
 			/**
 			 * @name Constructors and Destructors
@@ -85,6 +92,35 @@ namespace FiftyoneDegrees {
 				fiftyoneDegreesResultsIpi *results,
 				shared_ptr<fiftyoneDegreesResourceManager> manager);
 
+			/**
+			 * Construct results which form part of a batch. The underlying
+			 * results are owned by the batch which is freed when the last
+			 * results referencing it are deleted.
+			 * @param results pointer to the results within the batch
+			 * @param manager to the resource manager for the data set
+			 * @param batch shared pointer to the batch containing the results
+			 */
+			ResultsIpi(
+				fiftyoneDegreesResultsIpi *results,
+				shared_ptr<fiftyoneDegreesResourceManager> manager,
+				shared_ptr<fiftyoneDegreesResultsIpiBatch> batch);
+
+			/**
+			 * Construct results taken from the engine's results pool. The
+			 * underlying results are returned to the pool when the results
+			 * are deleted.
+			 * @param results pointer to the results taken from the pool
+			 * @param manager to the resource manager for the data set
+			 * @param pool shared pointer to the pool the results came from
+			 * @param valuesCache shared pointer to the engine's values cache,
+			 * or nullptr if there is no cache
+			 */
+			ResultsIpi(
+				fiftyoneDegreesResultsIpi *results,
+				shared_ptr<fiftyoneDegreesResourceManager> manager,
+				shared_ptr<ResultsPoolIpi> pool,
+				shared_ptr<ValuesCacheIpi> valuesCache);
+
 			/**
 			 * Release the reference to the underlying results
 			 * and associated data set.
@@ -247,6 +283,39 @@ namespace FiftyoneDegrees {
 			Common::Value<vector<WeightedValue<string>>>
 				getValuesAsWeightedStringList(int requiredPropertyIndex);
 
+			/**
+			 * Get a vector with views of all the values associated with the
+			 * required property index. When the data set is in memory string
+			 * values are not copied and only other values are rendered as
+			 * strings. The views are only valid while these results exist. If the index is not valid an empty vector is
+			 * returned.
+			 * @param requiredPropertyIndex in the required properties
+			 * @return a vector of weighted string views for the property
+			 */
+			Common::Value<vector<WeightedStringView>>
+				getValuesAsWeightedStringViewList(int requiredPropertyIndex);
+
+			/**
+			 * Get a vector with views of all the values associated with the
+			 * required property name. See
+			 * getValuesAsWeightedStringViewList(int).
+			 * @param propertyName pointer to a string containing the property
+			 * name
+			 * @return a vector of weighted string views for the property
+			 */
+			Common::Value<vector<WeightedStringView>>
+				getValuesAsWeightedStringViewList(const char *propertyName);
+
+			/**
+			 * Get a vector with views of all the values associated with the
+			 * required property name. See
+			 * getValuesAsWeightedStringViewList(int).
+			 * @param propertyName string containing the property name
+			 * @return a vector of weighted string views for the property
+			 */
+			Common::Value<vector<WeightedStringView>>
+				getValuesAsWeightedStringViewList(const string &propertyName);
+
 			/**
 			 * Get a vector with all weighted string representations of the
 			 * values associated with the required property name. If the name
@@ -384,6 +453,39 @@ namespace FiftyoneDegrees {
 			Common::Value<vector<WeightedValue<double>>>
 			getValuesAsWeightedDoubleList(int requiredPropertyIndex);
 
+			/**
+			 * Get a vector with all weighted coordinates of the point values
+			 * associated with the required property index. The points are
+			 * decoded directly from the stored values rather than being
+			 * formatted as WKT and parsed. Values which are not points have
+			 * NaN latitude and longitude.
+			 * @param requiredPropertyIndex in the required properties
+			 * @return a vector of weighted coordinates for the property
+			 */
+			Common::Value<vector<WeightedValue<fiftyoneDegreesIpiCoordinate>>>
+			getValuesAsWeightedCoordinateList(int requiredPropertyIndex);
+
+			/**
+			 * Get a vector with all weighted coordinates of the point values
+			 * associated with the required property name. See
+			 * getValuesAsWeightedCoordinateList(int).
+			 * @param propertyName pointer to a string containing the property
+			 * name
+			 * @return a vector of weighted coordinates for the property
+			 */
+			Common::Value<vector<WeightedValue<fiftyoneDegreesIpiCoordinate>>>
+			getValuesAsWeightedCoordinateList(const char *propertyName);
+
+			/**
+			 * Get a vector with all weighted coordinates of the point values
+			 * associated with the required property name. See
+			 * getValuesAsWeightedCoordinateList(int).
+			 * @param propertyName string containing the property name
+			 * @return a vector of weighted coordinates for the property
+			 */
+			Common::Value<vector<WeightedValue<fiftyoneDegreesIpiCoordinate>>>
+			getValuesAsWeightedCoordinateList(const string &propertyName);
+
 			/**
 			 * Get an IpAddress instance representation of the value associated 
 			 * with the required property name. If the property name is not valid
@@ -425,6 +527,61 @@ namespace FiftyoneDegrees {
 			Common::Value<IpIntelligence::IpAddress> getValueAsIpAddress(
 				int requiredPropertyIndex);
 
+			/**
+			 * @}
+			 * @name Range Getters
+			 * @{
+			 */
+
+			/**
+			 * Get the first IP address of the range matched by the IP
+			 * address. This is the range for which the result of every
+			 * component with IpRangeStart and IpRangeEnd properties is the
+			 * same. It is found the first time a range getter is called.
+			 * If the range is not known then hasValue returns false.
+			 * @return the first IP address of the matched range
+			 */
+			Common::Value<IpIntelligence::IpAddress> getRangeStart();
+
+			/**
+			 * Get the last IP address of the range matched by the IP
+			 * address. If the range is not known then hasValue returns false.
+			 * @return the last IP address of the matched range
+			 */
+			Common::Value<IpIntelligence::IpAddress> getRangeEnd();
+
+			/**
+			 * Get the id of the range matched by the IP address. The id is
+			 * a 32 bit hash of the first and last IP addresses of the range
+			 * so is the same for every IP address in the range. The id is
+			 * NOT unique. A data file has millions of ranges so different
+			 * ranges are expected to share an id. Compare getRangeStart and
+			 * getRangeEnd where a range must be identified exactly.
+			 * @return the id of the matched range, or
+			 * #FIFTYONE_DEGREES_IPI_NO_RANGE_ID if the range is not known
+			 */
+			uint32_t getRangeId();
+
+			/**
+			 * Write a JSON object with the values of all the required
+			 * properties to the buffer provided. Each property is an array
+			 * of objects with the value as a string and the weight as a
+			 * number. The JSON is written directly to the buffer without
+			 * creating intermediate strings.
+			 * @param buffer to write the null terminated JSON to
+			 * @param bufferLength number of characters the buffer can hold
+			 * @return the number of characters needed for the JSON. If this
+			 * is not less than bufferLength then the JSON may be truncated
+			 */
+			size_t getValuesAsJson(char *buffer, size_t bufferLength);
+
+			/**
+			 * Get a JSON object with the values of all the required
+			 * properties. See getValuesAsJson(char*, size_t).
+			 * @return the JSON for the results
+			 */
+			string getValuesAsJson();
+
 		protected:
 			void getValuesInternal(
 				int requiredPropertyIndex,
@@ -453,6 +610,17 @@ namespace FiftyoneDegrees {
 				int requiredPropertyIndex,
 				fiftyoneDegreesException *exception);
 
+			/**
+			 * Gets the result for the component of the property which is
+			 * the only result the values of the property depend on.
+			 * @param requiredPropertyIndex index in the required
+			 * properties list
+			 * @return the result, or nullptr if there is no result for the
+			 * component
+			 */
+			const fiftyoneDegreesResultIpi* getPropertyResult(
+				int requiredPropertyIndex);
+
 			/**
 			 * Iterates over available values for the caller to populate results.
 			 * @param requiredPropertyIndex index in the required
@@ -475,7 +643,32 @@ namespace FiftyoneDegrees {
 					fiftyoneDegreesException *exception)>& onEachValue,
 				const std::function<void()>& onAfterValues);
 
+			/**
+			 * Gets the first or last IP address of the matched range.
+			 * @param first true for the first IP address, false for the last
+			 * @return the IP address, or no value if the range is not known
+			 */
+			Common::Value<IpIntelligence::IpAddress> getRangeBound(bool first);
+
 			fiftyoneDegreesResultsIpi *results;
+
+			/**
+			 * Batch which owns the results, or nullptr if the results were
+			 * created individually.
+			 */
+			shared_ptr<fiftyoneDegreesResultsIpiBatch> batch;
+
+			/**
+			 * Pool the results are returned to, or nullptr if the results
+			 * were not taken from a pool.
+			 */
+			shared_ptr<ResultsPoolIpi> pool;
+
+			/**
+			 * Cache of the values of properties, or nullptr if the engine
+			 * does not have a values cache.
+			 */
+			shared_ptr<ValuesCacheIpi> valuesCache;
 		};
 	}
 }
@@ -89,4 +89,9 @@ public:
         const std::string &propertyName);
     Value<IpAddress> getValueAsIpAddress(
         int requiredPropertyIndex);
+
+    Value<IpAddress> getRangeStart();
+    Value<IpAddress> getRangeEnd();
+    uint32_t getRangeId();
+    std::string getValuesAsJson();
 };
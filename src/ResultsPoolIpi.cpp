@@ -0,0 +1,120 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include "ResultsPoolIpi.hpp"
+#include "common-cxx/Exceptions.hpp"
+#include "fiftyone.h"
+
+using namespace FiftyoneDegrees;
+using namespace FiftyoneDegrees::Common;
+using namespace FiftyoneDegrees::IpIntelligence;
+
+ResultsPoolIpi::ResultsPoolIpi(
+	shared_ptr<fiftyoneDegreesResourceManager> manager,
+	uint32_t capacity)
+	: manager(manager),
+	slots(new atomic<fiftyoneDegreesResultsIpi*>[capacity]),
+	capacity(capacity),
+	hits(0),
+	misses(0),
+	inUse(0),
+	highWaterMark(0) {
+	for (uint32_t i = 0; i < capacity; i++) {
+		slots[i].store(nullptr);
+	}
+}
+
+ResultsPoolIpi::~ResultsPoolIpi() {
+	clear();
+}
+
+fiftyoneDegreesResultsIpi* ResultsPoolIpi::get() {
+	fiftyoneDegreesResultsIpi *results;
+	for (uint32_t i = 0; i < capacity; i++) {
+		if (slots[i].load(std::memory_order_relaxed) == nullptr) {
+			continue;
+		}
+		results = slots[i].exchange(nullptr, std::memory_order_acquire);
+		if (results == nullptr) {
+			continue;
+		}
+
+		// Results for a data set which has since been reloaded are freed so
+		// the reference to the old data set is released.
+		if (ResultsIpiGetIsActive(results, manager.get())) {
+			hits++;
+			addInUse();
+			return results;
+		}
+		ResultsIpiFree(results);
+	}
+	results = ResultsIpiCreate(manager.get());
+	if (results == nullptr) {
+		throw StatusCodeException(INSUFFICIENT_MEMORY);
+	}
+	misses++;
+	addInUse();
+	return results;
+}
+
+void ResultsPoolIpi::release(fiftyoneDegreesResultsIpi *results) {
+	inUse--;
+	if (ResultsIpiGetIsActive(results, manager.get())) {
+		ResultsIpiReset(results);
+		for (uint32_t i = 0; i < capacity; i++) {
+			fiftyoneDegreesResultsIpi *expected = nullptr;
+			if (slots[i].compare_exchange_strong(
+				expected,
+				results,
+				std::memory_order_release)) {
+				return;
+			}
+		}
+	}
+	ResultsIpiFree(results);
+}
+
+void ResultsPoolIpi::clear() {
+	for (uint32_t i = 0; i < capacity; i++) {
+		fiftyoneDegreesResultsIpi *results = slots[i].exchange(nullptr);
+		if (results != nullptr) {
+			ResultsIpiFree(results);
+		}
+	}
+}
+
+ResultsPoolIpi::Stats ResultsPoolIpi::getStats() const {
+	Stats stats;
+	stats.hits = hits.load();
+	stats.misses = misses.load();
+	stats.highWaterMark = highWaterMark.load();
+	stats.capacity = capacity;
+	return stats;
+}
+
+void ResultsPoolIpi::addInUse() {
+	const uint32_t current = ++inUse;
+	uint32_t highest = highWaterMark.load(std::memory_order_relaxed);
+	while (current > highest &&
+		highWaterMark.compare_exchange_weak(highest, current) == false) {
+	}
+}
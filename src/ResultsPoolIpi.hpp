@@ -0,0 +1,145 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_RESULTS_POOL_IPI_HPP
+#define FIFTYONE_DEGREES_RESULTS_POOL_IPI_HPP
+
+#include <atomic>
+#include <memory>
+#include "ipi.h"
+
+
+namespace FiftyoneDegrees {
+	namespace IpIntelligence {
+		using std::shared_ptr;
+		using std::unique_ptr;
+		using std::atomic;
+
+		/**
+		 * Pool of #fiftyoneDegreesResultsIpi structures owned by an engine
+		 * so that results, and the memory for their values, are reused
+		 * across requests rather than being allocated and freed for every
+		 * one.
+		 *
+		 * The pool is a fixed number of slots which are taken and returned
+		 * with atomic operations, so no locks are needed. Results taken
+		 * from the pool which no longer reference the active data set are
+		 * freed and replaced with new results for the current data set.
+		 * When the pool is empty new results are created, and when it is
+		 * full returned results are freed.
+		 *
+		 * The pool is shared with the results it creates so that it
+		 * outlives the engine if results are deleted after the engine.
+		 */
+		class ResultsPoolIpi {
+		public:
+			/**
+			 * Counters for the use of the pool.
+			 */
+			struct Stats {
+				/** Number of results taken from the pool */
+				uint64_t hits;
+				/** Number of results created because the pool was empty */
+				uint64_t misses;
+				/** Highest number of results in use at the same time */
+				uint32_t highWaterMark;
+				/** Number of results the pool can hold */
+				uint32_t capacity;
+			};
+
+			/**
+			 * @name Constructors and Destructors
+			 * @{
+			 */
+
+			/**
+			 * Constructs a new empty pool.
+			 * @param manager the resource manager for the data set
+			 * @param capacity number of results the pool can hold
+			 */
+			ResultsPoolIpi(
+				shared_ptr<fiftyoneDegreesResourceManager> manager,
+				uint32_t capacity);
+
+			/**
+			 * Frees all the results held in the pool.
+			 */
+			~ResultsPoolIpi();
+
+			/**
+			 * @}
+			 * @name Pool Methods
+			 * @{
+			 */
+
+			/**
+			 * Takes results for the active data set from the pool, or
+			 * creates new results if the pool is empty.
+			 * @return results ready to process an IP address
+			 */
+			fiftyoneDegreesResultsIpi* get();
+
+			/**
+			 * Returns results taken from the pool. If the results no longer
+			 * reference the active data set, or the pool is full, they are
+			 * freed.
+			 * @param results the results to return
+			 */
+			void release(fiftyoneDegreesResultsIpi *results);
+
+			/**
+			 * Frees all the results held in the pool. Used when the data set
+			 * is reloaded so that the pool does not keep the previous data
+			 * set in memory.
+			 */
+			void clear();
+
+			/**
+			 * Gets the counters for the use of the pool.
+			 * @return the pool counters
+			 */
+			Stats getStats() const;
+
+			/**
+			 * @}
+			 */
+		private:
+			void addInUse();
+
+			shared_ptr<fiftyoneDegreesResourceManager> manager;
+
+			unique_ptr<atomic<fiftyoneDegreesResultsIpi*>[]> slots;
+
+			uint32_t capacity;
+
+			atomic<uint64_t> hits;
+
+			atomic<uint64_t> misses;
+
+			atomic<uint32_t> inUse;
+
+			atomic<uint32_t> highWaterMark;
+		};
+	}
+}
+
+#endif
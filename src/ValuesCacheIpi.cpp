@@ -0,0 +1,137 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include <algorithm>
+#include "ValuesCacheIpi.hpp"
+#include "fiftyone.h"
+
+using namespace FiftyoneDegrees;
+using namespace FiftyoneDegrees::IpIntelligence;
+
+ValuesCacheIpi::ValuesCacheIpi(
+	shared_ptr<fiftyoneDegreesResourceManager> manager,
+	uint32_t capacity,
+	uint32_t concurrency)
+	: manager(manager),
+	entries(new Entry[capacity]),
+	locks(new std::shared_mutex[std::max(std::min(concurrency, capacity), 1u)]),
+	capacity(capacity),
+	locksCount(std::max(std::min(concurrency, capacity), 1u)),
+	hits(0),
+	misses(0) {
+	for (uint32_t i = 0; i < capacity; i++) {
+		entries[i].dataSet = nullptr;
+	}
+}
+
+shared_ptr<const vector<string>> ValuesCacheIpi::get(
+	const fiftyoneDegreesResultsIpi *results,
+	int requiredPropertyIndex,
+	const fiftyoneDegreesResultIpi *result) {
+	const void *dataSet = results->b.dataSet;
+	const uint32_t rawOffset = result->graphResult.rawOffset;
+	const uint32_t slot = getSlot(dataSet, requiredPropertyIndex, rawOffset);
+	{
+		std::shared_lock<std::shared_mutex> lock(getLock(slot));
+		const Entry &entry = entries[slot];
+		if (entry.dataSet == dataSet &&
+			entry.requiredPropertyIndex == requiredPropertyIndex &&
+			entry.rawOffset == rawOffset &&
+			entry.isGroupOffset == result->graphResult.isGroupOffset) {
+			hits++;
+			return entry.values;
+		}
+	}
+	misses++;
+	return nullptr;
+}
+
+bool ValuesCacheIpi::contains(
+	const fiftyoneDegreesResultsIpi *results,
+	int requiredPropertyIndex,
+	const fiftyoneDegreesResultIpi *result) const {
+	const void *dataSet = results->b.dataSet;
+	const uint32_t rawOffset = result->graphResult.rawOffset;
+	const uint32_t slot = getSlot(dataSet, requiredPropertyIndex, rawOffset);
+	std::shared_lock<std::shared_mutex> lock(getLock(slot));
+	const Entry &entry = entries[slot];
+	return entry.dataSet == dataSet &&
+		entry.requiredPropertyIndex == requiredPropertyIndex &&
+		entry.rawOffset == rawOffset &&
+		entry.isGroupOffset == result->graphResult.isGroupOffset;
+}
+
+void ValuesCacheIpi::add(
+	const fiftyoneDegreesResultsIpi *results,
+	int requiredPropertyIndex,
+	const fiftyoneDegreesResultIpi *result,
+	shared_ptr<const vector<string>> values) {
+	const void *dataSet = results->b.dataSet;
+	const uint32_t rawOffset = result->graphResult.rawOffset;
+	const uint32_t slot = getSlot(dataSet, requiredPropertyIndex, rawOffset);
+	std::unique_lock<std::shared_mutex> lock(getLock(slot));
+
+	// The check is made while the lock is held so that values for a data
+	// set which has been replaced can not be added after the cache has been
+	// cleared, where a new data set at the same address could find them.
+	if (ResultsIpiGetIsActive(
+		(fiftyoneDegreesResultsIpi*)results,
+		manager.get()) == false) {
+		return;
+	}
+	Entry &entry = entries[slot];
+	entry.dataSet = dataSet;
+	entry.requiredPropertyIndex = requiredPropertyIndex;
+	entry.rawOffset = rawOffset;
+	entry.isGroupOffset = result->graphResult.isGroupOffset;
+	entry.values = values;
+}
+
+void ValuesCacheIpi::clear() {
+	for (uint32_t i = 0; i < capacity; i++) {
+		std::unique_lock<std::shared_mutex> lock(getLock(i));
+		entries[i].dataSet = nullptr;
+		entries[i].values.reset();
+	}
+}
+
+ValuesCacheIpi::Stats ValuesCacheIpi::getStats() const {
+	Stats stats;
+	stats.hits = hits.load();
+	stats.misses = misses.load();
+	stats.capacity = capacity;
+	return stats;
+}
+
+uint32_t ValuesCacheIpi::getSlot(
+	const void *dataSet,
+	int requiredPropertyIndex,
+	uint32_t rawOffset) const {
+	uint64_t hash = (uint64_t)(uintptr_t)dataSet;
+	hash ^= ((uint64_t)(uint32_t)requiredPropertyIndex << 32) | rawOffset;
+	hash *= 0x9E3779B97F4A7C15ULL;
+	return (uint32_t)((hash >> 32) % capacity);
+}
+
+std::shared_mutex &ValuesCacheIpi::getLock(uint32_t slot) const {
+	return locks[slot % locksCount];
+}
@@ -0,0 +1,195 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_VALUES_CACHE_IPI_HPP
+#define FIFTYONE_DEGREES_VALUES_CACHE_IPI_HPP
+
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "ipi.h"
+
+
+namespace FiftyoneDegrees {
+	namespace IpIntelligence {
+		using std::shared_ptr;
+		using std::unique_ptr;
+		using std::atomic;
+		using std::string;
+		using std::vector;
+
+		/**
+		 * Cache of the values returned for a required property owned by an
+		 * engine. Every IP address which the graph of a component maps to
+		 * the same profile, or profile group, has the same values for the
+		 * properties of that component. The cache holds the values already
+		 * converted to strings keyed on the data set, the required property
+		 * and the graph result for the property's component, so repeat
+		 * visits to popular networks avoid reading the profiles, values and
+		 * strings again.
+		 *
+		 * Each key maps to a single entry which is replaced when a different
+		 * key maps to it, bounding the size of the cache. The entries are
+		 * spread over shards each with a read write lock so that many
+		 * threads can read the cache at the same time.
+		 *
+		 * Values are only added for the active data set, and the cache is
+		 * cleared when the data set is reloaded.
+		 *
+		 * Only the string values returned by the ResultsBase value accessors,
+		 * such as getValuesAsString, are cached. The getValuesAsWeighted*
+		 * accessors of ResultsIpi, the string views and the C API always
+		 * read the values from the data set.
+		 */
+		class ValuesCacheIpi {
+		public:
+			/**
+			 * Counters for the use of the cache.
+			 */
+			struct Stats {
+				/** Number of values returned from the cache */
+				uint64_t hits;
+				/** Number of values not found in the cache */
+				uint64_t misses;
+				/** Number of entries in the cache */
+				uint32_t capacity;
+			};
+
+			/**
+			 * @name Constructors and Destructors
+			 * @{
+			 */
+
+			/**
+			 * Constructs a new empty cache.
+			 * @param manager the resource manager for the data set
+			 * @param capacity number of entries in the cache
+			 * @param concurrency expected number of concurrent requests
+			 * used to set the number of shards
+			 */
+			ValuesCacheIpi(
+				shared_ptr<fiftyoneDegreesResourceManager> manager,
+				uint32_t capacity,
+				uint32_t concurrency);
+
+			/**
+			 * @}
+			 * @name Cache Methods
+			 * @{
+			 */
+
+			/**
+			 * Gets the values for the required property from the cache.
+			 * @param results the results the values are for
+			 * @param requiredPropertyIndex index of the property in the
+			 * required properties
+			 * @param result the result for the component of the property
+			 * @return the values, or nullptr if they are not in the cache
+			 */
+			shared_ptr<const vector<string>> get(
+				const fiftyoneDegreesResultsIpi *results,
+				int requiredPropertyIndex,
+				const fiftyoneDegreesResultIpi *result);
+
+			/**
+			 * Checks if the values for the required property are in the
+			 * cache without changing the counters, so that checking for
+			 * values before getting them does not count the same request
+			 * twice.
+			 * @param results the results the values are for
+			 * @param requiredPropertyIndex index of the property in the
+			 * required properties
+			 * @param result the result for the component of the property
+			 * @return true if the values are in the cache
+			 */
+			bool contains(
+				const fiftyoneDegreesResultsIpi *results,
+				int requiredPropertyIndex,
+				const fiftyoneDegreesResultIpi *result) const;
+
+			/**
+			 * Adds the values for the required property to the cache,
+			 * replacing any entry with a different key. Values for results
+			 * which do not reference the active data set are not added.
+			 * @param results the results the values are for
+			 * @param requiredPropertyIndex index of the property in the
+			 * required properties
+			 * @param result the result for the component of the property
+			 * @param values the values to add
+			 */
+			void add(
+				const fiftyoneDegreesResultsIpi *results,
+				int requiredPropertyIndex,
+				const fiftyoneDegreesResultIpi *result,
+				shared_ptr<const vector<string>> values);
+
+			/**
+			 * Removes all the entries from the cache. Used when the data set
+			 * is reloaded.
+			 */
+			void clear();
+
+			/**
+			 * Gets the counters for the use of the cache.
+			 * @return the cache counters
+			 */
+			Stats getStats() const;
+
+			/**
+			 * @}
+			 */
+		private:
+			struct Entry {
+				const void *dataSet;
+				int requiredPropertyIndex;
+				uint32_t rawOffset;
+				bool isGroupOffset;
+				shared_ptr<const vector<string>> values;
+			};
+
+			uint32_t getSlot(
+				const void *dataSet,
+				int requiredPropertyIndex,
+				uint32_t rawOffset) const;
+
+			std::shared_mutex &getLock(uint32_t slot) const;
+
+			shared_ptr<fiftyoneDegreesResourceManager> manager;
+
+			unique_ptr<Entry[]> entries;
+
+			unique_ptr<std::shared_mutex[]> locks;
+
+			uint32_t capacity;
+
+			uint32_t locksCount;
+
+			atomic<uint64_t> hits;
+
+			atomic<uint64_t> misses;
+		};
+	}
+}
+
+#endif
@@ -0,0 +1,76 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#include <sstream>
+#include "WeightedStringView.hpp"
+#include "fiftyone.h"
+#include "common-cxx/wkbtot_pp.hpp"
+#include "common-cxx/string_pp.hpp"
+#include "common-cxx/Exceptions.hpp"
+
+using namespace FiftyoneDegrees;
+using namespace FiftyoneDegrees::IpIntelligence;
+
+WeightedStringView::WeightedStringView(
+	const fiftyoneDegreesStoredBinaryValue *binaryValue,
+	fiftyoneDegreesPropertyValueType storedValueType,
+	uint32_t rawWeight,
+	bool copy)
+	: binaryValue(binaryValue),
+	storedValueType(storedValueType),
+	rawWeight(rawWeight) {
+	// Values which are not strings are rendered now rather than when first
+	// read so that getValue does not change the instance, and can be called
+	// from several threads at once.
+	if (copy ||
+		storedValueType != FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING) {
+		render();
+	}
+}
+
+std::string_view WeightedStringView::getValue() const {
+	if (binaryValue != nullptr &&
+		storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING) {
+		// Strings are viewed in place, excluding the null terminator.
+		const String *value = (const String*)binaryValue;
+		size_t size = value->size > 0 ? (size_t)value->size : 0;
+		if (size > 0 && (&value->value)[size - 1] == '\0') {
+			size--;
+		}
+		return std::string_view(&value->value, size);
+	}
+	return std::string_view(rendered);
+}
+
+void WeightedStringView::render() {
+	EXCEPTION_CREATE;
+	std::stringstream stream;
+	writeStoredBinaryValueToStringStream(
+		binaryValue,
+		storedValueType,
+		stream,
+		DefaultWktDecimalPlaces,
+		exception);
+	EXCEPTION_THROW;
+	rendered = stream.str();
+	binaryValue = nullptr;
+}
@@ -0,0 +1,117 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_WEIGHTED_STRING_VIEW_HPP
+#define FIFTYONE_DEGREES_WEIGHTED_STRING_VIEW_HPP
+
+#include <string>
+#include <string_view>
+#include "ipi.h"
+
+namespace FiftyoneDegrees {
+	namespace IpIntelligence {
+		/**
+		 * A single value returned for an IP Intelligence property as a
+		 * string view, together with its weight. Where the data set is in
+		 * memory string values point directly to the strings collection
+		 * rather than being copied. Values of other types, or all values
+		 * where the data set is not in memory, are rendered as a string
+		 * when the instance is constructed. An instance is not changed once
+		 * constructed so may be read from several threads at once.
+		 *
+		 * The view returned from getValue is only valid while the results
+		 * the value came from, and this instance, exist.
+		 */
+		class WeightedStringView {
+		public:
+			/**
+			 * @name Constructors
+			 * @{
+			 */
+
+			/**
+			 * Construct an instance for the stored value.
+			 * @param binaryValue pointer to the stored value
+			 * @param storedValueType type the value is stored as
+			 * @param rawWeight of the value (1 ~ 65535^2)
+			 * @param copy true if the stored value will not remain valid
+			 * and must be copied now
+			 */
+			WeightedStringView(
+				const fiftyoneDegreesStoredBinaryValue *binaryValue,
+				fiftyoneDegreesPropertyValueType storedValueType,
+				uint32_t rawWeight,
+				bool copy);
+
+			/**
+			 * @}
+			 * @name Getters
+			 * @{
+			 */
+
+			/**
+			 * Get the value.
+			 * @return view of the value
+			 */
+			[[nodiscard]]
+			std::string_view getValue() const;
+
+			/**
+			 * Get the weight (0.0 ~ 1.0)
+			 * @return the weight
+			 */
+			[[nodiscard]]
+			float getWeight() const {
+				return (float)(
+					rawWeight
+					/ (double)FIFTYONE_DEGREES_WEIGHTED_ITEM_MAX_WEIGHT);
+			};
+
+			/**
+			 * Get the raw weight (1 ~ 65535^2)
+			 * @return the raw weight
+			 */
+			[[nodiscard]]
+			uint32_t getRawWeight() const { return rawWeight; };
+
+			/**
+			 * @}
+			 */
+		private:
+			/**
+			 * Renders the stored value as a string.
+			 */
+			void render();
+
+			/** The stored value, or nullptr once rendered */
+			const fiftyoneDegreesStoredBinaryValue *binaryValue;
+			/** The type the value is stored as */
+			fiftyoneDegreesPropertyValueType storedValueType;
+			/** The weight of the value, (1 ~ 65535^2) */
+			uint32_t rawWeight;
+			/** The value rendered as a string */
+			std::string rendered;
+		};
+	}
+}
+
+#endif
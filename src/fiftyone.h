@@ -26,6 +26,10 @@
 #include "ipi.h"
 #include "constantsIpi.h"
 #include "ipi_weighted_results.h"
+#include "ipi_sorted.h"
+#include "ipi_mapped.h"
+#include "ipi_delta.h"
+#include "ipi_file_reader.h"
 #include "common-cxx/fiftyone.h"
 
 // Data types
@@ -34,6 +38,39 @@ MAP_TYPE(WeightedItemList)
 MAP_TYPE(ResultIpi)
 MAP_TYPE(ResultsIpi)
 MAP_TYPE(ResultIpiArray)
+MAP_TYPE(ResultsIpiBatch)
+MAP_TYPE(ResultsIpiProperties)
+MAP_TYPE(IpiIpv4Table)
+MAP_TYPE(IpiIpKey)
+MAP_TYPE(IpiIpv6Table)
+MAP_TYPE(IpiIpv6PrefixEntry)
+MAP_TYPE(IpiIpv6PrefixIndex)
+MAP_TYPE(IpiIpv6Index)
+MAP_TYPE(IpiRangeCacheEntry)
+MAP_TYPE(IpiRangeCacheShard)
+MAP_TYPE(IpiRangeCache)
+MAP_TYPE(IpiRangeCacheStats)
+MAP_TYPE(IpiInitTimings)
+MAP_TYPE(IpiReloadWarm)
+MAP_TYPE(IpiReloadResult)
+MAP_TYPE(IpiReloadCallback)
+MAP_TYPE(IpiReload)
+MAP_TYPE(IpiRangeProperties)
+MAP_TYPE(IpiRenderFormat)
+MAP_TYPE(IpiRenderProperty)
+MAP_TYPE(IpiRenderProperties)
+MAP_TYPE(IpiValueIndexProfile)
+MAP_TYPE(IpiValueIndex)
+MAP_TYPE(IpiProfileGroupEntry)
+MAP_TYPE(IpiProfileGroupsTable)
+MAP_TYPE(IpiIpAddressNextMethod)
+MAP_TYPE(IpiSortedResultsMethod)
+MAP_TYPE(IpiMappedFile)
+MAP_TYPE(IpiDeltaHeader)
+MAP_TYPE(IpiDeltaOperation)
+MAP_TYPE(IpiDeltaOperationType)
+MAP_TYPE(IpiDeltaStats)
+MAP_TYPE(IpiFileReader)
 MAP_TYPE(ConfigIpi)
 MAP_TYPE(DataSetIpi)
 MAP_TYPE(DataSetIpiHeader)
@@ -47,28 +84,47 @@ MAP_TYPE(WeightedDouble)
 MAP_TYPE(WeightedBool)
 MAP_TYPE(WeightedByte)
 MAP_TYPE(WeightedString)
+MAP_TYPE(IpiCoordinate)
+MAP_TYPE(WeightedCoordinate)
 MAP_TYPE(WeightedValuesCollection)
 
 // Methods
 #define ResultsIpiCreate fiftyoneDegreesResultsIpiCreate /**< Synonym for #fiftyoneDegreesResultsIpiCreate function. */
 #define ResultsIpiFree fiftyoneDegreesResultsIpiFree /**< Synonym for #fiftyoneDegreesResultsIpiFree function. */
+#define ResultsIpiReset fiftyoneDegreesResultsIpiReset /**< Synonym for #fiftyoneDegreesResultsIpiReset function. */
+#define ResultsIpiGetIsActive fiftyoneDegreesResultsIpiGetIsActive /**< Synonym for #fiftyoneDegreesResultsIpiGetIsActive function. */
 #define ResultsIpiFromIpAddress fiftyoneDegreesResultsIpiFromIpAddress /**< Synonym for #fiftyoneDegreesResultsIpiFromIpAddress function. */
 #define ResultsIpiFromIpAddressString fiftyoneDegreesResultsIpiFromIpAddressString /**< Synonym for #fiftyoneDegreesResultsIpiFromIpAddressString function. */
 #define ResultsIpiFromEvidence fiftyoneDegreesResultsIpiFromEvidence /**< Synonym for #fiftyoneDegreesResultsIpiFromEvidence function. */
+#define ResultsIpiBatchCreate fiftyoneDegreesResultsIpiBatchCreate /**< Synonym for #fiftyoneDegreesResultsIpiBatchCreate function. */
+#define ResultsIpiBatchFree fiftyoneDegreesResultsIpiBatchFree /**< Synonym for #fiftyoneDegreesResultsIpiBatchFree function. */
+#define ResultsIpiFromIpAddressBatch fiftyoneDegreesResultsIpiFromIpAddressBatch /**< Synonym for #fiftyoneDegreesResultsIpiFromIpAddressBatch function. */
+#define ResultsIpiGetResultRange fiftyoneDegreesResultsIpiGetResultRange /**< Synonym for #fiftyoneDegreesResultsIpiGetResultRange function. */
+#define ResultsIpiGetRange fiftyoneDegreesResultsIpiGetRange /**< Synonym for #fiftyoneDegreesResultsIpiGetRange function. */
 #define ResultsIpiGetValues fiftyoneDegreesResultsIpiGetValues /**< Synonym for #fiftyoneDegreesResultsIpiGetValues function. */
+#define ResultsIpiGetValuesForProperties fiftyoneDegreesResultsIpiGetValuesForProperties /**< Synonym for #fiftyoneDegreesResultsIpiGetValuesForProperties function. */
+#define ResultsIpiGetPropertiesLists fiftyoneDegreesResultsIpiGetPropertiesLists /**< Synonym for #fiftyoneDegreesResultsIpiGetPropertiesLists function. */
 #define ResultsIpiAddValuesString fiftyoneDegreesResultsIpiAddValuesString /**< Synonym for #fiftyoneDegreesResultsIpiAddValuesString function. */
 #define ResultsIpiGetValuesString fiftyoneDegreesResultsIpiGetValuesString /**< Synonym for #fiftyoneDegreesResultsIpiGetValuesString function. */
 #define ResultsIpiGetValuesStringByRequiredPropertyIndex fiftyoneDegreesResultsIpiGetValuesStringByRequiredPropertyIndex /**< Synonym for #fiftyoneDegreesResultsIpiGetValuesStringByRequiredPropertyIndex function. */
+#define ResultsIpiGetValuesJson fiftyoneDegreesResultsIpiGetValuesJson /**< Synonym for #fiftyoneDegreesResultsIpiGetValuesJson function. */
+#define ResultsIpiRenderAll fiftyoneDegreesResultsIpiRenderAll /**< Synonym for #fiftyoneDegreesResultsIpiRenderAll function. */
+#define ResultsIpiRenderHeader fiftyoneDegreesResultsIpiRenderHeader /**< Synonym for #fiftyoneDegreesResultsIpiRenderHeader function. */
 #define ResultsIpiGetHasValues fiftyoneDegreesResultsIpiGetHasValues /**< Synonym for #fiftyoneDegreesResultsIpiGetHasValues function. */
 #define ResultsIpiGetNoValueReason fiftyoneDegreesResultsIpiGetNoValueReason /**< Synonym for #fiftyoneDegreesResultsIpiGetNoValueReason function. */
+#define ResultsIpiGetValuesWithReason fiftyoneDegreesResultsIpiGetValuesWithReason /**< Synonym for #fiftyoneDegreesResultsIpiGetValuesWithReason function. */
 #define ResultsIpiGetNoValueReasonMessage fiftyoneDegreesResultsIpiGetNoValueReasonMessage /**< Synonym for #fiftyoneDegreesResultsIpiGetNoValueReasonMessage function. */
 #define IpiInitManagerFromFile fiftyoneDegreesIpiInitManagerFromFile /**< Synonym for #fiftyoneDegreesIpiInitManagerFromFile function. */
 #define IpiInitManagerFromMemory fiftyoneDegreesIpiInitManagerFromMemory /**< Synonym for #fiftyoneDegreesIpiInitManagerFromMemory function. */
 #define DataSetIpiGet fiftyoneDegreesDataSetIpiGet /**< Synonym for #fiftyoneDegreesDataSetIpiGet function. */
 #define DataSetIpiRelease fiftyoneDegreesDataSetIpiRelease /**< Synonym for #fiftyoneDegreesDataSetIpiRelease function. */
+#define IpiGetRangeCacheStats fiftyoneDegreesIpiGetRangeCacheStats /**< Synonym for #fiftyoneDegreesIpiGetRangeCacheStats function. */
+#define IpiGetInitTimings fiftyoneDegreesIpiGetInitTimings /**< Synonym for #fiftyoneDegreesIpiGetInitTimings function. */
 #define IpiReloadManagerFromOriginalFile fiftyoneDegreesIpiReloadManagerFromOriginalFile /**< Synonym for #fiftyoneDegreesIpiReloadManagerFromOriginalFile function. */
 #define IpiReloadManagerFromFile fiftyoneDegreesIpiReloadManagerFromFile /**< Synonym for #fiftyoneDegreesIpiReloadManagerFromFile function. */
 #define IpiReloadManagerFromMemory fiftyoneDegreesIpiReloadManagerFromMemory /**< Synonym for #fiftyoneDegreesIpiReloadManagerFromMemory function. */
+#define IpiReloadManagerFromFileAsync fiftyoneDegreesIpiReloadManagerFromFileAsync /**< Synonym for #fiftyoneDegreesIpiReloadManagerFromFileAsync function. */
+#define IpiReloadWait fiftyoneDegreesIpiReloadWait /**< Synonym for #fiftyoneDegreesIpiReloadWait function. */
 #define IpiGetNetworkIdFromResult fiftyoneDegreesIpiGetNetworkIdFromResult /**< Synonym for #fiftyoneDegreesIpiGetNetworkIdFromResult function. */
 #define IpiGetNetworkIdFromResults fiftyoneDegreesIpiGetNetworkIdFromResults /**< Synonym for #fiftyoneDegreesIpiGetNetworkIdFromResults function. */
 #define IpiGetIpAddressAsString fiftyoneDegreesIpiGetIpAddressAsString /**< Synonym for #fiftyoneDegreesIpiGetIpAddressAsString function. */
@@ -76,6 +132,24 @@ MAP_TYPE(WeightedValuesCollection)
 #define IpiIterateProfilesForPropertyAndValue fiftyoneDegreesIpiIterateProfilesForPropertyAndValue /**< Synonym for #fiftyoneDegreesIpiIterateProfilesForPropertyAndValue function. */
 #define ResultsIpiGetValuesCollection fiftyoneDegreesResultsIpiGetValuesCollection /**< Synonym for #fiftyoneDegreesResultsIpiGetValuesCollection function. */
 #define WeightedValuesCollectionRelease fiftyoneDegreesWeightedValuesCollectionRelease /**< Synonym for #fiftyoneDegreesWeightedValuesCollectionRelease function. */
+#define ResultsIpiGetValuesAsWeightedInts fiftyoneDegreesResultsIpiGetValuesAsWeightedInts /**< Synonym for #fiftyoneDegreesResultsIpiGetValuesAsWeightedInts function. */
+#define ResultsIpiGetValuesAsWeightedDoubles fiftyoneDegreesResultsIpiGetValuesAsWeightedDoubles /**< Synonym for #fiftyoneDegreesResultsIpiGetValuesAsWeightedDoubles function. */
+#define ResultsIpiGetValuesAsWeightedCoordinates fiftyoneDegreesResultsIpiGetValuesAsWeightedCoordinates /**< Synonym for #fiftyoneDegreesResultsIpiGetValuesAsWeightedCoordinates function. */
+#define IpiGetCoordinate fiftyoneDegreesIpiGetCoordinate /**< Synonym for #fiftyoneDegreesIpiGetCoordinate function. */
+#define IpiIpKeyFromIpAddress fiftyoneDegreesIpiIpKeyFromIpAddress /**< Synonym for #fiftyoneDegreesIpiIpKeyFromIpAddress function. */
+#define IpiIpKeyCompare fiftyoneDegreesIpiIpKeyCompare /**< Synonym for #fiftyoneDegreesIpiIpKeyCompare function. */
+#define ResultsIpiFromSortedIpAddresses fiftyoneDegreesResultsIpiFromSortedIpAddresses /**< Synonym for #fiftyoneDegreesResultsIpiFromSortedIpAddresses function. */
+#define IpiSortIpAddressFile fiftyoneDegreesIpiSortIpAddressFile /**< Synonym for #fiftyoneDegreesIpiSortIpAddressFile function. */
+#define IpiMappedFileReset fiftyoneDegreesIpiMappedFileReset /**< Synonym for #fiftyoneDegreesIpiMappedFileReset function. */
+#define IpiMappedFileOpen fiftyoneDegreesIpiMappedFileOpen /**< Synonym for #fiftyoneDegreesIpiMappedFileOpen function. */
+#define IpiMappedFileClose fiftyoneDegreesIpiMappedFileClose /**< Synonym for #fiftyoneDegreesIpiMappedFileClose function. */
+#define IpiDeltaCreate fiftyoneDegreesIpiDeltaCreate /**< Synonym for #fiftyoneDegreesIpiDeltaCreate function. */
+#define IpiDeltaApply fiftyoneDegreesIpiDeltaApply /**< Synonym for #fiftyoneDegreesIpiDeltaApply function. */
+#define IpiReloadManagerFromDelta fiftyoneDegreesIpiReloadManagerFromDelta /**< Synonym for #fiftyoneDegreesIpiReloadManagerFromDelta function. */
+#define IpiFileReaderReset fiftyoneDegreesIpiFileReaderReset /**< Synonym for #fiftyoneDegreesIpiFileReaderReset function. */
+#define IpiFileReaderOpen fiftyoneDegreesIpiFileReaderOpen /**< Synonym for #fiftyoneDegreesIpiFileReaderOpen function. */
+#define IpiFileReaderRead fiftyoneDegreesIpiFileReaderRead /**< Synonym for #fiftyoneDegreesIpiFileReaderRead function. */
+#define IpiFileReaderClose fiftyoneDegreesIpiFileReaderClose /**< Synonym for #fiftyoneDegreesIpiFileReaderClose function. */
 
 // Constants
 #define DefaultWktDecimalPlaces fiftyoneDegreesDefaultWktDecimalPlaces /**< Synonym for #fiftyoneDegreesDefaultWktDecimalPlaces config. */
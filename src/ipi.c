@@ -26,6 +26,7 @@
 #include "constantsIpi.h"
 #include "common-cxx/collectionKeyTypes.h"
 #include "ip-graph-cxx/graph.h"
+#include <stddef.h>
 
 MAP_TYPE(Collection)
 
@@ -39,6 +40,8 @@ MAP_TYPE(Collection)
 #define NULL_VALUE_OFFSET UINT32_MAX
 /** Dynamic component */
 #define DYNAMIC_COMPONENT_OFFSET UINT32_MAX
+/** Range id of a result where the range is not known. */
+#define NO_RANGE_ID FIFTYONE_DEGREES_IPI_NO_RANGE_ID
 
 /** Default value and percentage separator */
 #define DEFAULT_VALUE_PERCENTAGE_SEPARATOR ":"
@@ -59,17 +62,6 @@ if (dataSet->t == NULL) { \
 	return INVALID_COLLECTION_CONFIG; \
 }
 
-#define COLLECTION_CREATE_FILE(t,f) \
-dataSet->t = CollectionCreateFromFile( \
-	file, \
-	&dataSet->b.b.filePool, \
-	&dataSet->config.t, \
-	dataSet->header.t, \
-	f); \
-if (dataSet->t == NULL) { \
-	return INVALID_COLLECTION_CONFIG; \
-}
-
 /** 
  * Get min/max values with header guards to prevent redefinition warnings
  * when amalgamated with system headers (e.g., macOS sys/param.h)
@@ -129,6 +121,108 @@ typedef struct offset_percentage_t {
 } offsetPercentage;
 #pragma pack(pop)
 
+/**
+ * Called for each range of IP addresses when walking the ranges in a data
+ * set with the results for each of the components with range properties.
+ */
+typedef bool(*rangeWalkerMethod)(
+	void* state, /* State passed to the walker */
+	const IpAddress* start, /* First IP address of the range */
+	const IpAddress* end, /* Last IP address of the range */
+	const fiftyoneDegreesIpiCgResult* results); /* Result for each component */
+
+/**
+ * Used to walk the ranges of IP addresses in a data set in ascending order.
+ * Only the components with range properties are walked as the extent of the
+ * results of other components can not be found.
+ */
+typedef struct range_walker_t {
+	const fiftyoneDegreesDataSetIpi* dataSet; /* Data set being walked */
+	Property** properties; /* IpRangeEnd property of each component used to
+						   find the end of its ranges */
+	Item* propertyItems; /* Items for the IpRangeEnd properties */
+	int* propertyIndexes; /* Indexes of the IpRangeEnd properties */
+	fiftyoneDegreesResultsIpi* results; /* Results used to read the
+										IpRangeEnd values */
+	byte* componentIds; /* Ids of the components with range properties */
+	uint32_t componentsCount; /* Number of components in componentIds */
+	fiftyoneDegreesIpiCgResult* current; /* Result of each component for
+										 its current range */
+	IpAddress* ends; /* Last IP address of each component's current range */
+} rangeWalker;
+
+/**
+ * State used when building the flattened IPv4 table.
+ */
+typedef struct ipv4_table_builder_t {
+	fiftyoneDegreesIpiIpv4Table* table; /* Table being built */
+	uint32_t capacity; /* Number of ranges the table arrays can hold */
+	StatusCode status; /* Status of the build */
+} ipv4TableBuilder;
+
+/**
+ * State used when building the flattened IPv6 table.
+ */
+typedef struct ipv6_table_builder_t {
+	fiftyoneDegreesIpiIpv6Table* table; /* Table being built */
+	uint32_t capacity; /* Number of ranges the table arrays can hold */
+	StatusCode status; /* Status of the build */
+} ipv6TableBuilder;
+
+/**
+ * Consecutive IP addresses which share the same result for a component when
+ * building the IPv6 prefix index.
+ */
+typedef struct ipv6_index_segment_t {
+	IpAddress start; /* First IP address of the segment */
+	IpAddress end; /* Last IP address of the segment */
+	fiftyoneDegreesIpiCgResult result; /* Result for the component */
+	uint64_t lastPrefix; /* Last prefix added to the component's index */
+	uint32_t capacity; /* Number of entries the component's index can hold */
+} ipv6IndexSegment;
+
+/**
+ * State used when building the IPv6 prefix index.
+ */
+typedef struct ipv6_index_builder_t {
+	fiftyoneDegreesIpiIpv6Index* index; /* Index being built */
+	ipv6IndexSegment* segments; /* Current segment for each component */
+	bool started; /* True once the first range has been added */
+	StatusCode status; /* Status of the build */
+} ipv6IndexBuilder;
+
+/**
+ * A required property whose values are being added to a list when getting
+ * the values for several properties in a single pass of the profiles.
+ */
+typedef struct property_values_t {
+	Item propertyItem; /* Item for the property */
+	Property* property; /* The property, or NULL if not available */
+	int32_t column; /* Column of the value index, or -1 if not indexed */
+	WeightedItemList* list; /* List the values are added to */
+} propertyValues;
+
+/**
+ * State used when getting the values for several properties in a single
+ * pass of the profiles.
+ */
+typedef struct properties_values_t {
+	const DataSetIpi* dataSet; /* Data set the profiles are from */
+	propertyValues* items; /* Properties the values are being added for */
+	uint32_t count; /* Number of properties */
+	bool allIndexed; /* True if every property is in the value index */
+} propertiesValues;
+
+/**
+ * Used to pass the list and weighting to the callback which adds the values
+ * of a profile to the list.
+ */
+typedef struct state_with_list_t {
+	const DataSetIpi* dataSet; /* Data set the values are from */
+	WeightedItemList* list; /* List to add the values to */
+	uint16_t rawWeighting; /* Weighting of the profile */
+} stateWithList;
+
 /**
  * All profile weightings in a groups should add up to exactly this number.
  */
@@ -156,7 +250,17 @@ fiftyoneDegreesConfigIpi fiftyoneDegreesIpiInMemoryConfig = {
 	{0,0,0}, // ProfileGroups
 	{0,0,0}, // PropertyTypes
 	{0,0,0}, // ProfileOffsets
-	{0,0,0}  // Graph
+	{0,0,0}, // Graph
+	false, // IPv4 table
+	0, // IPv6 prefix bits
+	false, // IPv6 table
+	0, // Range cache capacity
+	false, // Value index
+	false, // Profile groups table
+	false, // Map file
+	0, // Map hints
+	0, // Init threads
+	false // Positional read
 };
 #undef FIFTYONE_DEGREES_CONFIG_ALL_IN_MEMORY
 #define FIFTYONE_DEGREES_CONFIG_ALL_IN_MEMORY \
@@ -174,7 +278,17 @@ fiftyoneDegreesConfigIpi fiftyoneDegreesIpiHighPerformanceConfig = {
 	{ true, 0, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, // ProfileGroups
 	{ true, 0, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, // PropertyTypes
 	{ true, 0, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, // ProfileOffsets
-	{ true, 0, FIFTYONE_DEGREES_CACHE_CONCURRENCY }  // Graph
+	{ true, 0, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, // Graph
+	false, // IPv4 table
+	0, // IPv6 prefix bits
+	false, // IPv6 table
+	0, // Range cache capacity
+	false, // Value index
+	false, // Profile groups table
+	false, // Map file
+	0, // Map hints
+	0, // Init threads
+	false // Positional read
 };
 
 fiftyoneDegreesConfigIpi fiftyoneDegreesIpiLowMemoryConfig = {
@@ -189,7 +303,17 @@ fiftyoneDegreesConfigIpi fiftyoneDegreesIpiLowMemoryConfig = {
 	{ false, 0, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, // ProfileGroups
 	{ false, 0, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, // PropertyTypes
 	{ false, 0, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, // ProfileOffsets
-	{ false, 0, FIFTYONE_DEGREES_CACHE_CONCURRENCY }  // Graph
+	{ false, 0, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, // Graph
+	false, // IPv4 table
+	0, // IPv6 prefix bits
+	false, // IPv6 table
+	0, // Range cache capacity
+	false, // Value index
+	false, // Profile groups table
+	false, // Map file
+	0, // Map hints
+	0, // Init threads
+	false // Positional read
 };
 
 #define FIFTYONE_DEGREES_IPI_CONFIG_BALANCED \
@@ -204,7 +328,17 @@ fiftyoneDegreesConfigIpi fiftyoneDegreesIpiLowMemoryConfig = {
 { FIFTYONE_DEGREES_PROFILE_GROUPS_LOADED, FIFTYONE_DEGREES_PROFILE_GROUPS_CACHE_SIZE, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, /* ProfileGroups */ \
 { FIFTYONE_DEGREES_PROPERTY_LOADED, FIFTYONE_DEGREES_PROPERTY_CACHE_SIZE, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, /* Property Types */ \
 { FIFTYONE_DEGREES_PROFILE_LOADED, FIFTYONE_DEGREES_PROFILE_CACHE_SIZE, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, /* ProfileOffsets */ \
-{ FIFTYONE_DEGREES_IP_GRAPH_LOADED, FIFTYONE_DEGREES_IP_GRAPH_CACHE_SIZE, FIFTYONE_DEGREES_CACHE_CONCURRENCY } /* Graph */
+{ FIFTYONE_DEGREES_IP_GRAPH_LOADED, FIFTYONE_DEGREES_IP_GRAPH_CACHE_SIZE, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, /* Graph */ \
+false, /* IPv4 table */ \
+0, /* IPv6 prefix bits */ \
+false, /* IPv6 table */ \
+0, /* Range cache capacity */ \
+false, /* Value index */ \
+false, /* Profile groups table */ \
+false, /* Map file */ \
+0, /* Map hints */ \
+0, /* Init threads */ \
+false /* Positional read */
 
 fiftyoneDegreesConfigIpi fiftyoneDegreesIpiBalancedConfig = {
 	FIFTYONE_DEGREES_IPI_CONFIG_BALANCED
@@ -241,7 +375,17 @@ fiftyoneDegreesConfigIpi fiftyoneDegreesIpiBalancedTempConfig = {
 	{ FIFTYONE_DEGREES_PROFILE_GROUPS_LOADED, FIFTYONE_DEGREES_PROFILE_GROUPS_CACHE_SIZE, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, /* ProfileGroups */
 	{ FIFTYONE_DEGREES_PROPERTY_LOADED, FIFTYONE_DEGREES_PROPERTY_CACHE_SIZE, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, /* Property Types */
 	{ FIFTYONE_DEGREES_PROFILE_LOADED, FIFTYONE_DEGREES_PROFILE_CACHE_SIZE, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, /* ProfileOffsets */
-	{ FIFTYONE_DEGREES_IP_GRAPH_LOADED, FIFTYONE_DEGREES_IP_GRAPH_CACHE_SIZE, FIFTYONE_DEGREES_CACHE_CONCURRENCY } /* Graph */
+	{ FIFTYONE_DEGREES_IP_GRAPH_LOADED, FIFTYONE_DEGREES_IP_GRAPH_CACHE_SIZE, FIFTYONE_DEGREES_CACHE_CONCURRENCY }, /* Graph */
+	false, /* IPv4 table */
+	0, /* IPv6 prefix bits */
+	false, /* IPv6 table */
+	0, /* Range cache capacity */
+	false, /* Value index */
+	false, /* Profile groups table */
+	false, /* Map file */
+	0, /* Map hints */
+	0, /* Init threads */
+	false /* Positional read */
 };
 #undef FIFTYONE_DEGREES_CONFIG_USE_TEMP_FILE
 #define FIFTYONE_DEGREES_CONFIG_USE_TEMP_FILE \
@@ -254,17 +398,72 @@ FIFTYONE_DEGREES_CONFIG_USE_TEMP_FILE_DEFAULT
 static void resultIpiReset(ResultIpi* result) {
 	memset(result->targetIpAddress.value, 0, FIFTYONE_DEGREES_IPV6_LENGTH);
 	result->targetIpAddress.type = IP_TYPE_INVALID;
+	result->rangeStart.type = IP_TYPE_INVALID;
+	result->rangeEnd.type = IP_TYPE_INVALID;
+	result->rangeId = NO_RANGE_ID;
+	result->rangeResolved = false;
+}
+
+static uint32_t getIpv4AsInteger(const byte* value) {
+	return ((uint32_t)value[0] << 24) |
+		((uint32_t)value[1] << 16) |
+		((uint32_t)value[2] << 8) |
+		(uint32_t)value[3];
+}
+
+static uint64_t getIpv6Upper(const byte* value) {
+	uint64_t upper = 0;
+	for (int i = 0; i < 8; i++) {
+		upper = (upper << 8) | value[i];
+	}
+	return upper;
+}
+
+static uint64_t getIpv6Lower(const byte* value) {
+	return getIpv6Upper(value + 8);
+}
+
+/**
+ * Returns the key for the IP address bytes. IPv4 addresses are held in the
+ * lower 32 bits so keys compare in the same order as the bytes.
+ */
+static IpiIpKey getIpKey(const byte* value, int length) {
+	IpiIpKey key;
+	if (length == IPV4_LENGTH) {
+		key.upper = 0;
+		key.lower = getIpv4AsInteger(value);
+	}
+	else {
+		key.upper = getIpv6Upper(value);
+		key.lower = getIpv6Lower(value);
+	}
+	return key;
+}
+
+static int compareIpKeys(const IpiIpKey* key1, const IpiIpKey* key2) {
+	if (key1->upper != key2->upper) {
+		return key1->upper < key2->upper ? -1 : 1;
+	}
+	return (key1->lower > key2->lower) - (key1->lower < key2->lower);
 }
 
+/**
+ * Compares the IP addresses as integers rather than byte by byte. Returns a
+ * negative value if the first is lower, positive if higher, and 0 if they
+ * are the same.
+ */
 static int compareIpAddresses(
 	const byte* address1,
 	const byte* address2,
 	int length) {
-	for (int i = 0; i < length; i++) {
-		const int difference = (int)address1[i] - (int)address2[i];
-		if (difference != 0) return difference;
+	if (length == IPV4_LENGTH) {
+		const uint32_t value1 = getIpv4AsInteger(address1);
+		const uint32_t value2 = getIpv4AsInteger(address2);
+		return (value1 > value2) - (value1 < value2);
 	}
-	return 0;
+	const IpiIpKey key1 = getIpKey(address1, length);
+	const IpiIpKey key2 = getIpKey(address2, length);
+	return compareIpKeys(&key1, &key2);
 }
 
 static CollectionKeyType CollectionKeyType_Ipv4Range = {
@@ -284,9 +483,10 @@ static int compareToIpv4Range(
 	long curIndex,
 	Exception* exception) {
 	int result = 0;
-	const fiftyoneDegreesIpAddress target = *((const fiftyoneDegreesIpAddress *)state);
+	const fiftyoneDegreesIpAddress* const target =
+		(const fiftyoneDegreesIpAddress*)state;
 	// We will terminate if IP address is within the range between the current item and the next item
-	const int tempResult = compareIpAddresses(((Ipv4Range*)item->data.ptr)->start, target.value, FIFTYONE_DEGREES_IPV4_LENGTH);
+	const int tempResult = compareIpAddresses(((Ipv4Range*)item->data.ptr)->start, target->value, FIFTYONE_DEGREES_IPV4_LENGTH);
 	if (tempResult < 0) {
 		Item nextItem;
 		DataReset(&nextItem.data);
@@ -302,7 +502,7 @@ static int compareToIpv4Range(
 				exception) != NULL && EXCEPTION_OKAY) {
 				if (compareIpAddresses(
 					((Ipv4Range*)nextItem.data.ptr)->start,
-					target.value,
+					target->value,
 					FIFTYONE_DEGREES_IPV4_LENGTH) <= 0) {
 					result = -1;
 				}
@@ -325,9 +525,10 @@ static int compareToIpv6Range(
 	long curIndex,
 	Exception* exception) {
 	int result = 0;
-	const fiftyoneDegreesIpAddress target = *((fiftyoneDegreesIpAddress*)state);
+	const fiftyoneDegreesIpAddress* const target =
+		(const fiftyoneDegreesIpAddress*)state;
 	// We will terminate if IP address is within the range between the current item and the next item
-	const int tempResult = compareIpAddresses(((Ipv6Range*)item->data.ptr)->start, target.value, FIFTYONE_DEGREES_IPV6_LENGTH);
+	const int tempResult = compareIpAddresses(((Ipv6Range*)item->data.ptr)->start, target->value, FIFTYONE_DEGREES_IPV6_LENGTH);
 	if (tempResult < 0) {
 		Item nextItem;
 		DataReset(&nextItem.data);
@@ -342,7 +543,7 @@ static int compareToIpv6Range(
 				&nextItem,
 				exception) != NULL && EXCEPTION_OKAY) {
 
-				if (compareIpAddresses(((Ipv6Range*)nextItem.data.ptr)->start, target.value, FIFTYONE_DEGREES_IPV6_LENGTH) <= 0) {
+				if (compareIpAddresses(((Ipv6Range*)nextItem.data.ptr)->start, target->value, FIFTYONE_DEGREES_IPV6_LENGTH) <= 0) {
 					// The IP address is not within the range
 					result = -1;
 				}
@@ -359,11 +560,185 @@ static int compareToIpv6Range(
 	return result;
 }
 
+/**
+ * Returns the leading bits of the IPv6 address. The number of bits must be
+ * between 1 and 64.
+ */
+static uint64_t getIpv6Prefix(const byte* value, byte prefixBits) {
+	const uint64_t upper = getIpv6Upper(value);
+	return prefixBits == 64 ? upper : upper >> (64 - prefixBits);
+}
+
+/**
+ * Returns the index of the range in the IPv4 table which contains the IPv4
+ * address. The directory entry for the upper 16 bits of the address and the
+ * one following it bound the binary search to the ranges starting within the
+ * prefix.
+ */
+static uint32_t ipv4TableFind(
+	const IpiIpv4Table* const table,
+	const uint32_t address) {
+	const uint32_t prefix = address >> 16;
+	uint32_t lower = table->directory[prefix];
+	uint32_t upper = table->directory[prefix + 1];
+	while (lower < upper) {
+		const uint32_t middle = lower + (upper - lower + 1) / 2;
+		if (table->starts[middle] <= address) {
+			lower = middle;
+		}
+		else {
+			upper = middle - 1;
+		}
+	}
+	return lower;
+}
+
+/**
+ * Sets the result from the IPv4 table if one is available for the data set
+ * and the component. Returns true if the table was used, otherwise false to
+ * indicate the graph must be evaluated.
+ */
+static bool setResultFromIpv4Table(
+	ResultIpi* const result,
+	const IpiIpv4Table* const table,
+	byte componentId) {
+	uint32_t slot;
+	for (slot = 0; slot < table->componentsCount; slot++) {
+		if (table->componentIds[slot] == componentId) {
+			break;
+		}
+	}
+	if (slot == table->componentsCount) {
+		return false;
+	}
+	const uint32_t index = ipv4TableFind(
+		table,
+		getIpv4AsInteger(result->targetIpAddress.value));
+	const fiftyoneDegreesIpiCgResult* const graphResult =
+		&table->results[(size_t)index * table->componentsCount + slot];
+	if (graphResult->rawOffset != NULL_PROFILE_OFFSET) {
+		result->graphResult = *graphResult;
+	}
+	return true;
+}
+
+/**
+ * Returns the index of the range in the IPv6 table which contains the IPv6
+ * address. Works in the same way as ipv4TableFind.
+ */
+static uint32_t ipv6TableFind(
+	const IpiIpv6Table* const table,
+	const byte* value) {
+	const IpiIpKey key = getIpKey(value, IPV6_LENGTH);
+	const uint32_t prefix = (uint32_t)(key.upper >> 48);
+	uint32_t first = table->directory[prefix];
+	uint32_t last = table->directory[prefix + 1];
+	while (first < last) {
+		const uint32_t middle = first + (last - first + 1) / 2;
+		if (compareIpKeys(&table->starts[middle], &key) <= 0) {
+			first = middle;
+		}
+		else {
+			last = middle - 1;
+		}
+	}
+	return first;
+}
+
+/**
+ * Sets the result from the IPv6 table if one is available for the data set
+ * and the component. Returns true if the table was used, otherwise false to
+ * indicate the graph must be evaluated.
+ */
+static bool setResultFromIpv6Table(
+	ResultIpi* const result,
+	const IpiIpv6Table* const table,
+	byte componentId) {
+	uint32_t slot;
+	for (slot = 0; slot < table->componentsCount; slot++) {
+		if (table->componentIds[slot] == componentId) {
+			break;
+		}
+	}
+	if (slot == table->componentsCount) {
+		return false;
+	}
+	const uint32_t index = ipv6TableFind(
+		table,
+		result->targetIpAddress.value);
+	const fiftyoneDegreesIpiCgResult* const graphResult =
+		&table->results[(size_t)index * table->componentsCount + slot];
+	if (graphResult->rawOffset != NULL_PROFILE_OFFSET) {
+		result->graphResult = *graphResult;
+	}
+	return true;
+}
+
+/**
+ * Sets the result from the IPv6 prefix index if one is available for the
+ * component and every address within the prefix of the IPv6 address has the
+ * same result. Returns true if the index was used, otherwise false to
+ * indicate the graph must be evaluated.
+ */
+static bool setResultFromIpv6Index(
+	ResultIpi* const result,
+	const IpiIpv6Index* const index,
+	byte componentId) {
+	const IpiIpv6PrefixIndex* component = NULL;
+	for (uint32_t c = 0; c < index->componentsCount; c++) {
+		if (index->components[c].componentId == componentId) {
+			component = &index->components[c];
+			break;
+		}
+	}
+	if (component == NULL) {
+		return false;
+	}
+
+	// Find the last entry which starts at or before the prefix.
+	const uint64_t prefix = getIpv6Prefix(
+		result->targetIpAddress.value,
+		index->prefixBits);
+	uint32_t lower = 0, upper = component->count - 1;
+	while (lower < upper) {
+		const uint32_t middle = lower + (upper - lower + 1) / 2;
+		if (component->entries[middle].start <= prefix) {
+			lower = middle;
+		}
+		else {
+			upper = middle - 1;
+		}
+	}
+	const IpiIpv6PrefixEntry* const entry = &component->entries[lower];
+	if (entry->uniform == false) {
+		return false;
+	}
+	if (entry->result.rawOffset != NULL_PROFILE_OFFSET) {
+		result->graphResult = entry->result;
+	}
+	return true;
+}
+
 static void setResultFromIpAddress(
 	ResultIpi* const result,
 	const DataSetIpi* const dataSet,
 	byte componentId,
 	Exception* const exception) {
+	if (dataSet->ipv4Table != NULL &&
+		result->targetIpAddress.type == IP_TYPE_IPV4 &&
+		setResultFromIpv4Table(result, dataSet->ipv4Table, componentId)) {
+		return;
+	}
+	if (dataSet->ipv6Table != NULL &&
+		result->targetIpAddress.type == IP_TYPE_IPV6 &&
+		setResultFromIpv6Table(result, dataSet->ipv6Table, componentId)) {
+		return;
+	}
+	if (dataSet->ipv6Index != NULL &&
+		result->targetIpAddress.type == IP_TYPE_IPV6 &&
+		setResultFromIpv6Index(result, dataSet->ipv6Index, componentId)) {
+		return;
+	}
 	const fiftyoneDegreesIpiCgResult graphResult = fiftyoneDegreesIpiGraphEvaluate(
 		dataSet->graphsArray,
 		componentId,
@@ -393,11 +768,85 @@ static void resetDataSet(DataSetIpi* dataSet) {
 	dataSet->strings = NULL;
 	dataSet->values = NULL;
 	dataSet->graphsArray = NULL;
+	dataSet->ipv4Table = NULL;
+	dataSet->ipv6Index = NULL;
+	dataSet->ipv6Table = NULL;
+	dataSet->rangeCache = NULL;
+	dataSet->valueIndex = NULL;
+	dataSet->profileGroupsTable = NULL;
+	dataSet->renderProperties = NULL;
+	IpiMappedFileReset(&dataSet->mapped);
+	IpiFileReaderReset(&dataSet->fileReader);
+	memset(&dataSet->timings, 0, sizeof(IpiInitTimings));
+	dataSet->memory = NULL;
+	dataSet->memoryLength = 0;
+	dataSet->ranges = NULL;
+	dataSet->rangesAvailableCount = 0;
+}
+
+static void freeIpv4Table(IpiIpv4Table* table) {
+	Free(table->directory);
+	Free(table->starts);
+	Free(table->results);
+	Free(table);
+}
+
+static void freeIpv6Table(IpiIpv6Table* table) {
+	Free(table->directory);
+	Free(table->starts);
+	Free(table->results);
+	Free(table);
+}
+
+// Defined with the methods used to build the index.
+static void freeIpv6Index(IpiIpv6Index* index);
+
+static void freeRangeCache(IpiRangeCache* cache) {
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+	for (uint32_t i = 0; i < cache->shardsCount; i++) {
+		FIFTYONE_DEGREES_MUTEX_CLOSE(cache->shards[i].lock);
+	}
+#endif
+	Free(cache);
+}
+
+static void freeValueIndex(IpiValueIndex* index) {
+	if (index->columns != NULL) {
+		Free(index->columns);
+	}
+	if (index->profiles != NULL) {
+		Free(index->profiles);
+	}
+	if (index->starts != NULL) {
+		Free(index->starts);
+	}
+	if (index->valueIndexes != NULL) {
+		Free(index->valueIndexes);
+	}
+	Free(index);
+}
+
+static void freeProfileGroupsTable(IpiProfileGroupsTable* table) {
+	Free(table->entries);
+	Free(table);
+}
+
+static void freeRenderProperties(IpiRenderProperties* properties) {
+	Free(properties->names);
+	Free(properties->items);
+	Free(properties);
 }
 
 static void freeDataSet(void* dataSetPtr) {
 	DataSetIpi* dataSet = (DataSetIpi*)dataSetPtr;
 
+	// Remove the mapping of the data file, and close the positional reader,
+	// before the common fields are freed so that a temporary file is no
+	// longer open when it is deleted. Nothing after this point reads from the
+	// data.
+	IpiMappedFileClose(&dataSet->mapped);
+	IpiFileReaderClose(&dataSet->fileReader);
+
 	// Free the common data set fields.
 	DataSetFree(&dataSet->b.b);
 
@@ -406,6 +855,46 @@ static void freeDataSet(void* dataSetPtr) {
 		fiftyoneDegreesIpiGraphFree(dataSet->graphsArray);
 	}
 
+	// Free the flattened IPv4 table if one was built.
+	if (dataSet->ipv4Table) {
+		freeIpv4Table(dataSet->ipv4Table);
+	}
+
+	// Free the flattened IPv6 table if one was built.
+	if (dataSet->ipv6Table) {
+		freeIpv6Table(dataSet->ipv6Table);
+	}
+
+	// Free the IPv6 prefix index if one was built.
+	if (dataSet->ipv6Index) {
+		freeIpv6Index(dataSet->ipv6Index);
+	}
+
+	// Free the range cache if one was created.
+	if (dataSet->rangeCache) {
+		freeRangeCache(dataSet->rangeCache);
+	}
+
+	// Free the value index if one was built.
+	if (dataSet->valueIndex) {
+		freeValueIndex(dataSet->valueIndex);
+	}
+
+	// Free the resolved profile groups if they were built.
+	if (dataSet->profileGroupsTable) {
+		freeProfileGroupsTable(dataSet->profileGroupsTable);
+	}
+
+	// Free the properties prepared for rendering.
+	if (dataSet->renderProperties) {
+		freeRenderProperties(dataSet->renderProperties);
+	}
+
+	// Free the range properties of the components.
+	if (dataSet->ranges) {
+		Free(dataSet->ranges);
+	}
+
 	// Free the memory used for the lists and collections.
 	ListFree(&dataSet->componentsList);
 	Free(dataSet->componentsAvailable);
@@ -531,44 +1020,6 @@ static StatusCode initComponentsAvailable(
 	return SUCCESS;
 }
 
-static int findPropertyIndexByName(
-	Collection *properties,
-	Collection *strings,
-	char *name,
-	Exception *exception) {
-	int index;
-	bool found = false;
-	Property *property;
-	const String *propertyName;
-	Item propertyItem, nameItem;
-	const int count = CollectionGetCount(properties);
-	DataReset(&propertyItem.data);
-	DataReset(&nameItem.data);
-	for (index = 0; index < count && found == false; index++) {
-		property = PropertyGet(
-			properties,
-			index,
-			&propertyItem,
-			exception);
-		if (property != NULL &&
-			EXCEPTION_OKAY) {
-			propertyName = PropertyGetName(
-				strings,
-				property,
-				&nameItem,
-				exception);
-			if (propertyName != NULL && EXCEPTION_OKAY) {
-				if (StringCompare(name, &propertyName->value) == 0) {
-					found = true;
-				}
-				COLLECTION_RELEASE(strings, &nameItem);
-			}
-			COLLECTION_RELEASE(properties, &propertyItem);
-		}
-	}
-	return found ? index : -1;
-}
-
 static void initGetEvidencePropertyRelated(
 	DataSetIpi* const dataSet,
 	PropertyAvailable* const availableProperty,
@@ -730,6 +1181,204 @@ static void initDataSetPost(
 		sizeof(bool) * dataSet->componentsList.count);
 }
 
+/**
+ * Returns the time in milliseconds from a monotonic clock used to time the
+ * stages of initialising the data set.
+ */
+static double initTimerNow() {
+#ifdef _MSC_VER
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (double)counter.QuadPart * 1000.0 / (double)frequency.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1.0e6;
+#endif
+}
+
+/**
+ * Maximum number of tasks in a stage of initialising the data set. There is
+ * a task for each collection when they are created from file.
+ */
+#define INIT_TASKS_MAX 10
+
+/**
+ * Part of a stage of initialising the data set which does not depend on the
+ * other parts of the same stage and so can run on any thread. Each task has
+ * its own exception so that a failure can be reported once all the tasks
+ * have completed.
+ */
+typedef struct init_task_t {
+	DataSetIpi* dataSet; /* Data set being initialised */
+	/* Runs the task setting the exception if it fails */
+	StatusCode(*run)(struct init_task_t* task, Exception* exception);
+	const void* state; /* State used by the run method */
+	StatusCode status; /* Status returned by the run method */
+	Exception exception; /* Exception set by the run method */
+} initTask;
+
+/**
+ * Tasks shared by the threads running a stage.
+ */
+typedef struct init_tasks_t {
+	initTask* items; /* Tasks of the stage */
+	uint32_t count; /* Number of tasks */
+	uint32_t next; /* Index of the next task to be run */
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+	FIFTYONE_DEGREES_MUTEX lock; /* Lock used to take the next task */
+#endif
+} initTasks;
+
+/**
+ * Method which initialises part of the data set.
+ */
+typedef StatusCode(*initMethod)(DataSetIpi* dataSet, Exception* exception);
+
+/**
+ * Step of a task and the timing to set to the time taken.
+ */
+typedef struct init_step_t {
+	initMethod init; /* Initialises part of the data set */
+	double* elapsed; /* Timing to set */
+} initStep;
+
+/**
+ * Runs the steps in the task state in order until one fails. The last step
+ * has a NULL init method.
+ */
+static StatusCode initStepsRun(initTask* task, Exception* exception) {
+	StatusCode status = SUCCESS;
+	const initStep* step = (const initStep*)task->state;
+	for (;
+		step->init != NULL && status == SUCCESS && EXCEPTION_OKAY;
+		step++) {
+		const double start = initTimerNow();
+		status = step->init(task->dataSet, exception);
+		*step->elapsed = initTimerNow() - start;
+	}
+	return status;
+}
+
+static void initTaskRun(initTask* task) {
+	Exception* exception = &task->exception;
+	EXCEPTION_CLEAR;
+	task->status = task->run(task, exception);
+}
+
+static bool initTaskFailed(initTask* task) {
+	Exception* exception = &task->exception;
+	return task->status != SUCCESS || EXCEPTION_FAILED;
+}
+
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+
+static void initTasksRunShared(initTasks* tasks) {
+	initTask* task;
+	do {
+		FIFTYONE_DEGREES_MUTEX_LOCK(&tasks->lock);
+		task = tasks->next < tasks->count ?
+			&tasks->items[tasks->next++] :
+			NULL;
+		FIFTYONE_DEGREES_MUTEX_UNLOCK(&tasks->lock);
+		if (task != NULL) {
+			initTaskRun(task);
+		}
+	} while (task != NULL);
+}
+
+static void initTasksThread(void* state) {
+	initTasksRunShared((initTasks*)state);
+	FIFTYONE_DEGREES_THREAD_EXIT;
+}
+
+/**
+ * Starts a thread running the routine with the state.
+ * @return true if the thread was started, otherwise false and the thread
+ * must not be joined or closed
+ */
+static bool threadCreate(
+	FIFTYONE_DEGREES_THREAD* thread,
+	FIFTYONE_DEGREES_THREAD_ROUTINE routine,
+	void* state) {
+#ifdef _MSC_VER
+	FIFTYONE_DEGREES_THREAD_CREATE(*thread, routine, state);
+	return *thread != NULL;
+#else
+	return FIFTYONE_DEGREES_THREAD_CREATE(*thread, routine, state) == 0;
+#endif
+}
+
+#endif
+
+/**
+ * Runs the tasks of a stage and waits for them to complete. Where the
+ * configuration has more than one init thread the tasks are shared between
+ * the calling thread and up to initThreads - 1 new threads. If a thread can
+ * not be started the tasks are shared by the threads which were, as the
+ * calling thread alone will run every task if it has to. Otherwise they
+ * are run in order on the calling thread stopping at the first failure. In
+ * both cases the status and exception returned are those of the first task
+ * in the array which failed, so the same error is reported whatever order
+ * the tasks completed in.
+ */
+static StatusCode initTasksRun(
+	DataSetIpi* dataSet,
+	initTask* items,
+	uint32_t count,
+	Exception* exception) {
+	uint32_t i;
+	bool parallel = false;
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+	FIFTYONE_DEGREES_THREAD threads[INIT_TASKS_MAX];
+	uint32_t threadsCount = dataSet->config.initThreads;
+	assert(count <= INIT_TASKS_MAX);
+	if (threadsCount > count) {
+		threadsCount = count;
+	}
+	if (threadsCount > 1 && ThreadingGetIsThreadSafe()) {
+		initTasks tasks;
+		tasks.items = items;
+		tasks.count = count;
+		tasks.next = 0;
+		FIFTYONE_DEGREES_MUTEX_CREATE(tasks.lock);
+		for (i = 1; i < threadsCount; i++) {
+			if (threadCreate(
+				&threads[i],
+				(FIFTYONE_DEGREES_THREAD_ROUTINE)&initTasksThread,
+				&tasks) == false) {
+				threadsCount = i;
+				break;
+			}
+		}
+		initTasksRunShared(&tasks);
+		for (i = 1; i < threadsCount; i++) {
+			FIFTYONE_DEGREES_THREAD_JOIN(threads[i]);
+			FIFTYONE_DEGREES_THREAD_CLOSE(threads[i]);
+		}
+		FIFTYONE_DEGREES_MUTEX_CLOSE(tasks.lock);
+		parallel = true;
+	}
+#else
+#ifdef _MSC_VER
+	UNREFERENCED_PARAMETER(dataSet);
+#endif
+#endif
+	for (i = 0; i < count; i++) {
+		if (parallel == false) {
+			initTaskRun(&items[i]);
+		}
+		if (initTaskFailed(&items[i])) {
+			if (exception != NULL) {
+				*exception = items[i].exception;
+			}
+			return items[i].status;
+		}
+	}
+	return SUCCESS;
+}
+
 static StatusCode initWithMemory(
 	DataSetIpi* dataSet,
 	MemoryReader* reader,
@@ -758,7 +1407,9 @@ static StatusCode initWithMemory(
 		return status;
 	}
 
-	// Create each of the collections.
+	// Create each of the collections. These only point into the memory so
+	// are not worth creating in parallel.
+	double start = initTimerNow();
 	const uint32_t stringsCount = dataSet->header.strings.count;
 	*(uint32_t*)(&dataSet->header.strings.count) = 0;
 	COLLECTION_CREATE_MEMORY(strings)
@@ -784,11 +1435,14 @@ static StatusCode initWithMemory(
 	COLLECTION_CREATE_MEMORY(profileGroups);
 	COLLECTION_CREATE_MEMORY(propertyTypes);
 	COLLECTION_CREATE_MEMORY(profileOffsets);
+	dataSet->timings.collections = initTimerNow() - start;
 
+	start = initTimerNow();
 	dataSet->graphsArray = fiftyoneDegreesIpiGraphCreateFromMemory(
 		dataSet->graphs,
 		reader,
 		exception);
+	dataSet->timings.graphs = initTimerNow() - start;
 
 	/* Check that the current pointer equals the last byte */
 	if (reader->lastByte != reader->current) {
@@ -804,12 +1458,42 @@ static StatusCode initInMemory(
 	DataSetIpi* dataSet,
 	Exception* exception) {
 	MemoryReader reader;
+	StatusCode status;
 
-	// Read the data from the source file into memory using the reader to 
-	// store the pointer to the first and last bytes.
-	StatusCode status = DataSetInitInMemory(
-		&dataSet->b.b,
-		&reader);
+	if (dataSet->config.mapFile == true) {
+		// A mapping of the data file itself would see any change made to
+		// the file while it is in use, and could fault if the file were
+		// truncated, so only a temporary copy which is private to the data
+		// set can be mapped.
+		if (dataSet->config.b.useTempFile == false) {
+			status = INVALID_CONFIG;
+		}
+		else {
+			// Map the temporary copy read only so that the collections point
+			// directly into its pages rather than into memory read from it.
+			// The file name of the data set is the temporary copy.
+			status = IpiMappedFileOpen(
+				dataSet->b.b.fileName,
+				dataSet->config.mapHints,
+				&dataSet->mapped);
+		}
+		if (status == SUCCESS) {
+			reader.startByte = reader.current = dataSet->mapped.startByte;
+			reader.length = dataSet->mapped.length;
+			reader.lastByte = reader.current + reader.length;
+		}
+	}
+	else {
+		// Read the data from the source file into memory using the reader to
+		// store the pointer to the first and last bytes.
+		status = DataSetInitInMemory(
+			&dataSet->b.b,
+			&reader);
+		if (status == SUCCESS) {
+			dataSet->memory = reader.startByte;
+			dataSet->memoryLength = reader.length;
+		}
+	}
 	if (status != SUCCESS) {
 		freeDataSet(dataSet);
 		return status;
@@ -857,12 +1541,165 @@ static StatusCode readHeaderFromFile(
 	return SUCCESS;
 }
 
-static StatusCode readDataSetFromFile(
-	DataSetIpi* dataSet,
-	FILE* file,
-	Exception* exception) {
-	StatusCode status = SUCCESS;
-
+/**
+ * Returns the file reader of the data set as the file pool pointer given to
+ * a collection created from file. The collection only stores the pointer in
+ * its CollectionFile and passes it to the collection's read method. It never
+ * gets or releases a handle with it and never frees it. So the reader can
+ * stand in for the pool as long as the read method of the collection is
+ * readFileFixed or readFileVariable. They are the only methods which turn
+ * the pointer back into a reader with positionalReaderFromPool.
+ */
+static FilePool* positionalReaderAsPool(IpiFileReader* reader) {
+	return (FilePool*)reader;
+}
+
+/**
+ * Returns the file reader which positionalReaderAsPool passed to the
+ * collection as its file pool.
+ */
+static const IpiFileReader* positionalReaderFromPool(const FilePool* pool) {
+	return (const IpiFileReader*)pool;
+}
+
+/**
+ * Reads bytes of a collection from file with a positional read. Collections
+ * using positional reads are created with the file reader of the data set
+ * in place of the file pool, which they only pass to their read method.
+ */
+static void* readFilePositional(
+	const CollectionFile* file,
+	FileOffset offset,
+	Data* data,
+	uint32_t size,
+	Exception* exception) {
+	void* const ptr = DataMalloc(data, size);
+	if (ptr == NULL) {
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		return NULL;
+	}
+	const StatusCode status = IpiFileReaderRead(
+		positionalReaderFromPool(file->reader),
+		file->offsetToData + offset,
+		ptr,
+		size);
+	if (status != SUCCESS) {
+		data->used = 0;
+		EXCEPTION_SET(status);
+		return NULL;
+	}
+	data->used = size;
+	return ptr;
+}
+
+/**
+ * Reads an item of a fixed width collection with a positional read from the
+ * file reader of the data set rather than a handle from the file pool.
+ */
+static void* readFileFixed(
+	const CollectionFile* file,
+	const CollectionKey* key,
+	Data* data,
+	Exception* exception) {
+	const uint32_t size = file->collection->elementSize;
+	return readFilePositional(
+		file,
+		(FileOffset)key->indexOrOffset.index * size,
+		data,
+		size,
+		exception);
+}
+
+/**
+ * Reads an item of a variable width collection with positional reads from
+ * the file reader of the data set. The initial bytes of the item are read to
+ * find the size of the whole item using the key type, and then the whole
+ * item is read as the data may be reallocated when it grows.
+ */
+static void* readFileVariable(
+	const CollectionFile* file,
+	const CollectionKey* key,
+	Data* data,
+	Exception* exception) {
+	const CollectionKeyType* const keyType = key->keyType;
+	const FileOffset offset = (FileOffset)key->indexOrOffset.offset;
+	uint32_t size = keyType->initialBytesCount;
+	void* ptr = readFilePositional(file, offset, data, size, exception);
+	if (ptr == NULL || keyType->getFinalSize == NULL) {
+		return ptr;
+	}
+	size = keyType->getFinalSize(ptr, exception);
+	if (EXCEPTION_FAILED) {
+		data->used = 0;
+		return NULL;
+	}
+	if (size > keyType->initialBytesCount) {
+		ptr = readFilePositional(file, offset, data, size, exception);
+	}
+	return ptr;
+}
+
+/**
+ * Collection of the data set which is created from the data file.
+ */
+typedef struct init_collection_t {
+	Collection** collection; /* Collection of the data set to set */
+	const CollectionConfig* config; /* Configuration of the collection */
+	CollectionHeader header; /* Size and location of the collection */
+	fiftyoneDegreesCollectionFileRead read; /* Reads an item from file */
+	FILE* file; /* File to read from, or NULL if the task should open its
+				own handle */
+	FilePool* reader; /* Passed to the read method, which is the file reader
+					  of the data set for positional reads */
+} initCollection;
+
+/**
+ * Returns the header with the count set to zero so that the variable length
+ * collections can work.
+ */
+static CollectionHeader initVariableHeader(CollectionHeader header) {
+	header.count = 0;
+	return header;
+}
+
+static StatusCode initCollectionFromFile(
+	initTask* task,
+	Exception* exception) {
+	const initCollection* const init = (const initCollection*)task->state;
+	StatusCode status = SUCCESS;
+	FILE* file = init->file;
+#ifdef _MSC_VER
+	UNREFERENCED_PARAMETER(exception);
+#endif
+	if (file == NULL) {
+		status = FileOpen(task->dataSet->b.b.fileName, &file);
+		if (status != SUCCESS) {
+			return status;
+		}
+	}
+	*init->collection = CollectionCreateFromFile(
+		file,
+		init->reader,
+		init->config,
+		init->header,
+		init->read);
+	if (*init->collection == NULL) {
+		status = INVALID_COLLECTION_CONFIG;
+	}
+	if (init->file == NULL) {
+		fclose(file);
+	}
+	return status;
+}
+
+static StatusCode readDataSetFromFile(
+	DataSetIpi* dataSet,
+	FILE* file,
+	Exception* exception) {
+	StatusCode status = SUCCESS;
+	initTask tasks[INIT_TASKS_MAX];
+	uint32_t i;
+
 	// Copy the bytes that form the header from the start of the memory
 	// location to the data set data.ptr provided
 	status = readHeaderFromFile(file, &dataSet->header);
@@ -876,33 +1713,136 @@ static StatusCode readDataSetFromFile(
 		return status;
 	}
 
-	// Create the strings collection.
-	const uint32_t stringsCount = dataSet->header.strings.count;
-	*(uint32_t*)(&dataSet->header.strings.count) = 0;
-	COLLECTION_CREATE_FILE(strings, fiftyoneDegreesStoredBinaryValueRead);
-	*(uint32_t*)(&dataSet->header.strings.count) = stringsCount;
-
-	// Override the header count so that the variable collection can work.
-	const uint32_t componentCount = dataSet->header.components.count;
-	*(uint32_t*)(&dataSet->header.components.count) = 0;
-	COLLECTION_CREATE_FILE(components, fiftyoneDegreesComponentReadFromFile);
-	*(uint32_t*)(&dataSet->header.components.count) = componentCount;
-
-	COLLECTION_CREATE_FILE(maps, CollectionReadFileFixed);
-	COLLECTION_CREATE_FILE(properties, CollectionReadFileFixed);
-	COLLECTION_CREATE_FILE(values, CollectionReadFileFixed);
-
-	const uint32_t profileCount = dataSet->header.profiles.count;
-	*(uint32_t*)(&dataSet->header.profiles.count) = 0;
-	COLLECTION_CREATE_FILE(profiles, fiftyoneDegreesProfileReadFromFile);
-	*(uint32_t*)(&dataSet->header.profiles.count) = profileCount;
-
-	COLLECTION_CREATE_FILE(graphs, CollectionReadFileFixed);
+	// Each collection reads from a different part of the file. If they are
+	// created in parallel then every task needs a file handle of its own.
+	FILE* const shared = dataSet->config.initThreads > 1 ? NULL : file;
+
+	// Collections can read their items with positional reads which are not
+	// limited by the number of handles in the file pool. Such collections
+	// are given the file reader in place of the file pool, and every read
+	// method, including those of the variable width collections, must then
+	// use it. The graphs are not collections created here and always read
+	// from the file pool.
+	const bool positional = dataSet->config.positionalRead;
+	FilePool* const reader = positional ?
+		positionalReaderAsPool(&dataSet->fileReader) :
+		&dataSet->b.b.filePool;
+	const fiftyoneDegreesCollectionFileRead readFixed = positional ?
+		readFileFixed :
+		CollectionReadFileFixed;
+	const fiftyoneDegreesCollectionFileRead readStrings = positional ?
+		readFileVariable :
+		fiftyoneDegreesStoredBinaryValueRead;
+	const fiftyoneDegreesCollectionFileRead readComponents = positional ?
+		readFileVariable :
+		fiftyoneDegreesComponentReadFromFile;
+	const fiftyoneDegreesCollectionFileRead readProfiles = positional ?
+		readFileVariable :
+		fiftyoneDegreesProfileReadFromFile;
+	const initCollection collections[] = {
+		{
+			&dataSet->strings,
+			&dataSet->config.strings,
+			initVariableHeader(dataSet->header.strings),
+			readStrings,
+			shared,
+			reader
+		},
+		{
+			&dataSet->components,
+			&dataSet->config.components,
+			initVariableHeader(dataSet->header.components),
+			readComponents,
+			shared,
+			reader
+		},
+		{
+			&dataSet->maps,
+			&dataSet->config.maps,
+			dataSet->header.maps,
+			readFixed,
+			shared,
+			reader
+		},
+		{
+			&dataSet->properties,
+			&dataSet->config.properties,
+			dataSet->header.properties,
+			readFixed,
+			shared,
+			reader
+		},
+		{
+			&dataSet->values,
+			&dataSet->config.values,
+			dataSet->header.values,
+			readFixed,
+			shared,
+			reader
+		},
+		{
+			&dataSet->profiles,
+			&dataSet->config.profiles,
+			initVariableHeader(dataSet->header.profiles),
+			readProfiles,
+			shared,
+			reader
+		},
+		{
+			&dataSet->graphs,
+			&dataSet->config.graphs,
+			dataSet->header.graphs,
+			readFixed,
+			shared,
+			reader
+		},
+		{
+			&dataSet->profileGroups,
+			&dataSet->config.profileGroups,
+			dataSet->header.profileGroups,
+			readFixed,
+			shared,
+			reader
+		},
+		{
+			&dataSet->propertyTypes,
+			&dataSet->config.propertyTypes,
+			dataSet->header.propertyTypes,
+			readFixed,
+			shared,
+			reader
+		},
+		{
+			&dataSet->profileOffsets,
+			&dataSet->config.profileOffsets,
+			dataSet->header.profileOffsets,
+			readFixed,
+			shared,
+			reader
+		}
+	};
 
-	COLLECTION_CREATE_FILE(profileGroups, CollectionReadFileFixed);
-	COLLECTION_CREATE_FILE(propertyTypes, CollectionReadFileFixed);
-	COLLECTION_CREATE_FILE(profileOffsets, CollectionReadFileFixed);
+	// Create the collections.
+	const uint32_t count = sizeof(collections) / sizeof(collections[0]);
+	for (i = 0; i < count; i++) {
+
+		// Only the positional read methods can be given the file reader.
+		assert(positional == false ||
+			collections[i].read == readFileFixed ||
+			collections[i].read == readFileVariable);
+		tasks[i].dataSet = dataSet;
+		tasks[i].run = initCollectionFromFile;
+		tasks[i].state = &collections[i];
+		tasks[i].status = NOT_SET;
+	}
+	double start = initTimerNow();
+	status = initTasksRun(dataSet, tasks, count, exception);
+	dataSet->timings.collections = initTimerNow() - start;
+	if (status != SUCCESS || EXCEPTION_FAILED) {
+		return status;
+	}
 
+	start = initTimerNow();
 	dataSet->graphsArray = fiftyoneDegreesIpiGraphCreateFromFile(
 		dataSet->graphs,
 		file,
@@ -911,6 +1851,7 @@ static StatusCode readDataSetFromFile(
 		// the configuration for each individual graph.
 		dataSet->config.graph,
 		exception);
+	dataSet->timings.graphs = initTimerNow() - start;
 
 	initDataSetPost(dataSet, exception);
 
@@ -943,6 +1884,330 @@ static uint16_t getMaxConcurrency(const ConfigIpi* config) {
 	return concurrency;
 }
 
+/**
+ * Returns the index of the component's result in the results, or -1 if the
+ * component has no available properties and so has no result. Results are
+ * added in the order of the available components.
+ */
+static int getResultIndex(const DataSetIpi* dataSet, uint32_t componentIndex) {
+	int resultIndex = 0;
+	if (componentIndex >= dataSet->componentsList.count ||
+		dataSet->componentsAvailable[componentIndex] == false) {
+		return -1;
+	}
+	for (uint32_t i = 0; i < componentIndex; i++) {
+		if (dataSet->componentsAvailable[i]) {
+			resultIndex++;
+		}
+	}
+	return resultIndex;
+}
+
+/**
+ * Finds the IpRangeStart and IpRangeEnd properties of each component with
+ * available properties which are used to find the range of IP addresses the
+ * component's result applies to. Components which do not have both
+ * properties have their indexes set to -1 and the range of their results is
+ * never known.
+ */
+static StatusCode initRangeProperties(
+	DataSetIpi* dataSet,
+	Exception* exception) {
+	uint32_t i;
+	int index, resultIndex;
+	const String* name;
+	Item propertyItem, nameItem;
+	IpiRangeProperties* ranges;
+	const uint32_t count = dataSet->componentsAvailableCount;
+	dataSet->rangesAvailableCount = 0;
+	if (count == 0) {
+		return SUCCESS;
+	}
+	ranges = (IpiRangeProperties*)Malloc(sizeof(IpiRangeProperties) * count);
+	if (ranges == NULL) {
+		return INSUFFICIENT_MEMORY;
+	}
+	dataSet->ranges = ranges;
+	for (i = 0; i < count; i++) {
+		ranges[i].startIndex = -1;
+		ranges[i].endIndex = -1;
+		ranges[i].componentId = 0;
+	}
+	for (i = 0; i < dataSet->componentsList.count; i++) {
+		const Component* const component = COMPONENT(dataSet, i);
+		resultIndex = getResultIndex(dataSet, i);
+		if (resultIndex >= 0 && component != NULL) {
+			ranges[resultIndex].componentId = component->componentId;
+		}
+	}
+
+	// Record the range properties against the component they belong to.
+	DataReset(&propertyItem.data);
+	DataReset(&nameItem.data);
+	const int propertiesCount = CollectionGetCount(dataSet->properties);
+	for (index = 0; index < propertiesCount; index++) {
+		const Property* const property = PropertyGet(
+			dataSet->properties,
+			index,
+			&propertyItem,
+			exception);
+		if (property == NULL || EXCEPTION_FAILED) {
+			return COLLECTION_FAILURE;
+		}
+		resultIndex = getResultIndex(dataSet, property->componentIndex);
+		name = PropertyGetName(
+			dataSet->strings,
+			property,
+			&nameItem,
+			exception);
+		COLLECTION_RELEASE(dataSet->properties, &propertyItem);
+		if (name == NULL || EXCEPTION_FAILED) {
+			return COLLECTION_FAILURE;
+		}
+		if (resultIndex >= 0) {
+			if (StringCompare("IpRangeStart", &name->value) == 0) {
+				ranges[resultIndex].startIndex = index;
+			}
+			else if (StringCompare("IpRangeEnd", &name->value) == 0) {
+				ranges[resultIndex].endIndex = index;
+			}
+		}
+		COLLECTION_RELEASE(dataSet->strings, &nameItem);
+	}
+
+	// Only components with both properties have a known range.
+	for (i = 0; i < count; i++) {
+		if (ranges[i].startIndex < 0 || ranges[i].endIndex < 0) {
+			ranges[i].startIndex = -1;
+			ranges[i].endIndex = -1;
+		}
+		else {
+			dataSet->rangesAvailableCount++;
+		}
+	}
+	return SUCCESS;
+}
+
+/**
+ * Returns the number of characters needed to add the name to a JSON string.
+ */
+static size_t getJsonEscapedLength(const char* name) {
+	size_t length = 0;
+	for (; *name != '\0'; name++) {
+		if (*name == '"' || *name == '\\') {
+			length += 2;
+		}
+		else if ((unsigned char)*name < 0x20) {
+			length += 6;
+		}
+		else {
+			length++;
+		}
+	}
+	return length;
+}
+
+/**
+ * Returns the number of characters needed to add the name to a quoted CSV
+ * field.
+ */
+static size_t getCsvEscapedLength(const char* name) {
+	size_t length = 0;
+	for (; *name != '\0'; name++) {
+		length += *name == '"' ? 2 : 1;
+	}
+	return length;
+}
+
+/**
+ * Writes the name quoted for each render format to the next characters,
+ * setting the names of the render property and returning the character after
+ * the last one written.
+ */
+static char* setRenderPropertyNames(
+	IpiRenderProperty* property,
+	const char* name,
+	char* next) {
+	static const char hex[] = "0123456789abcdef";
+	const char* c;
+
+	// Name=
+	property->names[FIFTYONE_DEGREES_IPI_RENDER_FORMAT_PIPE] = next;
+	for (c = name; *c != '\0'; c++) {
+		*next++ = *c;
+	}
+	*next++ = '=';
+	*next++ = '\0';
+
+	// "Name":[
+	property->names[FIFTYONE_DEGREES_IPI_RENDER_FORMAT_JSON] = next;
+	*next++ = '"';
+	for (c = name; *c != '\0'; c++) {
+		if (*c == '"' || *c == '\\') {
+			*next++ = '\\';
+			*next++ = *c;
+		}
+		else if ((unsigned char)*c < 0x20) {
+			*next++ = '\\';
+			*next++ = 'u';
+			*next++ = '0';
+			*next++ = '0';
+			*next++ = hex[((unsigned char)*c >> 4) & 0x0F];
+			*next++ = hex[(unsigned char)*c & 0x0F];
+		}
+		else {
+			*next++ = *c;
+		}
+	}
+	*next++ = '"';
+	*next++ = ':';
+	*next++ = '[';
+	*next++ = '\0';
+
+	// "Name"
+	property->names[FIFTYONE_DEGREES_IPI_RENDER_FORMAT_CSV] = next;
+	*next++ = '"';
+	for (c = name; *c != '\0'; c++) {
+		if (*c == '"') {
+			*next++ = '"';
+		}
+		*next++ = *c;
+	}
+	*next++ = '"';
+	*next++ = '\0';
+
+	for (int i = 0; i < FIFTYONE_DEGREES_IPI_RENDER_FORMAT_COUNT; i++) {
+		property->namesLength[i] = strlen(property->names[i]);
+	}
+	return next;
+}
+
+/**
+ * Prepares the required properties for rendering so that the names do not
+ * need to be found and quoted, or the stored types found, for every result.
+ */
+static StatusCode initRenderProperties(
+	DataSetIpi* dataSet,
+	Exception* exception) {
+	uint32_t i;
+	size_t namesSize = 0;
+	const char* name;
+	char* next;
+	const PropertiesAvailable* const available = dataSet->b.b.available;
+	if (available->count == 0) {
+		return SUCCESS;
+	}
+	IpiRenderProperties* const properties = (IpiRenderProperties*)Malloc(
+		sizeof(IpiRenderProperties));
+	if (properties == NULL) {
+		return INSUFFICIENT_MEMORY;
+	}
+	properties->count = available->count;
+	properties->names = NULL;
+	properties->items = (IpiRenderProperty*)Malloc(
+		sizeof(IpiRenderProperty) * properties->count);
+	if (properties->items == NULL) {
+		freeRenderProperties(properties);
+		return INSUFFICIENT_MEMORY;
+	}
+
+	// Work out the space needed for the names in every format including the
+	// quotes, separators and null terminators.
+	for (i = 0; i < properties->count; i++) {
+		name = STRING(PropertiesGetNameFromRequiredIndex(available, (int)i));
+		namesSize += strlen(name) + 3;
+		namesSize += getJsonEscapedLength(name) + 5;
+		namesSize += getCsvEscapedLength(name) + 3;
+	}
+	properties->names = (char*)Malloc(namesSize);
+	if (properties->names == NULL) {
+		freeRenderProperties(properties);
+		return INSUFFICIENT_MEMORY;
+	}
+
+	next = properties->names;
+	for (i = 0; i < properties->count; i++) {
+		IpiRenderProperty* const property = &properties->items[i];
+		property->propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
+			available,
+			(int)i);
+		property->storedValueType = PropertyGetStoredTypeByIndex(
+			dataSet->propertyTypes,
+			property->propertyIndex,
+			exception);
+		if (EXCEPTION_FAILED) {
+			freeRenderProperties(properties);
+			return COLLECTION_FAILURE;
+		}
+		name = STRING(PropertiesGetNameFromRequiredIndex(available, (int)i));
+		next = setRenderPropertyNames(property, name, next);
+	}
+	dataSet->renderProperties = properties;
+	return SUCCESS;
+}
+
+/**
+ * Creates the range cache if enabled in the configuration. The cache needs
+ * the IpRangeStart and IpRangeEnd properties to find the range of each IP
+ * address, so is not created if no component has them.
+ */
+static StatusCode initRangeCache(DataSetIpi* dataSet, Exception* exception) {
+	uint32_t i;
+	IpiRangeCache* cache;
+	const uint32_t capacity = dataSet->config.rangeCacheCapacity;
+	if (capacity == 0 ||
+		dataSet->componentsAvailableCount == 0 ||
+		dataSet->rangesAvailableCount == 0) {
+		return SUCCESS;
+	}
+
+	// Allocate the cache, shards, entries, results and component ids as a
+	// single block of memory. There is a shard for each concurrent
+	// operation expected.
+	const uint32_t shardsCount = MIN(
+		(uint32_t)getMaxConcurrency(&dataSet->config),
+		capacity);
+	const size_t componentsCount = dataSet->rangesAvailableCount;
+	cache = (IpiRangeCache*)Malloc(
+		sizeof(IpiRangeCache) +
+		sizeof(IpiRangeCacheShard) * shardsCount +
+		sizeof(IpiRangeCacheEntry) * capacity +
+		sizeof(fiftyoneDegreesIpiCgResult) * capacity * componentsCount +
+		componentsCount);
+	if (cache == NULL) {
+		return INSUFFICIENT_MEMORY;
+	}
+	cache->capacity = capacity;
+	cache->shardsCount = shardsCount;
+	cache->shards = (IpiRangeCacheShard*)(cache + 1);
+	cache->entries = (IpiRangeCacheEntry*)(cache->shards + shardsCount);
+	fiftyoneDegreesIpiCgResult* const results =
+		(fiftyoneDegreesIpiCgResult*)(cache->entries + capacity);
+	byte* const componentIds = (byte*)(results + capacity * componentsCount);
+	cache->componentIds = componentIds;
+	cache->componentsCount = 0;
+	for (i = 0; i < dataSet->componentsAvailableCount; i++) {
+		if (dataSet->ranges[i].startIndex >= 0) {
+			componentIds[cache->componentsCount++] =
+				dataSet->ranges[i].componentId;
+		}
+	}
+	for (i = 0; i < capacity; i++) {
+		cache->entries[i].start.type = IP_TYPE_INVALID;
+		cache->entries[i].rangeId = NO_RANGE_ID;
+		cache->entries[i].results = results + (size_t)i * componentsCount;
+	}
+	for (i = 0; i < shardsCount; i++) {
+		cache->shards[i].hits = 0;
+		cache->shards[i].misses = 0;
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+		FIFTYONE_DEGREES_MUTEX_CREATE(cache->shards[i].lock);
+#endif
+	}
+	dataSet->rangeCache = cache;
+	return SUCCESS;
+}
+
 #ifndef FIFTYONE_DEGREES_MEMORY_ONLY
 
 static StatusCode initWithFile(DataSetIpi* dataSet, Exception* exception) {
@@ -960,6 +2225,17 @@ static StatusCode initWithFile(DataSetIpi* dataSet, Exception* exception) {
 		return status;
 	}
 
+	// The graphs still read from the file pool, but the collections can
+	// share a single handle.
+	if (dataSet->config.positionalRead == true) {
+		status = IpiFileReaderOpen(
+			dataSet->b.b.fileName,
+			&dataSet->fileReader);
+		if (status != SUCCESS) {
+			return status;
+		}
+	}
+
 	// Create a new file handle for the read operation. The file handle can't
 	// come from the pool of handles because there may only be one available
 	// in the pool and it will be needed for some initialisation activities.
@@ -994,6 +2270,9 @@ static StatusCode initWithFile(DataSetIpi* dataSet, Exception* exception) {
 
 #endif
 
+// Defined after the methods which build each of the tables and indexes.
+static StatusCode initIndexes(DataSetIpi* dataSet, Exception* exception);
+
 static StatusCode initDataSetFromFile(
 	void* dataSetBase,
 	const void* configBase,
@@ -1003,6 +2282,7 @@ static StatusCode initDataSetFromFile(
 	DataSetIpi* dataSet = (DataSetIpi*)dataSetBase;
 	ConfigIpi* config = (ConfigIpi*)configBase;
 	StatusCode status = NOT_SET;
+	const double total = initTimerNow();
 
 	// Common data set initialisation actions.
 	initDataSet(dataSet, &config);
@@ -1042,6 +2322,7 @@ static StatusCode initDataSetFromFile(
 
 	// Initialise the required properties and headers and check the 
 	// initialisation was successful.
+	double start = initTimerNow();
 	status = initPropertiesAndHeaders(dataSet, properties, exception);
 	if (status != SUCCESS || EXCEPTION_FAILED) {
 		// Delete the temp file if one has been created.
@@ -1061,6 +2342,38 @@ static StatusCode initDataSetFromFile(
 		return status;
 	}
 
+	// Find the properties used to return the range matched by an IP address.
+	status = initRangeProperties(dataSet, exception);
+	if (status != SUCCESS || EXCEPTION_FAILED) {
+		if (config->b.useTempFile == true) {
+			FileDelete(dataSet->b.b.fileName);
+		}
+		return status;
+	}
+
+	// Prepare the required properties for rendering.
+	status = initRenderProperties(dataSet, exception);
+	if (status != SUCCESS || EXCEPTION_FAILED) {
+		if (config->b.useTempFile == true) {
+			FileDelete(dataSet->b.b.fileName);
+		}
+		return status;
+	}
+
+	dataSet->timings.properties = initTimerNow() - start;
+
+	// Build the tables, indexes and caches enabled in the configuration.
+	start = initTimerNow();
+	status = initIndexes(dataSet, exception);
+	dataSet->timings.indexes = initTimerNow() - start;
+	if (status != SUCCESS || EXCEPTION_FAILED) {
+		if (config->b.useTempFile == true) {
+			FileDelete(dataSet->b.b.fileName);
+		}
+		return status;
+	}
+	dataSet->timings.total = initTimerNow() - total;
+
 	// Check there are properties available for retrieval.
 	if (dataSet->b.b.available->count == 0) {
 		// Delete the temp file if one has been created.
@@ -1119,6 +2432,11 @@ size_t fiftyoneDegreesIpiSizeManagerFromFile(
 	Free = MemoryTrackingFree;
 	FreeAligned = MemoryTrackingFreeAligned;
 
+	// Initialise in sequence so that the maximum memory allocated does not
+	// depend on the order in which parallel tasks run.
+	ConfigIpi sizeConfig = config != NULL ? *config : IpiBalancedConfig;
+	sizeConfig.initThreads = 0;
+
 	// Initialise the manager with the tracking methods in use to determine
 	// the amount of memory that is allocated.
 #ifdef _DEBUG 
@@ -1126,7 +2444,7 @@ size_t fiftyoneDegreesIpiSizeManagerFromFile(
 #endif
 		IpiInitManagerFromFile(
 			&manager,
-			config,
+			&sizeConfig,
 			properties,
 			fileName,
 			exception);
@@ -1164,6 +2482,7 @@ static StatusCode initDataSetFromMemory(
 	MemoryReader reader;
 	DataSetIpi* dataSet = (DataSetIpi*)dataSetBase;
 	ConfigIpi* config = (ConfigIpi*)configBase;
+	const double total = initTimerNow();
 
 	// Common data set initialisation actions.
 	initDataSet(dataSet, &config);
@@ -1178,6 +2497,8 @@ static StatusCode initDataSetFromMemory(
 	reader.startByte = reader.current = (byte*)memory;
 	reader.length = size;
 	reader.lastByte = reader.current + size;
+	dataSet->memory = (const byte*)memory;
+	dataSet->memoryLength = size;
 
 	// Initialise the data set from the memory reader.
 	status = initWithMemory(dataSet, &reader, exception);
@@ -1188,6 +2509,7 @@ static StatusCode initDataSetFromMemory(
 	}
 
 	// Initialise the required properties and headers.
+	double start = initTimerNow();
 	status = initPropertiesAndHeaders(dataSet, properties, exception);
 	if (status != SUCCESS || EXCEPTION_FAILED) {
 		return status;
@@ -1196,6 +2518,29 @@ static StatusCode initDataSetFromMemory(
 	// Initialise the components available to flag which components have
 	// properties which are to be returned (i.e. available properties).
 	status = initComponentsAvailable(dataSet, exception);
+	if (status != SUCCESS || EXCEPTION_FAILED) {
+		return status;
+	}
+
+	// Find the properties used to return the range matched by an IP address.
+	status = initRangeProperties(dataSet, exception);
+	if (status != SUCCESS || EXCEPTION_FAILED) {
+		return status;
+	}
+
+	// Prepare the required properties for rendering.
+	status = initRenderProperties(dataSet, exception);
+	if (status != SUCCESS || EXCEPTION_FAILED) {
+		return status;
+	}
+
+	dataSet->timings.properties = initTimerNow() - start;
+
+	// Build the tables, indexes and caches enabled in the configuration.
+	start = initTimerNow();
+	status = initIndexes(dataSet, exception);
+	dataSet->timings.indexes = initTimerNow() - start;
+	dataSet->timings.total = initTimerNow() - total;
 
 	return status;
 }
@@ -1250,9 +2595,12 @@ size_t fiftyoneDegreesIpiSizeManagerFromMemory(
 	Free = MemoryTrackingFree;
 	FreeAligned = MemoryTrackingFreeAligned;
 
-	// Ensure that the memory used is not freed with the data set.
+	// Ensure that the memory used is not freed with the data set, and
+	// initialise in sequence so that the maximum memory allocated does not
+	// depend on the order in which parallel tasks run.
 	ConfigIpi sizeConfig = *config;
 	sizeConfig.b.freeData = false;
+	sizeConfig.initThreads = 0;
 
 	// Initialise the manager with the tracking methods in use to determine
 	// the amount of memory that is allocated.
@@ -1297,6 +2645,36 @@ void fiftyoneDegreesDataSetIpiRelease(fiftyoneDegreesDataSetIpi* dataSet) {
 	DataSetRelease(&dataSet->b.b);
 }
 
+fiftyoneDegreesIpiRangeCacheStats fiftyoneDegreesIpiGetRangeCacheStats(
+	fiftyoneDegreesResourceManager* manager) {
+	IpiRangeCacheStats stats = { 0, 0, 0 };
+	DataSetIpi* dataSet = DataSetIpiGet(manager);
+	IpiRangeCache* const cache = dataSet->rangeCache;
+	if (cache != NULL) {
+		stats.capacity = cache->capacity;
+		for (uint32_t i = 0; i < cache->shardsCount; i++) {
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+			FIFTYONE_DEGREES_MUTEX_LOCK(&cache->shards[i].lock);
+#endif
+			stats.hits += cache->shards[i].hits;
+			stats.misses += cache->shards[i].misses;
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+			FIFTYONE_DEGREES_MUTEX_UNLOCK(&cache->shards[i].lock);
+#endif
+		}
+	}
+	DataSetIpiRelease(dataSet);
+	return stats;
+}
+
+fiftyoneDegreesIpiInitTimings fiftyoneDegreesIpiGetInitTimings(
+	fiftyoneDegreesResourceManager* manager) {
+	DataSetIpi* dataSet = DataSetIpiGet(manager);
+	const IpiInitTimings timings = dataSet->timings;
+	DataSetIpiRelease(dataSet);
+	return timings;
+}
+
 /**
  * Definition of the reload methods from the data set macro.
  */
@@ -1322,32 +2700,80 @@ FIFTYONE_DEGREES_DATASET_RELOAD(Ipi)
  * Results methods
  */
 
-fiftyoneDegreesResultsIpi* fiftyoneDegreesResultsIpiCreate(
-	fiftyoneDegreesResourceManager* manager) {
-	ResultsIpi* results;
-	DataSetIpi* dataSet;
+/**
+ * Initialises the members of results which have already been allocated to
+ * reference the data set.
+ */
+static void resultsIpiInit(
+	ResultsIpi* results,
+	const DataSetIpi* dataSet) {
+	fiftyoneDegreesResultsInit(&results->b, (void*)(&dataSet->b));
 
-	// Increment the inUse counter for the active data set so that we can
-	// track any results that are created.
-	dataSet = (DataSetIpi*)DataSetGet(manager);
+	// Reset the property and values list ready for first use sized for 
+	// a single value to be returned.
+	WeightedItemListInit(
+		&results->values,
+		1,
+		FIFTYONE_DEGREES_WEIGHTED_ITEM_LIST_DEFAULT_LOAD_FACTOR);
+	DataReset(&results->propertyItem.data);
+	DataReset(&results->properties.state);
+	DataReset(&results->properties.indexes);
+	results->properties.lists = NULL;
+	results->properties.listsCount = 0;
+}
 
-	// Create a new instance of results.
+/**
+ * Frees the memory owned by the members of the results but not the results
+ * themselves. Any values must already have been released.
+ */
+static void resultsIpiFreeMembers(ResultsIpi* results) {
+	ResultsIpiProperties* const properties = &results->properties;
+	WeightedItemListFree(&results->values);
+	for (uint32_t i = 0; i < properties->listsCount; i++) {
+		WeightedItemListRelease(&properties->lists[i]);
+		WeightedItemListFree(&properties->lists[i]);
+	}
+	if (properties->lists != NULL) {
+		Free(properties->lists);
+	}
+	if (properties->state.ptr != NULL) {
+		Free(properties->state.ptr);
+	}
+	if (properties->indexes.ptr != NULL) {
+		Free(properties->indexes.ptr);
+	}
+}
+
+/**
+ * Creates results with capacity for a result from each available component
+ * of the data set, initialised to reference it. The caller is responsible
+ * for any reference counting of the data set.
+ * @return new results, or NULL if there was not enough memory
+ */
+static ResultsIpi* resultsIpiCreateForDataSet(const DataSetIpi* dataSet) {
+	ResultsIpi* results;
 	FIFTYONE_DEGREES_ARRAY_CREATE(
 		ResultIpi,
 		results,
 		dataSet->componentsAvailableCount);
-
 	if (results != NULL) {
+		resultsIpiInit(results, dataSet);
+	}
+	return results;
+}
+
+fiftyoneDegreesResultsIpi* fiftyoneDegreesResultsIpiCreate(
+	fiftyoneDegreesResourceManager* manager) {
+	ResultsIpi* results;
+	DataSetIpi* dataSet;
 
-		// Initialise the results.
-		fiftyoneDegreesResultsInit(&results->b, (void*)(&dataSet->b));
+	// Increment the inUse counter for the active data set so that we can
+	// track any results that are created.
+	dataSet = (DataSetIpi*)DataSetGet(manager);
 
-		// Reset the property and values list ready for first use sized for 
-		// a single value to be returned.
-		WeightedItemListInit(&results->values, 1, FIFTYONE_DEGREES_WEIGHTED_ITEM_LIST_DEFAULT_LOAD_FACTOR);
-		DataReset(&results->propertyItem.data);
-	}
-	else {
+	// Create a new instance of results.
+	results = resultsIpiCreateForDataSet(dataSet);
+	if (results == NULL) {
 		DataSetRelease((DataSetBase *)dataSet);
 	}
 
@@ -1366,17 +2792,424 @@ static void resultsIpiRelease(ResultsIpi* results) {
 
 void fiftyoneDegreesResultsIpiFree(fiftyoneDegreesResultsIpi* results) {
 	resultsIpiRelease(results);
-	WeightedItemListFree(&results->values);
+	resultsIpiFreeMembers(results);
 	DataSetRelease((DataSetBase*)results->b.dataSet);
 	Free(results);
 }
 
-static bool addResultsFromIpAddressNoChecks(
+void fiftyoneDegreesResultsIpiReset(fiftyoneDegreesResultsIpi* results) {
+	resultsIpiRelease(results);
+	DataReset(&results->propertyItem.data);
+	results->count = 0;
+}
+
+bool fiftyoneDegreesResultsIpiGetIsActive(
+	fiftyoneDegreesResultsIpi* results,
+	fiftyoneDegreesResourceManager* manager) {
+	const ResourceHandle* const active =
+		(const ResourceHandle*)manager->active;
+	return active != NULL && active->resource == results->b.dataSet;
+}
+
+static void initResultFromIpAddress(
+	ResultIpi* const result,
+	const unsigned char* ipAddress,
+	fiftyoneDegreesIpType type) {
+	resultIpiReset(result);
+	// Default IP range offset
+	result->graphResult = FIFTYONE_DEGREES_IPI_CG_RESULT_DEFAULT;
+	result->graphResult.rawOffset = NULL_PROFILE_OFFSET; // Default IP range offset
+	result->targetIpAddress.type = type;
+	result->type = type;
+
+	if (type == IP_TYPE_IPV4) {
+		// We only get the exact length of ipv4
+		memcpy(result->targetIpAddress.value, ipAddress, IPV4_LENGTH);
+	}
+	else {
+		// We only get the exact length of ipv6
+		memcpy(result->targetIpAddress.value, ipAddress, IPV6_LENGTH);
+	}
+}
+
+static void addResultFromIpAddress(
 	ResultsIpi* results,
+	const DataSetIpi* const dataSet,
+	byte componentId,
+	const unsigned char* ipAddress,
+	fiftyoneDegreesIpType type,
+	fiftyoneDegreesException* exception) {
+	ResultIpi * const nextResult = &(results->items[results->count]);
+	results->count++;
+	initResultFromIpAddress(nextResult, ipAddress, type);
+	setResultFromIpAddress(
+		nextResult,
+		dataSet,
+		componentId,
+		exception);
+}
+
+// Defined with the other methods used to get values from results.
+static uint32_t addValuesFromResult(
+	ResultsIpi* results,
+	ResultIpi* result,
+	Property* property,
+	int propertyIndex,
+	Exception* exception);
+
+/**
+ * Gets the lowest, or highest, IP address from the values of the property
+ * for the result. Only IP addresses of the same type as the result's target
+ * IP address are considered. The values list of the results is used to read
+ * the values and is left empty. Returns false if there are no values.
+ */
+static bool getIpAddressBound(
+	ResultsIpi* results,
+	ResultIpi* result,
+	Property* property,
+	int propertyIndex,
+	bool highest,
+	IpAddress* bound,
+	Exception* exception) {
+	bool found = false;
+	const IpType type = result->targetIpAddress.type;
+	const int length = type == IP_TYPE_IPV4 ? IPV4_LENGTH : IPV6_LENGTH;
+	WeightedItemListRelease(&results->values);
+	addValuesFromResult(results, result, property, propertyIndex, exception);
+	for (uint32_t i = 0; i < results->values.count && EXCEPTION_OKAY; i++) {
+		const VarLengthByteArray* const value =
+			(const VarLengthByteArray*)results->values.items[i].item.data.ptr;
+		if (value == NULL || value->size != length) {
+			continue;
+		}
+		const int difference = found == false ? 0 : compareIpAddresses(
+			&value->firstByte,
+			bound->value,
+			length);
+		if (found == false ||
+			(highest ? difference > 0 : difference < 0)) {
+			memset(bound->value, 0, IPV6_LENGTH);
+			memcpy(bound->value, &value->firstByte, length);
+			bound->type = type;
+			found = true;
+		}
+	}
+	WeightedItemListRelease(&results->values);
+	return found && EXCEPTION_OKAY;
+}
+
+/**
+ * Range cache methods
+ */
+
+/**
+ * Returns the entry in the cache for the IP address. IP addresses which
+ * share the same leading 24 bits for IPv4, or 48 bits for IPv6, map to the
+ * same entry as they usually fall within the same range.
+ */
+static uint32_t rangeCacheGetSlot(
+	const IpiRangeCache* cache,
+	const unsigned char* ipAddress,
+	IpType type) {
+	const int prefixLength = type == IP_TYPE_IPV4 ? 3 : 6;
+	uint64_t key = (uint64_t)type;
+	for (int i = 0; i < prefixLength; i++) {
+		key = (key << 8) | ipAddress[i];
+	}
+	key *= 0x9E3779B97F4A7C15ULL;
+	return (uint32_t)((key >> 32) % cache->capacity);
+}
+
+/**
+ * Sets the results from the cache if the IP address falls within the range
+ * of the cache entry it maps to. Returns true if the cache was used,
+ * otherwise false to indicate the graphs must be evaluated. The cache only
+ * holds the results of the components with range properties. The results of
+ * other components can change within the range so are always evaluated.
+ */
+static bool rangeCacheGet(
+	const DataSetIpi* dataSet,
+	ResultsIpi* results,
+	const unsigned char* ipAddress,
+	IpType type,
+	Exception* exception) {
+	uint32_t c, index = 0;
+	IpiRangeCache* const cache = dataSet->rangeCache;
+	const uint32_t slot = rangeCacheGetSlot(cache, ipAddress, type);
+	IpiRangeCacheShard* const shard = &cache->shards[slot % cache->shardsCount];
+	const IpiRangeCacheEntry* const entry = &cache->entries[slot];
+	const IpiIpKey key = getIpKey(
+		ipAddress,
+		type == IP_TYPE_IPV4 ? IPV4_LENGTH : IPV6_LENGTH);
+	ResultIpi* const items = &results->items[results->count];
+	bool hit;
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+	FIFTYONE_DEGREES_MUTEX_LOCK(&shard->lock);
+#endif
+	hit = entry->start.type == type &&
+		compareIpKeys(&entry->startKey, &key) <= 0 &&
+		compareIpKeys(&key, &entry->endKey) <= 0;
+	if (hit) {
+		for (c = 0; c < dataSet->componentsAvailableCount; c++) {
+			ResultIpi* const result = &items[c];
+			initResultFromIpAddress(result, ipAddress, type);
+			if (dataSet->ranges[c].startIndex < 0) {
+				continue;
+			}
+			if (entry->results[index].rawOffset != NULL_PROFILE_OFFSET) {
+				result->graphResult = entry->results[index];
+			}
+			index++;
+		}
+		results->count += dataSet->componentsAvailableCount;
+		shard->hits++;
+	}
+	else {
+		shard->misses++;
+	}
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+	FIFTYONE_DEGREES_MUTEX_UNLOCK(&shard->lock);
+#endif
+	for (c = 0; hit && c < dataSet->componentsAvailableCount; c++) {
+		if (dataSet->ranges[c].startIndex < 0) {
+			setResultFromIpAddress(
+				&items[c],
+				dataSet,
+				dataSet->ranges[c].componentId,
+				exception);
+			if (EXCEPTION_FAILED) {
+				break;
+			}
+		}
+	}
+	return hit;
+}
+
+/**
+ * Returns an id for the range derived from its first and last IP addresses
+ * with the 32 bit FNV-1a hash. The id is the same for every IP address in
+ * the range and does not depend on how the range was found. It is not
+ * unique, as a data file has millions of ranges some of them share an id,
+ * so it is never used to tell whether two ranges are the same.
+ */
+static uint32_t getRangeId(const IpAddress* start, const IpAddress* end) {
+	int i;
+	uint32_t hash = 2166136261U;
+	const int length = start->type == IP_TYPE_IPV4 ?
+		IPV4_LENGTH : IPV6_LENGTH;
+	hash = (hash ^ (byte)start->type) * 16777619U;
+	for (i = 0; i < length; i++) {
+		hash = (hash ^ start->value[i]) * 16777619U;
+	}
+	for (i = 0; i < length; i++) {
+		hash = (hash ^ end->value[i]) * 16777619U;
+	}
+	return hash == NO_RANGE_ID ? hash - 1 : hash;
+}
+
+/**
+ * Sets the first and last IP addresses, and the id, of the range the result
+ * at the index applies to from the IpRangeStart and IpRangeEnd values of its
+ * component. The range is left unknown if the component does not have the
+ * properties, there is no profile for the result, or the values do not
+ * contain the target IP address.
+ */
+static void resolveResultRange(
+	ResultsIpi* results,
+	uint32_t index,
+	Exception* exception) {
+	bool found = false;
+	IpAddress start, end;
+	Item startItem, endItem;
+	const DataSetIpi* const dataSet = (const DataSetIpi*)results->b.dataSet;
+	ResultIpi* const result = &results->items[index];
+	if (index >= dataSet->componentsAvailableCount ||
+		dataSet->ranges[index].startIndex < 0 ||
+		result->graphResult.rawOffset == NULL_PROFILE_OFFSET) {
+		result->rangeResolved = true;
+		return;
+	}
+	const IpiRangeProperties* const range = &dataSet->ranges[index];
+
+	// Get the first and last IP addresses of the range.
+	DataReset(&startItem.data);
+	DataReset(&endItem.data);
+	Property* const startProperty = PropertyGet(
+		dataSet->properties,
+		range->startIndex,
+		&startItem,
+		exception);
+	if (startProperty != NULL && EXCEPTION_OKAY) {
+		Property* const endProperty = PropertyGet(
+			dataSet->properties,
+			range->endIndex,
+			&endItem,
+			exception);
+		if (endProperty != NULL && EXCEPTION_OKAY) {
+			found = getIpAddressBound(
+				results,
+				result,
+				startProperty,
+				range->startIndex,
+				true,
+				&start,
+				exception) &&
+				getIpAddressBound(
+					results,
+					result,
+					endProperty,
+					range->endIndex,
+					false,
+					&end,
+					exception);
+			COLLECTION_RELEASE(dataSet->properties, &endItem);
+		}
+		COLLECTION_RELEASE(dataSet->properties, &startItem);
+	}
+	if (EXCEPTION_FAILED) {
+		return;
+	}
+	result->rangeResolved = true;
+	const int length = result->targetIpAddress.type == IP_TYPE_IPV4 ?
+		IPV4_LENGTH : IPV6_LENGTH;
+	if (found == false ||
+		compareIpAddresses(
+			start.value,
+			result->targetIpAddress.value,
+			length) > 0 ||
+		compareIpAddresses(
+			result->targetIpAddress.value,
+			end.value,
+			length) > 0) {
+		return;
+	}
+	result->rangeStart = start;
+	result->rangeEnd = end;
+	result->rangeId = getRangeId(&start, &end);
+}
+
+/**
+ * Adds the range containing the IP address, and the results of the
+ * components with range properties, to the cache replacing the entry the IP
+ * address maps to. The range is the intersection of the ranges of those
+ * results so every result is the same for any IP address within it. If the
+ * range is not known the cache is not changed.
+ */
+static void rangeCacheAdd(
+	const DataSetIpi* dataSet,
+	ResultsIpi* results,
+	const unsigned char* ipAddress,
+	IpType type,
+	Exception* exception) {
+	uint32_t c, index = 0, rangeId;
+	IpAddress start, end;
+	IpiRangeCache* const cache = dataSet->rangeCache;
+	if (results->count != dataSet->componentsAvailableCount ||
+		results->count == 0 ||
+		ResultsIpiGetRange(
+			results,
+			&start,
+			&end,
+			&rangeId,
+			exception) == false) {
+		return;
+	}
+
+	// Create the keys before taking the lock.
+	const int length = type == IP_TYPE_IPV4 ? IPV4_LENGTH : IPV6_LENGTH;
+	const IpiIpKey startKey = getIpKey(start.value, length);
+	const IpiIpKey endKey = getIpKey(end.value, length);
+
+	// Replace the entry the IP address maps to.
+	const uint32_t slot = rangeCacheGetSlot(cache, ipAddress, type);
+	IpiRangeCacheShard* const shard = &cache->shards[slot % cache->shardsCount];
+	IpiRangeCacheEntry* const entry = &cache->entries[slot];
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+	FIFTYONE_DEGREES_MUTEX_LOCK(&shard->lock);
+#endif
+	entry->start = start;
+	entry->end = end;
+	entry->startKey = startKey;
+	entry->endKey = endKey;
+	entry->rangeId = rangeId;
+	for (c = 0; c < results->count; c++) {
+		if (dataSet->ranges[c].startIndex >= 0) {
+			entry->results[index++] = results->items[c].graphResult;
+		}
+	}
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+	FIFTYONE_DEGREES_MUTEX_UNLOCK(&shard->lock);
+#endif
+}
+
+/**
+ * Adds the results for every available component using the flattened table
+ * for the IP address type. A single search finds the results for all the
+ * components in the table, rather than a search or graph evaluation for each
+ * component. Components which are not in the table are evaluated as normal.
+ * Returns false if there is no table for the IP address type.
+ */
+static bool addResultsFromRangeTable(
+	ResultsIpi* results,
+	const DataSetIpi* dataSet,
+	const unsigned char* ipAddress,
+	fiftyoneDegreesIpType type,
+	fiftyoneDegreesException* exception) {
+	uint32_t c, slot = 0, componentsCount;
+	const byte* componentIds;
+	const fiftyoneDegreesIpiCgResult* graphResults;
+	if (type == IP_TYPE_IPV4 && dataSet->ipv4Table != NULL) {
+		const IpiIpv4Table* const table = dataSet->ipv4Table;
+		componentsCount = table->componentsCount;
+		componentIds = table->componentIds;
+		graphResults = &table->results[(size_t)ipv4TableFind(
+			table,
+			getIpv4AsInteger(ipAddress)) * componentsCount];
+	}
+	else if (type == IP_TYPE_IPV6 && dataSet->ipv6Table != NULL) {
+		const IpiIpv6Table* const table = dataSet->ipv6Table;
+		componentsCount = table->componentsCount;
+		componentIds = table->componentIds;
+		graphResults = &table->results[(size_t)ipv6TableFind(
+			table,
+			ipAddress) * componentsCount];
+	}
+	else {
+		return false;
+	}
+
+	// The tables hold a result for the components with range properties in
+	// the same order as the results.
+	for (c = 0; c < dataSet->componentsAvailableCount; c++) {
+		const byte componentId = dataSet->ranges[c].componentId;
+		ResultIpi* const result = &results->items[results->count++];
+		initResultFromIpAddress(result, ipAddress, type);
+		if (slot < componentsCount && componentIds[slot] == componentId) {
+			if (graphResults[slot].rawOffset != NULL_PROFILE_OFFSET) {
+				result->graphResult = graphResults[slot];
+			}
+			slot++;
+		}
+		else {
+			setResultFromIpAddress(result, dataSet, componentId, exception);
+			if (EXCEPTION_FAILED) {
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+/**
+ * Adds the results for every available component by evaluating the graph
+ * of each component in turn.
+ */
+static bool addResultsFromGraphs(
+	ResultsIpi* results,
+	const DataSetIpi* dataSet,
 	const unsigned char* ipAddress,
 	fiftyoneDegreesIpType type,
 	fiftyoneDegreesException* exception) {
-	const DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
 	for (uint32_t componentIndex = 0;
 		componentIndex < dataSet->componentsList.count;
 		componentIndex++) {
@@ -1387,29 +3220,12 @@ static bool addResultsFromIpAddressNoChecks(
 		if (!component) {
 			continue;
 		}
-		ResultIpi * const nextResult = &(results->items[results->count]);
-		results->count++;
-		resultIpiReset(nextResult);
-		// Default IP range offset
-		nextResult->graphResult = FIFTYONE_DEGREES_IPI_CG_RESULT_DEFAULT;
-		nextResult->graphResult.rawOffset = NULL_PROFILE_OFFSET; // Default IP range offset
-		nextResult->targetIpAddress.type = type;
-		nextResult->type = type;
-
-		if (type == IP_TYPE_IPV4) {
-			// We only get the exact length of ipv4
-			memset(nextResult->targetIpAddress.value, 0, IPV6_LENGTH);
-			memcpy(nextResult->targetIpAddress.value, ipAddress, IPV4_LENGTH);
-		}
-		else {
-			// We only get the exact length of ipv6
-			memcpy(nextResult->targetIpAddress.value, ipAddress, IPV6_LENGTH);
-		}
-
-		setResultFromIpAddress(
-			nextResult,
+		addResultFromIpAddress(
+			results,
 			dataSet,
 			component->componentId,
+			ipAddress,
+			type,
 			exception);
 		if (EXCEPTION_FAILED) {
 			return false;
@@ -1418,6 +3234,42 @@ static bool addResultsFromIpAddressNoChecks(
 	return true;
 }
 
+static bool addResultsFromIpAddressNoChecks(
+	ResultsIpi* results,
+	const unsigned char* ipAddress,
+	fiftyoneDegreesIpType type,
+	fiftyoneDegreesException* exception) {
+	const DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
+	if (dataSet->rangeCache != NULL &&
+		rangeCacheGet(dataSet, results, ipAddress, type, exception)) {
+		return EXCEPTION_OKAY;
+	}
+	if (addResultsFromRangeTable(
+			results,
+			dataSet,
+			ipAddress,
+			type,
+			exception) == false &&
+		addResultsFromGraphs(
+			results,
+			dataSet,
+			ipAddress,
+			type,
+			exception) == false) {
+		return false;
+	}
+	if (EXCEPTION_FAILED) {
+		return false;
+	}
+	if (dataSet->rangeCache != NULL) {
+		rangeCacheAdd(dataSet, results, ipAddress, type, exception);
+		if (EXCEPTION_FAILED) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void fiftyoneDegreesResultsIpiFromIpAddress(
 	fiftyoneDegreesResultsIpi* results,
 	const unsigned char* ipAddress,
@@ -1588,54 +3440,269 @@ void fiftyoneDegreesResultsIpiFromEvidence(
 	}
 }
 
-static bool addWeightedValue(
-	ResultsIpi* results,
-	Item* item,
-	uint16_t rawWeighting,
-	Exception* exception) {
-	Item valueItem;
-	WeightedItem weightedItem;
-	const DataSetIpi* dataSet = (DataSetIpi*)results->b.dataSet;
-	const Value* value = (Value*)item->data.ptr;
-	if (value != NULL) {
-		if (results->values.count == results->values.capacity) {
-			WeightedItemListExtend(
-				&results->values,
-				results->values.capacity
-				* FIFTYONE_DEGREES_WEIGHTED_ITEM_LIST_RESIZE_FACTOR,
-				exception);
-			if (EXCEPTION_FAILED) {
-				COLLECTION_RELEASE(dataSet->values, item);
-				return false;
-			}
-		}
-		PropertyValueType const storedValueType = PropertyGetStoredTypeByIndex(
-			dataSet->propertyTypes,
-			value->propertyIndex,
-			exception);
-		if (EXCEPTION_OKAY) {
-			DataReset(&valueItem.data);
-			const uint16_t valueRawWeight = ValueGetWeight(value);
-			const uint16_t valueWeight = valueRawWeight ? valueRawWeight : 0xFFFFU;
-			if (StoredBinaryValueGet(
-				dataSet->strings,
-				value->nameOffset,
-				storedValueType,
-				&valueItem,
-				exception) != NULL && EXCEPTION_OKAY) {
-				weightedItem.item = valueItem;
-				weightedItem.rawWeighting = ((uint32_t)rawWeighting) * (uint32_t)valueWeight;
-				WeightedItemListAdd(&results->values, &weightedItem, exception);
-			}
-		}
-	}
-	COLLECTION_RELEASE(dataSet->values, item);
-	return EXCEPTION_OKAY;
-}
+/**
+ * Batch methods
+ */
 
-static bool addWeightedValueWithState(void* state, Item* item) {
-	// The results values are a list of collection items and their weighting.
-	// The weighting cannot be passed along with Item as this is the profile
+/**
+ * Rounds the size up so that each structure within the contiguous block of
+ * memory used for a batch remains correctly aligned.
+ */
+#define BATCH_ALIGN(s) \
+(((s) + (sizeof(uint64_t) - 1)) & ~(sizeof(uint64_t) - 1))
+
+fiftyoneDegreesResultsIpiBatch* fiftyoneDegreesResultsIpiBatchCreate(
+	fiftyoneDegreesResourceManager* manager,
+	uint32_t capacity) {
+	ResultsIpiBatch* batch;
+	DataSetIpi* dataSet;
+	ResultsIpi* results;
+	byte* componentIds;
+	uint32_t i;
+
+	// Take a single reference to the active data set which is shared by all
+	// the results in the batch.
+	dataSet = (DataSetIpi*)DataSetGet(manager);
+
+	// Allocate the batch, the pointers to the results, the results and the
+	// component ids as a single block of memory.
+	const size_t headerSize = BATCH_ALIGN(
+		sizeof(ResultsIpiBatch) + sizeof(ResultsIpi*) * capacity);
+	const size_t resultsSize = BATCH_ALIGN(
+		sizeof(ResultsIpi) +
+		sizeof(ResultIpi) * dataSet->componentsAvailableCount);
+	batch = (ResultsIpiBatch*)Malloc(
+		headerSize +
+		resultsSize * capacity +
+		dataSet->componentsList.count);
+	if (batch == NULL) {
+		DataSetRelease((DataSetBase*)dataSet);
+		return NULL;
+	}
+	batch->dataSet = dataSet;
+	batch->count = 0;
+	batch->capacity = capacity;
+	batch->items = (ResultsIpi**)(batch + 1);
+
+	// Resolve the ids of the components which have properties available
+	// once for the batch rather than for every IP address.
+	componentIds = (byte*)batch + headerSize + resultsSize * capacity;
+	batch->componentIds = componentIds;
+	batch->componentIdsCount = 0;
+	for (i = 0; i < dataSet->componentsList.count; i++) {
+		const Component* const component = COMPONENT(dataSet, i);
+		if (dataSet->componentsAvailable[i] && component != NULL) {
+			componentIds[batch->componentIdsCount++] = component->componentId;
+		}
+	}
+
+	// Initialise each of the results to reference the shared data set.
+	for (i = 0; i < capacity; i++) {
+		results = (ResultsIpi*)((byte*)batch + headerSize + resultsSize * i);
+		results->items = (ResultIpi*)(results + 1);
+		results->count = 0;
+		results->capacity = dataSet->componentsAvailableCount;
+		resultsIpiInit(results, dataSet);
+		batch->items[i] = results;
+	}
+
+	return batch;
+}
+
+#undef BATCH_ALIGN
+
+void fiftyoneDegreesResultsIpiBatchFree(
+	fiftyoneDegreesResultsIpiBatch* batch) {
+	for (uint32_t i = 0; i < batch->capacity; i++) {
+		resultsIpiRelease(batch->items[i]);
+		resultsIpiFreeMembers(batch->items[i]);
+	}
+	DataSetRelease((DataSetBase*)batch->dataSet);
+	Free(batch);
+}
+
+void fiftyoneDegreesResultsIpiFromIpAddressBatch(
+	fiftyoneDegreesResultsIpiBatch* batch,
+	const fiftyoneDegreesIpAddress* ipAddresses,
+	uint32_t count,
+	fiftyoneDegreesException* exception) {
+	uint32_t i, c;
+	ResultsIpi* results;
+
+	if (count > batch->capacity) {
+		EXCEPTION_SET(INSUFFICIENT_CAPACITY);
+		return;
+	}
+
+	// Prepare the results for every IP address before any graph is
+	// evaluated. Invalid IP addresses result in empty results for that index
+	// only.
+	for (i = 0; i < count; i++) {
+		results = batch->items[i];
+		results->count = 0;
+		if (ipAddresses[i].type != IP_TYPE_IPV4 &&
+			ipAddresses[i].type != IP_TYPE_IPV6) {
+			continue;
+		}
+		for (c = 0; c < batch->componentIdsCount; c++) {
+			initResultFromIpAddress(
+				&results->items[c],
+				ipAddresses[i].value,
+				ipAddresses[i].type);
+		}
+		results->count = batch->componentIdsCount;
+	}
+	batch->count = count;
+
+	// Evaluate the batch one component graph at a time. Each evaluation runs
+	// to completion before the next IP address, as the graph evaluator does
+	// not expose its steps to interleave, so only the order changes.
+	for (c = 0; c < batch->componentIdsCount; c++) {
+		for (i = 0; i < count; i++) {
+			results = batch->items[i];
+			if (results->count == 0) {
+				continue;
+			}
+			setResultFromIpAddress(
+				&results->items[c],
+				batch->dataSet,
+				batch->componentIds[c],
+				exception);
+			if (EXCEPTION_FAILED) {
+				return;
+			}
+		}
+	}
+}
+
+const fiftyoneDegreesResultIpi* fiftyoneDegreesResultsIpiGetResultRange(
+	fiftyoneDegreesResultsIpi* results,
+	uint32_t index,
+	fiftyoneDegreesException* exception) {
+	if (index >= results->count) {
+		return NULL;
+	}
+	ResultIpi* const result = &results->items[index];
+	if (result->rangeResolved == false) {
+		resolveResultRange(results, index, exception);
+	}
+	return result;
+}
+
+bool fiftyoneDegreesResultsIpiGetRange(
+	fiftyoneDegreesResultsIpi* results,
+	fiftyoneDegreesIpAddress* start,
+	fiftyoneDegreesIpAddress* end,
+	uint32_t* rangeId,
+	fiftyoneDegreesException* exception) {
+	bool found = false;
+	IpAddress first, last;
+	if (rangeId != NULL) {
+		*rangeId = NO_RANGE_ID;
+	}
+
+	// Every result is for the same target IP address so the intersection of
+	// the known ranges always contains it.
+	for (uint32_t i = 0; i < results->count; i++) {
+		const ResultIpi* const result = ResultsIpiGetResultRange(
+			results,
+			i,
+			exception);
+		if (EXCEPTION_FAILED) {
+			return false;
+		}
+		if (result->rangeId == NO_RANGE_ID) {
+			continue;
+		}
+		const int length = result->rangeStart.type == IP_TYPE_IPV4 ?
+			IPV4_LENGTH : IPV6_LENGTH;
+		if (found == false ||
+			compareIpAddresses(
+				result->rangeStart.value,
+				first.value,
+				length) > 0) {
+			first = result->rangeStart;
+		}
+		if (found == false ||
+			compareIpAddresses(
+				result->rangeEnd.value,
+				last.value,
+				length) < 0) {
+			last = result->rangeEnd;
+		}
+		found = true;
+	}
+	if (found) {
+		*start = first;
+		*end = last;
+		if (rangeId != NULL) {
+			*rangeId = getRangeId(&first, &last);
+		}
+	}
+	return found;
+}
+
+static bool addWeightedValueToList(
+	const DataSetIpi* dataSet,
+	WeightedItemList* list,
+	Item* item,
+	uint16_t rawWeighting,
+	Exception* exception) {
+	Item valueItem;
+	WeightedItem weightedItem;
+	const Value* value = (Value*)item->data.ptr;
+	if (value != NULL) {
+		if (list->count == list->capacity) {
+			WeightedItemListExtend(
+				list,
+				list->capacity
+				* FIFTYONE_DEGREES_WEIGHTED_ITEM_LIST_RESIZE_FACTOR,
+				exception);
+			if (EXCEPTION_FAILED) {
+				COLLECTION_RELEASE(dataSet->values, item);
+				return false;
+			}
+		}
+		PropertyValueType const storedValueType = PropertyGetStoredTypeByIndex(
+			dataSet->propertyTypes,
+			value->propertyIndex,
+			exception);
+		if (EXCEPTION_OKAY) {
+			DataReset(&valueItem.data);
+			const uint16_t valueRawWeight = ValueGetWeight(value);
+			const uint16_t valueWeight = valueRawWeight ? valueRawWeight : 0xFFFFU;
+			if (StoredBinaryValueGet(
+				dataSet->strings,
+				value->nameOffset,
+				storedValueType,
+				&valueItem,
+				exception) != NULL && EXCEPTION_OKAY) {
+				weightedItem.item = valueItem;
+				weightedItem.rawWeighting = ((uint32_t)rawWeighting) * (uint32_t)valueWeight;
+				WeightedItemListAdd(list, &weightedItem, exception);
+			}
+		}
+	}
+	COLLECTION_RELEASE(dataSet->values, item);
+	return EXCEPTION_OKAY;
+}
+
+static bool addWeightedValue(
+	ResultsIpi* results,
+	Item* item,
+	uint16_t rawWeighting,
+	Exception* exception) {
+	return addWeightedValueToList(
+		(DataSetIpi*)results->b.dataSet,
+		&results->values,
+		item,
+		rawWeighting,
+		exception);
+}
+
+static bool addWeightedValueWithState(void* state, Item* item) {
+	// The results values are a list of collection items and their weighting.
+	// The weighting cannot be passed along with Item as this is the profile
 	// standard in common-cxx. Thus the weighting is passed along with the state.
 	const stateWithWeighting* weightingState = (stateWithWeighting*)((stateWithException*)state)->state;
 	ResultsIpi* results =
@@ -1649,6 +3716,105 @@ static bool addWeightedValueWithState(void* state, Item* item) {
 		exception);
 }
 
+/**
+ * Returns the column of the value index for the property, or -1 if there is
+ * no value index or the property is not required.
+ */
+static int32_t valueIndexGetColumn(
+	const IpiValueIndex* index,
+	int propertyIndex) {
+	if (index == NULL ||
+		propertyIndex < 0 ||
+		(uint32_t)propertyIndex >= index->propertiesCount) {
+		return -1;
+	}
+	return index->columns[propertyIndex];
+}
+
+/**
+ * Finds the row of the value index for the profile offset. Returns false if
+ * the profile is not in the index.
+ */
+static bool valueIndexGetRow(
+	const IpiValueIndex* index,
+	uint32_t profileOffset,
+	uint32_t* row) {
+	uint32_t lower = 0, upper = index->profilesCount;
+	while (lower < upper) {
+		const uint32_t middle = lower + (upper - lower) / 2;
+		if (index->profiles[middle].offset < profileOffset) {
+			lower = middle + 1;
+		}
+		else {
+			upper = middle;
+		}
+	}
+	if (lower < index->profilesCount &&
+		index->profiles[lower].offset == profileOffset) {
+		*row = index->profiles[lower].row;
+		return true;
+	}
+	return false;
+}
+
+/**
+ * Adds the values in the slice of the value index for the row and column to
+ * the results. Returns the number of values in the slice.
+ */
+static uint32_t addValuesFromValueIndexToList(
+	const DataSetIpi* dataSet,
+	WeightedItemList* list,
+	uint32_t row,
+	int32_t column,
+	uint16_t rawWeighting,
+	Exception* exception) {
+	Item valueItem;
+	const IpiValueIndex* const index = dataSet->valueIndex;
+	const size_t cell = (size_t)row * index->columnsCount + column;
+	const uint32_t first = index->starts[cell];
+	const uint32_t last = index->starts[cell + 1];
+	for (uint32_t i = first; i < last && EXCEPTION_OKAY; i++) {
+		DataReset(&valueItem.data);
+		const CollectionKey valueKey = {
+			index->valueIndexes[i],
+			CollectionKeyType_Value,
+		};
+		if (dataSet->values->get(
+			dataSet->values,
+			&valueKey,
+			&valueItem,
+			exception) == NULL || EXCEPTION_FAILED) {
+			break;
+		}
+
+		// The value item is released by addWeightedValueToList.
+		if (addWeightedValueToList(
+			dataSet,
+			list,
+			&valueItem,
+			rawWeighting,
+			exception) == false) {
+			break;
+		}
+	}
+	return last - first;
+}
+
+static uint32_t addValuesFromValueIndex(
+	ResultsIpi* results,
+	uint32_t row,
+	int32_t column,
+	uint16_t rawWeighting,
+	Exception* exception) {
+	return addValuesFromValueIndexToList(
+		(DataSetIpi*)results->b.dataSet,
+		&results->values,
+		row,
+		column,
+		rawWeighting,
+		exception);
+}
+
 static uint32_t addValuesFromProfile(
 	DataSetIpi* dataSet,
 	ResultsIpi* results,
@@ -1690,13 +3856,26 @@ static uint32_t addValuesFromProfile(
 static uint32_t addValuesFromSingleProfile(
 	ResultsIpi* results,
 	Property *property,
+	int32_t column,
 	uint32_t profileOffset,
 	uint16_t rawWeighting,
 	Exception* exception) {
-	uint32_t count = 0;
+	uint32_t count = 0, row;
 	Item profileItem;
 	DataSetIpi* dataSet = (DataSetIpi*)results->b.dataSet;
 
+	// Use the value index if the property is in it to avoid searching the
+	// values of the profile.
+	if (column >= 0 &&
+		valueIndexGetRow(dataSet->valueIndex, profileOffset, &row)) {
+		return addValuesFromValueIndex(
+			results,
+			row,
+			column,
+			rawWeighting,
+			exception);
+	}
+
 	// Add values from profiles
 	Profile *profile = NULL;
 	if (profileOffset != NULL_PROFILE_OFFSET) {
@@ -1731,17 +3910,65 @@ static const CollectionKeyType CollectionKeyType_OffsetPercentage = {
 	NULL,
 };
 
+/**
+ * Adds the values of each profile in the group from the profile groups table.
+ * The weights of the group were checked when the table was built.
+ */
+static uint32_t addValuesFromProfileGroupsTable(
+	ResultsIpi * const results,
+	Property * const property,
+	const int32_t column,
+	const IpiProfileGroupEntry * const first,
+	Exception * const exception) {
+	uint32_t count = 0;
+	DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
+	for (const IpiProfileGroupEntry* entry = first;
+		entry < first + first->length && EXCEPTION_OKAY;
+		entry++) {
+		if (column >= 0 && entry->valueIndexRow != UINT32_MAX) {
+			count += addValuesFromValueIndex(
+				results,
+				entry->valueIndexRow,
+				column,
+				entry->rawWeighting,
+				exception);
+		}
+		else if (entry->profile != NULL) {
+			count += addValuesFromProfile(
+				dataSet,
+				results,
+				(Profile*)entry->profile,
+				property,
+				entry->rawWeighting,
+				exception);
+		}
+	}
+	return count;
+}
+
 static uint32_t addValuesFromProfileGroup(
 	ResultsIpi * const results,
 	Property * const property,
+	const int32_t column,
 	const uint32_t profileGroupOffset,
 	Exception * const exception) {
 	uint32_t count = 0;
 	const DataSetIpi * const dataSet = (const DataSetIpi*)results->b.dataSet;
+	const IpiProfileGroupsTable * const table = dataSet->profileGroupsTable;
 
 	if (profileGroupOffset == NULL_PROFILE_OFFSET) {
 		return 0;
 	}
+	if (table != NULL &&
+		profileGroupOffset < table->count &&
+		table->entries[profileGroupOffset].length > 0) {
+		return addValuesFromProfileGroupsTable(
+			results,
+			property,
+			column,
+			&table->entries[profileGroupOffset],
+			exception);
+	}
 	Item profileGroupItem;
 	DataReset(&profileGroupItem.data);
 
@@ -1766,6 +3993,7 @@ static uint32_t addValuesFromProfileGroup(
 			count += addValuesFromSingleProfile(
 				results,
 				property,
+				column,
 				nextWeightedProfileOffset->offset,
 				nextWeightedProfileOffset->rawWeighting,
 				exception);
@@ -1843,13 +4071,29 @@ static uint32_t addValuesFromResult(
 	ResultsIpi* results,
 	ResultIpi* result,
 	Property* property,
+	int propertyIndex,
 	Exception* exception) {
 	uint32_t count = 0;
 	const DataSetIpi* const dataSet = (DataSetIpi*)results->b.dataSet;
+	const int32_t column = valueIndexGetColumn(
+		dataSet->valueIndex,
+		propertyIndex);
 
 	if (results->count > 0) {
 		if (result->graphResult.rawOffset != NULL_PROFILE_OFFSET) {
-			if (!result->graphResult.isGroupOffset) {
+			if (!result->graphResult.isGroupOffset &&
+				column >= 0 &&
+				result->graphResult.offset <
+				dataSet->valueIndex->profilesCount) {
+				// The offset of a single profile is the row of the value
+				// index so the profile offset is not needed.
+				count += addValuesFromValueIndex(
+					results,
+					result->graphResult.offset,
+					column,
+					FULL_RAW_WEIGHTING,
+					exception);
+			} else if (!result->graphResult.isGroupOffset) {
 				const uint32_t profileOffsetValue = getProfileOffset(
 					dataSet->profileOffsets,
 					result->graphResult.offset,
@@ -1859,6 +4103,7 @@ static uint32_t addValuesFromResult(
 					count += addValuesFromSingleProfile(
 						results,
 						property,
+						column,
 						profileOffsetValue,
 						FULL_RAW_WEIGHTING,
 						exception);
@@ -1867,6 +4112,7 @@ static uint32_t addValuesFromResult(
 				count += addValuesFromProfileGroup(
 					results,
 					property,
+					column,
 					result->graphResult.offset,
 					exception);
 			}
@@ -1879,10 +4125,11 @@ static WeightedItem* getValuesFromResult(
 	ResultsIpi* results,
 	ResultIpi* result,
 	Property* property,
+	int propertyIndex,
 	Exception* exception) {
 	// There is a profile available for the property requested. 
 	// Use this to add the values to the results.
-	addValuesFromResult(results, result, property, exception);
+	addValuesFromResult(results, result, property, propertyIndex, exception);
 
 	// Return the first value in the list of items.
 	return results->values.items;
@@ -1929,6 +4176,7 @@ const fiftyoneDegreesWeightedItem* fiftyoneDegreesResultsIpiGetValues(
 					results,
 					&results->items[i],
 					property,
+					(int)propertyIndex,
 					exception);
 			}
 
@@ -1954,27 +4202,45 @@ const fiftyoneDegreesWeightedItem* fiftyoneDegreesResultsIpiGetValues(
 	return firstValue;
 }
 
-static bool visitProfilePropertyValue(
-	void *state,
-	fiftyoneDegreesCollectionItem *item) {
-#	ifdef _MSC_VER
-	UNREFERENCED_PARAMETER(item);
-#	endif
-
-	*((bool *)state) = true; // found
-	return false; // break
+static bool addWeightedValueToListWithState(void* state, Item* item) {
+	const stateWithList* listState =
+		(stateWithList*)((stateWithException*)state)->state;
+	Exception* const exception = ((stateWithException*)state)->exception;
+	return addWeightedValueToList(
+		listState->dataSet,
+		listState->list,
+		item,
+		listState->rawWeighting,
+		exception);
 }
 
-static bool profileHasValidPropertyValue(
-	const DataSetIpi * const dataSet,
-	const uint32_t profileOffset,
-	Property * const property,
-	Exception * const exception) {
+/**
+ * Adds the values of a single profile to the list of every property. Either
+ * the profile or its offset must be provided, and the row of the value index
+ * if already known. The profile is only fetched if there is a property that
+ * can't be read from the value index.
+ */
+static void addValuesFromProfileForProperties(
+	propertiesValues* state,
+	uint32_t profileOffset,
+	const Profile* profile,
+	uint32_t row,
+	uint16_t rawWeighting,
+	Exception* exception) {
 	Item profileItem;
-	Profile *profile = NULL;
-	bool valueFound = false;
-
-	if (profileOffset != NULL_PROFILE_OFFSET) {
+	stateWithList listState;
+	stateWithException callbackState;
+	bool fetched = false;
+	const DataSetIpi* const dataSet = state->dataSet;
+
+	if (row == UINT32_MAX &&
+		dataSet->valueIndex != NULL &&
+		profileOffset != NULL_PROFILE_OFFSET) {
+		valueIndexGetRow(dataSet->valueIndex, profileOffset, &row);
+	}
+	if (profile == NULL &&
+		(row == UINT32_MAX || state->allIndexed == false) &&
+		profileOffset != NULL_PROFILE_OFFSET) {
 		DataReset(&profileItem.data);
 		const CollectionKey profileKey = {
 			profileOffset,
@@ -1985,40 +4251,369 @@ static bool profileHasValidPropertyValue(
 			&profileKey,
 			&profileItem,
 			exception);
-		// If profile is found
-		if (profile != NULL && EXCEPTION_OKAY) {
+		if (profile == NULL || EXCEPTION_FAILED) {
+			return;
+		}
+		fetched = true;
+	}
+
+	listState.dataSet = dataSet;
+	listState.rawWeighting = rawWeighting;
+	callbackState.state = &listState;
+	callbackState.exception = exception;
+	for (uint32_t i = 0; i < state->count && EXCEPTION_OKAY; i++) {
+		propertyValues* const item = &state->items[i];
+		if (item->property == NULL) {
+			continue;
+		}
+		if (item->column >= 0 && row != UINT32_MAX) {
+			addValuesFromValueIndexToList(
+				dataSet,
+				item->list,
+				row,
+				item->column,
+				rawWeighting,
+				exception);
+		}
+		else if (profile != NULL) {
+			listState.list = item->list;
 			ProfileIterateValuesForProperty(
 				dataSet->values,
-				profile,
-				property,
-				&valueFound,
-				visitProfilePropertyValue,
+				(Profile*)profile,
+				item->property,
+				&callbackState,
+				addWeightedValueToListWithState,
 				exception);
-			COLLECTION_RELEASE(dataSet->profiles, &profileItem);
 		}
 	}
-	return valueFound;
+	if (fetched) {
+		COLLECTION_RELEASE(dataSet->profiles, &profileItem);
+	}
 }
 
-static bool resultGetHasValidPropertyValueOffset(
-	fiftyoneDegreesResultsIpi* const results,
-	const fiftyoneDegreesResultIpi* const result,
-	const int requiredPropertyIndex,
-	fiftyoneDegreesException* const exception) {
-	bool hasValidOffset = false;
-	Item item;
-	DataReset(&item.data);
-	const DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
-
-	// Work out the property index from the required property index.
-	const int32_t propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
-		dataSet->b.b.available,
-		requiredPropertyIndex);
+static void addValuesFromProfileGroupForProperties(
+	propertiesValues* state,
+	uint32_t profileGroupOffset,
+	Exception* exception) {
+	const DataSetIpi* const dataSet = state->dataSet;
+	const IpiProfileGroupsTable* const table = dataSet->profileGroupsTable;
 
-	if (propertyIndex >= 0) {
-		// Set the property that will be available in the results structure.
-		// This may also be needed to work out which of a selection of results
-		// are used to obtain the values.
+	if (profileGroupOffset == NULL_PROFILE_OFFSET) {
+		return;
+	}
+	if (table != NULL &&
+		profileGroupOffset < table->count &&
+		table->entries[profileGroupOffset].length > 0) {
+		const IpiProfileGroupEntry* const first =
+			&table->entries[profileGroupOffset];
+		for (const IpiProfileGroupEntry* entry = first;
+			entry < first + first->length && EXCEPTION_OKAY;
+			entry++) {
+			addValuesFromProfileForProperties(
+				state,
+				NULL_PROFILE_OFFSET,
+				entry->profile,
+				entry->valueIndexRow,
+				entry->rawWeighting,
+				exception);
+		}
+		return;
+	}
+	Item profileGroupItem;
+	DataReset(&profileGroupItem.data);
+
+	const Collection* const profileGroups = dataSet->profileGroups;
+	for (uint32_t totalWeight = 0, nextOffset = profileGroupOffset;
+		(totalWeight < FULL_RAW_WEIGHTING) && EXCEPTION_OKAY;
+		++nextOffset) {
+		const CollectionKey profileGroupKey = {
+			nextOffset,
+			&CollectionKeyType_OffsetPercentage,
+		};
+		const offsetPercentage* const nextWeightedProfileOffset =
+			(const offsetPercentage*)profileGroups->get(
+				profileGroups,
+				&profileGroupKey,
+				&profileGroupItem,
+				exception);
+		if (!(nextWeightedProfileOffset && EXCEPTION_OKAY)) {
+			break;
+		}
+		totalWeight += nextWeightedProfileOffset->rawWeighting;
+		if (totalWeight <= FULL_RAW_WEIGHTING) {
+			addValuesFromProfileForProperties(
+				state,
+				nextWeightedProfileOffset->offset,
+				NULL,
+				UINT32_MAX,
+				nextWeightedProfileOffset->rawWeighting,
+				exception);
+		} else {
+			EXCEPTION_SET(FIFTYONE_DEGREES_STATUS_CORRUPT_DATA);
+		}
+		COLLECTION_RELEASE(dataSet->profileGroups, &profileGroupItem);
+	}
+}
+
+static void addValuesFromResultForProperties(
+	propertiesValues* state,
+	const ResultIpi* result,
+	Exception* exception) {
+	uint32_t row = UINT32_MAX, profileOffset = NULL_PROFILE_OFFSET;
+	const DataSetIpi* const dataSet = state->dataSet;
+	const fiftyoneDegreesIpiCgResult* const graphResult = &result->graphResult;
+
+	if (graphResult->rawOffset == NULL_PROFILE_OFFSET) {
+		return;
+	}
+	if (graphResult->isGroupOffset) {
+		addValuesFromProfileGroupForProperties(
+			state,
+			graphResult->offset,
+			exception);
+		return;
+	}
+
+	// The offset of a single profile is the row of the value index so the
+	// profile offset is only needed if a property is not in the index.
+	if (dataSet->valueIndex != NULL &&
+		graphResult->offset < dataSet->valueIndex->profilesCount) {
+		row = graphResult->offset;
+	}
+	if (row == UINT32_MAX || state->allIndexed == false) {
+		profileOffset = getProfileOffset(
+			dataSet->profileOffsets,
+			graphResult->offset,
+			exception);
+		if (EXCEPTION_FAILED) {
+			return;
+		}
+	}
+	addValuesFromProfileForProperties(
+		state,
+		profileOffset,
+		NULL,
+		row,
+		FULL_RAW_WEIGHTING,
+		exception);
+}
+
+/**
+ * Adds the default value of the property to the list if the property is
+ * mandatory and no values were found.
+ */
+static void addDefaultValueToList(
+	const DataSetIpi* dataSet,
+	const propertyValues* item,
+	Exception* exception) {
+	Item valueItem;
+	if (item->property == NULL ||
+		item->list->count > 0 ||
+		item->property->defaultValueIndex == UINT32_MAX ||
+		item->property->isMandatory == false) {
+		return;
+	}
+	DataReset(&valueItem.data);
+	const CollectionKey valueKey = {
+		item->property->defaultValueIndex,
+		CollectionKeyType_Value,
+	};
+	if (dataSet->values->get(
+		dataSet->values,
+		&valueKey,
+		&valueItem,
+		exception) != NULL &&
+		EXCEPTION_OKAY) {
+
+		// The value item is released by addWeightedValueToList.
+		addWeightedValueToList(
+			dataSet,
+			item->list,
+			&valueItem,
+			FULL_RAW_WEIGHTING,
+			exception);
+	}
+}
+
+void fiftyoneDegreesResultsIpiGetValuesForProperties(
+	fiftyoneDegreesResultsIpi* const results,
+	const int* const requiredPropertyIndexes,
+	uint32_t const requiredPropertyIndexesLength,
+	fiftyoneDegreesWeightedItemList* const lists,
+	fiftyoneDegreesException* const exception) {
+	uint32_t i;
+	propertiesValues state;
+	const DataSetIpi* const dataSet = (DataSetIpi*)results->b.dataSet;
+
+	for (i = 0; i < requiredPropertyIndexesLength; i++) {
+		WeightedItemListRelease(&lists[i]);
+	}
+	if (requiredPropertyIndexesLength == 0) {
+		return;
+	}
+	state.dataSet = dataSet;
+	state.count = requiredPropertyIndexesLength;
+	state.allIndexed = dataSet->valueIndex != NULL;
+
+	// The state is held by the results so that it is only allocated when
+	// more properties are requested than before.
+	state.items = (propertyValues*)DataMalloc(
+		&results->properties.state,
+		sizeof(propertyValues) * requiredPropertyIndexesLength);
+	if (state.items == NULL) {
+		EXCEPTION_SET(INSUFFICIENT_MEMORY);
+		return;
+	}
+	for (i = 0; i < state.count; i++) {
+		DataReset(&state.items[i].propertyItem.data);
+		state.items[i].property = NULL;
+		state.items[i].column = -1;
+		state.items[i].list = &lists[i];
+	}
+
+	// Get each property once rather than once for every profile.
+	for (i = 0; i < state.count && EXCEPTION_OKAY; i++) {
+		propertyValues* const item = &state.items[i];
+		const int propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
+			dataSet->b.b.available,
+			requiredPropertyIndexes[i]);
+		if (propertyIndex >= 0) {
+			item->property = PropertyGet(
+				dataSet->properties,
+				propertyIndex,
+				&item->propertyItem,
+				exception);
+			item->column = valueIndexGetColumn(
+				dataSet->valueIndex,
+				propertyIndex);
+			if (item->property != NULL && item->column < 0) {
+				state.allIndexed = false;
+			}
+		}
+	}
+
+	// Visit each profile of each result once, adding the values for all the
+	// properties.
+	for (i = 0; i < results->count && EXCEPTION_OKAY; i++) {
+		addValuesFromResultForProperties(
+			&state,
+			&results->items[i],
+			exception);
+	}
+	for (i = 0; i < state.count && EXCEPTION_OKAY; i++) {
+		addDefaultValueToList(dataSet, &state.items[i], exception);
+	}
+
+	for (i = 0; i < state.count; i++) {
+		if (state.items[i].property != NULL) {
+			COLLECTION_RELEASE(
+				dataSet->properties,
+				&state.items[i].propertyItem);
+		}
+	}
+}
+
+fiftyoneDegreesWeightedItemList* fiftyoneDegreesResultsIpiGetPropertiesLists(
+	fiftyoneDegreesResultsIpi* const results,
+	uint32_t const count,
+	fiftyoneDegreesException* const exception) {
+	ResultsIpiProperties* const properties = &results->properties;
+	if (count > properties->listsCount) {
+		WeightedItemList* const lists = (WeightedItemList*)Malloc(
+			sizeof(WeightedItemList) * count);
+		if (lists == NULL) {
+			EXCEPTION_SET(INSUFFICIENT_MEMORY);
+			return NULL;
+		}
+
+		// Keep the lists which have already been sized by earlier calls.
+		if (properties->lists != NULL) {
+			memcpy(
+				lists,
+				properties->lists,
+				sizeof(WeightedItemList) * properties->listsCount);
+			Free(properties->lists);
+		}
+		for (uint32_t i = properties->listsCount; i < count; i++) {
+			WeightedItemListInit(
+				&lists[i],
+				1,
+				FIFTYONE_DEGREES_WEIGHTED_ITEM_LIST_DEFAULT_LOAD_FACTOR);
+		}
+		properties->lists = lists;
+		properties->listsCount = count;
+	}
+	for (uint32_t i = 0; i < count; i++) {
+		WeightedItemListRelease(&properties->lists[i]);
+	}
+	return properties->lists;
+}
+
+static bool visitProfilePropertyValue(
+	void *state,
+	fiftyoneDegreesCollectionItem *item) {
+#	ifdef _MSC_VER
+	UNREFERENCED_PARAMETER(item);
+#	endif
+
+	*((bool *)state) = true; // found
+	return false; // break
+}
+
+static bool profileHasValidPropertyValue(
+	const DataSetIpi * const dataSet,
+	const uint32_t profileOffset,
+	Property * const property,
+	Exception * const exception) {
+	Item profileItem;
+	Profile *profile = NULL;
+	bool valueFound = false;
+
+	if (profileOffset != NULL_PROFILE_OFFSET) {
+		DataReset(&profileItem.data);
+		const CollectionKey profileKey = {
+			profileOffset,
+			CollectionKeyType_Profile,
+		};
+		profile = (Profile*)dataSet->profiles->get(
+			dataSet->profiles,
+			&profileKey,
+			&profileItem,
+			exception);
+		// If profile is found
+		if (profile != NULL && EXCEPTION_OKAY) {
+			ProfileIterateValuesForProperty(
+				dataSet->values,
+				profile,
+				property,
+				&valueFound,
+				visitProfilePropertyValue,
+				exception);
+			COLLECTION_RELEASE(dataSet->profiles, &profileItem);
+		}
+	}
+	return valueFound;
+}
+
+static bool resultGetHasValidPropertyValueOffset(
+	fiftyoneDegreesResultsIpi* const results,
+	const fiftyoneDegreesResultIpi* const result,
+	const int requiredPropertyIndex,
+	fiftyoneDegreesException* const exception) {
+	bool hasValidOffset = false;
+	Item item;
+	DataReset(&item.data);
+	const DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
+
+	// Work out the property index from the required property index.
+	const int32_t propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
+		dataSet->b.b.available,
+		requiredPropertyIndex);
+
+	if (propertyIndex >= 0) {
+		// Set the property that will be available in the results structure.
+		// This may also be needed to work out which of a selection of results
+		// are used to obtain the values.
 		Property * const property = PropertyGet(
 			dataSet->properties,
 			propertyIndex,
@@ -2172,6 +4767,40 @@ fiftyoneDegreesResultsNoValueReason fiftyoneDegreesResultsIpiGetNoValueReason(
 	return FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_UNKNOWN;
 }
 
+const fiftyoneDegreesWeightedItem* fiftyoneDegreesResultsIpiGetValuesWithReason(
+	fiftyoneDegreesResultsIpi* results,
+	int requiredPropertyIndex,
+	fiftyoneDegreesResultsNoValueReason* reason,
+	fiftyoneDegreesException* exception) {
+	const DataSetIpi *dataSet = (DataSetIpi*)results->b.dataSet;
+	*reason = FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_UNKNOWN;
+
+	if (requiredPropertyIndex < 0 ||
+		requiredPropertyIndex >= (int)dataSet->b.b.available->count) {
+		// Ensure any previous uses of the results to get values are released.
+		resultsIpiRelease(results);
+		*reason = FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_INVALID_PROPERTY;
+		return NULL;
+	}
+
+	if (results->count == 0) {
+		resultsIpiRelease(results);
+		*reason = FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_NO_RESULTS;
+		return NULL;
+	}
+
+	// Getting the values includes the default value of a mandatory property
+	// so if there are none then no profile had a value for the property.
+	const WeightedItem* firstValue = ResultsIpiGetValues(
+		results,
+		requiredPropertyIndex,
+		exception);
+	if (firstValue == NULL && EXCEPTION_OKAY) {
+		*reason = FIFTYONE_DEGREES_RESULTS_NO_VALUE_REASON_NULL_PROFILE;
+	}
+	return firstValue;
+}
+
 const char* fiftyoneDegreesResultsIpiGetNoValueReasonMessage(
 	fiftyoneDegreesResultsNoValueReason reason) {
 	switch (reason) {
@@ -2355,54 +4984,1917 @@ size_t fiftyoneDegreesResultsIpiGetValuesStringByRequiredPropertyIndex(
 	return builder.added;
 }
 
-/*
- * Supporting Macros to printout the NetworkId
- */
-#define PRINT_PROFILE_SEP(d,b,s,f) printProfileSeparator(&d, (b - d) + s, f)
-#define PRINT_PROFILE_ID(d,b,s,f,v,p) printProfileId(&d, (b - d) + s, f, v, p)
-#define PRINT_NULL_PROFILE_ID(d,b,s,p) PRINT_PROFILE_ID(d, b, s, "%i:%f", 0, p)
-
-size_t fiftyoneDegreesIpiGetIpAddressAsString(
-	const fiftyoneDegreesCollectionItem * const item,
-	const fiftyoneDegreesIpType type,
-	char * const buffer,
-	const uint32_t bufferLength,
-	fiftyoneDegreesException * const exception) {
+size_t fiftyoneDegreesResultsIpiGetValuesJson(
+	fiftyoneDegreesResultsIpi* results,
+	char* buffer,
+	size_t bufferLength,
+	fiftyoneDegreesException* exception) {
 
 	StringBuilder builder = { buffer, bufferLength };
 	StringBuilderInit(&builder);
 
-	StringBuilderAddIpAddress(
+	fiftyoneDegreesResultsIpiRenderAll(
+		results,
+		FIFTYONE_DEGREES_IPI_RENDER_FORMAT_JSON,
 		&builder,
-		(const VarLengthByteArray *)item->data.ptr,
-		type,
 		exception);
 
+	StringBuilderComplete(&builder);
+
 	return builder.added;
 }
 
-uint32_t fiftyoneDegreesIpiIterateProfilesForPropertyAndValue(
-	fiftyoneDegreesResourceManager* manager,
-	const char* propertyName,
-	const char* valueName,
-	void* state,
-	fiftyoneDegreesProfileIterateMethod callback,
-	fiftyoneDegreesException* exception) {
-	uint32_t count = 0;
-	DataSetIpi* dataSet = DataSetIpiGet(manager);
-	count = ProfileIterateProfilesForPropertyWithTypeAndValueAndOffsetExtractor(
-		dataSet->strings,
-		dataSet->properties,
-		dataSet->propertyTypes,
-		dataSet->values,
-		dataSet->profiles,
-		dataSet->profileOffsets,
-		ProfileOffsetAsPureOffset,
-		propertyName,
-		valueName,
-		state,
-		callback,
-		exception);
-	DataSetIpiRelease(dataSet);
-	return count;
+/**
+ * Adds the characters to the builder escaping any which can not appear in a
+ * JSON string.
+ */
+static void renderJsonChars(
+	StringBuilder* const builder,
+	const char* const chars,
+	const size_t length) {
+	static const char hex[] = "0123456789abcdef";
+	for (size_t i = 0; i < length; i++) {
+		const unsigned char c = (unsigned char)chars[i];
+		if (c == '"' || c == '\\') {
+			StringBuilderAddChar(builder, '\\');
+			StringBuilderAddChar(builder, (char)c);
+		}
+		else if (c < 0x20) {
+			StringBuilderAddChars(builder, "\\u00", 4);
+			StringBuilderAddChar(builder, hex[c >> 4]);
+			StringBuilderAddChar(builder, hex[c & 0x0F]);
+		}
+		else {
+			StringBuilderAddChar(builder, (char)c);
+		}
+	}
+}
+
+/**
+ * Adds the characters to the builder doubling any quotes so they can appear
+ * in a quoted CSV field.
+ */
+static void renderCsvChars(
+	StringBuilder* const builder,
+	const char* const chars,
+	const size_t length) {
+	for (size_t i = 0; i < length; i++) {
+		if (chars[i] == '"') {
+			StringBuilderAddChar(builder, '"');
+		}
+		StringBuilderAddChar(builder, chars[i]);
+	}
+}
+
+/**
+ * Adds the weight to the builder rounded to the number of decimal places
+ * without trailing zeros. The weight is formatted with integer arithmetic
+ * from the raw weighting which avoids converting a double to characters.
+ */
+static void renderWeight(
+	StringBuilder* const builder,
+	const uint32_t rawWeighting,
+	const uint8_t decimalPlaces) {
+	char digits[20];
+	uint64_t scale = 1;
+	uint8_t places = decimalPlaces > 9 ? 9 : decimalPlaces;
+	for (uint8_t i = 0; i < places; i++) {
+		scale *= 10;
+	}
+	const uint64_t max = FIFTYONE_DEGREES_WEIGHTED_ITEM_MAX_WEIGHT;
+	const uint64_t scaled = ((uint64_t)rawWeighting * scale + max / 2) / max;
+	uint64_t fraction = scaled % scale;
+
+	// Add the integer part.
+	uint64_t integer = scaled / scale;
+	int count = 0;
+	do {
+		digits[count++] = (char)('0' + integer % 10);
+		integer /= 10;
+	} while (integer > 0);
+	while (count > 0) {
+		StringBuilderAddChar(builder, digits[--count]);
+	}
+
+	// Add the fraction without the trailing zeros.
+	if (fraction > 0) {
+		while (fraction % 10 == 0) {
+			fraction /= 10;
+			places--;
+		}
+		StringBuilderAddChar(builder, '.');
+		for (count = places; count > 0; count--) {
+			digits[count - 1] = (char)('0' + fraction % 10);
+			fraction /= 10;
+		}
+		StringBuilderAddChars(builder, digits, places);
+	}
+}
+
+/**
+ * Adds the value to the builder as a WKT point if it is a 2D point stored as
+ * WKB or reduced WKB. The ordinates are read directly from the bytes and
+ * formatted in the same way as the common WKT converter, without it having
+ * to walk the geometry.
+ * @return true if the value was a point and has been added, otherwise false
+ */
+static bool renderPoint(
+	StringBuilder* const builder,
+	const StoredBinaryValue* const binaryValue,
+	const PropertyValueType storedValueType) {
+	IpiCoordinate coordinate;
+	if ((storedValueType != FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB &&
+		storedValueType != FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB_R) ||
+		IpiGetCoordinate(binaryValue, storedValueType, &coordinate) == false ||
+		isfinite(coordinate.lon) == false ||
+		isfinite(coordinate.lat) == false) {
+		return false;
+	}
+	StringBuilderAddChars(builder, "POINT(", 6);
+	StringBuilderAddDouble(builder, coordinate.lon, DefaultWktDecimalPlaces);
+	StringBuilderAddChar(builder, ' ');
+	StringBuilderAddDouble(builder, coordinate.lat, DefaultWktDecimalPlaces);
+	StringBuilderAddChar(builder, ')');
+	return true;
+}
+
+/**
+ * Adds the value to the builder. Strings are the only stored type which can
+ * contain characters that need escaping, so they are escaped from the stored
+ * value as they are added. Points are formatted from their ordinates and
+ * other types are formatted directly.
+ */
+static void renderValue(
+	StringBuilder* const builder,
+	const IpiRenderFormat format,
+	const StoredBinaryValue* const binaryValue,
+	const PropertyValueType storedValueType,
+	Exception* const exception) {
+	if (storedValueType == FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING &&
+		format != FIFTYONE_DEGREES_IPI_RENDER_FORMAT_PIPE) {
+		const String* const string = (const String*)binaryValue;
+		const char* const chars = &string->value;
+		size_t length = string->size > 0 ? (size_t)string->size : 0;
+
+		// Strip the null terminator.
+		if (length > 0 && chars[length - 1] == '\0') {
+			length--;
+		}
+		if (format == FIFTYONE_DEGREES_IPI_RENDER_FORMAT_JSON) {
+			renderJsonChars(builder, chars, length);
+		}
+		else {
+			renderCsvChars(builder, chars, length);
+		}
+	}
+	else if (renderPoint(builder, binaryValue, storedValueType) == false) {
+		StringBuilderAddStringValue(
+			builder,
+			binaryValue,
+			storedValueType,
+			DefaultWktDecimalPlaces,
+			exception);
+	}
+}
+
+/**
+ * Adds the values of a property to the builder in the format provided.
+ */
+static void renderValues(
+	StringBuilder* const builder,
+	const IpiRenderFormat format,
+	const WeightedItem* const weightedItems,
+	const uint32_t count,
+	const PropertyValueType storedValueType,
+	Exception* const exception) {
+	for (uint32_t i = 0; i < count && EXCEPTION_OKAY; i++) {
+		const StoredBinaryValue* const binaryValue =
+			(const StoredBinaryValue*)weightedItems[i].item.data.ptr;
+		switch (format) {
+		case FIFTYONE_DEGREES_IPI_RENDER_FORMAT_JSON:
+			if (i) {
+				StringBuilderAddChar(builder, ',');
+			}
+			StringBuilderAddChars(builder, "{\"value\":\"", 10);
+			renderValue(
+				builder,
+				format,
+				binaryValue,
+				storedValueType,
+				exception);
+			StringBuilderAddChars(builder, "\",\"weight\":", 11);
+			renderWeight(
+				builder,
+				weightedItems[i].rawWeighting,
+				DefaultWktDecimalPlaces);
+			StringBuilderAddChar(builder, '}');
+			break;
+		case FIFTYONE_DEGREES_IPI_RENDER_FORMAT_CSV:
+			if (i) {
+				StringBuilderAddChar(builder, '|');
+			}
+			renderValue(
+				builder,
+				format,
+				binaryValue,
+				storedValueType,
+				exception);
+			StringBuilderAddChar(builder, ':');
+			renderWeight(
+				builder,
+				weightedItems[i].rawWeighting,
+				DefaultWktDecimalPlaces);
+			break;
+		case FIFTYONE_DEGREES_IPI_RENDER_FORMAT_PIPE:
+		default:
+			if (i) {
+				StringBuilderAddChar(builder, ',');
+			}
+			StringBuilderAddChar(builder, '"');
+			renderValue(
+				builder,
+				format,
+				binaryValue,
+				storedValueType,
+				exception);
+			StringBuilderAddChar(builder, '"');
+			StringBuilderAddChar(builder, ':');
+			StringBuilderAddDouble(
+				builder,
+				(double)weightedItems[i].rawWeighting /
+				(double)FIFTYONE_DEGREES_WEIGHTED_ITEM_MAX_WEIGHT,
+				DefaultWktDecimalPlaces);
+			break;
+		}
+	}
+}
+
+void fiftyoneDegreesResultsIpiRenderAll(
+	fiftyoneDegreesResultsIpi* results,
+	fiftyoneDegreesIpiRenderFormat format,
+	fiftyoneDegreesStringBuilder* builder,
+	fiftyoneDegreesException* exception) {
+	const DataSetIpi* const dataSet = (DataSetIpi*)results->b.dataSet;
+	const IpiRenderProperties* const properties = dataSet->renderProperties;
+	const uint32_t count = properties == NULL ? 0 : properties->count;
+
+	if (format == FIFTYONE_DEGREES_IPI_RENDER_FORMAT_JSON) {
+		StringBuilderAddChar(builder, '{');
+	}
+	for (uint32_t i = 0; i < count && EXCEPTION_OKAY; i++) {
+		const IpiRenderProperty* const property = &properties->items[i];
+
+		// Add the separator and the name of the property if the format has
+		// one.
+		switch (format) {
+		case FIFTYONE_DEGREES_IPI_RENDER_FORMAT_JSON:
+			if (i) {
+				StringBuilderAddChar(builder, ',');
+			}
+			StringBuilderAddChars(
+				builder,
+				property->names[format],
+				property->namesLength[format]);
+			break;
+		case FIFTYONE_DEGREES_IPI_RENDER_FORMAT_CSV:
+			if (i) {
+				StringBuilderAddChar(builder, ',');
+			}
+			StringBuilderAddChar(builder, '"');
+			break;
+		case FIFTYONE_DEGREES_IPI_RENDER_FORMAT_PIPE:
+		default:
+			if (i) {
+				StringBuilderAddChar(builder, '|');
+			}
+			StringBuilderAddChars(
+				builder,
+				property->names[FIFTYONE_DEGREES_IPI_RENDER_FORMAT_PIPE],
+				property->namesLength[FIFTYONE_DEGREES_IPI_RENDER_FORMAT_PIPE]);
+			break;
+		}
+
+		// Add the values. A property without values is left empty.
+		const WeightedItem* const weightedItems =
+			fiftyoneDegreesResultsIpiGetValues(
+				results,
+				(int)i,
+				exception);
+		if (weightedItems != NULL && EXCEPTION_OKAY) {
+			renderValues(
+				builder,
+				format,
+				weightedItems,
+				results->values.count,
+				property->storedValueType,
+				exception);
+		}
+
+		// Close the values.
+		switch (format) {
+		case FIFTYONE_DEGREES_IPI_RENDER_FORMAT_JSON:
+			StringBuilderAddChar(builder, ']');
+			break;
+		case FIFTYONE_DEGREES_IPI_RENDER_FORMAT_CSV:
+			StringBuilderAddChar(builder, '"');
+			break;
+		case FIFTYONE_DEGREES_IPI_RENDER_FORMAT_PIPE:
+		default:
+			break;
+		}
+	}
+	if (format == FIFTYONE_DEGREES_IPI_RENDER_FORMAT_JSON) {
+		StringBuilderAddChar(builder, '}');
+	}
+}
+
+void fiftyoneDegreesResultsIpiRenderHeader(
+	fiftyoneDegreesResultsIpi* results,
+	fiftyoneDegreesIpiRenderFormat format,
+	fiftyoneDegreesStringBuilder* builder) {
+	const DataSetIpi* const dataSet = (DataSetIpi*)results->b.dataSet;
+	const IpiRenderProperties* const properties = dataSet->renderProperties;
+	if (format != FIFTYONE_DEGREES_IPI_RENDER_FORMAT_CSV ||
+		properties == NULL) {
+		return;
+	}
+	for (uint32_t i = 0; i < properties->count; i++) {
+		if (i) {
+			StringBuilderAddChar(builder, ',');
+		}
+		StringBuilderAddChars(
+			builder,
+			properties->items[i].names[format],
+			properties->items[i].namesLength[format]);
+	}
+}
+
+/*
+ * Supporting Macros to printout the NetworkId
+ */
+#define PRINT_PROFILE_SEP(d,b,s,f) printProfileSeparator(&d, (b - d) + s, f)
+#define PRINT_PROFILE_ID(d,b,s,f,v,p) printProfileId(&d, (b - d) + s, f, v, p)
+#define PRINT_NULL_PROFILE_ID(d,b,s,p) PRINT_PROFILE_ID(d, b, s, "%i:%f", 0, p)
+
+size_t fiftyoneDegreesIpiGetIpAddressAsString(
+	const fiftyoneDegreesCollectionItem * const item,
+	const fiftyoneDegreesIpType type,
+	char * const buffer,
+	const uint32_t bufferLength,
+	fiftyoneDegreesException * const exception) {
+
+	StringBuilder builder = { buffer, bufferLength };
+	StringBuilderInit(&builder);
+
+	StringBuilderAddIpAddress(
+		&builder,
+		(const VarLengthByteArray *)item->data.ptr,
+		type,
+		exception);
+
+	return builder.added;
+}
+
+fiftyoneDegreesIpiIpKey fiftyoneDegreesIpiIpKeyFromIpAddress(
+	const fiftyoneDegreesIpAddress* const ipAddress) {
+	return getIpKey(
+		ipAddress->value,
+		ipAddress->type == IP_TYPE_IPV4 ? IPV4_LENGTH : IPV6_LENGTH);
+}
+
+int fiftyoneDegreesIpiIpKeyCompare(
+	const fiftyoneDegreesIpiIpKey* const key1,
+	const fiftyoneDegreesIpiIpKey* const key2) {
+	return compareIpKeys(key1, key2);
+}
+
+uint32_t fiftyoneDegreesIpiIterateProfilesForPropertyAndValue(
+	fiftyoneDegreesResourceManager* manager,
+	const char* propertyName,
+	const char* valueName,
+	void* state,
+	fiftyoneDegreesProfileIterateMethod callback,
+	fiftyoneDegreesException* exception) {
+	uint32_t count = 0;
+	DataSetIpi* dataSet = DataSetIpiGet(manager);
+	count = ProfileIterateProfilesForPropertyWithTypeAndValueAndOffsetExtractor(
+		dataSet->strings,
+		dataSet->properties,
+		dataSet->propertyTypes,
+		dataSet->values,
+		dataSet->profiles,
+		dataSet->profileOffsets,
+		ProfileOffsetAsPureOffset,
+		propertyName,
+		valueName,
+		state,
+		callback,
+		exception);
+	DataSetIpiRelease(dataSet);
+	return count;
+}
+
+/**
+ * IP RANGE METHODS
+ */
+
+/**
+ * Increments the IP address by one. Returns false if the address was the
+ * last one of its type and has wrapped around to the first.
+ */
+static bool ipAddressIncrement(byte* value, int length) {
+	for (int i = length - 1; i >= 0; i--) {
+		if (++value[i] != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void rangeWalkerFree(rangeWalker* walker) {
+	for (uint32_t c = 0; c < walker->componentsCount; c++) {
+		COLLECTION_RELEASE(
+			walker->dataSet->properties,
+			&walker->propertyItems[c]);
+	}
+	if (walker->results != NULL) {
+		resultsIpiFreeMembers(walker->results);
+		Free(walker->results);
+	}
+	if (walker->properties != NULL) {
+		Free(walker->properties);
+	}
+	if (walker->propertyItems != NULL) {
+		Free(walker->propertyItems);
+	}
+	if (walker->propertyIndexes != NULL) {
+		Free(walker->propertyIndexes);
+	}
+	if (walker->componentIds != NULL) {
+		Free(walker->componentIds);
+	}
+	if (walker->current != NULL) {
+		Free(walker->current);
+	}
+	if (walker->ends != NULL) {
+		Free(walker->ends);
+	}
+}
+
+/**
+ * Initialises the walker for the data set with the IpRangeEnd property of
+ * every component which has range properties. If no component has them
+ * then the components count is left zero and the ranges can not be walked.
+ */
+static StatusCode rangeWalkerInit(
+	const DataSetIpi* dataSet,
+	rangeWalker* walker,
+	Exception* exception) {
+	uint32_t i, c;
+	memset(walker, 0, sizeof(rangeWalker));
+	walker->dataSet = dataSet;
+	const uint32_t count = dataSet->rangesAvailableCount;
+	if (count == 0) {
+		return SUCCESS;
+	}
+	walker->properties = (Property**)Malloc(sizeof(Property*) * count);
+	walker->propertyItems = (Item*)Malloc(sizeof(Item) * count);
+	walker->propertyIndexes = (int*)Malloc(sizeof(int) * count);
+	walker->componentIds = (byte*)Malloc(count);
+	walker->current = (fiftyoneDegreesIpiCgResult*)Malloc(
+		sizeof(fiftyoneDegreesIpiCgResult) * count);
+	walker->ends = (IpAddress*)Malloc(sizeof(IpAddress) * count);
+
+	// Results used to read the IpRangeEnd values for each range.
+	FIFTYONE_DEGREES_ARRAY_CREATE(ResultIpi, walker->results, 1);
+	if (walker->results != NULL) {
+		resultsIpiInit(walker->results, dataSet);
+	}
+	if (walker->properties == NULL ||
+		walker->propertyItems == NULL ||
+		walker->propertyIndexes == NULL ||
+		walker->componentIds == NULL ||
+		walker->current == NULL ||
+		walker->ends == NULL ||
+		walker->results == NULL) {
+		return INSUFFICIENT_MEMORY;
+	}
+
+	// Get the IpRangeEnd property of each component in the order of the
+	// results. The count only includes properties which are held.
+	for (i = 0; i < dataSet->componentsAvailableCount; i++) {
+		const IpiRangeProperties* const range = &dataSet->ranges[i];
+		if (range->endIndex < 0) {
+			continue;
+		}
+		c = walker->componentsCount;
+		DataReset(&walker->propertyItems[c].data);
+		walker->properties[c] = PropertyGet(
+			dataSet->properties,
+			range->endIndex,
+			&walker->propertyItems[c],
+			exception);
+		if (walker->properties[c] == NULL || EXCEPTION_FAILED) {
+			return COLLECTION_FAILURE;
+		}
+		walker->propertyIndexes[c] = range->endIndex;
+		walker->componentIds[c] = range->componentId;
+		walker->componentsCount++;
+	}
+	return SUCCESS;
+}
+
+/**
+ * Evaluates the graph of the component at the start address and finds the
+ * last IP address of the component's range from the IpRangeEnd values of the
+ * profile, or profiles, returned. Where a profile group is returned the
+ * lowest end is used. The graph is evaluated at the last IP address to check
+ * the result is the same. Returns false if no range end is available for
+ * the address or the check fails.
+ */
+static bool rangeWalkerNextRange(
+	rangeWalker* walker,
+	uint32_t c,
+	const IpAddress* start,
+	Exception* exception) {
+	ResultsIpi* const results = walker->results;
+	ResultIpi* const result = &results->items[0];
+	const int length = start->type == IP_TYPE_IPV4 ? IPV4_LENGTH : IPV6_LENGTH;
+	initResultFromIpAddress(result, start->value, start->type);
+	results->count = 1;
+	result->graphResult = fiftyoneDegreesIpiGraphEvaluate(
+		walker->dataSet->graphsArray,
+		walker->componentIds[c],
+		result->targetIpAddress,
+		exception);
+	if (EXCEPTION_FAILED) {
+		return false;
+	}
+	walker->current[c] = result->graphResult;
+	if (getIpAddressBound(
+			results,
+			result,
+			walker->properties[c],
+			walker->propertyIndexes[c],
+			false,
+			&walker->ends[c],
+			exception) == false ||
+		compareIpAddresses(walker->ends[c].value, start->value, length) < 0) {
+		return false;
+	}
+	const fiftyoneDegreesIpiCgResult last = fiftyoneDegreesIpiGraphEvaluate(
+		walker->dataSet->graphsArray,
+		walker->componentIds[c],
+		walker->ends[c],
+		exception);
+	return EXCEPTION_OKAY && last.rawOffset == walker->current[c].rawOffset;
+}
+
+/**
+ * Walks the address space of the IP type one range at a time from the first
+ * address calling the method with the results for every component with range
+ * properties. Each component's own ranges are followed and a range ends at
+ * the first boundary of any of them, so the result for every component is
+ * the same for all the addresses within a range. Returns true if every range
+ * was visited, otherwise false if a component's range could not be found.
+ */
+static bool rangeWalkerIterate(
+	rangeWalker* walker,
+	IpType type,
+	void* state,
+	rangeWalkerMethod method,
+	Exception* exception) {
+	uint32_t c;
+	IpAddress start, end;
+	const int length = type == IP_TYPE_IPV4 ? IPV4_LENGTH : IPV6_LENGTH;
+	memset(start.value, 0, IPV6_LENGTH);
+	start.type = type;
+	for (c = 0; c < walker->componentsCount; c++) {
+		if (rangeWalkerNextRange(walker, c, &start, exception) == false) {
+			return false;
+		}
+	}
+	while (true) {
+
+		// The range ends where the first of the component ranges ends.
+		end = walker->ends[0];
+		for (c = 1; c < walker->componentsCount; c++) {
+			if (compareIpAddresses(
+				walker->ends[c].value,
+				end.value,
+				length) < 0) {
+				end = walker->ends[c];
+			}
+		}
+		if (method(state, &start, &end, walker->current) == false) {
+			return false;
+		}
+		start = end;
+		if (ipAddressIncrement(start.value, length) == false) {
+			return true;
+		}
+
+		// Move the components whose range has ended on to their next range.
+		for (c = 0; c < walker->componentsCount; c++) {
+			if (compareIpAddresses(
+					walker->ends[c].value,
+					end.value,
+					length) == 0 &&
+				rangeWalkerNextRange(walker, c, &start, exception) == false) {
+				return false;
+			}
+		}
+	}
+}
+
+/**
+ * IPV4 TABLE METHODS
+ */
+
+/**
+ * Number of ranges the IPv4 table arrays are initially sized for. The arrays
+ * double in size whenever they become full.
+ */
+#define IPV4_TABLE_INITIAL_CAPACITY 4096
+
+/**
+ * Number of entries in the IPv4 table directory. One for each 16 bit prefix
+ * followed by one which bounds the search for the last prefix.
+ */
+#define IPV4_TABLE_DIRECTORY_COUNT 0x10001
+
+/**
+ * Adds a range to the table, or extends the previous range if the results
+ * for every component are the same. Returns false if there was insufficient
+ * memory to add the range.
+ */
+static bool ipv4TableAddRange(
+	void* state,
+	const IpAddress* start,
+	const IpAddress* end,
+	const fiftyoneDegreesIpiCgResult* results) {
+	uint32_t c;
+	ipv4TableBuilder* const builder = (ipv4TableBuilder*)state;
+	IpiIpv4Table* const table = builder->table;
+	const uint32_t componentsCount = table->componentsCount;
+#	ifdef _MSC_VER
+	UNREFERENCED_PARAMETER(end);
+#	endif
+	if (table->count > 0) {
+		const fiftyoneDegreesIpiCgResult* const previous =
+			&table->results[(size_t)(table->count - 1) * componentsCount];
+		for (c = 0; c < componentsCount; c++) {
+			if (previous[c].rawOffset != results[c].rawOffset) {
+				break;
+			}
+		}
+		if (c == componentsCount) {
+			return true;
+		}
+	}
+	if (table->count == builder->capacity) {
+		const uint32_t newCapacity = builder->capacity * 2;
+		uint32_t* const starts = (uint32_t*)Malloc(
+			sizeof(uint32_t) * newCapacity);
+		fiftyoneDegreesIpiCgResult* const newResults =
+			(fiftyoneDegreesIpiCgResult*)Malloc(
+				sizeof(fiftyoneDegreesIpiCgResult) *
+				newCapacity *
+				componentsCount);
+		if (starts == NULL || newResults == NULL) {
+			if (starts != NULL) {
+				Free(starts);
+			}
+			if (newResults != NULL) {
+				Free(newResults);
+			}
+			builder->status = INSUFFICIENT_MEMORY;
+			return false;
+		}
+		memcpy(starts, table->starts, sizeof(uint32_t) * table->count);
+		memcpy(
+			newResults,
+			table->results,
+			sizeof(fiftyoneDegreesIpiCgResult) *
+			table->count *
+			componentsCount);
+		Free(table->starts);
+		Free(table->results);
+		table->starts = starts;
+		table->results = newResults;
+		builder->capacity = newCapacity;
+	}
+	table->starts[table->count] = getIpv4AsInteger(start->value);
+	memcpy(
+		&table->results[(size_t)table->count * componentsCount],
+		results,
+		sizeof(fiftyoneDegreesIpiCgResult) * componentsCount);
+	table->count++;
+	return true;
+}
+
+static void ipv4TableInitDirectory(IpiIpv4Table* table) {
+	uint32_t prefix, index = 0;
+	for (prefix = 0; prefix < IPV4_TABLE_DIRECTORY_COUNT - 1; prefix++) {
+		while (index + 1 < table->count &&
+			table->starts[index + 1] <= prefix << 16) {
+			index++;
+		}
+		table->directory[prefix] = index;
+	}
+	table->directory[IPV4_TABLE_DIRECTORY_COUNT - 1] = table->count - 1;
+}
+
+static StatusCode initIpv4Table(
+	DataSetIpi* dataSet,
+	rangeWalker* walker,
+	Exception* exception) {
+	ipv4TableBuilder builder;
+	IpiIpv4Table* table;
+
+	// Allocate the table along with the ids of the components it contains
+	// results for, and the initial arrays of ranges.
+	table = (IpiIpv4Table*)Malloc(
+		sizeof(IpiIpv4Table) + walker->componentsCount);
+	if (table == NULL) {
+		return INSUFFICIENT_MEMORY;
+	}
+	memcpy((byte*)(table + 1), walker->componentIds, walker->componentsCount);
+	table->componentIds = (byte*)(table + 1);
+	table->componentsCount = walker->componentsCount;
+	table->count = 0;
+	table->directory = (uint32_t*)Malloc(
+		sizeof(uint32_t) * IPV4_TABLE_DIRECTORY_COUNT);
+	table->starts = (uint32_t*)Malloc(
+		sizeof(uint32_t) * IPV4_TABLE_INITIAL_CAPACITY);
+	table->results = (fiftyoneDegreesIpiCgResult*)Malloc(
+		sizeof(fiftyoneDegreesIpiCgResult) *
+		IPV4_TABLE_INITIAL_CAPACITY *
+		walker->componentsCount);
+	builder.table = table;
+	builder.capacity = IPV4_TABLE_INITIAL_CAPACITY;
+	builder.status = SUCCESS;
+
+	if (table->directory == NULL ||
+		table->starts == NULL ||
+		table->results == NULL) {
+		builder.status = INSUFFICIENT_MEMORY;
+	}
+	else if (rangeWalkerIterate(
+		walker,
+		IP_TYPE_IPV4,
+		&builder,
+		ipv4TableAddRange,
+		exception)) {
+		ipv4TableInitDirectory(table);
+		dataSet->ipv4Table = table;
+	}
+	else if (builder.status == SUCCESS && EXCEPTION_OKAY) {
+
+		// The ranges of a component could not be followed.
+		builder.status = CORRUPT_DATA;
+	}
+
+	// Free the table if it could not be built.
+	if (dataSet->ipv4Table == NULL) {
+		if (table->directory != NULL) {
+			Free(table->directory);
+		}
+		if (table->starts != NULL) {
+			Free(table->starts);
+		}
+		if (table->results != NULL) {
+			Free(table->results);
+		}
+		Free(table);
+	}
+	return builder.status;
+}
+
+#undef IPV4_TABLE_INITIAL_CAPACITY
+#undef IPV4_TABLE_DIRECTORY_COUNT
+
+/**
+ * IPV6 TABLE METHODS
+ */
+
+/**
+ * Number of ranges the IPv6 table arrays are initially sized for. The arrays
+ * double in size whenever they become full.
+ */
+#define IPV6_TABLE_INITIAL_CAPACITY 4096
+
+/**
+ * Number of entries in the IPv6 table directory. One for each 16 bit prefix
+ * followed by one which bounds the search for the last prefix.
+ */
+#define IPV6_TABLE_DIRECTORY_COUNT 0x10001
+
+/**
+ * Adds a range to the table, or extends the previous range if the results
+ * for every component are the same. Works in the same way as
+ * ipv4TableAddRange.
+ */
+static bool ipv6TableAddRange(
+	void* state,
+	const IpAddress* start,
+	const IpAddress* end,
+	const fiftyoneDegreesIpiCgResult* results) {
+	uint32_t c;
+	ipv6TableBuilder* const builder = (ipv6TableBuilder*)state;
+	IpiIpv6Table* const table = builder->table;
+	const uint32_t componentsCount = table->componentsCount;
+#	ifdef _MSC_VER
+	UNREFERENCED_PARAMETER(end);
+#	endif
+	if (table->count > 0) {
+		const fiftyoneDegreesIpiCgResult* const previous =
+			&table->results[(size_t)(table->count - 1) * componentsCount];
+		for (c = 0; c < componentsCount; c++) {
+			if (previous[c].rawOffset != results[c].rawOffset) {
+				break;
+			}
+		}
+		if (c == componentsCount) {
+			return true;
+		}
+	}
+	if (table->count == builder->capacity) {
+		const uint32_t newCapacity = builder->capacity * 2;
+		IpiIpKey* const starts = (IpiIpKey*)Malloc(
+			sizeof(IpiIpKey) * newCapacity);
+		fiftyoneDegreesIpiCgResult* const newResults =
+			(fiftyoneDegreesIpiCgResult*)Malloc(
+				sizeof(fiftyoneDegreesIpiCgResult) *
+				newCapacity *
+				componentsCount);
+		if (starts == NULL || newResults == NULL) {
+			if (starts != NULL) {
+				Free(starts);
+			}
+			if (newResults != NULL) {
+				Free(newResults);
+			}
+			builder->status = INSUFFICIENT_MEMORY;
+			return false;
+		}
+		memcpy(starts, table->starts, sizeof(IpiIpKey) * table->count);
+		memcpy(
+			newResults,
+			table->results,
+			sizeof(fiftyoneDegreesIpiCgResult) *
+			table->count *
+			componentsCount);
+		Free(table->starts);
+		Free(table->results);
+		table->starts = starts;
+		table->results = newResults;
+		builder->capacity = newCapacity;
+	}
+	table->starts[table->count] = getIpKey(start->value, IPV6_LENGTH);
+	memcpy(
+		&table->results[(size_t)table->count * componentsCount],
+		results,
+		sizeof(fiftyoneDegreesIpiCgResult) * componentsCount);
+	table->count++;
+	return true;
+}
+
+static void ipv6TableInitDirectory(IpiIpv6Table* table) {
+	uint32_t prefix, index = 0;
+	for (prefix = 0; prefix < IPV6_TABLE_DIRECTORY_COUNT - 1; prefix++) {
+		const uint64_t first = (uint64_t)prefix << 48;
+		while (index + 1 < table->count &&
+			(table->starts[index + 1].upper < first ||
+			(table->starts[index + 1].upper == first &&
+			table->starts[index + 1].lower == 0))) {
+			index++;
+		}
+		table->directory[prefix] = index;
+	}
+	table->directory[IPV6_TABLE_DIRECTORY_COUNT - 1] = table->count - 1;
+}
+
+static StatusCode initIpv6Table(
+	DataSetIpi* dataSet,
+	rangeWalker* walker,
+	Exception* exception) {
+	ipv6TableBuilder builder;
+	IpiIpv6Table* table;
+
+	// Allocate the table along with the ids of the components it contains
+	// results for, and the initial arrays of ranges.
+	table = (IpiIpv6Table*)Malloc(
+		sizeof(IpiIpv6Table) + walker->componentsCount);
+	if (table == NULL) {
+		return INSUFFICIENT_MEMORY;
+	}
+	memcpy((byte*)(table + 1), walker->componentIds, walker->componentsCount);
+	table->componentIds = (byte*)(table + 1);
+	table->componentsCount = walker->componentsCount;
+	table->count = 0;
+	table->directory = (uint32_t*)Malloc(
+		sizeof(uint32_t) * IPV6_TABLE_DIRECTORY_COUNT);
+	table->starts = (IpiIpKey*)Malloc(
+		sizeof(IpiIpKey) * IPV6_TABLE_INITIAL_CAPACITY);
+	table->results = (fiftyoneDegreesIpiCgResult*)Malloc(
+		sizeof(fiftyoneDegreesIpiCgResult) *
+		IPV6_TABLE_INITIAL_CAPACITY *
+		walker->componentsCount);
+	builder.table = table;
+	builder.capacity = IPV6_TABLE_INITIAL_CAPACITY;
+	builder.status = SUCCESS;
+
+	if (table->directory == NULL ||
+		table->starts == NULL ||
+		table->results == NULL) {
+		builder.status = INSUFFICIENT_MEMORY;
+	}
+	else if (rangeWalkerIterate(
+		walker,
+		IP_TYPE_IPV6,
+		&builder,
+		ipv6TableAddRange,
+		exception)) {
+		ipv6TableInitDirectory(table);
+		dataSet->ipv6Table = table;
+	}
+	else if (builder.status == SUCCESS && EXCEPTION_OKAY) {
+
+		// The ranges of a component could not be followed.
+		builder.status = CORRUPT_DATA;
+	}
+
+	// Free the table if it could not be built.
+	if (dataSet->ipv6Table == NULL) {
+		if (table->directory != NULL) {
+			Free(table->directory);
+		}
+		if (table->starts != NULL) {
+			Free(table->starts);
+		}
+		if (table->results != NULL) {
+			Free(table->results);
+		}
+		Free(table);
+	}
+	return builder.status;
+}
+
+#undef IPV6_TABLE_INITIAL_CAPACITY
+#undef IPV6_TABLE_DIRECTORY_COUNT
+
+/**
+ * IPV6 PREFIX INDEX METHODS
+ */
+
+/**
+ * Number of entries the IPv6 prefix index of each component is initially
+ * sized for. The entries double in size whenever they become full.
+ */
+#define IPV6_INDEX_INITIAL_CAPACITY 256
+
+/**
+ * Returns true if the address is the first address of its prefix.
+ */
+static bool ipv6IndexIsPrefixStart(const byte* value, byte prefixBits) {
+	const uint64_t mask = prefixBits == 64 ? 0 : UINT64_MAX >> prefixBits;
+	for (int i = 8; i < IPV6_LENGTH; i++) {
+		if (value[i] != 0) {
+			return false;
+		}
+	}
+	return (getIpv6Upper(value) & mask) == 0;
+}
+
+/**
+ * Returns true if the address is the last address of its prefix.
+ */
+static bool ipv6IndexIsPrefixEnd(const byte* value, byte prefixBits) {
+	const uint64_t mask = prefixBits == 64 ? 0 : UINT64_MAX >> prefixBits;
+	for (int i = 8; i < IPV6_LENGTH; i++) {
+		if (value[i] != 0xFF) {
+			return false;
+		}
+	}
+	return (getIpv6Upper(value) & mask) == mask;
+}
+
+static bool ipv6IndexPush(
+	IpiIpv6PrefixIndex* index,
+	ipv6IndexSegment* segment,
+	uint64_t start,
+	bool uniform,
+	const fiftyoneDegreesIpiCgResult* result) {
+	if (index->count == segment->capacity) {
+		const uint32_t newCapacity = segment->capacity * 2;
+		IpiIpv6PrefixEntry* const entries = (IpiIpv6PrefixEntry*)Malloc(
+			sizeof(IpiIpv6PrefixEntry) * newCapacity);
+		if (entries == NULL) {
+			return false;
+		}
+		memcpy(
+			entries,
+			index->entries,
+			sizeof(IpiIpv6PrefixEntry) * index->count);
+		Free(index->entries);
+		index->entries = entries;
+		segment->capacity = newCapacity;
+	}
+	IpiIpv6PrefixEntry* const entry = &index->entries[index->count++];
+	entry->start = start;
+	entry->uniform = uniform;
+	entry->result = *result;
+	return true;
+}
+
+/**
+ * Adds the prefixes from first to last inclusive to the index. Prefixes are
+ * uniform if every address within them has the same result. A prefix which
+ * is shared with the previous segment is never uniform. Consecutive
+ * prefixes with the same result, or which are all not uniform, are merged
+ * into a single entry. Returns false if there was insufficient memory.
+ */
+static bool ipv6IndexAddPrefixes(
+	IpiIpv6PrefixIndex* index,
+	ipv6IndexSegment* segment,
+	uint64_t first,
+	uint64_t last,
+	bool uniform) {
+	IpiIpv6PrefixEntry* entry =
+		index->count > 0 ? &index->entries[index->count - 1] : NULL;
+	if (entry != NULL && first == segment->lastPrefix) {
+		if (entry->uniform) {
+			if (entry->start == first) {
+				entry->uniform = false;
+				if (index->count > 1 &&
+					index->entries[index->count - 2].uniform == false) {
+					index->count--;
+				}
+			}
+			else if (ipv6IndexPush(
+				index,
+				segment,
+				first,
+				false,
+				&segment->result) == false) {
+				return false;
+			}
+		}
+		if (first == last) {
+			return true;
+		}
+		first++;
+		entry = &index->entries[index->count - 1];
+	}
+	segment->lastPrefix = last;
+	if (entry != NULL &&
+		entry->uniform == uniform &&
+		(uniform == false ||
+		entry->result.rawOffset == segment->result.rawOffset)) {
+		return true;
+	}
+	return ipv6IndexPush(index, segment, first, uniform, &segment->result);
+}
+
+/**
+ * Adds the prefixes covered by the segment of addresses which share the
+ * same result for the component to the index.
+ */
+static bool ipv6IndexAddSegment(
+	IpiIpv6PrefixIndex* index,
+	ipv6IndexSegment* segment,
+	byte prefixBits) {
+	const uint64_t first = getIpv6Prefix(segment->start.value, prefixBits);
+	const uint64_t last = getIpv6Prefix(segment->end.value, prefixBits);
+	const bool startsPrefix = ipv6IndexIsPrefixStart(
+		segment->start.value,
+		prefixBits);
+	const bool endsPrefix = ipv6IndexIsPrefixEnd(
+		segment->end.value,
+		prefixBits);
+	if (first == last) {
+		return ipv6IndexAddPrefixes(
+			index,
+			segment,
+			first,
+			first,
+			startsPrefix && endsPrefix);
+	}
+	return ipv6IndexAddPrefixes(index, segment, first, first, startsPrefix) &&
+		(last - first < 2 || ipv6IndexAddPrefixes(
+			index,
+			segment,
+			first + 1,
+			last - 1,
+			true)) &&
+		ipv6IndexAddPrefixes(index, segment, last, last, endsPrefix);
+}
+
+/**
+ * Extends the current segment of each component with the range, or adds the
+ * segment to the component's index and starts a new one if the result for
+ * the component has changed.
+ */
+static bool ipv6IndexAddRange(
+	void* state,
+	const IpAddress* start,
+	const IpAddress* end,
+	const fiftyoneDegreesIpiCgResult* results) {
+	ipv6IndexBuilder* const builder = (ipv6IndexBuilder*)state;
+	IpiIpv6Index* const index = builder->index;
+	for (uint32_t c = 0; c < index->componentsCount; c++) {
+		ipv6IndexSegment* const segment = &builder->segments[c];
+		if (builder->started &&
+			segment->result.rawOffset == results[c].rawOffset) {
+			segment->end = *end;
+			continue;
+		}
+		if (builder->started && ipv6IndexAddSegment(
+			&index->components[c],
+			segment,
+			index->prefixBits) == false) {
+			builder->status = INSUFFICIENT_MEMORY;
+			return false;
+		}
+		segment->start = *start;
+		segment->end = *end;
+		segment->result = results[c];
+	}
+	builder->started = true;
+	return true;
+}
+
+static void freeIpv6Index(IpiIpv6Index* index) {
+	for (uint32_t c = 0; c < index->componentsCount; c++) {
+		if (index->components[c].entries != NULL) {
+			Free(index->components[c].entries);
+		}
+	}
+	Free(index);
+}
+
+static StatusCode initIpv6Index(
+	DataSetIpi* dataSet,
+	rangeWalker* walker,
+	Exception* exception) {
+	uint32_t c;
+	ipv6IndexBuilder builder;
+	IpiIpv6Index* index;
+
+	// Allocate the index with the prefix index for each component.
+	index = (IpiIpv6Index*)Malloc(
+		sizeof(IpiIpv6Index) +
+		sizeof(IpiIpv6PrefixIndex) * walker->componentsCount);
+	if (index == NULL) {
+		return INSUFFICIENT_MEMORY;
+	}
+	index->prefixBits = dataSet->config.ipv6PrefixBits > 64 ?
+		64 : dataSet->config.ipv6PrefixBits;
+	index->componentsCount = walker->componentsCount;
+	index->components = (IpiIpv6PrefixIndex*)(index + 1);
+	builder.index = index;
+	builder.started = false;
+	builder.status = SUCCESS;
+	builder.segments = (ipv6IndexSegment*)Malloc(
+		sizeof(ipv6IndexSegment) * walker->componentsCount);
+	for (c = 0; c < walker->componentsCount; c++) {
+		index->components[c].componentId = walker->componentIds[c];
+		index->components[c].count = 0;
+		index->components[c].entries = (IpiIpv6PrefixEntry*)Malloc(
+			sizeof(IpiIpv6PrefixEntry) * IPV6_INDEX_INITIAL_CAPACITY);
+		if (index->components[c].entries == NULL) {
+			builder.status = INSUFFICIENT_MEMORY;
+		}
+		if (builder.segments != NULL) {
+			builder.segments[c].capacity = IPV6_INDEX_INITIAL_CAPACITY;
+			builder.segments[c].lastPrefix = 0;
+		}
+	}
+
+	if (builder.segments == NULL || builder.status != SUCCESS) {
+		builder.status = INSUFFICIENT_MEMORY;
+	}
+	else if (rangeWalkerIterate(
+		walker,
+		IP_TYPE_IPV6,
+		&builder,
+		ipv6IndexAddRange,
+		exception)) {
+
+		// Add the last segment of each component which runs to the end of
+		// the address space.
+		for (c = 0; c < index->componentsCount; c++) {
+			if (ipv6IndexAddSegment(
+				&index->components[c],
+				&builder.segments[c],
+				index->prefixBits) == false) {
+				builder.status = INSUFFICIENT_MEMORY;
+				break;
+			}
+		}
+		if (builder.status == SUCCESS) {
+			dataSet->ipv6Index = index;
+		}
+	}
+	else if (builder.status == SUCCESS && EXCEPTION_OKAY) {
+
+		// The ranges of a component could not be followed.
+		builder.status = CORRUPT_DATA;
+	}
+
+	// Free the index if it could not be built.
+	if (builder.segments != NULL) {
+		Free(builder.segments);
+	}
+	if (dataSet->ipv6Index == NULL) {
+		freeIpv6Index(index);
+	}
+	return builder.status;
+}
+
+#undef IPV6_INDEX_INITIAL_CAPACITY
+
+/**
+ * Method which builds one of the flattened tables or the IPv6 prefix index
+ * from the ranges found by the walker.
+ */
+typedef StatusCode(*rangeIndexInit)(
+	DataSetIpi* dataSet,
+	rangeWalker* walker,
+	Exception* exception);
+
+/**
+ * Builds one of the flattened IPv4 and IPv6 tables or the IPv6 prefix index.
+ * They are only built when the data set is in memory as where collections are
+ * read from file the graph evaluation is not the dominant cost of a lookup.
+ * If no component has the range properties needed to build them the graphs
+ * are always evaluated. If the ranges of a component can not be followed
+ * CORRUPT_DATA is returned rather than quietly falling back to the graphs.
+ * Each uses a walker of its own so that they can be built in parallel.
+ */
+static StatusCode initRangeIndex(
+	DataSetIpi* dataSet,
+	rangeIndexInit init,
+	Exception* exception) {
+	rangeWalker walker;
+	StatusCode status;
+	if (dataSet->b.b.isInMemory == false ||
+		dataSet->componentsAvailableCount == 0) {
+		return SUCCESS;
+	}
+	status = rangeWalkerInit(dataSet, &walker, exception);
+	if (status == SUCCESS && walker.componentsCount > 0) {
+		status = init(dataSet, &walker, exception);
+	}
+	rangeWalkerFree(&walker);
+
+	// A failure evaluating the graphs is not recoverable.
+	if (status == SUCCESS && EXCEPTION_FAILED) {
+		status = COLLECTION_FAILURE;
+	}
+	return status;
+}
+
+static StatusCode initIpv4TableIfEnabled(
+	DataSetIpi* dataSet,
+	Exception* exception) {
+	return dataSet->config.ipv4Table ?
+		initRangeIndex(dataSet, initIpv4Table, exception) :
+		SUCCESS;
+}
+
+static StatusCode initIpv6TableIfEnabled(
+	DataSetIpi* dataSet,
+	Exception* exception) {
+	return dataSet->config.ipv6Table ?
+		initRangeIndex(dataSet, initIpv6Table, exception) :
+		SUCCESS;
+}
+
+static StatusCode initIpv6IndexIfEnabled(
+	DataSetIpi* dataSet,
+	Exception* exception) {
+	return dataSet->config.ipv6PrefixBits > 0 ?
+		initRangeIndex(dataSet, initIpv6Index, exception) :
+		SUCCESS;
+}
+
+/**
+ * VALUE INDEX METHODS
+ */
+
+static int compareValueIndexProfiles(const void* a, const void* b) {
+	const uint32_t x = ((const IpiValueIndexProfile*)a)->offset;
+	const uint32_t y = ((const IpiValueIndexProfile*)b)->offset;
+	return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * Returns the position of the first of the profile's value indexes which is
+ * not lower than the target. The value indexes of a profile are in
+ * ascending order.
+ */
+static uint32_t profileValuesLowerBound(
+	const uint32_t* values,
+	uint32_t count,
+	uint32_t target) {
+	uint32_t lower = 0, upper = count;
+	while (lower < upper) {
+		const uint32_t middle = lower + (upper - lower) / 2;
+		if (values[middle] < target) {
+			lower = middle + 1;
+		}
+		else {
+			upper = middle;
+		}
+	}
+	return lower;
+}
+
+/**
+ * Finds the value indexes of every profile for each required property. The
+ * first pass records the number of value indexes for each row and column in
+ * the following entry of starts. The second pass copies the value indexes to
+ * the position in starts. ranges contains the first and last value index of
+ * the property for each column, or -1 if the property has no values.
+ */
+static StatusCode valueIndexAddProfiles(
+	DataSetIpi* dataSet,
+	IpiValueIndex* index,
+	const int32_t* ranges,
+	bool copy,
+	Exception* exception) {
+	uint32_t row, column;
+	Item profileItem;
+	for (row = 0; row < index->profilesCount; row++) {
+		const uint32_t profileOffset = getProfileOffset(
+			dataSet->profileOffsets,
+			row,
+			exception);
+		if (EXCEPTION_FAILED) {
+			return COLLECTION_FAILURE;
+		}
+		index->profiles[row].offset = profileOffset;
+		index->profiles[row].row = row;
+		uint32_t* const starts = index->starts +
+			(size_t)row * index->columnsCount;
+		if (profileOffset == NULL_PROFILE_OFFSET) {
+			if (copy == false) {
+				memset(starts + 1, 0, sizeof(uint32_t) * index->columnsCount);
+			}
+			continue;
+		}
+		DataReset(&profileItem.data);
+		const CollectionKey profileKey = {
+			profileOffset,
+			CollectionKeyType_Profile,
+		};
+		const Profile* const profile = (const Profile*)dataSet->profiles->get(
+			dataSet->profiles,
+			&profileKey,
+			&profileItem,
+			exception);
+		if (profile == NULL || EXCEPTION_FAILED) {
+			return COLLECTION_FAILURE;
+		}
+		const uint32_t* const values = (const uint32_t*)(profile + 1);
+		for (column = 0; column < index->columnsCount; column++) {
+			uint32_t first = 0, last = 0;
+			if (ranges[column * 2] >= 0) {
+				first = profileValuesLowerBound(
+					values,
+					profile->valueCount,
+					(uint32_t)ranges[column * 2]);
+				last = first;
+				while (last < profile->valueCount &&
+					values[last] <= (uint32_t)ranges[column * 2 + 1]) {
+					last++;
+				}
+			}
+			if (copy) {
+				memcpy(
+					index->valueIndexes + starts[column],
+					values + first,
+					sizeof(uint32_t) * (last - first));
+			}
+			else {
+				starts[column + 1] = last - first;
+			}
+		}
+		COLLECTION_RELEASE(dataSet->profiles, &profileItem);
+	}
+	return SUCCESS;
+}
+
+/**
+ * Sets the column of each required property and the first and last value
+ * index of the property for the column in ranges.
+ */
+static StatusCode valueIndexSetColumns(
+	DataSetIpi* dataSet,
+	IpiValueIndex* index,
+	int32_t* ranges,
+	Exception* exception) {
+	uint32_t i;
+	Item propertyItem;
+	for (i = 0; i < index->propertiesCount; i++) {
+		index->columns[i] = -1;
+	}
+	for (i = 0; i < index->columnsCount; i++) {
+		const int propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
+			dataSet->b.b.available,
+			(int)i);
+		ranges[i * 2] = -1;
+		ranges[i * 2 + 1] = -1;
+		if (propertyIndex < 0 ||
+			(uint32_t)propertyIndex >= index->propertiesCount) {
+			continue;
+		}
+		DataReset(&propertyItem.data);
+		const Property* const property = PropertyGet(
+			dataSet->properties,
+			propertyIndex,
+			&propertyItem,
+			exception);
+		if (property == NULL || EXCEPTION_FAILED) {
+			return COLLECTION_FAILURE;
+		}
+		index->columns[propertyIndex] = (int32_t)i;
+		if (property->firstValueIndex >= 0 &&
+			property->lastValueIndex >= property->firstValueIndex) {
+			ranges[i * 2] = property->firstValueIndex;
+			ranges[i * 2 + 1] = property->lastValueIndex;
+		}
+		COLLECTION_RELEASE(dataSet->properties, &propertyItem);
+	}
+	return SUCCESS;
+}
+
+/**
+ * Builds the index of the values of the required properties for every
+ * profile if enabled in the configuration. Only in memory data sets are
+ * indexed as the profiles and values are already loaded. The index uses
+ * four bytes for every profile and required property in addition to the
+ * value indexes.
+ */
+static StatusCode initValueIndex(DataSetIpi* dataSet, Exception* exception) {
+	StatusCode status;
+	const PropertiesAvailable* const available = dataSet->b.b.available;
+	if (dataSet->config.valueIndex == false ||
+		dataSet->b.b.isInMemory == false ||
+		available->count == 0) {
+		return SUCCESS;
+	}
+	IpiValueIndex* const index = (IpiValueIndex*)Malloc(sizeof(IpiValueIndex));
+	if (index == NULL) {
+		return INSUFFICIENT_MEMORY;
+	}
+	index->profilesCount = dataSet->profileOffsets->count;
+	index->columnsCount = available->count;
+	index->propertiesCount = dataSet->properties->count;
+	const size_t cells = (size_t)index->profilesCount * index->columnsCount;
+	index->columns = (int32_t*)Malloc(
+		sizeof(int32_t) * index->propertiesCount);
+	index->profiles = (IpiValueIndexProfile*)Malloc(
+		sizeof(IpiValueIndexProfile) * index->profilesCount);
+	index->starts = (uint32_t*)Malloc(sizeof(uint32_t) * (cells + 1));
+	index->valueIndexes = NULL;
+	int32_t* const ranges = (int32_t*)Malloc(
+		sizeof(int32_t) * 2 * index->columnsCount);
+	if (index->columns == NULL ||
+		index->profiles == NULL ||
+		index->starts == NULL ||
+		ranges == NULL) {
+		status = INSUFFICIENT_MEMORY;
+	}
+	else {
+		status = valueIndexSetColumns(dataSet, index, ranges, exception);
+	}
+
+	// Count the value indexes for each row and column, then convert the
+	// counts to the start of each slice and copy the value indexes.
+	if (status == SUCCESS) {
+		index->starts[0] = 0;
+		status = valueIndexAddProfiles(
+			dataSet,
+			index,
+			ranges,
+			false,
+			exception);
+	}
+	if (status == SUCCESS) {
+		for (size_t i = 1; i <= cells; i++) {
+			index->starts[i] += index->starts[i - 1];
+		}
+		if (index->starts[cells] > 0) {
+			index->valueIndexes = (uint32_t*)Malloc(
+				sizeof(uint32_t) * index->starts[cells]);
+			if (index->valueIndexes == NULL) {
+				status = INSUFFICIENT_MEMORY;
+			}
+		}
+	}
+	if (status == SUCCESS) {
+		status = valueIndexAddProfiles(
+			dataSet,
+			index,
+			ranges,
+			true,
+			exception);
+	}
+	if (ranges != NULL) {
+		Free(ranges);
+	}
+	if (status != SUCCESS) {
+		freeValueIndex(index);
+		return status;
+	}
+
+	// Order the profiles by offset so the row of a profile in a profile
+	// group can be found with a binary search.
+	qsort(
+		index->profiles,
+		index->profilesCount,
+		sizeof(IpiValueIndexProfile),
+		compareValueIndexProfiles);
+	dataSet->valueIndex = index;
+	return SUCCESS;
+}
+
+/**
+ * PROFILE GROUPS TABLE METHODS
+ */
+
+/**
+ * Sets the profile, value index row and weight of the entry from the record
+ * in the profile groups collection.
+ */
+static StatusCode profileGroupsTableSetEntry(
+	DataSetIpi* dataSet,
+	IpiProfileGroupEntry* entry,
+	uint32_t index,
+	Exception* exception) {
+	Item item;
+	DataReset(&item.data);
+	const CollectionKey profileGroupKey = {
+		index,
+		&CollectionKeyType_OffsetPercentage,
+	};
+	const offsetPercentage* const record =
+		(const offsetPercentage*)dataSet->profileGroups->get(
+			dataSet->profileGroups,
+			&profileGroupKey,
+			&item,
+			exception);
+	if (record == NULL || EXCEPTION_FAILED) {
+		return COLLECTION_FAILURE;
+	}
+	const uint32_t profileOffset = record->offset;
+	entry->rawWeighting = record->rawWeighting;
+	entry->length = 0;
+	entry->profile = NULL;
+	entry->valueIndexRow = UINT32_MAX;
+	COLLECTION_RELEASE(dataSet->profileGroups, &item);
+	if (profileOffset == NULL_PROFILE_OFFSET) {
+		return SUCCESS;
+	}
+
+	// The data set is in memory so the profile remains valid for as long as
+	// the data set.
+	DataReset(&item.data);
+	const CollectionKey profileKey = {
+		profileOffset,
+		CollectionKeyType_Profile,
+	};
+	entry->profile = (const Profile*)dataSet->profiles->get(
+		dataSet->profiles,
+		&profileKey,
+		&item,
+		exception);
+	if (entry->profile == NULL || EXCEPTION_FAILED) {
+		return COLLECTION_FAILURE;
+	}
+	COLLECTION_RELEASE(dataSet->profiles, &item);
+	if (dataSet->valueIndex != NULL) {
+		valueIndexGetRow(
+			dataSet->valueIndex,
+			profileOffset,
+			&entry->valueIndexRow);
+	}
+	return SUCCESS;
+}
+
+/**
+ * Resolves every record of the profile groups collection if enabled in the
+ * configuration. Only in memory data sets are resolved so that the profile
+ * pointers remain valid. A group starting at a record is valid if the
+ * weights of the records from it add up to exactly the full weighting. The
+ * lengths of the groups are found for every record, as the offsets used by
+ * the graphs are not known, and records which do not start a valid group are
+ * left to be read from the collection which reports any corruption.
+ */
+static StatusCode initProfileGroupsTable(
+	DataSetIpi* dataSet,
+	Exception* exception) {
+	uint32_t i, next, totalWeight;
+	StatusCode status = SUCCESS;
+	if (dataSet->config.profileGroupsTable == false ||
+		dataSet->b.b.isInMemory == false ||
+		dataSet->profileGroups->count == 0) {
+		return SUCCESS;
+	}
+	IpiProfileGroupsTable* const table = (IpiProfileGroupsTable*)Malloc(
+		sizeof(IpiProfileGroupsTable));
+	if (table == NULL) {
+		return INSUFFICIENT_MEMORY;
+	}
+	table->count = dataSet->profileGroups->count;
+	table->entries = (IpiProfileGroupEntry*)Malloc(
+		sizeof(IpiProfileGroupEntry) * table->count);
+	if (table->entries == NULL) {
+		Free(table);
+		return INSUFFICIENT_MEMORY;
+	}
+	for (i = 0; i < table->count && status == SUCCESS; i++) {
+		status = profileGroupsTableSetEntry(
+			dataSet,
+			&table->entries[i],
+			i,
+			exception);
+	}
+	if (status != SUCCESS) {
+		freeProfileGroupsTable(table);
+		return status;
+	}
+	for (i = 0; i < table->count; i++) {
+		totalWeight = 0;
+		for (next = i;
+			next < table->count && totalWeight < FULL_RAW_WEIGHTING;
+			next++) {
+			totalWeight += table->entries[next].rawWeighting;
+		}
+		if (totalWeight == FULL_RAW_WEIGHTING && next - i <= UINT16_MAX) {
+			table->entries[i].length = (uint16_t)(next - i);
+		}
+	}
+	dataSet->profileGroupsTable = table;
+	return SUCCESS;
+}
+
+/**
+ * INIT INDEXES METHODS
+ */
+
+/**
+ * Builds the tables, indexes and caches enabled in the configuration. Each
+ * only depends on the collections and required properties, except for the
+ * profile groups table which uses the value index, so they are built as
+ * separate tasks which can run in parallel.
+ */
+static StatusCode initIndexes(DataSetIpi* dataSet, Exception* exception) {
+	uint32_t i;
+	IpiInitTimings* const timings = &dataSet->timings;
+	const initStep ipv4Table[] = {
+		{ initIpv4TableIfEnabled, &timings->ipv4Table },
+		{ NULL, NULL } };
+	const initStep ipv6Table[] = {
+		{ initIpv6TableIfEnabled, &timings->ipv6Table },
+		{ NULL, NULL } };
+	const initStep ipv6Index[] = {
+		{ initIpv6IndexIfEnabled, &timings->ipv6Index },
+		{ NULL, NULL } };
+	const initStep rangeCache[] = {
+		{ initRangeCache, &timings->rangeCache },
+		{ NULL, NULL } };
+	const initStep values[] = {
+		{ initValueIndex, &timings->valueIndex },
+		{ initProfileGroupsTable, &timings->profileGroupsTable },
+		{ NULL, NULL } };
+	const initStep* const steps[] = {
+		ipv4Table,
+		ipv6Table,
+		ipv6Index,
+		rangeCache,
+		values };
+	initTask tasks[sizeof(steps) / sizeof(steps[0])];
+	const uint32_t count = sizeof(steps) / sizeof(steps[0]);
+	for (i = 0; i < count; i++) {
+		tasks[i].dataSet = dataSet;
+		tasks[i].run = initStepsRun;
+		tasks[i].state = steps[i];
+		tasks[i].status = NOT_SET;
+	}
+	return initTasksRun(dataSet, tasks, count, exception);
+}
+
+/**
+ * BACKGROUND RELOAD METHODS
+ */
+
+/**
+ * Distance between the bytes read to touch every page of a mapped data file.
+ */
+#define RELOAD_PAGE_SIZE 4096
+
+/**
+ * Reads a byte from every page of a mapped data file so that the pages are
+ * in memory before the data set becomes active.
+ */
+static void reloadTouchPages(const DataSetIpi* dataSet) {
+	FileOffset offset;
+	volatile byte touched = 0;
+	for (offset = 0;
+		offset < dataSet->mapped.length;
+		offset += RELOAD_PAGE_SIZE) {
+		touched ^= dataSet->mapped.startByte[offset];
+	}
+	(void)touched;
+}
+
+/**
+ * Processes each of the IP addresses with the new data set and gets the
+ * values of every required property. The data set is not yet managed so the
+ * results are created without a reference to it. IP addresses which can not
+ * be processed are skipped as warming is only an optimisation.
+ * @return number of IP addresses processed
+ */
+static uint32_t reloadWarm(
+	DataSetIpi* dataSet,
+	const IpiReloadWarm* warm) {
+	uint32_t i, warmed = 0;
+	int property;
+	ResultsIpi* results;
+	EXCEPTION_CREATE;
+	if (warm->touchPages) {
+		reloadTouchPages(dataSet);
+	}
+	if (warm->ipAddresses == NULL || warm->count == 0) {
+		return 0;
+	}
+	results = resultsIpiCreateForDataSet(dataSet);
+	if (results == NULL) {
+		return 0;
+	}
+	for (i = 0; i < warm->count; i++) {
+		const char* const ipAddress = warm->ipAddresses[i];
+		if (ipAddress == NULL) {
+			continue;
+		}
+		EXCEPTION_CLEAR;
+		ResultsIpiFromIpAddressString(
+			results,
+			ipAddress,
+			strlen(ipAddress),
+			exception);
+		if (EXCEPTION_OKAY) {
+			for (property = 0;
+				property < (int)dataSet->b.b.available->count;
+				property++) {
+				ResultsIpiGetValues(results, property, exception);
+				EXCEPTION_CLEAR;
+			}
+			warmed++;
+		}
+		ResultsIpiReset(results);
+	}
+	resultsIpiFreeMembers(results);
+	Free(results);
+	return warmed;
+}
+
+/**
+ * Initialises the new data set with the configuration and required
+ * properties of the active one, warms it, and then makes it active.
+ */
+static void reloadRun(IpiReload* reload) {
+	StatusCode status;
+	DataSetIpi* dataSet;
+	Exception* exception = &reload->exception;
+	const double start = initTimerNow();
+	EXCEPTION_CLEAR;
+	memset(&reload->result, 0, sizeof(IpiReloadResult));
+
+	// Use the same configuration and properties as the active data set which
+	// is held until the new one is initialised.
+	DataSetIpi* const active = DataSetIpiGet(reload->manager);
+	ConfigIpi config = active->config;
+	PropertiesRequired properties = PropertiesDefault;
+	properties.existing = active->b.b.available;
+	dataSet = (DataSetIpi*)Malloc(sizeof(DataSetIpi));
+	if (dataSet == NULL) {
+		status = INSUFFICIENT_MEMORY;
+	}
+	else {
+		status = initDataSetFromFile(
+			dataSet,
+			&config,
+			&properties,
+			reload->fileName != NULL ?
+				reload->fileName :
+				active->b.b.masterFileName,
+			exception);
+	}
+	DataSetIpiRelease(active);
+	reload->result.initDuration = initTimerNow() - start;
+
+	if (status == SUCCESS && EXCEPTION_OKAY) {
+		const double warmStart = initTimerNow();
+		reload->result.warmed = reloadWarm(dataSet, &reload->warm);
+		reload->result.warmDuration = initTimerNow() - warmStart;
+		reload->result.memory = dataSet->memoryLength;
+
+		// Replace the active data set now that the new one is warm.
+		ResourceReplace(reload->manager, dataSet, &dataSet->b.b.handle);
+		if (dataSet->b.b.handle == NULL) {
+			freeDataSet(dataSet);
+			status = INSUFFICIENT_MEMORY;
+		}
+	}
+	else if (status == SUCCESS) {
+		status = exception->status;
+	}
+	reload->result.status = status;
+	reload->result.duration = initTimerNow() - start;
+	if (reload->callback != NULL) {
+		reload->callback(reload->state, &reload->result);
+	}
+}
+
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+static void reloadThread(void* state) {
+	reloadRun((IpiReload*)state);
+	FIFTYONE_DEGREES_THREAD_EXIT;
+}
+#endif
+
+fiftyoneDegreesStatusCode fiftyoneDegreesIpiReloadManagerFromFileAsync(
+	fiftyoneDegreesIpiReload* reload,
+	fiftyoneDegreesResourceManager* manager,
+	const char* fileName,
+	const fiftyoneDegreesIpiReloadWarm* warm,
+	fiftyoneDegreesIpiReloadCallback callback,
+	void* state) {
+	Exception* exception = &reload->exception;
+	EXCEPTION_CLEAR;
+	memset(&reload->result, 0, sizeof(IpiReloadResult));
+	reload->manager = manager;
+	reload->fileName = NULL;
+	reload->callback = callback;
+	reload->state = state;
+	reload->running = false;
+	if (warm != NULL) {
+		reload->warm = *warm;
+	}
+	else {
+		memset(&reload->warm, 0, sizeof(IpiReloadWarm));
+	}
+
+	// Copy the file name as the caller's copy might not outlive the reload.
+	if (fileName != NULL) {
+		const size_t length = strlen(fileName) + 1;
+		reload->fileName = (char*)Malloc(length);
+		if (reload->fileName == NULL) {
+			reload->result.status = INSUFFICIENT_MEMORY;
+			return INSUFFICIENT_MEMORY;
+		}
+		memcpy(reload->fileName, fileName, length);
+	}
+
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+	if (ThreadingGetIsThreadSafe()) {
+		reload->running = threadCreate(
+			&reload->thread,
+			(FIFTYONE_DEGREES_THREAD_ROUTINE)&reloadThread,
+			reload);
+		if (reload->running) {
+			return SUCCESS;
+		}
+	}
+#endif
+
+	// Without threads, or if the thread could not be started, the reload
+	// completes before returning.
+	reloadRun(reload);
+	return SUCCESS;
+}
+
+fiftyoneDegreesStatusCode fiftyoneDegreesIpiReloadWait(
+	fiftyoneDegreesIpiReload* reload,
+	fiftyoneDegreesException* exception) {
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+	if (reload->running) {
+		FIFTYONE_DEGREES_THREAD_JOIN(reload->thread);
+		FIFTYONE_DEGREES_THREAD_CLOSE(reload->thread);
+		reload->running = false;
+	}
+#endif
+	if (reload->fileName != NULL) {
+		Free(reload->fileName);
+		reload->fileName = NULL;
+	}
+	if (exception != NULL) {
+		*exception = reload->exception;
+	}
+	return reload->result.status;
 }
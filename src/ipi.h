@@ -71,6 +71,8 @@
 #include "common-cxx/stringBuilder.h"
 #include "common-cxx/weightedItem.h"
 #include "ip-graph-cxx/graph.h"
+#include "ipi_mapped.h"
+#include "ipi_file_reader.h"
 
 /** Default value for the cache concurrency used in the default configuration. */
 #ifndef FIFTYONE_DEGREES_CACHE_CONCURRENCY
@@ -180,6 +182,13 @@
 #define FIFTYONE_DEGREES_PROPERTY_LOADED true
 #endif
 
+/**
+ * Range id of a result for which the matched IP range is not known. Known
+ * ranges are given an id derived from their first and last IP addresses
+ * which is never this value.
+ */
+#define FIFTYONE_DEGREES_IPI_NO_RANGE_ID UINT32_MAX
+
 /**
  * DATA STRUCTURES
  */
@@ -259,8 +268,416 @@ typedef struct fiftyone_degrees_config_ipi_t {
 	fiftyoneDegreesCollectionConfig propertyTypes; /**< Property types collection
 												   config */
 	fiftyoneDegreesCollectionConfig graph; /**< Config for each graph */
+	bool ipv4Table; /**< True if a flattened table of IPv4 ranges should be
+					built from the graphs when an in memory data set is
+					loaded. Increases memory usage and load time in exchange
+					for faster IPv4 lookups. */
+	uint8_t ipv6PrefixBits; /**< Number of leading bits of IPv6 addresses used
+							to key the prefix index built for each component
+							when an in memory data set is loaded, between 1
+							and 64, or 0 if no index should be built */
+	bool ipv6Table; /**< True if a flattened table of IPv6 ranges should be
+					built from the graphs when an in memory data set is
+					loaded. Increases memory usage and load time in exchange
+					for faster IPv6 lookups. */
+	uint32_t rangeCacheCapacity; /**< Number of IP ranges held in the range
+								 cache of each data set, or 0 if no cache
+								 should be used */
+	bool valueIndex; /**< True if an index of the values of the required
+					 properties for each profile should be built when an in
+					 memory data set is loaded. Increases memory usage and
+					 load time in exchange for faster value retrieval. */
+	bool profileGroupsTable; /**< True if the profile groups should be
+							 resolved into a table of profiles and weights
+							 when an in memory data set is loaded.
+							 Increases memory usage and load time in
+							 exchange for faster retrieval of values from
+							 profile groups. */
+	bool mapFile; /**< True if an all in memory data set should be created
+				  from a read only mapping of the temporary copy of the
+				  data file rather than reading the file into allocated
+				  memory. Requires b.useTempFile, otherwise the data set
+				  fails with #FIFTYONE_DEGREES_STATUS_INVALID_CONFIG.
+				  Updates must replace the data file by renaming a
+				  complete new file over it, never by writing over it, so
+				  that a copy is never made from a partly written file */
+	uint8_t mapHints; /**< Combination of the FIFTYONE_DEGREES_IPI_MAP_*
+					  flags used when mapFile is true */
+	uint16_t initThreads; /**< Number of threads used to build the
+						  independent parts of the data set when it is
+						  initialised, or 0 or 1 to build them in sequence
+						  on the calling thread */
+	bool positionalRead; /**< True if items of the collections which are
+						 read from file should use positional reads from a
+						 single handle shared by every thread rather than a
+						 handle from the file pool. The graphs still use the
+						 file pool */
 } fiftyoneDegreesConfigIpi;
 
+/**
+ * Flattened table of the IPv4 ranges in the data set built from the graphs
+ * of the components with available properties when the data set is loaded.
+ * The ranges are bounded by the IpRangeStart and IpRangeEnd values of every
+ * component which has them, so only those components are held in the table
+ * and the results for any others are found from their graphs. Adjacent
+ * ranges which share the same results for every component are merged. A
+ * directory indexed by the upper 16 bits of the IPv4 address narrows the
+ * search to the ranges which start within that prefix, so most lookups need
+ * a single directory read and a single results read.
+ */
+typedef struct fiftyone_degrees_ipi_ipv4_table_t {
+	uint32_t count; /**< Number of ranges in the table */
+	uint32_t componentsCount; /**< Number of results stored for each range */
+	const byte *componentIds; /**< Id of the component for each of the
+							  results stored for a range */
+	uint32_t *directory; /**< Index of the range containing the first IPv4
+						 address of each 16 bit prefix followed by the index of
+						 the last range */
+	uint32_t *starts; /**< First IPv4 address of each range as an integer in
+					  ascending order */
+	fiftyoneDegreesIpiCgResult *results; /**< Results for each component of
+										 each range */
+} fiftyoneDegreesIpiIpv4Table;
+
+/**
+ * IP address held as two native integers so that IP addresses can be
+ * compared with integer comparisons rather than byte by byte. IPv4 addresses
+ * are held in the lower 32 bits of lower with upper set to zero. Keys compare
+ * in the same order as the bytes of the IP addresses they are created from.
+ * See #fiftyoneDegreesIpiIpKeyFromIpAddress.
+ */
+typedef struct fiftyone_degrees_ipi_ip_key_t {
+	uint64_t upper; /**< Upper 64 bits of an IPv6 address */
+	uint64_t lower; /**< Lower 64 bits of an IPv6 address, or the IPv4
+					address */
+} fiftyoneDegreesIpiIpKey;
+
+/**
+ * Flattened table of the IPv6 ranges in the data set built in the same way
+ * as #fiftyoneDegreesIpiIpv4Table. The directory is indexed by the upper 16
+ * bits of the IPv6 address.
+ */
+typedef struct fiftyone_degrees_ipi_ipv6_table_t {
+	uint32_t count; /**< Number of ranges in the table */
+	uint32_t componentsCount; /**< Number of results stored for each range */
+	const byte *componentIds; /**< Id of the component for each of the
+							  results stored for a range */
+	uint32_t *directory; /**< Index of the range containing the first IPv6
+						 address of each 16 bit prefix followed by the index of
+						 the last range */
+	fiftyoneDegreesIpiIpKey *starts; /**< First IPv6 address of each
+										 range in ascending order */
+	fiftyoneDegreesIpiCgResult *results; /**< Results for each component of
+										 each range */
+} fiftyoneDegreesIpiIpv6Table;
+
+/**
+ * Entry in the IPv6 prefix index of a component covering the prefixes from
+ * its start up to the start of the next entry.
+ */
+typedef struct fiftyone_degrees_ipi_ipv6_prefix_entry_t {
+	uint64_t start; /**< First prefix covered by the entry */
+	fiftyoneDegreesIpiCgResult result; /**< Result for every IP address
+									   within the prefixes if uniform */
+	bool uniform; /**< True if every IP address within the prefixes has the
+				  same result, otherwise the graph must be evaluated */
+} fiftyoneDegreesIpiIpv6PrefixEntry;
+
+/**
+ * Sorted entries covering every prefix of the IPv6 address space for a
+ * single component.
+ */
+typedef struct fiftyone_degrees_ipi_ipv6_prefix_index_t {
+	byte componentId; /**< Id of the component the index is for */
+	uint32_t count; /**< Number of entries */
+	fiftyoneDegreesIpiIpv6PrefixEntry *entries; /**< Entries in ascending
+												order of start prefix */
+} fiftyoneDegreesIpiIpv6PrefixIndex;
+
+/**
+ * Index keyed on the leading bits of IPv6 addresses built from the graphs
+ * of the components with IpRangeStart and IpRangeEnd properties when the
+ * data set is loaded.
+ * IPv6 allocations are sparse so most prefixes fall entirely within a single
+ * range. For these the result is returned from the index without evaluating
+ * the graph. Prefixes which contain more than one result for the component
+ * are still resolved by the graph.
+ */
+typedef struct fiftyone_degrees_ipi_ipv6_index_t {
+	byte prefixBits; /**< Number of leading bits of the IPv6 address used as
+					 the prefix */
+	uint32_t componentsCount; /**< Number of components in the index */
+	fiftyoneDegreesIpiIpv6PrefixIndex *components; /**< Index for each of the
+												   components */
+} fiftyoneDegreesIpiIpv6Index;
+
+/**
+ * Entry in the range cache containing the results for every component for
+ * all the IP addresses in the range.
+ */
+typedef struct fiftyone_degrees_ipi_range_cache_entry_t {
+	fiftyoneDegreesIpAddress start; /**< First IP address of the range, the
+									type is invalid if the entry is empty */
+	fiftyoneDegreesIpAddress end; /**< Last IP address of the range */
+	fiftyoneDegreesIpiIpKey startKey; /**< Key of the first IP address */
+	fiftyoneDegreesIpiIpKey endKey; /**< Key of the last IP address */
+	uint32_t rangeId; /**< Id of the range */
+	fiftyoneDegreesIpiCgResult *results; /**< Result for each component */
+} fiftyoneDegreesIpiRangeCacheEntry;
+
+/**
+ * Shard of the range cache with its own lock and counters. Entries are
+ * spread over the shards to reduce contention between threads.
+ */
+typedef struct fiftyone_degrees_ipi_range_cache_shard_t {
+	uint64_t hits; /**< Number of lookups answered from the cache */
+	uint64_t misses; /**< Number of lookups which evaluated the graphs */
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+	fiftyoneDegreesMutex lock; /**< Lock for the entries in the shard */
+#endif
+} fiftyoneDegreesIpiRangeCacheShard;
+
+/**
+ * Cache of the results for the IP ranges most recently looked up. A cached
+ * range is the intersection of the ranges of every component with
+ * IpRangeStart and IpRangeEnd properties, so their results are the same for
+ * every IP address in it and are answered without evaluating the graphs.
+ * Components without the properties are not cached and their graphs are
+ * always evaluated. Each IP address maps to a single entry from its leading
+ * 24 bits for IPv4, or 48 bits for IPv6. The cache belongs to the data set so
+ * is discarded when the data set is reloaded.
+ */
+typedef struct fiftyone_degrees_ipi_range_cache_t {
+	uint32_t capacity; /**< Number of entries */
+	uint32_t shardsCount; /**< Number of shards */
+	uint32_t componentsCount; /**< Number of results in each entry */
+	const byte *componentIds; /**< Id of the component for each of the
+							  results in an entry */
+	fiftyoneDegreesIpiRangeCacheShard *shards; /**< Shards of the cache */
+	fiftyoneDegreesIpiRangeCacheEntry *entries; /**< Entries of the cache */
+} fiftyoneDegreesIpiRangeCache;
+
+/**
+ * Counters from the range cache of a data set.
+ */
+typedef struct fiftyone_degrees_ipi_range_cache_stats_t {
+	uint32_t capacity; /**< Number of entries, or 0 if there is no cache */
+	uint64_t hits; /**< Number of lookups answered from the cache */
+	uint64_t misses; /**< Number of lookups which evaluated the graphs */
+} fiftyoneDegreesIpiRangeCacheStats;
+
+/**
+ * Row of the value index for a profile offset.
+ */
+typedef struct fiftyone_degrees_ipi_value_index_profile_t {
+	uint32_t offset; /**< Offset of the profile in the profiles collection */
+	uint32_t row; /**< Row of the profile in the value index */
+} fiftyoneDegreesIpiValueIndexProfile;
+
+/**
+ * Index of the values of the required properties for every profile built
+ * when an in memory data set is loaded. Each row corresponds to a profile in
+ * the profile offsets collection and each column to a required property. The
+ * value indexes for a row and column are a contiguous slice of valueIndexes,
+ * so the values of a property are returned without searching the profile's
+ * values.
+ */
+typedef struct fiftyone_degrees_ipi_value_index_t {
+	uint32_t profilesCount; /**< Number of rows, one for each profile */
+	uint32_t columnsCount; /**< Number of columns, one for each required
+						   property */
+	uint32_t propertiesCount; /**< Number of properties in the data set */
+	int32_t *columns; /**< Column for each property index, or -1 if the
+					  property is not required */
+	fiftyoneDegreesIpiValueIndexProfile *profiles; /**< Row of each profile
+												   in ascending order of
+												   offset, used to find the
+												   row of a profile in a
+												   profile group */
+	uint32_t *starts; /**< Position in valueIndexes of the first value for
+					  each row and column, followed by the total number of
+					  value indexes */
+	uint32_t *valueIndexes; /**< Value indexes for every row and column */
+} fiftyoneDegreesIpiValueIndex;
+
+/**
+ * Profile within a profile group resolved when an in memory data set is
+ * loaded.
+ */
+typedef struct fiftyone_degrees_ipi_profile_group_entry_t {
+	const fiftyoneDegreesProfile *profile; /**< Profile, or NULL if the
+										   entry has a null profile offset */
+	uint32_t valueIndexRow; /**< Row of the profile in the value index, or
+							UINT32_MAX if there is no value index */
+	uint16_t rawWeighting; /**< Weight of the profile in the group out of
+						   65535 */
+	uint16_t length; /**< Number of entries in the profile group which
+					 starts with this entry, or 0 if a valid group does
+					 not start at this entry */
+} fiftyoneDegreesIpiProfileGroupEntry;
+
+/**
+ * Profile groups resolved when an in memory data set is loaded. There is an
+ * entry for every record in the profile groups collection so the group at a
+ * profile group offset is the entries starting at the same index. The weights
+ * of each group are checked when the table is built, so returning the values
+ * of a group does not need to read or check the profile groups collection.
+ */
+typedef struct fiftyone_degrees_ipi_profile_groups_table_t {
+	uint32_t count; /**< Number of entries */
+	fiftyoneDegreesIpiProfileGroupEntry *entries; /**< Entry for each
+												  record in the profile
+												  groups collection */
+} fiftyoneDegreesIpiProfileGroupsTable;
+
+/**
+ * Location of the IpRangeStart and IpRangeEnd properties of a component used
+ * to find the range of IP addresses its result applies to.
+ */
+typedef struct fiftyone_degrees_ipi_range_properties_t {
+	int startIndex; /**< Index of the component's IpRangeStart property, or
+					-1 if the component does not have both properties */
+	int endIndex; /**< Index of the component's IpRangeEnd property, or -1 if
+				  the component does not have both properties */
+	byte componentId; /**< Id of the component */
+} fiftyoneDegreesIpiRangeProperties;
+
+/**
+ * Formats which all the required properties of results can be rendered in
+ * with fiftyoneDegreesResultsIpiRenderAll.
+ */
+typedef enum e_fiftyone_degrees_ipi_render_format {
+	FIFTYONE_DEGREES_IPI_RENDER_FORMAT_PIPE, /**< Name="value":weight,...
+											 with each property separated by
+											 a pipe */
+	FIFTYONE_DEGREES_IPI_RENDER_FORMAT_JSON, /**< A JSON object with an array
+											 of value and weight objects for
+											 each property */
+	FIFTYONE_DEGREES_IPI_RENDER_FORMAT_CSV, /**< A CSV row with a quoted field
+											of value:weight pairs separated
+											by pipes for each property */
+	FIFTYONE_DEGREES_IPI_RENDER_FORMAT_COUNT /**< Number of formats */
+} fiftyoneDegreesIpiRenderFormat;
+
+/**
+ * Required property prepared when the data set is loaded so that rendering
+ * results does not need to find the property or quote its name.
+ */
+typedef struct fiftyone_degrees_ipi_render_property_t {
+	int propertyIndex; /**< Index of the property in the properties
+					   collection */
+	fiftyoneDegreesPropertyValueType storedValueType; /**< Type the values
+													  of the property are
+													  stored as */
+	const char *names[FIFTYONE_DEGREES_IPI_RENDER_FORMAT_COUNT]; /**< Name of
+																 the property
+																 quoted for
+																 each format
+																 */
+	size_t namesLength[FIFTYONE_DEGREES_IPI_RENDER_FORMAT_COUNT]; /**< Length
+																  of each
+																  name */
+} fiftyoneDegreesIpiRenderProperty;
+
+/**
+ * Required properties prepared for rendering when the data set is loaded.
+ */
+typedef struct fiftyone_degrees_ipi_render_properties_t {
+	uint32_t count; /**< Number of required properties */
+	fiftyoneDegreesIpiRenderProperty *items; /**< Property for each required
+											 property index */
+	char *names; /**< Memory used for the names of all the properties */
+} fiftyoneDegreesIpiRenderProperties;
+
+/**
+ * Time spent in each stage of initialising a data set, in milliseconds.
+ * Where the parts of a stage are built in parallel the time of each part is
+ * the time the part took on its own thread, so the parts can add up to more
+ * than the elapsed time of the stage.
+ */
+typedef struct fiftyone_degrees_ipi_init_timings_t {
+	double collections; /**< Elapsed time creating the collections from the
+						data. The collections can be created in parallel,
+						but the graphs are always created after them and
+						are timed separately */
+	double graphs; /**< Time creating the graph of each component */
+	double properties; /**< Time initialising the required properties,
+					   headers and components */
+	double indexes; /**< Elapsed time building the tables, indexes and
+					caches enabled in the configuration */
+	double ipv4Table; /**< Time building the flattened IPv4 table */
+	double ipv6Table; /**< Time building the flattened IPv6 table */
+	double ipv6Index; /**< Time building the IPv6 prefix index */
+	double rangeCache; /**< Time creating the range cache */
+	double valueIndex; /**< Time building the value index */
+	double profileGroupsTable; /**< Time resolving the profile groups */
+	double total; /**< Elapsed time initialising the data set */
+} fiftyoneDegreesIpiInitTimings;
+
+/**
+ * IP addresses used to warm a data set reloaded in the background before it
+ * replaces the active data set. Processing a sample of recent IP addresses
+ * loads the items they need into the caches of the collections, and reads
+ * the pages of a mapped data file they touch.
+ */
+typedef struct fiftyone_degrees_ipi_reload_warm_t {
+	const char* const *ipAddresses; /**< IP addresses to process, which must
+									remain valid until the reload has
+									completed, or NULL */
+	uint32_t count; /**< Number of IP addresses */
+	bool touchPages; /**< True if every page of a mapped data file should be
+					 read so that none are faulted in by requests */
+} fiftyoneDegreesIpiReloadWarm;
+
+/**
+ * Outcome of a reload in the background passed to the completion callback.
+ */
+typedef struct fiftyone_degrees_ipi_reload_result_t {
+	fiftyoneDegreesStatusCode status; /**< Status of the reload. Any value
+									  other than SUCCESS means the active data
+									  set was not replaced */
+	double initDuration; /**< Milliseconds initialising the new data set */
+	double warmDuration; /**< Milliseconds warming the new data set */
+	double duration; /**< Milliseconds from the start of the reload until
+					 the new data set was active */
+	uint32_t warmed; /**< Number of IP addresses processed while warming */
+	fiftyoneDegreesFileOffset memory; /**< Bytes of the data file held in
+									  allocated memory by the new data set.
+									  These are needed in addition to the
+									  active data set until it is released.
+									  Zero where the data file is mapped or
+									  read as needed. */
+} fiftyoneDegreesIpiReloadResult;
+
+/**
+ * Called on the reload thread when a reload in the background has completed.
+ * @param state pointer provided when the reload was started
+ * @param result outcome of the reload
+ */
+typedef void(*fiftyoneDegreesIpiReloadCallback)(
+	void* state,
+	const fiftyoneDegreesIpiReloadResult* result);
+
+/**
+ * Reload of a data set in the background. Started by
+ * #fiftyoneDegreesIpiReloadManagerFromFileAsync and completed by
+ * #fiftyoneDegreesIpiReloadWait. The fields are set by those methods.
+ */
+typedef struct fiftyone_degrees_ipi_reload_t {
+	fiftyoneDegreesResourceManager* manager; /**< Manager to reload */
+	char* fileName; /**< Copy of the file to reload from, or NULL to use the
+					original data file */
+	fiftyoneDegreesIpiReloadWarm warm; /**< IP addresses used to warm */
+	fiftyoneDegreesIpiReloadCallback callback; /**< Callback, or NULL */
+	void* state; /**< State passed to the callback */
+	fiftyoneDegreesIpiReloadResult result; /**< Outcome of the reload */
+	fiftyoneDegreesException exception; /**< Exception from the reload */
+#ifndef FIFTYONE_DEGREES_NO_THREADING
+	FIFTYONE_DEGREES_THREAD thread; /**< Thread running the reload */
+#endif
+	bool running; /**< True if the thread has not been waited for */
+} fiftyoneDegreesIpiReload;
+
 /**
  * Data set structure which contains the base dataset structure. This
  * acts as a wrapper and is used in the dataset structure for IP 
@@ -310,6 +727,59 @@ typedef struct fiftyone_degrees_dataset_ipi_t {
 											   collection */
 	fiftyoneDegreesIpiCgArray* graphsArray; /**< Array of graphs from 
 											collection */
+	fiftyoneDegreesIpiIpv4Table *ipv4Table; /**< Flattened IPv4 ranges, or
+											NULL if not enabled in the
+											configuration or no component
+											has range properties */
+	fiftyoneDegreesIpiIpv6Index *ipv6Index; /**< IPv6 prefix index, or NULL
+											if not enabled in the
+											configuration or no component
+											has range properties */
+	fiftyoneDegreesIpiIpv6Table *ipv6Table; /**< Flattened IPv6 ranges, or
+											NULL if not enabled in the
+											configuration or no component
+											has range properties */
+	fiftyoneDegreesIpiRangeCache *rangeCache; /**< Range cache, or NULL if
+											  not enabled in the
+											  configuration */
+	fiftyoneDegreesIpiValueIndex *valueIndex; /**< Index of the required
+											  property values of each
+											  profile, or NULL if not
+											  enabled in the configuration
+											  */
+	fiftyoneDegreesIpiProfileGroupsTable *profileGroupsTable; /**< Resolved
+															  profile groups,
+															  or NULL if not
+															  enabled in the
+															  configuration */
+	fiftyoneDegreesIpiRangeProperties *ranges; /**< Properties used to
+											   find the range of each
+											   result, one for each
+											   component with available
+											   properties in the order of
+											   the results */
+	uint32_t rangesAvailableCount; /**< Number of components in ranges which
+								   have range properties */
+	fiftyoneDegreesIpiRenderProperties *renderProperties; /**< Required
+														  properties prepared
+														  for rendering, or
+														  NULL if there are
+														  none */
+	fiftyoneDegreesIpiMappedFile mapped; /**< Mapping of the data file when
+										 the data set was created from a
+										 mapping */
+	fiftyoneDegreesIpiFileReader fileReader; /**< Reader used by the fixed
+											 width collections when
+											 positional reads are enabled */
+	fiftyoneDegreesIpiInitTimings timings; /**< Time spent in each stage of
+										   initialising the data set */
+	const byte *memory; /**< First byte of the data file held in allocated
+						memory, or NULL if the data is mapped or read from
+						file */
+	fiftyoneDegreesFileOffset memoryLength; /**< Bytes of the data file held
+											in allocated memory, or 0 if
+											the data is mapped or read from
+											file */
 } fiftyoneDegreesDataSetIpi;
 
 
@@ -334,15 +804,44 @@ typedef struct fiftyone_degrees_result_ipi_t {
 												 graph evaluation */
 	fiftyoneDegreesIpAddress targetIpAddress; /**< The target IP address
 											  to find a matching range for */
+	fiftyoneDegreesIpAddress rangeStart; /**< First IP address of the range
+										 the result applies to, the type is
+										 invalid if the range is not known.
+										 Only valid once rangeResolved is
+										 true */
+	fiftyoneDegreesIpAddress rangeEnd; /**< Last IP address of the range the
+									   result applies to */
+	uint32_t rangeId; /**< Id of the range hashed from its first and last
+					  IP addresses, or #FIFTYONE_DEGREES_IPI_NO_RANGE_ID.
+					  Not unique, see
+					  #fiftyoneDegreesResultsIpiGetRange */
+	bool rangeResolved; /**< True once the range fields have been found by
+						fiftyoneDegreesResultsIpiGetResultRange. They are
+						not found when the result is created as most
+						callers never need them */
 } fiftyoneDegreesResultIpi;
 
+/**
+ * Storage owned by the results which is reused by every call to
+ * #fiftyoneDegreesResultsIpiGetValuesForProperties, and by the callers which
+ * get the values of several properties, rather than being allocated and
+ * freed by each call. It only grows, and is freed with the results.
+ */
+typedef struct fiftyone_degrees_results_ipi_properties_t {
+	fiftyoneDegreesData state; /**< State for each of the properties */
+	fiftyoneDegreesData indexes; /**< Required property indexes */
+	fiftyoneDegreesIpiList *lists; /**< Lists of values, one per property */
+	uint32_t listsCount; /**< Number of lists which have been initialised */
+} fiftyoneDegreesResultsIpiProperties;
+
 /**
  * Macro defining the common members of an Ipi result.
  */
 #define FIFTYONE_DEGREES_RESULTS_IPI_MEMBERS \
 	fiftyoneDegreesResultsBase b; \
 	fiftyoneDegreesCollectionItem propertyItem; \
-	fiftyoneDegreesIpiList values;
+	fiftyoneDegreesIpiList values; \
+	fiftyoneDegreesResultsIpiProperties properties;
 
 FIFTYONE_DEGREES_ARRAY_TYPE(
 	fiftyoneDegreesResultIpi,
@@ -354,6 +853,24 @@ FIFTYONE_DEGREES_ARRAY_TYPE(
  */
 typedef fiftyoneDegreesResultIpiArray fiftyoneDegreesResultsIpi;
 
+/**
+ * Batch of Ipi results used to process many IP addresses in a single call.
+ * All the results in the batch share one reference to the data set and are
+ * allocated in one contiguous block of memory. The components to evaluate are
+ * resolved once when the batch is created rather than for every IP address.
+ */
+typedef struct fiftyone_degrees_results_ipi_batch_t {
+	fiftyoneDegreesDataSetIpi *dataSet; /**< Data set referenced by all the
+										results in the batch */
+	uint32_t count; /**< Number of results populated by the last call to
+					#fiftyoneDegreesResultsIpiFromIpAddressBatch */
+	uint32_t capacity; /**< Maximum number of IP addresses in a batch */
+	fiftyoneDegreesResultsIpi **items; /**< Results for each IP address */
+	const byte *componentIds; /**< Ids of the components which have
+							  properties available */
+	uint32_t componentIdsCount; /**< Number of component ids */
+} fiftyoneDegreesResultsIpiBatch;
+
 /**
  * Define the IP range structure
  */
@@ -469,6 +986,28 @@ EXTERNAL fiftyoneDegreesDataSetIpi* fiftyoneDegreesDataSetIpiGet(
  */
 EXTERNAL void fiftyoneDegreesDataSetIpiRelease(fiftyoneDegreesDataSetIpi* dataset);
 
+/**
+ * Gets the counters from the range cache of the active data set in the
+ * resource manager. The counters start from zero whenever the data set is
+ * reloaded as the cache is discarded with the data set.
+ * @param manager the resource manager containing a IP intelligence data set
+ * initialised by one of the IP intelligence data set init methods
+ * @return the counters, all zero if the range cache is not enabled
+ */
+EXTERNAL fiftyoneDegreesIpiRangeCacheStats fiftyoneDegreesIpiGetRangeCacheStats(
+	fiftyoneDegreesResourceManager* manager);
+
+/**
+ * Gets the time spent in each stage of initialising the active data set in
+ * the resource manager. Use this to find where the time is spent when the
+ * data set is loaded or reloaded.
+ * @param manager the resource manager containing a IP intelligence data set
+ * initialised by one of the IP intelligence data set init methods
+ * @return the timings of the active data set
+ */
+EXTERNAL fiftyoneDegreesIpiInitTimings fiftyoneDegreesIpiGetInitTimings(
+	fiftyoneDegreesResourceManager* manager);
+
 /**
  * Gets the total size in bytes which will be allocated when intialising a
  * IP Intelligence resource and associated manager with the same parameters. If any of
@@ -656,6 +1195,50 @@ fiftyoneDegreesIpiReloadManagerFromOriginalFile(
 	fiftyoneDegreesResourceManager* manager,
 	fiftyoneDegreesException* exception);
 
+/**
+ * Starts reloading the data set being used by the resource manager on a
+ * background thread. The new data set is initialised with the configuration
+ * and required properties of the active data set, warmed, and then replaces
+ * the active data set. Requests continue to use the active data set until
+ * the new one is ready, so they are not served from cold caches or pages
+ * which have not been read.
+ *
+ * The callback is called on the reload thread once the reload has
+ * completed. #fiftyoneDegreesIpiReloadWait must always be called to release
+ * the reload thread. Where threading is not available the reload completes
+ * before this method returns.
+ * @param reload structure to hold the state of the reload until it has been
+ * waited for
+ * @param manager pointer to the resource manager to reload the data set for
+ * @param fileName path to the new data file, or NULL to reload the data file
+ * the manager was created with
+ * @param warm IP addresses used to warm the new data set, or NULL
+ * @param callback called when the reload has completed, or NULL
+ * @param state pointer passed to the callback
+ * @return the status of starting the reload
+ */
+EXTERNAL fiftyoneDegreesStatusCode
+fiftyoneDegreesIpiReloadManagerFromFileAsync(
+	fiftyoneDegreesIpiReload* reload,
+	fiftyoneDegreesResourceManager* manager,
+	const char* fileName,
+	const fiftyoneDegreesIpiReloadWarm* warm,
+	fiftyoneDegreesIpiReloadCallback callback,
+	void* state);
+
+/**
+ * Waits for a reload started by #fiftyoneDegreesIpiReloadManagerFromFileAsync
+ * to complete and releases the resources used by it.
+ * @param reload started by #fiftyoneDegreesIpiReloadManagerFromFileAsync
+ * @param exception pointer to an exception data structure set to any
+ * exception which occurred during the reload. See exceptions.h.
+ * @return the status of the reload. Any value other than
+ * #FIFTYONE_DEGREES_STATUS_SUCCESS means the data set was not reloaded
+ */
+EXTERNAL fiftyoneDegreesStatusCode fiftyoneDegreesIpiReloadWait(
+	fiftyoneDegreesIpiReload* reload,
+	fiftyoneDegreesException* exception);
+
 /**
  * Allocates a results structure containing a reference to the IP Intelligence
  * data set managed by the resource manager provided. The referenced data set
@@ -677,6 +1260,29 @@ EXTERNAL fiftyoneDegreesResultsIpi* fiftyoneDegreesResultsIpiCreate(
 EXTERNAL void fiftyoneDegreesResultsIpiFree(
 	fiftyoneDegreesResultsIpi* results);
 
+/**
+ * Releases the collection items held by the results and clears them ready to
+ * be reused for another IP address. The results keep their reference to the
+ * data set and the memory allocated for their values.
+ * @param results pointer to the results to reset
+ */
+EXTERNAL void fiftyoneDegreesResultsIpiReset(
+	fiftyoneDegreesResultsIpi* results);
+
+/**
+ * Determines if the results reference the data set which is currently active
+ * in the resource manager. Results can be reused for further IP addresses
+ * without being freed and created again until the data set is reloaded, at
+ * which point they must be replaced so that the reference to the old data
+ * set is released.
+ * @param results pointer to the results created from the manager
+ * @param manager pointer to the manager the results were created from
+ * @return true if the results reference the active data set
+ */
+EXTERNAL bool fiftyoneDegreesResultsIpiGetIsActive(
+	fiftyoneDegreesResultsIpi* results,
+	fiftyoneDegreesResourceManager* manager);
+
 /**
  * Process a single byte array format IP Address and populate the IP range 
  * offset in the results structure. The result IP type will need to be checked
@@ -724,6 +1330,98 @@ EXTERNAL void fiftyoneDegreesResultsIpiFromEvidence(
 	fiftyoneDegreesEvidenceKeyValuePairArray* evidence,
 	fiftyoneDegreesException* exception);
 
+/**
+ * Allocates a batch of results able to hold the results for up to capacity
+ * IP addresses. A single reference to the IP Intelligence data set managed by
+ * the resource manager is taken and kept active until the batch is freed.
+ * @param manager pointer to the resource manager which manages a IP
+ * Intelligence data set
+ * @param capacity maximum number of IP addresses processed in one call
+ * @return newly created batch of results, or NULL if there was insufficient
+ * memory
+ */
+EXTERNAL fiftyoneDegreesResultsIpiBatch* fiftyoneDegreesResultsIpiBatchCreate(
+	fiftyoneDegreesResourceManager* manager,
+	uint32_t capacity);
+
+/**
+ * Frees the batch of results created by the
+ * #fiftyoneDegreesResultsIpiBatchCreate method. When freeing, the reference
+ * to the IP Intelligence data set resource is released. Any results obtained
+ * from the batch must not be used after this call.
+ * @param batch pointer to the batch of results to free
+ */
+EXTERNAL void fiftyoneDegreesResultsIpiBatchFree(
+	fiftyoneDegreesResultsIpiBatch* batch);
+
+/**
+ * Process an array of IP addresses and populate the results at the same
+ * index in the batch. The results for an IP address with the type
+ * #FIFTYONE_DEGREES_IP_TYPE_INVALID are left empty rather than failing the
+ * whole batch. The results can be used with all the methods that accept a
+ * #fiftyoneDegreesResultsIpi, but must not be freed individually.
+ * The batch is evaluated one component graph at a time across all the IP
+ * addresses rather than one IP address at a time. Each evaluation still
+ * runs to completion before the next starts, so the only difference from
+ * processing the IP addresses one by one is the order of the evaluations.
+ * @param batch preallocated batch of results to populate
+ * @param ipAddresses array of parsed IP addresses to process
+ * @param count number of IP addresses in the array which must not exceed the
+ * capacity of the batch
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ */
+EXTERNAL void fiftyoneDegreesResultsIpiFromIpAddressBatch(
+	fiftyoneDegreesResultsIpiBatch* batch,
+	const fiftyoneDegreesIpAddress* ipAddresses,
+	uint32_t count,
+	fiftyoneDegreesException* exception);
+
+/**
+ * Gets the range of IP addresses the result at the index applies to from
+ * the IpRangeStart and IpRangeEnd values of its component. The range is
+ * found the first time it is requested and kept in the result's rangeStart,
+ * rangeEnd and rangeId fields for later calls. The values list of the
+ * results is used to read the range values so values previously returned
+ * in it are released.
+ * @param results pointer to the results containing the result
+ * @param index of the result in the results
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ * @return pointer to the result with its range fields set, or NULL if the
+ * index is not valid
+ */
+EXTERNAL const fiftyoneDegreesResultIpi* fiftyoneDegreesResultsIpiGetResultRange(
+	fiftyoneDegreesResultsIpi* results,
+	uint32_t index,
+	fiftyoneDegreesException* exception);
+
+/**
+ * Gets the range of IP addresses for which every result with a known range
+ * is the same as for the IP address processed. This is the intersection of
+ * the ranges of those results. The id is a 32 bit hash of the first and
+ * last IP addresses so is the same for every IP address in the range, and
+ * for the same range after the data set is reloaded. The id is NOT unique.
+ * A data file has millions of ranges so different ranges are expected to
+ * share an id. Compare the start and end IP addresses where a range must be
+ * identified exactly.
+ * @param results pointer to the results to get the range of
+ * @param start set to the first IP address of the range
+ * @param end set to the last IP address of the range
+ * @param rangeId set to the id of the range, or
+ * #FIFTYONE_DEGREES_IPI_NO_RANGE_ID if the range is not known. Can be NULL.
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ * @return true if the range is known, otherwise false and start and end are
+ * not changed
+ */
+EXTERNAL bool fiftyoneDegreesResultsIpiGetRange(
+	fiftyoneDegreesResultsIpi* results,
+	fiftyoneDegreesIpAddress* start,
+	fiftyoneDegreesIpAddress* end,
+	uint32_t* rangeId,
+	fiftyoneDegreesException* exception);
+
 /**
  * Gets whether or not the results provided contain valid values for the
  * property index provided.
@@ -755,6 +1453,26 @@ EXTERNAL fiftyoneDegreesResultsNoValueReason fiftyoneDegreesResultsIpiGetNoValue
 	int requiredPropertyIndex,
 	fiftyoneDegreesException* exception);
 
+/**
+ * Populates the list of values in the results in the same way as
+ * #fiftyoneDegreesResultsIpiGetValues, and sets the reason if there are no
+ * values. The profiles are only traversed once, rather than once to check for
+ * values with #fiftyoneDegreesResultsIpiGetHasValues, again to get the reason
+ * with #fiftyoneDegreesResultsIpiGetNoValueReason and again to get the values.
+ * @param results pointer to the results to get the values from
+ * @param requiredPropertyIndex index in the required properties of the
+ * property to get the values of
+ * @param reason set to the reason there are no values if NULL is returned
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ * @return a pointer to the first value item, or NULL if there are no values
+ */
+EXTERNAL const fiftyoneDegreesWeightedItem* fiftyoneDegreesResultsIpiGetValuesWithReason(
+	fiftyoneDegreesResultsIpi* results,
+	int requiredPropertyIndex,
+	fiftyoneDegreesResultsNoValueReason* reason,
+	fiftyoneDegreesException* exception);
+
 /**
  * Gets a fuller description of the reason why a value is missing.
  * @param reason enum of the reason for the missing value
@@ -781,6 +1499,56 @@ EXTERNAL const fiftyoneDegreesProfilePercentage* fiftyoneDegreesResultsIpiGetVal
 	int requiredPropertyIndex,
 	fiftyoneDegreesException* exception);
 
+/**
+ * Populates a list of values for each of the required property indexes in a
+ * single pass of the results. Each profile, or profile group, matched by the
+ * results is fetched once and its values are distributed to the lists of all
+ * the properties, rather than fetching the profiles again for every property
+ * as #fiftyoneDegreesResultsIpiGetValues would. Mandatory properties without
+ * values are given their default value.
+ * The lists must be initialised by the caller and are released before being
+ * populated. The value items remain in use until the caller releases the
+ * lists with fiftyoneDegreesWeightedItemListRelease so the lists should be
+ * released as soon as the values are no longer needed. Lists owned by the
+ * results, which are reused by every call, are available from
+ * #fiftyoneDegreesResultsIpiGetPropertiesLists. Other state needed by the
+ * call is also held by the results, so repeated calls do not allocate
+ * memory once the results have been used for as many properties.
+ * @param results pointer to the results to get the values from
+ * @param requiredPropertyIndexes array of required property indexes
+ * @param requiredPropertyIndexesLength number of required property indexes
+ * @param lists array of lists, one for each required property index, to
+ * populate with the values of the property
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ */
+EXTERNAL void fiftyoneDegreesResultsIpiGetValuesForProperties(
+	fiftyoneDegreesResultsIpi* results,
+	const int* requiredPropertyIndexes,
+	uint32_t requiredPropertyIndexesLength,
+	fiftyoneDegreesWeightedItemList* lists,
+	fiftyoneDegreesException* exception);
+
+/**
+ * Gets lists owned by the results to pass to
+ * #fiftyoneDegreesResultsIpiGetValuesForProperties so that getting the values
+ * for several properties repeatedly does not allocate new lists each time.
+ * The lists are empty, and remain valid until the next call or until the
+ * results are freed. The caller must release them with
+ * fiftyoneDegreesWeightedItemListRelease once the values are no longer needed
+ * but must not free them.
+ * @param results pointer to the results which own the lists
+ * @param count number of lists needed
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ * @return pointer to the first of count lists, or NULL if there is not
+ * enough memory
+ */
+EXTERNAL fiftyoneDegreesWeightedItemList* fiftyoneDegreesResultsIpiGetPropertiesLists(
+	fiftyoneDegreesResultsIpi* results,
+	uint32_t count,
+	fiftyoneDegreesException* exception);
+
 /**
  * Adds to builder the values associated in the results for the property name.
  * @param results pointer to the results structure to release
@@ -837,6 +1605,57 @@ EXTERNAL size_t fiftyoneDegreesResultsIpiGetValuesStringByRequiredPropertyIndex(
 	const char* separator,
 	fiftyoneDegreesException* exception);
 
+/**
+ * Sets the buffer to a JSON object with the values of all the required
+ * properties in the results. Each property is an array of objects with the
+ * value as a string and the weight as a number. The names of the properties
+ * are escaped when the data set is loaded and the values are escaped as they
+ * are written, so no intermediate strings are allocated.
+ * @param results pointer to the results to serialize
+ * @param buffer character buffer allocated by the caller
+ * @param bufferLength of the character buffer
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ * @return the number of characters available for the JSON. May be larger
+ * than bufferLength if the buffer is not long enough to return the result.
+ */
+EXTERNAL size_t fiftyoneDegreesResultsIpiGetValuesJson(
+	fiftyoneDegreesResultsIpi* results,
+	char* buffer,
+	size_t bufferLength,
+	fiftyoneDegreesException* exception);
+
+/**
+ * Adds the values of all the required properties in the results to the
+ * string builder in the format provided. The names of the properties are
+ * quoted when the data set is loaded and the values are written directly to
+ * the builder, so this is faster than adding the values of each property
+ * with fiftyoneDegreesResultsIpiAddValuesString.
+ * @param results pointer to the results to render
+ * @param format of the output
+ * @param builder string builder to add the output to
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ */
+EXTERNAL void fiftyoneDegreesResultsIpiRenderAll(
+	fiftyoneDegreesResultsIpi* results,
+	fiftyoneDegreesIpiRenderFormat format,
+	fiftyoneDegreesStringBuilder* builder,
+	fiftyoneDegreesException* exception);
+
+/**
+ * Adds the header for the output of fiftyoneDegreesResultsIpiRenderAll to the
+ * string builder. Only the CSV format has a header, which is the quoted names
+ * of the required properties.
+ * @param results pointer to results from the data set to render
+ * @param format of the output
+ * @param builder string builder to add the header to
+ */
+EXTERNAL void fiftyoneDegreesResultsIpiRenderHeader(
+	fiftyoneDegreesResultsIpi* results,
+	fiftyoneDegreesIpiRenderFormat format,
+	fiftyoneDegreesStringBuilder* builder);
+
 /**
  * Get the network id string from the single result provided. This contains
  * profile ids for all components and their percentages for the matched
@@ -936,6 +1755,28 @@ EXTERNAL size_t fiftyoneDegreesIpiGetIpAddressAsString(
 	uint32_t bufferLength,
 	fiftyoneDegreesException *exception);
 
+/**
+ * Gets the key for the IP address which can be compared with
+ * #fiftyoneDegreesIpiIpKeyCompare. Converting IP addresses to keys once and
+ * then comparing the keys avoids comparing the IP addresses byte by byte.
+ * @param ipAddress IPv4 or IPv6 address to get the key for
+ * @return key for the IP address
+ */
+EXTERNAL fiftyoneDegreesIpiIpKey fiftyoneDegreesIpiIpKeyFromIpAddress(
+	const fiftyoneDegreesIpAddress *ipAddress);
+
+/**
+ * Compares two IP address keys. Keys should be from IP addresses of the same
+ * type.
+ * @param key1 first key to compare
+ * @param key2 second key to compare
+ * @return negative if the first key is lower, positive if it is higher, or 0
+ * if the keys are the same
+ */
+EXTERNAL int fiftyoneDegreesIpiIpKeyCompare(
+	const fiftyoneDegreesIpiIpKey *key1,
+	const fiftyoneDegreesIpiIpKey *key2);
+
 /**
  * @}
  */
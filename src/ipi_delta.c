@@ -0,0 +1,743 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+/**
+ * @file ipi_delta.c
+ * @brief Implementation of deltas between consecutive versions of a data
+ * file.
+ */
+
+// realpath is an extension which needs to be enabled before any system
+// header is included.
+#if !defined(_MSC_VER) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "ipi_delta.h"
+#include "fiftyone.h"
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#else
+#include <limits.h>
+#include <stdlib.h>
+#endif
+
+/**
+ * Number of bytes read from a delta at a time when it is applied.
+ */
+#define DELTA_BUFFER_LENGTH 65536
+
+/**
+ * Value of an empty entry in the block index.
+ */
+#define DELTA_NO_BLOCK UINT32_MAX
+
+/**
+ * Maximum number of blocks of the source which are indexed. Blocks beyond
+ * this are still found where they continue the previous copy.
+ */
+#define DELTA_MAX_BLOCKS (1U << 28)
+
+/**
+ * Returned when no block of the source matches the target.
+ */
+#define DELTA_NO_MATCH UINT64_MAX
+
+/**
+ * Initial value and prime of the FNV-1a checksum of the target.
+ */
+#define DELTA_CHECKSUM_INITIAL 2166136261U
+#define DELTA_CHECKSUM_PRIME 16777619U
+
+/**
+ * Marker at the start of every delta file.
+ */
+static const byte deltaMarker[8] = { '5', '1', 'D', 'I', 'P', 'I', 'D', 'L' };
+
+/**
+ * PRIVATE DATA STRUCTURES
+ */
+
+/**
+ * Data file bytes which a delta is created from or applied to.
+ */
+typedef struct delta_source_t {
+	const byte *start; /* First byte of the data file */
+	uint64_t length; /* Number of bytes in the data file */
+} deltaSource;
+
+/**
+ * Blocks of the source indexed by their weak hash.
+ */
+typedef struct delta_index_t {
+	uint32_t blockSize; /* Number of bytes in each block */
+	uint32_t blockCount; /* Number of whole blocks in the source */
+	uint32_t *weak; /* Weak hash of each block */
+	uint32_t *table; /* Block indexes in hash order, or DELTA_NO_BLOCK */
+	uint32_t mask; /* Number of entries in the table less one */
+} deltaIndex;
+
+/**
+ * Rolling weak hash of the block of the target being compared.
+ */
+typedef struct delta_weak_t {
+	uint32_t a; /* Sum of the bytes */
+	uint32_t b; /* Sum of the bytes weighted by their distance from the end */
+} deltaWeak;
+
+/**
+ * Writes operations to the delta file, combining consecutive operations of
+ * the same type.
+ */
+typedef struct delta_writer_t {
+	FILE *file; /* Delta file being written */
+	const byte *target; /* First byte of the target data file */
+	IpiDeltaOperation pending; /* Operation not yet written, or type 0 */
+	uint64_t pendingOffset; /* Offset in the target of the pending data */
+	IpiDeltaStats stats; /* Sizes of the delta written so far */
+} deltaWriter;
+
+/**
+ * CHECKSUM METHODS
+ */
+
+static uint32_t checksumAdd(
+	uint32_t checksum,
+	const byte *bytes,
+	size_t length) {
+	size_t i;
+	for (i = 0; i < length; i++) {
+		checksum ^= bytes[i];
+		checksum *= DELTA_CHECKSUM_PRIME;
+	}
+	return checksum;
+}
+
+static const byte* getTag(const deltaSource *source) {
+	return ((const DataSetIpiHeader*)source->start)->tag;
+}
+
+/**
+ * WEAK HASH METHODS
+ */
+
+static void weakInit(deltaWeak *weak, const byte *block, uint32_t length) {
+	uint32_t i;
+	weak->a = 0;
+	weak->b = 0;
+	for (i = 0; i < length; i++) {
+		weak->a += block[i];
+		weak->b += (length - i) * block[i];
+	}
+}
+
+/**
+ * Moves the block being hashed on by one byte.
+ */
+static void weakRoll(
+	deltaWeak *weak,
+	byte removed,
+	byte added,
+	uint32_t length) {
+	weak->a = weak->a - removed + added;
+	weak->b = weak->b - length * removed + weak->a;
+}
+
+static uint32_t weakGet(const deltaWeak *weak) {
+	return (weak->a & 0xffff) | (weak->b << 16);
+}
+
+/**
+ * BLOCK INDEX METHODS
+ */
+
+static uint32_t indexSlot(const deltaIndex *index, uint32_t weak) {
+	uint32_t hash = weak * 2654435761U;
+	return (hash ^ (hash >> 15)) & index->mask;
+}
+
+static void indexFree(deltaIndex *index) {
+	if (index->weak != NULL) {
+		Free(index->weak);
+	}
+	if (index->table != NULL) {
+		Free(index->table);
+	}
+}
+
+/**
+ * Indexes every whole block of the source. Where blocks are identical only
+ * the first is indexed so that repeated content, such as padding, does not
+ * lengthen the probes.
+ */
+static StatusCode indexCreate(
+	deltaIndex *index,
+	const deltaSource *source,
+	uint32_t blockSize) {
+	uint32_t i, slot, size = 16;
+	deltaWeak weak;
+	const uint64_t blockCount = source->length / blockSize;
+	index->blockSize = blockSize;
+	index->blockCount = blockCount > DELTA_MAX_BLOCKS ?
+		DELTA_MAX_BLOCKS : (uint32_t)blockCount;
+	while (size < index->blockCount * 2) {
+		size *= 2;
+	}
+	index->mask = size - 1;
+	index->weak = (uint32_t*)Malloc(
+		sizeof(uint32_t) * (index->blockCount == 0 ? 1 : index->blockCount));
+	index->table = (uint32_t*)Malloc(sizeof(uint32_t) * size);
+	if (index->weak == NULL || index->table == NULL) {
+		indexFree(index);
+		return INSUFFICIENT_MEMORY;
+	}
+	for (i = 0; i < size; i++) {
+		index->table[i] = DELTA_NO_BLOCK;
+	}
+	for (i = 0; i < index->blockCount; i++) {
+		const byte *block = source->start + (uint64_t)i * blockSize;
+		weakInit(&weak, block, blockSize);
+		index->weak[i] = weakGet(&weak);
+		slot = indexSlot(index, index->weak[i]);
+		while (index->table[slot] != DELTA_NO_BLOCK &&
+			(index->weak[index->table[slot]] != index->weak[i] ||
+			memcmp(
+				source->start + (uint64_t)index->table[slot] * blockSize,
+				block,
+				blockSize) != 0)) {
+			slot = (slot + 1) & index->mask;
+		}
+		if (index->table[slot] == DELTA_NO_BLOCK) {
+			index->table[slot] = i;
+		}
+	}
+	return SUCCESS;
+}
+
+/**
+ * Finds a block of the source which is the same as the block of the target.
+ * The offset which continues the previous copy is checked first as records
+ * which changed without changing size leave the rest of the collection at
+ * the same offset.
+ * @return offset of the matching bytes in the source, or DELTA_NO_MATCH
+ */
+static uint64_t indexFind(
+	const deltaIndex *index,
+	const deltaSource *source,
+	const byte *block,
+	uint32_t weak,
+	uint64_t expected) {
+	uint32_t slot;
+	if (expected != DELTA_NO_MATCH &&
+		expected + index->blockSize <= source->length &&
+		source->start[expected] == block[0] &&
+		memcmp(source->start + expected, block, index->blockSize) == 0) {
+		return expected;
+	}
+	slot = indexSlot(index, weak);
+	while (index->table[slot] != DELTA_NO_BLOCK) {
+		const uint64_t offset =
+			(uint64_t)index->table[slot] * index->blockSize;
+		if (index->weak[index->table[slot]] == weak &&
+			memcmp(source->start + offset, block, index->blockSize) == 0) {
+			return offset;
+		}
+		slot = (slot + 1) & index->mask;
+	}
+	return DELTA_NO_MATCH;
+}
+
+/**
+ * DELTA WRITER METHODS
+ */
+
+static StatusCode writerFlush(deltaWriter *writer) {
+	IpiDeltaOperation *pending = &writer->pending;
+	if (pending->type == 0) {
+		return SUCCESS;
+	}
+	if (fwrite(pending, sizeof(IpiDeltaOperation), 1, writer->file) != 1) {
+		return FILE_WRITE_ERROR;
+	}
+	if (pending->type == FIFTYONE_DEGREES_IPI_DELTA_DATA &&
+		fwrite(
+			writer->target + writer->pendingOffset,
+			1,
+			(size_t)pending->length,
+			writer->file) != pending->length) {
+		return FILE_WRITE_ERROR;
+	}
+	writer->stats.operations++;
+	pending->type = 0;
+	return SUCCESS;
+}
+
+/**
+ * Adds the next bytes of the target, extending the pending operation where
+ * it is of the same type and continues from it.
+ */
+static StatusCode writerAdd(
+	deltaWriter *writer,
+	IpiDeltaOperationType type,
+	uint64_t sourceOffset,
+	uint64_t targetOffset,
+	uint64_t length) {
+	StatusCode status = SUCCESS;
+	IpiDeltaOperation *pending = &writer->pending;
+	if (type == FIFTYONE_DEGREES_IPI_DELTA_COPY) {
+		writer->stats.copied += length;
+	}
+	else {
+		writer->stats.added += length;
+	}
+	if (pending->type == (byte)type && (
+		type == FIFTYONE_DEGREES_IPI_DELTA_DATA ||
+		pending->sourceOffset + pending->length == sourceOffset)) {
+		pending->length += length;
+		return SUCCESS;
+	}
+	status = writerFlush(writer);
+	pending->type = (byte)type;
+	pending->sourceOffset = type == FIFTYONE_DEGREES_IPI_DELTA_COPY ?
+		sourceOffset : 0;
+	pending->length = length;
+	writer->pendingOffset = targetOffset;
+	return status;
+}
+
+/**
+ * Writes the operations which produce the target from the source. Each
+ * position of the target is compared to the indexed blocks of the source
+ * using the rolling weak hash. Matches are extended for as long as the bytes
+ * are the same, and the bytes between matches are written as data.
+ */
+static StatusCode writeOperations(
+	deltaWriter *writer,
+	const deltaIndex *index,
+	const deltaSource *source,
+	const deltaSource *target) {
+	StatusCode status = SUCCESS;
+	deltaWeak weak;
+	bool hashed = false;
+	uint64_t position = 0, unmatched = 0, expected = 0, match, length;
+	const uint32_t blockSize = index->blockSize;
+	while (status == SUCCESS && position + blockSize <= target->length) {
+		if (hashed == false) {
+			weakInit(&weak, target->start + position, blockSize);
+			hashed = true;
+		}
+		match = indexFind(
+			index,
+			source,
+			target->start + position,
+			weakGet(&weak),
+			expected);
+		if (match == DELTA_NO_MATCH) {
+			if (position + blockSize < target->length) {
+				weakRoll(
+					&weak,
+					target->start[position],
+					target->start[position + blockSize],
+					blockSize);
+			}
+			position++;
+			if (expected != DELTA_NO_MATCH) {
+				expected++;
+			}
+			continue;
+		}
+		length = blockSize;
+		while (position + length < target->length &&
+			match + length < source->length &&
+			target->start[position + length] ==
+			source->start[match + length]) {
+			length++;
+		}
+		if (unmatched < position) {
+			status = writerAdd(
+				writer,
+				FIFTYONE_DEGREES_IPI_DELTA_DATA,
+				0,
+				unmatched,
+				position - unmatched);
+		}
+		if (status == SUCCESS) {
+			status = writerAdd(
+				writer,
+				FIFTYONE_DEGREES_IPI_DELTA_COPY,
+				match,
+				position,
+				length);
+		}
+		position += length;
+		unmatched = position;
+		expected = match + length;
+		hashed = false;
+	}
+	if (status == SUCCESS && unmatched < target->length) {
+		status = writerAdd(
+			writer,
+			FIFTYONE_DEGREES_IPI_DELTA_DATA,
+			0,
+			unmatched,
+			target->length - unmatched);
+	}
+	if (status == SUCCESS) {
+		status = writerFlush(writer);
+	}
+	return status;
+}
+
+/**
+ * Maps the data file and checks it is long enough to contain a header.
+ */
+static StatusCode mapSource(
+	const char *fileName,
+	IpiMappedFile *mapped,
+	deltaSource *source) {
+	StatusCode status = IpiMappedFileOpen(fileName, 0, mapped);
+	if (status != SUCCESS) {
+		return status;
+	}
+	if ((uint64_t)mapped->length < sizeof(DataSetIpiHeader)) {
+		IpiMappedFileClose(mapped);
+		return CORRUPT_DATA;
+	}
+	source->start = mapped->startByte;
+	source->length = (uint64_t)mapped->length;
+	return SUCCESS;
+}
+
+static StatusCode createDelta(
+	const deltaSource *source,
+	const deltaSource *target,
+	const char *deltaFileName,
+	uint32_t blockSize,
+	IpiDeltaStats *stats) {
+	StatusCode status;
+	deltaIndex index;
+	deltaWriter writer;
+	IpiDeltaHeader header;
+
+	memset(&header, 0, sizeof(IpiDeltaHeader));
+	memcpy(header.marker, deltaMarker, sizeof(deltaMarker));
+	header.version = FIFTYONE_DEGREES_IPI_DELTA_VERSION;
+	header.blockSize = blockSize;
+	memcpy(header.sourceTag, getTag(source), sizeof(header.sourceTag));
+	memcpy(header.targetTag, getTag(target), sizeof(header.targetTag));
+	header.sourceLength = source->length;
+	header.targetLength = target->length;
+	header.targetChecksum = checksumAdd(
+		DELTA_CHECKSUM_INITIAL,
+		target->start,
+		(size_t)target->length);
+
+	status = indexCreate(&index, source, blockSize);
+	if (status != SUCCESS) {
+		return status;
+	}
+	memset(&writer, 0, sizeof(deltaWriter));
+	writer.target = target->start;
+	writer.stats.sourceLength = source->length;
+	writer.stats.targetLength = target->length;
+	writer.file = fopen(deltaFileName, "wb");
+	if (writer.file == NULL) {
+		indexFree(&index);
+		return FILE_WRITE_ERROR;
+	}
+
+	// Write the header again once the number of operations is known.
+	if (fwrite(&header, sizeof(IpiDeltaHeader), 1, writer.file) != 1) {
+		status = FILE_WRITE_ERROR;
+	}
+	if (status == SUCCESS) {
+		status = writeOperations(&writer, &index, source, target);
+	}
+	if (status == SUCCESS) {
+		header.operationCount = writer.stats.operations;
+		rewind(writer.file);
+		if (fwrite(&header, sizeof(IpiDeltaHeader), 1, writer.file) != 1) {
+			status = FILE_WRITE_ERROR;
+		}
+	}
+	if (fclose(writer.file) != 0 && status == SUCCESS) {
+		status = FILE_WRITE_ERROR;
+	}
+	if (status != SUCCESS) {
+		remove(deltaFileName);
+	}
+	else if (stats != NULL) {
+		*stats = writer.stats;
+	}
+	indexFree(&index);
+	return status;
+}
+
+fiftyoneDegreesStatusCode fiftyoneDegreesIpiDeltaCreate(
+	const char *sourceFileName,
+	const char *targetFileName,
+	const char *deltaFileName,
+	uint32_t blockSize,
+	fiftyoneDegreesIpiDeltaStats *stats) {
+	StatusCode status;
+	IpiMappedFile sourceMapped, targetMapped;
+	deltaSource source, target;
+	if (blockSize == 0) {
+		blockSize = FIFTYONE_DEGREES_IPI_DELTA_DEFAULT_BLOCK_SIZE;
+	}
+	if (blockSize < FIFTYONE_DEGREES_IPI_DELTA_MIN_BLOCK_SIZE) {
+		blockSize = FIFTYONE_DEGREES_IPI_DELTA_MIN_BLOCK_SIZE;
+	}
+	status = mapSource(sourceFileName, &sourceMapped, &source);
+	if (status != SUCCESS) {
+		return status;
+	}
+	status = mapSource(targetFileName, &targetMapped, &target);
+	if (status == SUCCESS) {
+		status = createDelta(
+			&source,
+			&target,
+			deltaFileName,
+			blockSize,
+			stats);
+		IpiMappedFileClose(&targetMapped);
+	}
+	IpiMappedFileClose(&sourceMapped);
+	return status;
+}
+
+/**
+ * DELTA APPLY METHODS
+ */
+
+static StatusCode readHeader(
+	FILE *delta,
+	const deltaSource *source,
+	IpiDeltaHeader *header) {
+	if (fread(header, sizeof(IpiDeltaHeader), 1, delta) != 1 ||
+		memcmp(header->marker, deltaMarker, sizeof(deltaMarker)) != 0) {
+		return CORRUPT_DATA;
+	}
+	if (header->version != FIFTYONE_DEGREES_IPI_DELTA_VERSION ||
+		header->sourceLength != source->length ||
+		memcmp(
+			header->sourceTag,
+			getTag(source),
+			sizeof(header->sourceTag)) != 0) {
+		return INCORRECT_VERSION;
+	}
+	return SUCCESS;
+}
+
+static StatusCode writeTarget(
+	FILE *target,
+	const byte *bytes,
+	size_t length,
+	uint32_t *checksum) {
+	if (fwrite(bytes, 1, length, target) != length) {
+		return FILE_WRITE_ERROR;
+	}
+	*checksum = checksumAdd(*checksum, bytes, length);
+	return SUCCESS;
+}
+
+/**
+ * Carries out each operation of the delta in order, copying bytes from the
+ * source or from the delta to the target.
+ */
+static StatusCode applyOperations(
+	FILE *delta,
+	const deltaSource *source,
+	const IpiDeltaHeader *header,
+	FILE *target,
+	byte *buffer) {
+	uint32_t i;
+	size_t length;
+	uint64_t remaining, written = 0;
+	uint32_t checksum = DELTA_CHECKSUM_INITIAL;
+	StatusCode status = SUCCESS;
+	IpiDeltaOperation operation;
+	for (i = 0; i < header->operationCount && status == SUCCESS; i++) {
+		if (fread(&operation, sizeof(IpiDeltaOperation), 1, delta) != 1 ||
+			operation.length > header->targetLength - written) {
+			return CORRUPT_DATA;
+		}
+		switch (operation.type) {
+		case FIFTYONE_DEGREES_IPI_DELTA_COPY:
+			if (operation.sourceOffset > source->length ||
+				operation.length > source->length - operation.sourceOffset) {
+				return CORRUPT_DATA;
+			}
+			status = writeTarget(
+				target,
+				source->start + operation.sourceOffset,
+				(size_t)operation.length,
+				&checksum);
+			break;
+		case FIFTYONE_DEGREES_IPI_DELTA_DATA:
+			remaining = operation.length;
+			while (remaining > 0 && status == SUCCESS) {
+				length = remaining > DELTA_BUFFER_LENGTH ?
+					DELTA_BUFFER_LENGTH : (size_t)remaining;
+				if (fread(buffer, 1, length, delta) != length) {
+					return CORRUPT_DATA;
+				}
+				status = writeTarget(target, buffer, length, &checksum);
+				remaining -= length;
+			}
+			break;
+		default:
+			return CORRUPT_DATA;
+		}
+		written += operation.length;
+	}
+	if (status == SUCCESS && (
+		written != header->targetLength ||
+		checksum != header->targetChecksum)) {
+		status = CORRUPT_DATA;
+	}
+	return status;
+}
+
+/**
+ * Applies the delta to the source, removing the target if it could not be
+ * written in full so a partial data file is never left behind.
+ */
+static StatusCode applyDelta(
+	const deltaSource *source,
+	const char *deltaFileName,
+	const char *targetFileName) {
+	FILE *delta, *target;
+	IpiDeltaHeader header;
+	StatusCode status = FileOpen(deltaFileName, &delta);
+	if (status != SUCCESS) {
+		return status;
+	}
+	status = readHeader(delta, source, &header);
+	if (status != SUCCESS) {
+		fclose(delta);
+		return status;
+	}
+	byte *buffer = (byte*)Malloc(DELTA_BUFFER_LENGTH);
+	if (buffer == NULL) {
+		fclose(delta);
+		return INSUFFICIENT_MEMORY;
+	}
+	target = fopen(targetFileName, "wb");
+	if (target == NULL) {
+		status = FILE_WRITE_ERROR;
+	}
+	else {
+		status = applyOperations(delta, source, &header, target, buffer);
+		if (fclose(target) != 0 && status == SUCCESS) {
+			status = FILE_WRITE_ERROR;
+		}
+		if (status != SUCCESS) {
+			remove(targetFileName);
+		}
+	}
+	Free(buffer);
+	fclose(delta);
+	return status;
+}
+
+fiftyoneDegreesStatusCode fiftyoneDegreesIpiDeltaApply(
+	const char *sourceFileName,
+	const char *deltaFileName,
+	const char *targetFileName) {
+	IpiMappedFile mapped;
+	deltaSource source;
+	StatusCode status = mapSource(sourceFileName, &mapped, &source);
+	if (status == SUCCESS) {
+		status = applyDelta(&source, deltaFileName, targetFileName);
+		IpiMappedFileClose(&mapped);
+	}
+	return status;
+}
+
+/**
+ * Returns true if the paths refer to the same file once they have been made
+ * absolute and any "." and ".." segments, and on POSIX symbolic links, have
+ * been resolved. Where a path can't be resolved, usually because the file
+ * does not exist yet, the paths are compared as they are.
+ */
+static bool isSameFile(const char *path1, const char *path2) {
+#ifdef _MSC_VER
+	char full1[_MAX_PATH], full2[_MAX_PATH];
+	if (_fullpath(full1, path1, sizeof(full1)) == NULL ||
+		_fullpath(full2, path2, sizeof(full2)) == NULL) {
+		return _stricmp(path1, path2) == 0;
+	}
+	return _stricmp(full1, full2) == 0;
+#else
+	char full1[PATH_MAX], full2[PATH_MAX];
+	if (realpath(path1, full1) == NULL ||
+		realpath(path2, full2) == NULL) {
+		return strcmp(path1, path2) == 0;
+	}
+	return strcmp(full1, full2) == 0;
+#endif
+}
+
+fiftyoneDegreesStatusCode fiftyoneDegreesIpiReloadManagerFromDelta(
+	fiftyoneDegreesResourceManager *manager,
+	const char *deltaFileName,
+	const char *targetFileName,
+	fiftyoneDegreesException *exception) {
+	StatusCode status = SUCCESS;
+	IpiMappedFile mapped;
+	deltaSource source;
+	IpiMappedFileReset(&mapped);
+	DataSetIpi *dataSet = DataSetIpiGet(manager);
+
+	// Writing over the data file being read would corrupt the active data
+	// set, however the path to it is written.
+	if (isSameFile(targetFileName, dataSet->b.b.fileName) ||
+		isSameFile(targetFileName, dataSet->b.b.masterFileName)) {
+		status = FILE_WRITE_ERROR;
+	}
+
+	// Use the bytes of the data file already in memory if the active data
+	// set has them, otherwise map the data file it was created from.
+	else if (dataSet->mapped.startByte != NULL) {
+		source.start = dataSet->mapped.startByte;
+		source.length = (uint64_t)dataSet->mapped.length;
+	}
+	else if (dataSet->memory != NULL) {
+		source.start = dataSet->memory;
+		source.length = (uint64_t)dataSet->memoryLength;
+	}
+	else {
+		status = mapSource(dataSet->b.b.fileName, &mapped, &source);
+	}
+	if (status == SUCCESS) {
+		status = applyDelta(&source, deltaFileName, targetFileName);
+	}
+	IpiMappedFileClose(&mapped);
+	DataSetIpiRelease(dataSet);
+
+	if (status == SUCCESS) {
+		status = IpiReloadManagerFromFile(manager, targetFileName, exception);
+	}
+	return status;
+}
@@ -0,0 +1,180 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_IPI_DELTA_INCLUDED
+#define FIFTYONE_DEGREES_IPI_DELTA_INCLUDED
+
+/**
+ * @file ipi_delta.h
+ * @brief Deltas between consecutive versions of a data file.
+ *
+ * Consecutive data files share most of their collections, so an update can
+ * be distributed as a delta which only contains the bytes that changed.
+ * #fiftyoneDegreesIpiDeltaCreate compares the new data file to the previous
+ * one in blocks, recording blocks found anywhere in the previous data file as
+ * copies and everything else as new data. Records which move because
+ * others were added or removed before them are still found.
+ *
+ * #fiftyoneDegreesIpiDeltaApply rebuilds the new data file from the previous
+ * one and the delta, reading both in a fixed size buffer.
+ * #fiftyoneDegreesIpiReloadManagerFromDelta does the same using the data set
+ * being used by a resource manager as the previous data file, then reloads
+ * the manager from the result. Where the active data set holds the data file
+ * in memory the unchanged bytes are copied from it without reading the
+ * previous data file again.
+ *
+ * A delta only reduces the size of the update which is transferred. The new
+ * data file is still written in full and the manager reloaded from it, so a
+ * reload from a delta needs the same disk space and memory as any other
+ * reload, with the new data set created alongside the active one.
+ *
+ * The delta records the tags and lengths of both data files and a checksum
+ * of the new one, so a delta applied to the wrong data file, or which is
+ * truncated, is reported rather than producing a corrupt data file.
+ */
+
+#include <stdint.h>
+#include "ipi.h"
+
+/**
+ * Version of the delta format written by #fiftyoneDegreesIpiDeltaCreate.
+ */
+#define FIFTYONE_DEGREES_IPI_DELTA_VERSION 1
+
+/**
+ * Block size used when zero is passed to #fiftyoneDegreesIpiDeltaCreate.
+ */
+#define FIFTYONE_DEGREES_IPI_DELTA_DEFAULT_BLOCK_SIZE 1024
+
+/**
+ * Smallest block size which can be used to create a delta.
+ */
+#define FIFTYONE_DEGREES_IPI_DELTA_MIN_BLOCK_SIZE 16
+
+#pragma pack(push, 1)
+/**
+ * Header at the start of a delta file.
+ */
+typedef struct fiftyone_degrees_ipi_delta_header_t {
+	byte marker[8]; /**< Marker identifying the file as a delta */
+	uint32_t version; /**< Version of the delta format */
+	uint32_t blockSize; /**< Block size used to create the delta */
+	byte sourceTag[16]; /**< Tag of the data file the delta applies to */
+	byte targetTag[16]; /**< Tag of the data file produced by the delta */
+	uint64_t sourceLength; /**< Length of the data file the delta applies to */
+	uint64_t targetLength; /**< Length of the data file produced */
+	uint32_t targetChecksum; /**< Checksum of the data file produced */
+	uint32_t operationCount; /**< Number of operations following the header */
+} fiftyoneDegreesIpiDeltaHeader;
+
+/**
+ * Operation which writes the next bytes of the new data file. The bytes for a
+ * data operation follow it in the delta file.
+ */
+typedef struct fiftyone_degrees_ipi_delta_operation_t {
+	byte type; /**< Type of the operation. See
+			   fiftyoneDegreesIpiDeltaOperationType */
+	uint64_t sourceOffset; /**< Offset in the previous data file to copy from
+						   or zero for a data operation */
+	uint64_t length; /**< Number of bytes written by the operation */
+} fiftyoneDegreesIpiDeltaOperation;
+#pragma pack(pop)
+
+/**
+ * Types of delta operation.
+ */
+typedef enum e_fiftyone_degrees_ipi_delta_operation_type {
+	FIFTYONE_DEGREES_IPI_DELTA_COPY = 1, /**< Copy bytes from the previous
+										 data file */
+	FIFTYONE_DEGREES_IPI_DELTA_DATA = 2 /**< Write bytes from the delta */
+} fiftyoneDegreesIpiDeltaOperationType;
+
+/**
+ * Sizes of a delta returned by #fiftyoneDegreesIpiDeltaCreate.
+ */
+typedef struct fiftyone_degrees_ipi_delta_stats_t {
+	uint64_t sourceLength; /**< Length of the previous data file */
+	uint64_t targetLength; /**< Length of the new data file */
+	uint64_t copied; /**< Bytes of the new data file copied from the
+					 previous one */
+	uint64_t added; /**< Bytes of the new data file held in the delta */
+	uint32_t operations; /**< Number of operations in the delta */
+} fiftyoneDegreesIpiDeltaStats;
+
+/**
+ * Creates a delta which produces the target data file from the source data
+ * file. Both data files are mapped into memory while the delta is created.
+ * @param sourceFileName path to the previous data file
+ * @param targetFileName path to the new data file
+ * @param deltaFileName path to write the delta to
+ * @param blockSize number of bytes compared at a time, or zero for
+ * #FIFTYONE_DEGREES_IPI_DELTA_DEFAULT_BLOCK_SIZE. Smaller blocks find more of
+ * the unchanged bytes but need more memory and produce more operations
+ * @param stats to set to the sizes of the delta, or NULL
+ * @return the status associated with creating the delta
+ */
+EXTERNAL fiftyoneDegreesStatusCode fiftyoneDegreesIpiDeltaCreate(
+	const char *sourceFileName,
+	const char *targetFileName,
+	const char *deltaFileName,
+	uint32_t blockSize,
+	fiftyoneDegreesIpiDeltaStats *stats);
+
+/**
+ * Writes the target data file produced by applying the delta to the source
+ * data file.
+ * @param sourceFileName path to the data file the delta was created from
+ * @param deltaFileName path to the delta
+ * @param targetFileName path to write the new data file to
+ * @return the status associated with applying the delta.
+ * #FIFTYONE_DEGREES_STATUS_INCORRECT_VERSION is returned if the delta was not
+ * created from the source data file, and
+ * #FIFTYONE_DEGREES_STATUS_CORRUPT_DATA if the data file produced does not
+ * match the one the delta was created for
+ */
+EXTERNAL fiftyoneDegreesStatusCode fiftyoneDegreesIpiDeltaApply(
+	const char *sourceFileName,
+	const char *deltaFileName,
+	const char *targetFileName);
+
+/**
+ * Applies the delta to the data file of the data set being used by the
+ * resource manager, writing the new data file, and then reloads the manager
+ * from the new data file with the same configuration and required
+ * properties. The new data file must not be the one being used by the active
+ * data set, which is checked after resolving both paths. The whole new data
+ * file is written and loaded, so memory is used as for any other reload.
+ * @param manager pointer to the resource manager to reload the data set for
+ * @param deltaFileName path to the delta
+ * @param targetFileName path to write the new data file to
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h.
+ * @return the status associated with the reload. Any value other than
+ * #FIFTYONE_DEGREES_STATUS_SUCCESS means the data set was not reloaded
+ */
+EXTERNAL fiftyoneDegreesStatusCode fiftyoneDegreesIpiReloadManagerFromDelta(
+	fiftyoneDegreesResourceManager *manager,
+	const char *deltaFileName,
+	const char *targetFileName,
+	fiftyoneDegreesException *exception);
+
+#endif
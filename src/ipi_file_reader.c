@@ -0,0 +1,215 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+/**
+ * @file ipi_file_reader.c
+ * @brief Implementation of positional reads from a single handle shared by
+ * every thread.
+ */
+
+// pread is a POSIX extension which needs to be enabled before any system
+// header is included.
+#if !defined(_MSC_VER) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "ipi_file_reader.h"
+#include "fiftyone.h"
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Checks the bytes to read are within the file.
+ */
+static bool isInFile(
+	const IpiFileReader *reader,
+	FileOffset offset,
+	size_t length) {
+	return offset >= 0 &&
+		offset <= reader->length &&
+		(uint64_t)length <= (uint64_t)(reader->length - offset);
+}
+
+#ifdef _MSC_VER
+
+void fiftyoneDegreesIpiFileReaderReset(IpiFileReader *reader) {
+	reader->file = INVALID_HANDLE_VALUE;
+	reader->length = 0;
+}
+
+StatusCode fiftyoneDegreesIpiFileReaderOpen(
+	const char *fileName,
+	IpiFileReader *reader) {
+	LARGE_INTEGER size;
+	fiftyoneDegreesIpiFileReaderReset(reader);
+	reader->file = CreateFileA(
+		fileName,
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL |
+		FILE_FLAG_RANDOM_ACCESS |
+		FILE_FLAG_OVERLAPPED,
+		NULL);
+	if (reader->file == INVALID_HANDLE_VALUE) {
+		return GetLastError() == ERROR_FILE_NOT_FOUND ?
+			FILE_NOT_FOUND :
+			FILE_FAILURE;
+	}
+	if (GetFileSizeEx(reader->file, &size) == FALSE) {
+		fiftyoneDegreesIpiFileReaderClose(reader);
+		return FILE_FAILURE;
+	}
+	reader->length = (FileOffset)size.QuadPart;
+	return SUCCESS;
+}
+
+StatusCode fiftyoneDegreesIpiFileReaderRead(
+	const IpiFileReader *reader,
+	FileOffset offset,
+	void *destination,
+	size_t length) {
+	OVERLAPPED overlapped;
+	DWORD bytesRead;
+	HANDLE event;
+	StatusCode status = SUCCESS;
+	byte *current = (byte*)destination;
+	if (isInFile(reader, offset, length) == false) {
+		return POINTER_OUT_OF_BOUNDS;
+	}
+
+	// The handle is opened for overlapped IO so that the offset in the
+	// overlapped structure applies to this read only, and the position of
+	// the handle shared with other threads is never used. Each call has its
+	// own event as the handle would be signalled for any thread's read.
+	event = CreateEventA(NULL, TRUE, FALSE, NULL);
+	if (event == NULL) {
+		return FILE_FAILURE;
+	}
+	while (length > 0 && status == SUCCESS) {
+		const DWORD chunk = length > MAXDWORD ? MAXDWORD : (DWORD)length;
+		memset(&overlapped, 0, sizeof(OVERLAPPED));
+		overlapped.Offset = (DWORD)((uint64_t)offset & 0xffffffff);
+		overlapped.OffsetHigh = (DWORD)((uint64_t)offset >> 32);
+		overlapped.hEvent = event;
+		if (ReadFile(
+			reader->file,
+			current,
+			chunk,
+			NULL,
+			&overlapped) == FALSE &&
+			GetLastError() != ERROR_IO_PENDING) {
+			status = FILE_FAILURE;
+		}
+		else if (GetOverlappedResult(
+			reader->file,
+			&overlapped,
+			&bytesRead,
+			TRUE) == FALSE || bytesRead == 0) {
+			status = FILE_FAILURE;
+		}
+		else {
+			current += bytesRead;
+			offset += bytesRead;
+			length -= bytesRead;
+		}
+	}
+	CloseHandle(event);
+	return status;
+}
+
+void fiftyoneDegreesIpiFileReaderClose(IpiFileReader *reader) {
+	if (reader->file != INVALID_HANDLE_VALUE) {
+		CloseHandle(reader->file);
+	}
+	fiftyoneDegreesIpiFileReaderReset(reader);
+}
+
+#else
+
+void fiftyoneDegreesIpiFileReaderReset(IpiFileReader *reader) {
+	reader->file = -1;
+	reader->length = 0;
+}
+
+StatusCode fiftyoneDegreesIpiFileReaderOpen(
+	const char *fileName,
+	IpiFileReader *reader) {
+	struct stat info;
+	fiftyoneDegreesIpiFileReaderReset(reader);
+	reader->file = open(fileName, O_RDONLY);
+	if (reader->file < 0) {
+		return errno == ENOENT ? FILE_NOT_FOUND : FILE_FAILURE;
+	}
+	if (fstat(reader->file, &info) != 0) {
+		fiftyoneDegreesIpiFileReaderClose(reader);
+		return FILE_FAILURE;
+	}
+	reader->length = (FileOffset)info.st_size;
+	return SUCCESS;
+}
+
+StatusCode fiftyoneDegreesIpiFileReaderRead(
+	const IpiFileReader *reader,
+	FileOffset offset,
+	void *destination,
+	size_t length) {
+	ssize_t bytesRead;
+	byte *current = (byte*)destination;
+	if (isInFile(reader, offset, length) == false) {
+		return POINTER_OUT_OF_BOUNDS;
+	}
+
+	// pread does not move the file position, so the descriptor can be shared
+	// by any number of threads. Reads can return fewer bytes than requested,
+	// or be interrupted, in which case the rest is read again.
+	while (length > 0) {
+		bytesRead = pread(reader->file, current, length, (off_t)offset);
+		if (bytesRead < 0 && errno == EINTR) {
+			continue;
+		}
+		if (bytesRead <= 0) {
+			return FILE_FAILURE;
+		}
+		current += bytesRead;
+		offset += bytesRead;
+		length -= (size_t)bytesRead;
+	}
+	return SUCCESS;
+}
+
+void fiftyoneDegreesIpiFileReaderClose(IpiFileReader *reader) {
+	if (reader->file >= 0) {
+		close(reader->file);
+	}
+	fiftyoneDegreesIpiFileReaderReset(reader);
+}
+
+#endif
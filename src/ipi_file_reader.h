@@ -0,0 +1,96 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_IPI_FILE_READER_INCLUDED
+#define FIFTYONE_DEGREES_IPI_FILE_READER_INCLUDED
+
+/**
+ * @file ipi_file_reader.h
+ * @brief Positional reads from a single handle shared by every thread.
+ *
+ * A file pool gives each thread its own handle so that a seek followed by a
+ * read is not interrupted by another thread. The number of handles limits
+ * how many threads can read at once. Positional reads take the offset as part
+ * of the read, so one handle can be used by any number of threads at the same
+ * time without locks or a pool.
+ */
+
+#include <stdint.h>
+#include "common-cxx/data.h"
+#include "common-cxx/file.h"
+#include "common-cxx/status.h"
+
+/**
+ * File open for positional reads.
+ */
+typedef struct fiftyone_degrees_ipi_file_reader_t {
+#ifdef _MSC_VER
+	void *file; /**< Handle of the open file */
+#else
+	int file; /**< Descriptor of the open file, or -1 */
+#endif
+	fiftyoneDegreesFileOffset length; /**< Number of bytes in the file */
+} fiftyoneDegreesIpiFileReader;
+
+/**
+ * Resets the reader so that it can be closed even if it was never opened.
+ * @param reader to reset
+ */
+EXTERNAL void fiftyoneDegreesIpiFileReaderReset(
+	fiftyoneDegreesIpiFileReader *reader);
+
+/**
+ * Opens the file read only for positional reads.
+ * @param fileName path to the file to open
+ * @param reader to set to the open file
+ * @return the status of the operation
+ */
+EXTERNAL fiftyoneDegreesStatusCode fiftyoneDegreesIpiFileReaderOpen(
+	const char *fileName,
+	fiftyoneDegreesIpiFileReader *reader);
+
+/**
+ * Reads bytes from the offset provided without changing any state shared
+ * with other threads, so it can be called from any number of threads at the
+ * same time.
+ * @param reader open file to read from
+ * @param offset of the first byte to read from the start of the file
+ * @param destination to copy the bytes to
+ * @param length number of bytes to read
+ * @return #FIFTYONE_DEGREES_STATUS_SUCCESS if every byte was read,
+ * #FIFTYONE_DEGREES_STATUS_POINTER_OUT_OF_BOUNDS if the bytes are beyond the
+ * end of the file, otherwise #FIFTYONE_DEGREES_STATUS_FILE_FAILURE
+ */
+EXTERNAL fiftyoneDegreesStatusCode fiftyoneDegreesIpiFileReaderRead(
+	const fiftyoneDegreesIpiFileReader *reader,
+	fiftyoneDegreesFileOffset offset,
+	void *destination,
+	size_t length);
+
+/**
+ * Closes the file if it is open and resets the reader.
+ * @param reader to close
+ */
+EXTERNAL void fiftyoneDegreesIpiFileReaderClose(
+	fiftyoneDegreesIpiFileReader *reader);
+
+#endif
@@ -0,0 +1,182 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+/**
+ * @file ipi_mapped.c
+ * @brief Implementation of read only mapping of a data file into memory.
+ */
+
+// MAP_POPULATE and madvise are extensions which need to be enabled before
+// any system header is included.
+#if !defined(_MSC_VER) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
+#include "ipi_mapped.h"
+#include "fiftyone.h"
+
+#ifdef _MSC_VER
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+void fiftyoneDegreesIpiMappedFileReset(IpiMappedFile *mapped) {
+	mapped->startByte = NULL;
+	mapped->length = 0;
+#ifdef _MSC_VER
+	mapped->file = INVALID_HANDLE_VALUE;
+	mapped->mapping = NULL;
+#endif
+}
+
+#ifdef _MSC_VER
+
+StatusCode fiftyoneDegreesIpiMappedFileOpen(
+	const char *fileName,
+	uint8_t hints,
+	IpiMappedFile *mapped) {
+	LARGE_INTEGER size;
+	fiftyoneDegreesIpiMappedFileReset(mapped);
+
+	// Windows reads mapped pages on demand and has no equivalent of the
+	// hints which are all optional.
+	UNREFERENCED_PARAMETER(hints);
+
+	mapped->file = CreateFileA(
+		fileName,
+		GENERIC_READ,
+		FILE_SHARE_READ,
+		NULL,
+		OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL,
+		NULL);
+	if (mapped->file == INVALID_HANDLE_VALUE) {
+		return GetLastError() == ERROR_FILE_NOT_FOUND ?
+			FILE_NOT_FOUND :
+			FILE_FAILURE;
+	}
+	if (GetFileSizeEx(mapped->file, &size) == FALSE || size.QuadPart == 0) {
+		fiftyoneDegreesIpiMappedFileClose(mapped);
+		return FILE_FAILURE;
+	}
+	mapped->mapping = CreateFileMappingA(
+		mapped->file,
+		NULL,
+		PAGE_READONLY,
+		0,
+		0,
+		NULL);
+	if (mapped->mapping == NULL) {
+		fiftyoneDegreesIpiMappedFileClose(mapped);
+		return FILE_FAILURE;
+	}
+	mapped->startByte = (byte*)MapViewOfFile(
+		mapped->mapping,
+		FILE_MAP_READ,
+		0,
+		0,
+		0);
+	if (mapped->startByte == NULL) {
+		fiftyoneDegreesIpiMappedFileClose(mapped);
+		return INSUFFICIENT_MEMORY;
+	}
+	mapped->length = (FileOffset)size.QuadPart;
+	return SUCCESS;
+}
+
+void fiftyoneDegreesIpiMappedFileClose(IpiMappedFile *mapped) {
+	if (mapped->startByte != NULL) {
+		UnmapViewOfFile(mapped->startByte);
+	}
+	if (mapped->mapping != NULL) {
+		CloseHandle(mapped->mapping);
+	}
+	if (mapped->file != INVALID_HANDLE_VALUE) {
+		CloseHandle(mapped->file);
+	}
+	fiftyoneDegreesIpiMappedFileReset(mapped);
+}
+
+#else
+
+StatusCode fiftyoneDegreesIpiMappedFileOpen(
+	const char *fileName,
+	uint8_t hints,
+	IpiMappedFile *mapped) {
+	struct stat info;
+	int flags = MAP_SHARED;
+	fiftyoneDegreesIpiMappedFileReset(mapped);
+
+	const int file = open(fileName, O_RDONLY);
+	if (file < 0) {
+		return errno == ENOENT ? FILE_NOT_FOUND : FILE_FAILURE;
+	}
+	if (fstat(file, &info) != 0 || info.st_size == 0) {
+		close(file);
+		return FILE_FAILURE;
+	}
+#ifdef MAP_POPULATE
+	if ((hints & FIFTYONE_DEGREES_IPI_MAP_POPULATE) != 0) {
+		flags |= MAP_POPULATE;
+	}
+#endif
+	void * const start = mmap(
+		NULL,
+		(size_t)info.st_size,
+		PROT_READ,
+		flags,
+		file,
+		0);
+
+	// The mapping remains valid after the file is closed.
+	close(file);
+	if (start == MAP_FAILED) {
+		return errno == ENOMEM ? INSUFFICIENT_MEMORY : FILE_FAILURE;
+	}
+	mapped->startByte = (byte*)start;
+	mapped->length = (FileOffset)info.st_size;
+
+	// The advice is only a hint so failures are ignored.
+	if ((hints & FIFTYONE_DEGREES_IPI_MAP_WILL_NEED) != 0) {
+		madvise(start, (size_t)mapped->length, MADV_WILLNEED);
+	}
+#ifdef MADV_HUGEPAGE
+	if ((hints & FIFTYONE_DEGREES_IPI_MAP_HUGE_PAGES) != 0) {
+		madvise(start, (size_t)mapped->length, MADV_HUGEPAGE);
+	}
+#endif
+	return SUCCESS;
+}
+
+void fiftyoneDegreesIpiMappedFileClose(IpiMappedFile *mapped) {
+	if (mapped->startByte != NULL) {
+		munmap(mapped->startByte, (size_t)mapped->length);
+	}
+	fiftyoneDegreesIpiMappedFileReset(mapped);
+}
+
+#endif
@@ -0,0 +1,106 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_IPI_MAPPED_INCLUDED
+#define FIFTYONE_DEGREES_IPI_MAPPED_INCLUDED
+
+/**
+ * @file ipi_mapped.h
+ * @brief Read only mapping of a data file into memory.
+ *
+ * When an all in memory data set is created from a mapping, the collections
+ * point directly into the pages of the data file rather than into a copy
+ * read into allocated memory. Loading does not need to read the whole file
+ * first, and the operating system can share the same physical pages between
+ * every process which maps the same data file.
+ *
+ * A mapping sees any change made to the file while it is mapped, and access
+ * faults if the file is truncated. Data sets therefore only map a temporary
+ * copy of the data file which nothing else writes to, and a data file which
+ * is mapped directly must only ever be replaced by renaming a new file over
+ * it.
+ */
+
+#include <stdint.h>
+#include "common-cxx/data.h"
+#include "common-cxx/file.h"
+#include "common-cxx/status.h"
+
+/**
+ * Read all the pages of the mapping when it is created so that the first
+ * requests do not wait for them to be read. Only supported on Linux.
+ */
+#define FIFTYONE_DEGREES_IPI_MAP_POPULATE 0x01
+
+/**
+ * Advise the operating system that all the pages of the mapping will be
+ * needed so that they can be read ahead in the background.
+ */
+#define FIFTYONE_DEGREES_IPI_MAP_WILL_NEED 0x02
+
+/**
+ * Advise the operating system to use huge pages for the mapping where
+ * transparent huge pages are supported for files.
+ */
+#define FIFTYONE_DEGREES_IPI_MAP_HUGE_PAGES 0x04
+
+/**
+ * Read only mapping of a file into memory.
+ */
+typedef struct fiftyone_degrees_ipi_mapped_file_t {
+	byte *startByte; /**< First byte of the mapping, or NULL if the file is
+					 not mapped */
+	fiftyoneDegreesFileOffset length; /**< Number of bytes mapped */
+#ifdef _MSC_VER
+	void *file; /**< Handle of the mapped file */
+	void *mapping; /**< Handle of the file mapping object */
+#endif
+} fiftyoneDegreesIpiMappedFile;
+
+/**
+ * Resets the mapped file so that it can be closed even if it was never
+ * opened.
+ * @param mapped file to reset
+ */
+EXTERNAL void fiftyoneDegreesIpiMappedFileReset(
+	fiftyoneDegreesIpiMappedFile *mapped);
+
+/**
+ * Maps the whole of the file read only into memory.
+ * @param fileName path to the file to map
+ * @param hints combination of the FIFTYONE_DEGREES_IPI_MAP_* flags, or 0
+ * @param mapped file to set to the mapping
+ * @return the status of the operation
+ */
+EXTERNAL fiftyoneDegreesStatusCode fiftyoneDegreesIpiMappedFileOpen(
+	const char *fileName,
+	uint8_t hints,
+	fiftyoneDegreesIpiMappedFile *mapped);
+
+/**
+ * Removes the mapping if the file is mapped and resets the mapped file.
+ * @param mapped file to close
+ */
+EXTERNAL void fiftyoneDegreesIpiMappedFileClose(
+	fiftyoneDegreesIpiMappedFile *mapped);
+
+#endif
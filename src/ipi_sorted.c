@@ -0,0 +1,379 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+/**
+ * @file ipi_sorted.c
+ * @brief Implementation of offline processing of IP addresses in ascending
+ * order.
+ */
+
+#include <ctype.h>
+#include "ipi_sorted.h"
+#include "fiftyone.h"
+
+/**
+ * Number of characters, including the null terminator, kept for the text of
+ * each IP address. Enough for an IPv6 address with an embedded IPv4 address.
+ */
+#define SORT_TEXT_LENGTH 48
+
+/**
+ * Number of characters read from the input file for each line.
+ */
+#define SORT_LINE_LENGTH 256
+
+/**
+ * Initial number of runs allocated when sorting a file.
+ */
+#define SORT_RUNS_INITIAL_CAPACITY 16
+
+/**
+ * PRIVATE DATA STRUCTURES
+ */
+
+/**
+ * IP address read from the input file.
+ */
+typedef struct sort_record_t {
+	IpAddress address; /* Parsed IP address used to order the records */
+	char text[SORT_TEXT_LENGTH]; /* IP address as it appeared in the input */
+} sortRecord;
+
+/**
+ * Sorted block of records written to a temporary file.
+ */
+typedef struct sort_run_t {
+	FILE *file; /* Temporary file containing the records */
+	sortRecord current; /* Next record from the run to be merged */
+	bool available; /* True if current contains a record */
+} sortRun;
+
+/**
+ * All the runs written while sorting a file.
+ */
+typedef struct sort_runs_t {
+	sortRun *items; /* Runs in the order they were written */
+	uint32_t count; /* Number of runs */
+	uint32_t capacity; /* Number of runs allocated */
+} sortRuns;
+
+/**
+ * SORTED PROCESSING METHODS
+ */
+
+static int getIpAddressLength(IpType type) {
+	return type == IP_TYPE_IPV4 ? IPV4_LENGTH : IPV6_LENGTH;
+}
+
+/**
+ * Returns true if the IP address is within the range of every result from
+ * the IP address the results were last populated from, so every result is
+ * the same for it. Each result is checked against the range of its own
+ * component, so results of components without range properties are never
+ * reused.
+ */
+static bool isInResultsRange(
+	ResultsIpi *results,
+	const IpAddress *ipAddress,
+	Exception *exception) {
+	const int length = getIpAddressLength(ipAddress->type);
+	if (results->count == 0 || results->items[0].type != ipAddress->type) {
+		return false;
+	}
+	for (uint32_t i = 0; i < results->count; i++) {
+		const ResultIpi *result = ResultsIpiGetResultRange(
+			results,
+			i,
+			exception);
+		if (EXCEPTION_FAILED ||
+			result->rangeId == FIFTYONE_DEGREES_IPI_NO_RANGE_ID ||
+			memcmp(result->rangeStart.value, ipAddress->value, length) > 0 ||
+			memcmp(ipAddress->value, result->rangeEnd.value, length) > 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+uint32_t fiftyoneDegreesResultsIpiFromSortedIpAddresses(
+	fiftyoneDegreesResultsIpi *results,
+	void *state,
+	fiftyoneDegreesIpiIpAddressNextMethod next,
+	fiftyoneDegreesIpiSortedResultsMethod callback,
+	fiftyoneDegreesException *exception) {
+	uint32_t i, count = 0;
+	IpAddress ipAddress;
+	while (next(state, &ipAddress)) {
+		if (isInResultsRange(results, &ipAddress, exception)) {
+
+			// The graph results are the same for every IP address in the
+			// range so only the target IP address changes.
+			for (i = 0; i < results->count; i++) {
+				memcpy(
+					results->items[i].targetIpAddress.value,
+					ipAddress.value,
+					IPV6_LENGTH);
+			}
+		}
+		else if (
+			ipAddress.type == IP_TYPE_IPV4 ||
+			ipAddress.type == IP_TYPE_IPV6) {
+			ResultsIpiFromIpAddress(
+				results,
+				ipAddress.value,
+				getIpAddressLength(ipAddress.type),
+				ipAddress.type,
+				exception);
+			if (EXCEPTION_FAILED) {
+				break;
+			}
+		}
+		else {
+			results->count = 0;
+		}
+		count++;
+		if (callback(state, results) == false) {
+			break;
+		}
+	}
+	return count;
+}
+
+/**
+ * FILE SORTING METHODS
+ */
+
+static int compareRecords(const void *a, const void *b) {
+	const IpAddress *x = &((const sortRecord*)a)->address;
+	const IpAddress *y = &((const sortRecord*)b)->address;
+	if (x->type != y->type) {
+		return (int)x->type - (int)y->type;
+	}
+	return memcmp(x->value, y->value, getIpAddressLength(x->type));
+}
+
+/**
+ * Reads the next valid IP address from the input file into the record.
+ * Returns false when the end of the file is reached.
+ */
+static bool readRecord(FILE *input, sortRecord *record) {
+	char line[SORT_LINE_LENGTH];
+	while (fgets(line, sizeof(line), input) != NULL) {
+		size_t length = strlen(line);
+
+		// Discard the rest of a line which is too long for the buffer.
+		if (length > 0 && line[length - 1] != '\n' && feof(input) == 0) {
+			int c;
+			do {
+				c = fgetc(input);
+			} while (c != '\n' && c != EOF);
+			continue;
+		}
+
+		// Remove the surrounding white space.
+		while (length > 0 && isspace((unsigned char)line[length - 1])) {
+			line[--length] = '\0';
+		}
+		const char *start = line;
+		while (isspace((unsigned char)*start)) {
+			start++;
+			length--;
+		}
+		if (length == 0 || length >= SORT_TEXT_LENGTH) {
+			continue;
+		}
+		if (IpAddressParse(start, start + length, &record->address) &&
+			(record->address.type == IP_TYPE_IPV4 ||
+			record->address.type == IP_TYPE_IPV6)) {
+			memcpy(record->text, start, length);
+			record->text[length] = '\0';
+			return true;
+		}
+	}
+	return false;
+}
+
+static uint32_t readRecords(
+	FILE *input,
+	sortRecord *records,
+	uint32_t capacity) {
+	uint32_t count = 0;
+	while (count < capacity && readRecord(input, &records[count])) {
+		count++;
+	}
+	return count;
+}
+
+static StatusCode writeRecord(FILE *output, const sortRecord *record) {
+	return fprintf(output, "%s\n", record->text) < 0 ?
+		FILE_WRITE_ERROR : SUCCESS;
+}
+
+static StatusCode writeRecords(
+	const char *outputFilePath,
+	const sortRecord *records,
+	uint32_t count) {
+	uint32_t i;
+	StatusCode status = SUCCESS;
+	FILE *output = fopen(outputFilePath, "w");
+	if (output == NULL) {
+		return FILE_WRITE_ERROR;
+	}
+	for (i = 0; i < count && status == SUCCESS; i++) {
+		status = writeRecord(output, &records[i]);
+	}
+	fclose(output);
+	return status;
+}
+
+/**
+ * Writes the sorted records to a new temporary file and adds it to the runs.
+ */
+static StatusCode addRun(
+	sortRuns *runs,
+	const sortRecord *records,
+	uint32_t count) {
+	if (runs->count == runs->capacity) {
+		const uint32_t capacity = runs->capacity == 0 ?
+			SORT_RUNS_INITIAL_CAPACITY : runs->capacity * 2;
+		sortRun *items = (sortRun*)Malloc(sizeof(sortRun) * capacity);
+		if (items == NULL) {
+			return INSUFFICIENT_MEMORY;
+		}
+		if (runs->items != NULL) {
+			memcpy(items, runs->items, sizeof(sortRun) * runs->count);
+			Free(runs->items);
+		}
+		runs->items = items;
+		runs->capacity = capacity;
+	}
+	FILE *file = tmpfile();
+	if (file == NULL) {
+		return FILE_WRITE_ERROR;
+	}
+	runs->items[runs->count].file = file;
+	runs->items[runs->count].available = false;
+	runs->count++;
+	if (fwrite(records, sizeof(sortRecord), count, file) != count) {
+		return FILE_WRITE_ERROR;
+	}
+	return SUCCESS;
+}
+
+static bool readRun(sortRun *run) {
+	run->available = fread(&run->current, sizeof(sortRecord), 1, run->file) == 1;
+	return run->available;
+}
+
+/**
+ * Merges the runs into the output file by repeatedly writing the lowest of
+ * the next records from each run.
+ */
+static StatusCode mergeRuns(sortRuns *runs, const char *outputFilePath) {
+	uint32_t i;
+	StatusCode status = SUCCESS;
+	FILE *output = fopen(outputFilePath, "w");
+	if (output == NULL) {
+		return FILE_WRITE_ERROR;
+	}
+	for (i = 0; i < runs->count; i++) {
+		rewind(runs->items[i].file);
+		readRun(&runs->items[i]);
+	}
+	while (status == SUCCESS) {
+		sortRun *lowest = NULL;
+		for (i = 0; i < runs->count; i++) {
+			if (runs->items[i].available &&
+				(lowest == NULL || compareRecords(
+					&runs->items[i].current,
+					&lowest->current) < 0)) {
+				lowest = &runs->items[i];
+			}
+		}
+		if (lowest == NULL) {
+			break;
+		}
+		status = writeRecord(output, &lowest->current);
+		readRun(lowest);
+	}
+	fclose(output);
+	return status;
+}
+
+static void freeRuns(sortRuns *runs) {
+	uint32_t i;
+	for (i = 0; i < runs->count; i++) {
+		fclose(runs->items[i].file);
+	}
+	if (runs->items != NULL) {
+		Free(runs->items);
+	}
+}
+
+fiftyoneDegreesStatusCode fiftyoneDegreesIpiSortIpAddressFile(
+	const char *inputFilePath,
+	const char *outputFilePath,
+	size_t memoryLimit) {
+	FILE *input;
+	uint32_t count;
+	sortRuns runs = { NULL, 0, 0 };
+	const size_t capacity = memoryLimit / sizeof(sortRecord);
+	if (capacity < 2) {
+		return INSUFFICIENT_MEMORY;
+	}
+	StatusCode status = FileOpen(inputFilePath, &input);
+	if (status != SUCCESS) {
+		return status;
+	}
+	sortRecord *records = (sortRecord*)Malloc(sizeof(sortRecord) * capacity);
+	if (records == NULL) {
+		fclose(input);
+		return INSUFFICIENT_MEMORY;
+	}
+
+	// Sort each block of records which fits in memory. If the whole file
+	// fits then it is written straight to the output, otherwise each block
+	// becomes a run to be merged.
+	while (status == SUCCESS) {
+		count = readRecords(
+			input,
+			records,
+			capacity > UINT32_MAX ? UINT32_MAX : (uint32_t)capacity);
+		qsort(records, count, sizeof(sortRecord), compareRecords);
+		if (feof(input) && runs.count == 0) {
+			status = writeRecords(outputFilePath, records, count);
+			break;
+		}
+		if (count > 0) {
+			status = addRun(&runs, records, count);
+		}
+		if (status == SUCCESS && feof(input)) {
+			status = mergeRuns(&runs, outputFilePath);
+			break;
+		}
+	}
+
+	freeRuns(&runs);
+	Free(records);
+	fclose(input);
+	return status;
+}
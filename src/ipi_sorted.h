@@ -0,0 +1,109 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+#ifndef FIFTYONE_DEGREES_IPI_SORTED_INCLUDED
+#define FIFTYONE_DEGREES_IPI_SORTED_INCLUDED
+
+/**
+ * @file ipi_sorted.h
+ * @brief Offline processing of IP addresses in ascending order.
+ *
+ * When a large number of IP addresses are processed offline, sorting them
+ * first means consecutive IP addresses usually fall within the same range.
+ * #fiftyoneDegreesResultsIpiFromSortedIpAddresses merges the sorted IP
+ * addresses with the ranges of the data set, only evaluating the graphs when
+ * an IP address moves beyond the range matched by the previous one.
+ * #fiftyoneDegreesIpiSortIpAddressFile produces the sorted input from a file
+ * of IP addresses which is too large to sort in memory.
+ */
+
+#include "ipi.h"
+
+/**
+ * Called to get the next IP address to process.
+ * @param state pointer provided to
+ * #fiftyoneDegreesResultsIpiFromSortedIpAddresses
+ * @param ipAddress to set to the next IP address
+ * @return true if the IP address was set, false if there are no more
+ */
+typedef bool(*fiftyoneDegreesIpiIpAddressNextMethod)(
+	void *state,
+	fiftyoneDegreesIpAddress *ipAddress);
+
+/**
+ * Called with the results for each IP address processed.
+ * @param state pointer provided to
+ * #fiftyoneDegreesResultsIpiFromSortedIpAddresses
+ * @param results for the IP address, which are only valid until the method
+ * returns
+ * @return true to continue processing, false to stop
+ */
+typedef bool(*fiftyoneDegreesIpiSortedResultsMethod)(
+	void *state,
+	fiftyoneDegreesResultsIpi *results);
+
+/**
+ * Processes the IP addresses returned by the next method, calling the
+ * callback method with the results for each one. Where an IP address is
+ * within the range of every result for the previous IP address the previous
+ * results are returned without evaluating the graphs. Results for components
+ * without IpRangeStart and IpRangeEnd properties have no range so are never
+ * reused. IP addresses should be provided
+ * in ascending order, with all IPv4 addresses before IPv6 addresses, so every
+ * range is only found once. IP addresses which are not in order are still
+ * processed correctly, but will require the graphs to be evaluated.
+ * Invalid IP addresses are returned with empty results.
+ * @param results preallocated results to be populated for each IP address
+ * @param state pointer passed to the next and callback methods
+ * @param next method called to get each IP address
+ * @param callback method called with the results for each IP address
+ * @param exception pointer to an exception data structure to be used if an
+ * exception occurs. See exceptions.h
+ * @return the number of IP addresses processed
+ */
+EXTERNAL uint32_t fiftyoneDegreesResultsIpiFromSortedIpAddresses(
+	fiftyoneDegreesResultsIpi *results,
+	void *state,
+	fiftyoneDegreesIpiIpAddressNextMethod next,
+	fiftyoneDegreesIpiSortedResultsMethod callback,
+	fiftyoneDegreesException *exception);
+
+/**
+ * Sorts a text file of IP addresses, one per line, into ascending order as
+ * required by #fiftyoneDegreesResultsIpiFromSortedIpAddresses. IPv4 addresses
+ * are written before IPv6 addresses. Lines which are not valid IP addresses
+ * are not written to the output file. Blocks of IP addresses which fit within
+ * the memory limit are sorted and written to temporary files, which are then
+ * merged into the output file.
+ * @param inputFilePath path to the file of unsorted IP addresses
+ * @param outputFilePath path to write the sorted IP addresses to
+ * @param memoryLimit maximum number of bytes to use for sorting
+ * @return the status associated with the sort. Returns
+ * #FIFTYONE_DEGREES_STATUS_INSUFFICIENT_MEMORY if the memory limit is too
+ * small to sort with
+ */
+EXTERNAL fiftyoneDegreesStatusCode fiftyoneDegreesIpiSortIpAddressFile(
+	const char *inputFilePath,
+	const char *outputFilePath,
+	size_t memoryLimit);
+
+#endif
@@ -31,6 +31,9 @@
 
 #include "ipi_weighted_results.h"
 #include "fiftyone.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
 
 
 /**
@@ -123,6 +126,7 @@ static void PropValuesInit(PropValues * const values, const uint32_t count) {
     values->items = (PropValuesChunk *)values->data.ptr;
     for (uint32_t i = 0, n = values->count; i < n; i++) {
         DataReset(&values->items[i].data);
+        values->items[i].count = 0;
     }
 }
 
@@ -635,11 +639,13 @@ typedef struct {
 /**
  * @brief Initializes a property values chunk with values from results.
  * 
- * Gets the property values from the results and populates the chunk with
- * the appropriate type of values.
+ * Populates the chunk with the appropriate type of values from the property
+ * values already obtained from the results.
  * 
  * @param chunk Pointer to the chunk to initialize
  * @param results Pointer to the IP Intelligence results
+ * @param valuesItems Pointer to the first value item for the property, or NULL
+ * @param valuesCount Number of value items
  * @param defaults Pointer to the default values for conversion
  * @param tempData Temporary data structure for string conversion operations
  * @param exception Pointer to an exception structure for error handling
@@ -647,6 +653,8 @@ typedef struct {
 static void PropValuesChunkInit(
     PropValuesChunk * const chunk,
     ResultsIpi * const results,
+    const WeightedItem * const valuesItems,
+    const uint32_t valuesCount,
     const PropValuesItemConversionDefaults * const defaults,
     fiftyoneDegreesData * const tempData,
     Exception * const exception) {
@@ -672,19 +680,11 @@ static void PropValuesChunkInit(
         return;
     }
 
-    // Get a pointer to the first value item for the property.
-    const WeightedItem * const valuesItems = ResultsIpiGetValues(
-        results,
-        chunk->requiredPropertyIndex,
-        exception);
-    if (EXCEPTION_FAILED) {
-        return;
-    }
-    if (valuesItems == NULL) {
+    if (valuesItems == NULL || valuesCount == 0) {
         return;
     }
 
-    chunk->count = results->values.count;
+    chunk->count = valuesCount;
     const PropValuesChunkContext context = {
         chunk,
         valuesItems,
@@ -737,15 +737,93 @@ static void PropValuesPopulate(
     Exception * const exception) {
 
     for (uint32_t i = 0, n = values->count; (i < n) && EXCEPTION_OKAY; i++) {
+        // Get a pointer to the first value item for the property.
+        const WeightedItem * const valuesItems = ResultsIpiGetValues(
+            results,
+            values->items[i].requiredPropertyIndex,
+            exception);
+        if (EXCEPTION_FAILED) {
+            return;
+        }
         PropValuesChunkInit(
             &(values->items[i]),
             results,
+            valuesItems,
+            results->values.count,
             defaults,
             tempData,
             exception);
     }
 }
 
+/**
+ * @brief Populates all chunks in a PropValues structure in a single pass.
+ * 
+ * Gets the values for all the properties with one visit to each profile
+ * matched by the results, and then initializes each chunk from the values
+ * of its property. All the value items are held until every chunk has been
+ * populated.
+ * 
+ * @param values Pointer to the PropValues structure to populate
+ * @param results Pointer to the IP Intelligence results
+ * @param defaults Pointer to the default values for conversion
+ * @param tempData Temporary data structure for string conversion operations
+ * @param exception Pointer to an exception structure for error handling
+ */
+static void PropValuesPopulateSinglePass(
+    const PropValues * const values,
+    ResultsIpi * const results,
+    const PropValuesItemConversionDefaults * const defaults,
+    fiftyoneDegreesData * const tempData,
+    Exception * const exception) {
+
+    const uint32_t count = values->count;
+    if (count == 0) {
+        return;
+    }
+
+    // The indexes and lists are owned by the results and reused by every
+    // call rather than allocated each time.
+    int * const indexes = (int *)DataMalloc(
+        &results->properties.indexes,
+        count * sizeof(int));
+    if (indexes == NULL) {
+        EXCEPTION_SET(INSUFFICIENT_MEMORY);
+        return;
+    }
+    WeightedItemList * const lists = ResultsIpiGetPropertiesLists(
+        results,
+        count,
+        exception);
+    if (lists == NULL || EXCEPTION_FAILED) {
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        indexes[i] = values->items[i].requiredPropertyIndex;
+    }
+
+    ResultsIpiGetValuesForProperties(
+        results,
+        indexes,
+        count,
+        lists,
+        exception);
+    for (uint32_t i = 0; (i < count) && EXCEPTION_OKAY; i++) {
+        PropValuesChunkInit(
+            &(values->items[i]),
+            results,
+            lists[i].items,
+            lists[i].count,
+            defaults,
+            tempData,
+            exception);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        WeightedItemListRelease(&lists[i]);
+    }
+}
+
 /**
  * @brief Moves items from PropValues to a WeightedValuesCollection.
  * 
@@ -838,7 +916,24 @@ WeightedValuesCollection fiftyoneDegreesResultsIpiGetValuesCollection(
         Data * const theTempData = (tempData
             ? tempData
             : (DataReset(&myTempData), &myTempData));
-        PropValuesPopulate(&values, results, &defaults, theTempData, exception);
+        // A single pass holds the value items of every property at once so
+        // is only used when the collections are in memory. Otherwise each
+        // value item could occupy a cache entry.
+        if (dataSet->b.b.isInMemory) {
+            PropValuesPopulateSinglePass(
+                &values,
+                results,
+                &defaults,
+                theTempData,
+                exception);
+        } else {
+            PropValuesPopulate(
+                &values,
+                results,
+                &defaults,
+                theTempData,
+                exception);
+        }
         if ((theTempData == &myTempData) && myTempData.allocated) {
             Free(myTempData.ptr);
             DataReset(&myTempData);
@@ -879,3 +974,348 @@ void fiftyoneDegreesWeightedValuesCollectionRelease(
         DataReset(&collection->valuesData);
     }
 }
+
+/**
+ * @brief Size of the WKB for a 2D point: byte order, geometry type and the
+ * two ordinates.
+ */
+#define WKB_POINT_SIZE (1 + sizeof(uint32_t) + 2 * sizeof(double))
+
+/**
+ * @brief Size of the reduced WKB for a 2D point: byte order, a single byte
+ * geometry type and the two ordinates as 16 bit integers.
+ */
+#define WKB_R_POINT_SIZE (1 + 1 + 2 * sizeof(int16_t))
+
+/**
+ * @brief Degrees represented by the largest 16 bit ordinate of reduced WKB.
+ */
+#define WKB_R_SCALE 180.0
+
+/**
+ * @brief Size of the buffer used to format a point as WKT.
+ */
+#define WKT_POINT_BUFFER_SIZE 128
+
+/**
+ * @brief Reads a value from WKB bytes in the byte order of the geometry.
+ * 
+ * @param source Pointer to the first byte of the value
+ * @param destination Pointer to the value to write
+ * @param size Number of bytes in the value
+ * @param swap True if the byte order differs from the host
+ */
+static void ReadWkbBytes(
+    const uint8_t * const source,
+    void * const destination,
+    const size_t size,
+    const bool swap) {
+    uint8_t * const target = (uint8_t *)destination;
+    for (size_t i = 0; i < size; i++) {
+        target[i] = swap ? source[size - 1 - i] : source[i];
+    }
+}
+
+/**
+ * @brief Decodes a 2D point from WKB bytes.
+ * 
+ * @param bytes Pointer to the variable length byte array holding the WKB
+ * @param coordinate Pointer to the coordinate to write to
+ * @return True if the bytes were a 2D point, otherwise false
+ */
+static bool GetCoordinateFromWkb(
+    const VarLengthByteArray * const bytes,
+    IpiCoordinate * const coordinate) {
+    if (bytes->size < (int16_t)WKB_POINT_SIZE) {
+        return false;
+    }
+    const uint8_t * const wkb = &bytes->firstByte;
+    const uint16_t probe = 1;
+    const bool hostLittleEndian = *(const uint8_t *)&probe == 1;
+    const bool swap = (wkb[0] == 1) != hostLittleEndian;
+    uint32_t geometryType;
+    ReadWkbBytes(wkb + 1, &geometryType, sizeof(geometryType), swap);
+    if (geometryType != 1) {
+        return false;
+    }
+    ReadWkbBytes(
+        wkb + 1 + sizeof(uint32_t),
+        &coordinate->lon,
+        sizeof(double),
+        swap);
+    ReadWkbBytes(
+        wkb + 1 + sizeof(uint32_t) + sizeof(double),
+        &coordinate->lat,
+        sizeof(double),
+        swap);
+    return true;
+}
+
+/**
+ * @brief Decodes a 2D point from reduced WKB bytes.
+ * 
+ * Reduced WKB is the same as WKB except that the geometry type is a single
+ * byte and each ordinate is a 16 bit integer scaled so that INT16_MAX is
+ * WKB_R_SCALE degrees.
+ * 
+ * @param bytes Pointer to the variable length byte array holding the WKB
+ * @param coordinate Pointer to the coordinate to write to
+ * @return True if the bytes were a 2D point, otherwise false
+ */
+static bool GetCoordinateFromReducedWkb(
+    const VarLengthByteArray * const bytes,
+    IpiCoordinate * const coordinate) {
+    if (bytes->size < (int16_t)WKB_R_POINT_SIZE) {
+        return false;
+    }
+    const uint8_t * const wkb = &bytes->firstByte;
+    if (wkb[0] > 1 || wkb[1] != 1) {
+        return false;
+    }
+    const uint16_t probe = 1;
+    const bool hostLittleEndian = *(const uint8_t *)&probe == 1;
+    const bool swap = (wkb[0] == 1) != hostLittleEndian;
+    int16_t x, y;
+    ReadWkbBytes(wkb + 2, &x, sizeof(int16_t), swap);
+    ReadWkbBytes(wkb + 2 + sizeof(int16_t), &y, sizeof(int16_t), swap);
+    coordinate->lon = x * WKB_R_SCALE / INT16_MAX;
+    coordinate->lat = y * WKB_R_SCALE / INT16_MAX;
+    return true;
+}
+
+/**
+ * @brief Parses a coordinate from a WKT point such as "POINT (1.5 -2)".
+ * 
+ * @param wkt Null terminated WKT string
+ * @param coordinate Pointer to the coordinate to write to
+ * @return True if the string was a point, otherwise false
+ */
+static bool GetCoordinateFromWkt(
+    const char * const wkt,
+    IpiCoordinate * const coordinate) {
+    static const char prefix[] = "POINT";
+    if (strncmp(wkt, prefix, sizeof(prefix) - 1) != 0) {
+        return false;
+    }
+    const char *next = wkt + sizeof(prefix) - 1;
+    while (*next == ' ') {
+        next++;
+    }
+    if (*next != '(') {
+        return false;
+    }
+    char *end;
+    const double x = strtod(next + 1, &end);
+    if (end == next + 1) {
+        return false;
+    }
+    next = end;
+    const double y = strtod(next, &end);
+    if (end == next) {
+        return false;
+    }
+    while (*end == ' ') {
+        end++;
+    }
+    if (*end != ')') {
+        return false;
+    }
+    coordinate->lon = x;
+    coordinate->lat = y;
+    return true;
+}
+
+/* Implementation of the function declared in the header file */
+bool fiftyoneDegreesIpiGetCoordinate(
+    const StoredBinaryValue * const value,
+    const PropertyValueType storedValueType,
+    IpiCoordinate * const coordinate) {
+
+    coordinate->lat = NAN;
+    coordinate->lon = NAN;
+    switch (storedValueType) {
+        case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB:
+            return GetCoordinateFromWkb(
+                (const VarLengthByteArray *)value,
+                coordinate);
+        case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB_R:
+            return GetCoordinateFromReducedWkb(
+                (const VarLengthByteArray *)value,
+                coordinate);
+        case FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING:
+            return GetCoordinateFromWkt(
+                &((const String *)value)->value,
+                coordinate);
+        default: {
+            // Any other encoding is formatted as WKT with every significant
+            // digit so no precision is lost.
+            char buffer[WKT_POINT_BUFFER_SIZE];
+            StringBuilder builder = { buffer, sizeof(buffer) };
+            EXCEPTION_CREATE;
+            StringBuilderInit(&builder);
+            StringBuilderAddStringValue(
+                &builder,
+                value,
+                storedValueType,
+                DBL_DIG,
+                exception);
+            StringBuilderComplete(&builder);
+            if (EXCEPTION_FAILED || builder.added >= builder.length) {
+                return false;
+            }
+            return GetCoordinateFromWkt(buffer, coordinate);
+        }
+    }
+}
+
+/**
+ * @brief Saves a coordinate from a stored binary value.
+ * 
+ * @param header Pointer to the weighted value header
+ * @param storedBinaryValue Pointer to the stored binary value
+ * @param propertyValueType Type of the property value
+ * @param converterState Unused
+ * @param exception Pointer to an exception structure (unused)
+ */
+static void SaveCoordinate(
+    WeightedValueHeader * const header,
+    const StoredBinaryValue * const storedBinaryValue,
+    const PropertyValueType propertyValueType,
+    void * const converterState,
+    Exception * const exception) {
+#	ifdef _MSC_VER
+    UNREFERENCED_PARAMETER(converterState);
+    UNREFERENCED_PARAMETER(exception);
+#	endif
+
+    fiftyoneDegreesIpiGetCoordinate(
+        storedBinaryValue,
+        propertyValueType,
+        &((WeightedCoordinate*)header)->value);
+}
+
+/**
+ * @brief Writes the values of a property to a caller provided array.
+ * 
+ * Each stored binary value is passed to the save function which converts it
+ * to the value type of the array without formatting it as a string.
+ * 
+ * @param results Pointer to the IP Intelligence results
+ * @param requiredPropertyIndex Required property index of the property
+ * @param values Pointer to the first item of the array
+ * @param itemSize Size of each item in the array
+ * @param capacity Number of items the array can hold
+ * @param valueType Value type to record in the headers
+ * @param saveFunc Function to convert the stored binary values
+ * @param converterState State passed to the save function
+ * @param exception Pointer to an exception structure for error handling
+ * @return The number of values available for the property
+ */
+static uint32_t ResultsIpiGetValuesAsWeighted(
+    ResultsIpi * const results,
+    const int requiredPropertyIndex,
+    uint8_t * const values,
+    const size_t itemSize,
+    const uint32_t capacity,
+    const PropertyValueType valueType,
+    const PropValueSaveFunc saveFunc,
+    void * const converterState,
+    Exception * const exception) {
+
+    fiftyoneDegreesResultsNoValueReason reason;
+    const WeightedItem * const valuesItems = ResultsIpiGetValuesWithReason(
+        results,
+        requiredPropertyIndex,
+        &reason,
+        exception);
+    if (valuesItems == NULL || EXCEPTION_FAILED) {
+        return 0;
+    }
+
+    const DataSetIpi * const dataSet = (DataSetIpi*)results->b.dataSet;
+    const uint32_t propertyIndex = PropertiesGetPropertyIndexFromRequiredIndex(
+        dataSet->b.b.available,
+        requiredPropertyIndex);
+    const PropertyValueType storedValueType = PropertyGetStoredTypeByIndex(
+        dataSet->propertyTypes,
+        propertyIndex,
+        exception);
+    if (EXCEPTION_FAILED) {
+        return 0;
+    }
+
+    const uint32_t count = results->values.count;
+    for (uint32_t i = 0; (i < count) && (i < capacity) && EXCEPTION_OKAY; i++) {
+        WeightedValueHeader * const header = (WeightedValueHeader *)(
+            values + itemSize * i);
+        header->valueType = valueType;
+        header->requiredPropertyIndex = requiredPropertyIndex;
+        header->rawWeighting = valuesItems[i].rawWeighting;
+        saveFunc(
+            header,
+            (const StoredBinaryValue *)valuesItems[i].item.data.ptr,
+            storedValueType,
+            converterState,
+            exception);
+    }
+    return count;
+}
+
+/* Implementation of the function declared in the header file */
+uint32_t fiftyoneDegreesResultsIpiGetValuesAsWeightedInts(
+    ResultsIpi * const results,
+    const int requiredPropertyIndex,
+    WeightedInt * const values,
+    const uint32_t capacity,
+    Exception * const exception) {
+    int defaultValue = 0;
+    return ResultsIpiGetValuesAsWeighted(
+        results,
+        requiredPropertyIndex,
+        (uint8_t *)values,
+        sizeof(WeightedInt),
+        capacity,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_INTEGER,
+        SaveInt,
+        &defaultValue,
+        exception);
+}
+
+/* Implementation of the function declared in the header file */
+uint32_t fiftyoneDegreesResultsIpiGetValuesAsWeightedDoubles(
+    ResultsIpi * const results,
+    const int requiredPropertyIndex,
+    WeightedDouble * const values,
+    const uint32_t capacity,
+    Exception * const exception) {
+    double defaultValue = 0.0;
+    return ResultsIpiGetValuesAsWeighted(
+        results,
+        requiredPropertyIndex,
+        (uint8_t *)values,
+        sizeof(WeightedDouble),
+        capacity,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_DOUBLE,
+        SaveDouble,
+        &defaultValue,
+        exception);
+}
+
+/* Implementation of the function declared in the header file */
+uint32_t fiftyoneDegreesResultsIpiGetValuesAsWeightedCoordinates(
+    ResultsIpi * const results,
+    const int requiredPropertyIndex,
+    WeightedCoordinate * const values,
+    const uint32_t capacity,
+    Exception * const exception) {
+    return ResultsIpiGetValuesAsWeighted(
+        results,
+        requiredPropertyIndex,
+        (uint8_t *)values,
+        sizeof(WeightedCoordinate),
+        capacity,
+        FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB,
+        SaveCoordinate,
+        NULL,
+        exception);
+}
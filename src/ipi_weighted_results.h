@@ -102,6 +102,26 @@ typedef struct fiftyone_degrees_weighted_string_t {
  const char *value;                         /**< Pointer to the string value */
 } fiftyoneDegreesWeightedString;
 
+/**
+ * @brief Structure for a coordinate decoded from a point value.
+ * 
+ * The longitude is the X and the latitude the Y ordinate of the point.
+ */
+typedef struct fiftyone_degrees_ipi_coordinate_t {
+ double lat;                                /**< The latitude (Y ordinate) */
+ double lon;                                /**< The longitude (X ordinate) */
+} fiftyoneDegreesIpiCoordinate;
+
+/**
+ * @brief Structure for weighted coordinate values.
+ * 
+ * Contains a weighted value header and a coordinate value.
+ */
+typedef struct fiftyone_degrees_weighted_coordinate_t {
+ fiftyoneDegreesWeightedValueHeader header; /**< Common header for all weighted values */
+ fiftyoneDegreesIpiCoordinate value;        /**< The coordinate value */
+} fiftyoneDegreesWeightedCoordinate;
+
 
 /**
  * @brief Collection of weighted values.
@@ -147,4 +167,86 @@ EXTERNAL fiftyoneDegreesWeightedValuesCollection fiftyoneDegreesResultsIpiGetVal
 EXTERNAL void fiftyoneDegreesWeightedValuesCollectionRelease(
  fiftyoneDegreesWeightedValuesCollection *collection);
 
+/**
+ * @brief Gets the values of a property from the results as integers.
+ * 
+ * The stored binary values are converted directly to integers without being
+ * formatted as strings. Up to capacity values are written to the array
+ * provided. The total number of values is returned so a larger array can be
+ * provided if the capacity was not sufficient.
+ * 
+ * @param results Pointer to the IP Intelligence results
+ * @param requiredPropertyIndex Required property index of the property
+ * @param values Array to write the weighted values to
+ * @param capacity Number of items the values array can hold
+ * @param exception Pointer to an exception structure for error handling
+ * @return The number of values available for the property
+ */
+EXTERNAL uint32_t fiftyoneDegreesResultsIpiGetValuesAsWeightedInts(
+ fiftyoneDegreesResultsIpi *results,
+ int requiredPropertyIndex,
+ fiftyoneDegreesWeightedInt *values,
+ uint32_t capacity,
+ fiftyoneDegreesException *exception);
+
+/**
+ * @brief Gets the values of a property from the results as doubles.
+ * 
+ * Single precision float values are widened to doubles. See
+ * fiftyoneDegreesResultsIpiGetValuesAsWeightedInts for the handling of the
+ * values array.
+ * 
+ * @param results Pointer to the IP Intelligence results
+ * @param requiredPropertyIndex Required property index of the property
+ * @param values Array to write the weighted values to
+ * @param capacity Number of items the values array can hold
+ * @param exception Pointer to an exception structure for error handling
+ * @return The number of values available for the property
+ */
+EXTERNAL uint32_t fiftyoneDegreesResultsIpiGetValuesAsWeightedDoubles(
+ fiftyoneDegreesResultsIpi *results,
+ int requiredPropertyIndex,
+ fiftyoneDegreesWeightedDouble *values,
+ uint32_t capacity,
+ fiftyoneDegreesException *exception);
+
+/**
+ * @brief Gets the values of a point property from the results as
+ * coordinates.
+ * 
+ * Values which are not points have NaN latitude and longitude. See
+ * fiftyoneDegreesResultsIpiGetValuesAsWeightedInts for the handling of the
+ * values array.
+ * 
+ * @param results Pointer to the IP Intelligence results
+ * @param requiredPropertyIndex Required property index of the property
+ * @param values Array to write the weighted values to
+ * @param capacity Number of items the values array can hold
+ * @param exception Pointer to an exception structure for error handling
+ * @return The number of values available for the property
+ */
+EXTERNAL uint32_t fiftyoneDegreesResultsIpiGetValuesAsWeightedCoordinates(
+ fiftyoneDegreesResultsIpi *results,
+ int requiredPropertyIndex,
+ fiftyoneDegreesWeightedCoordinate *values,
+ uint32_t capacity,
+ fiftyoneDegreesException *exception);
+
+/**
+ * @brief Decodes a point from a stored binary value.
+ * 
+ * A 2D point stored as WKB, or as reduced WKB, is read directly from its
+ * bytes, and a WKT string is parsed. Any other stored type is formatted as
+ * WKT and parsed, so the value must be a POINT.
+ * 
+ * @param value Pointer to the stored binary value
+ * @param storedValueType Type the value is stored as
+ * @param coordinate Pointer to the coordinate to write to
+ * @return True if the value was a point, otherwise false
+ */
+EXTERNAL bool fiftyoneDegreesIpiGetCoordinate(
+ const fiftyoneDegreesStoredBinaryValue *value,
+ fiftyoneDegreesPropertyValueType storedValueType,
+ fiftyoneDegreesIpiCoordinate *coordinate);
+
 #endif //FIFTYONE_DEGREES_IPI_WEIGHTED_RESULTS_INCLUDED
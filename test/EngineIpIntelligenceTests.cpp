@@ -29,15 +29,59 @@
 #endif
 #endif
 #include <regex>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 #include "Constants.hpp"
 #include "EngineIpIntelligenceTests.hpp"
 #include "../src/EngineIpi.hpp"
+#include "../src/ipi_sorted.h"
+#include "../src/ipi_delta.h"
+#include "../src/ipi_weighted_results.h"
 #include "../src/common-cxx/file.h"
 
 using namespace FiftyoneDegrees::Common;
 using namespace FiftyoneDegrees::IpIntelligence;
 
+/**
+ * Creates an empty file with a unique name in the temporary directory so
+ * that tests running in parallel never write to the same file.
+ * @param prefix of the file name
+ * @return path to the file, or an empty string if it could not be created
+ */
+static string getTempFileName(const char *prefix) {
+#ifdef _WIN32
+	char directory[MAX_PATH];
+	char path[MAX_PATH];
+	if (GetTempPathA(MAX_PATH, directory) == 0 ||
+		GetTempFileNameA(directory, prefix, 0, path) == 0) {
+		return string();
+	}
+	return string(path);
+#else
+	const char *directory = getenv("TMPDIR");
+	string path = string(directory != nullptr ? directory : "/tmp") +
+		"/" + prefix + "_XXXXXX";
+	vector<char> buffer(path.begin(), path.end());
+	buffer.push_back('\0');
+	const int file = mkstemp(buffer.data());
+	if (file == -1) {
+		return string();
+	}
+	close(file);
+	return string(buffer.data());
+#endif
+}
+
 EngineIpIntelligenceTests::EngineIpIntelligenceTests(
 	ConfigIpi *config,
 	RequiredPropertiesConfig *requiredProperties,
@@ -455,6 +499,1599 @@ void EngineIpIntelligenceTests::verifyWithEmptyIpAddress() {
 	delete results;
 }
 
+/*
+ * Check that processing a batch of IP addresses returns the same values as
+ * processing each IP address individually, including for IP addresses which
+ * are not valid.
+ */
+void EngineIpIntelligenceTests::verifyProcessBatch() {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	vector<string> batchIpAddresses = {
+		ipv4Address,
+		ipv6Address,
+		badIpv4Address,
+		lowerBoundIpv4Address,
+		upperBoundIpv6Address,
+		"" };
+	for (size_t i = 0; i < ipAddresses.size() && i < 50; i++) {
+		batchIpAddresses.push_back(ipAddresses[i]);
+	}
+	vector<ResultsIpi*> batchResults = engineIpi->processBatch(
+		batchIpAddresses);
+	ASSERT_EQ(batchIpAddresses.size(), batchResults.size()) << "A result "
+		"should be returned for every IP address in the batch.";
+	for (size_t i = 0; i < batchResults.size(); i++) {
+		ResultsIpi *single = engineIpi->process(batchIpAddresses[i].c_str());
+		validateQuick(batchResults[i]);
+		for (int p = 0; p < single->getAvailableProperties(); p++) {
+			Common::Value<vector<string>> sv = single->getValues(p);
+			Common::Value<vector<string>> bv = batchResults[i]->getValues(p);
+			EXPECT_EQ(sv.hasValue(), bv.hasValue()) << "Batch and single "
+				"results differ for '" << batchIpAddresses[i] << "'";
+			if (sv.hasValue() && bv.hasValue()) {
+				EXPECT_EQ(*sv, *bv) << "Batch and single values differ for "
+					"'" << batchIpAddresses[i] << "'";
+			}
+		}
+		delete single;
+	}
+
+	// The shared batch is only freed when the last results are deleted.
+	for (size_t i = batchResults.size(); i > 0; i--) {
+		delete batchResults[i - 1];
+	}
+}
+
+/**
+ * Adds one to the IP address. Returns false if the address was the last one
+ * of its type.
+ */
+static bool ipAddressIncrement(fiftyoneDegreesIpAddress &ipAddress) {
+	const int length = ipAddress.type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+		FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+	for (int i = length - 1; i >= 0; i--) {
+		if (++ipAddress.value[i] != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Subtracts one from the IP address. Returns false if the address was the
+ * first one of its type.
+ */
+static bool ipAddressDecrement(fiftyoneDegreesIpAddress &ipAddress) {
+	const int length = ipAddress.type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+		FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+	for (int i = length - 1; i >= 0; i--) {
+		if (ipAddress.value[i]-- != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Returns the IP address half way between the first and last IP addresses.
+ */
+static fiftyoneDegreesIpAddress ipAddressMiddle(
+	const fiftyoneDegreesIpAddress &first,
+	const fiftyoneDegreesIpAddress &last) {
+	const int length = first.type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+		FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+	fiftyoneDegreesIpAddress middle = first;
+	unsigned int carry = 0;
+	for (int i = length - 1; i >= 0; i--) {
+		const unsigned int sum = first.value[i] + last.value[i] + carry;
+		middle.value[i] = (unsigned char)sum;
+		carry = sum >> 8;
+	}
+
+	// Halve the sum including the carry out of the most significant byte.
+	for (int i = 0; i < length; i++) {
+		const unsigned int next = middle.value[i] & 1;
+		middle.value[i] = (unsigned char)((middle.value[i] >> 1) | (carry << 7));
+		carry = next;
+	}
+	return middle;
+}
+
+EngineIpi* EngineIpIntelligenceTests::createEngine(ConfigMutator mutate) {
+	ConfigIpi engineConfig(&config->getConfig());
+	mutate(engineConfig);
+	return new EngineIpi(fullName, &engineConfig, requiredProperties);
+}
+
+vector<fiftyoneDegreesIpAddress>
+EngineIpIntelligenceTests::getCompareIpAddresses() {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	vector<string> values = {
+		ipv4Address,
+		ipv6Address,
+		lowerBoundIpv4Address,
+		upperBoundIpv4Address,
+		lowerBoundIpv6Address,
+		upperBoundIpv6Address };
+	for (size_t i = 0; i < ipAddresses.size() && i < 20; i++) {
+		values.push_back(ipAddresses[i]);
+	}
+	vector<fiftyoneDegreesIpAddress> compareIpAddresses;
+	for (const string &value : values) {
+		fiftyoneDegreesIpAddress ipAddress;
+		if (fiftyoneDegreesIpAddressParse(
+			value.c_str(),
+			value.c_str() + value.size(),
+			&ipAddress) == false) {
+			continue;
+		}
+		compareIpAddresses.push_back(ipAddress);
+
+		// Add the bounds of the matched range, another IP address within
+		// it, and the IP addresses either side of it, so that IP addresses
+		// which share a range, and the edges of ranges, are compared.
+		ResultsIpi *results = engineIpi->process(value.c_str());
+		Common::Value<IpIntelligence::IpAddress> rangeStart =
+			results->getRangeStart();
+		Common::Value<IpIntelligence::IpAddress> rangeEnd =
+			results->getRangeEnd();
+		delete results;
+		if (rangeStart.hasValue() == false || rangeEnd.hasValue() == false) {
+			continue;
+		}
+		const int length = ipAddress.type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+			FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+		fiftyoneDegreesIpAddress first, last;
+		memset(&first, 0, sizeof(first));
+		memset(&last, 0, sizeof(last));
+		first.type = last.type = ipAddress.type;
+		memcpy(first.value, rangeStart.getValue().getIpAddress(), length);
+		memcpy(last.value, rangeEnd.getValue().getIpAddress(), length);
+		compareIpAddresses.push_back(first);
+		compareIpAddresses.push_back(last);
+		compareIpAddresses.push_back(ipAddressMiddle(first, last));
+		if (ipAddressDecrement(first)) {
+			compareIpAddresses.push_back(first);
+		}
+		if (ipAddressIncrement(last)) {
+			compareIpAddresses.push_back(last);
+		}
+	}
+	return compareIpAddresses;
+}
+
+void EngineIpIntelligenceTests::compareEngines(
+	EngineIpi *expected,
+	EngineIpi *actual,
+	int passes) {
+	vector<fiftyoneDegreesIpAddress> compareIpAddresses =
+		getCompareIpAddresses();
+	for (int pass = 0; pass < passes; pass++) {
+		for (fiftyoneDegreesIpAddress ipAddress : compareIpAddresses) {
+			const int length =
+				ipAddress.type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+				FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+			ResultsIpi *a = expected->process(
+				ipAddress.value,
+				length,
+				ipAddress.type);
+			ResultsIpi *b = actual->process(
+				ipAddress.value,
+				length,
+				ipAddress.type);
+			compareResults(a, b);
+			delete a;
+			delete b;
+		}
+	}
+}
+
+void EngineIpIntelligenceTests::compareWithConfig(
+	ConfigMutator mutate,
+	int passes) {
+	EngineIpi *other = createEngine(mutate);
+	compareEngines((EngineIpi*)getEngine(), other, passes);
+	delete other;
+}
+
+/**
+ * Maximum number of ranges compared for each IP type by
+ * verifyRangeBoundaries. Define as 2000000 when building the tests to
+ * compare every range in the enterprise data file.
+ */
+#ifndef RANGE_BOUNDARIES_MAX
+#define RANGE_BOUNDARIES_MAX 10000
+#endif
+
+/**
+ * Returns true if every result has the same graph result in both results.
+ */
+static bool sameGraphResults(ResultsIpi *expected, ResultsIpi *actual) {
+	if (expected->results->count != actual->results->count) {
+		return false;
+	}
+	for (uint32_t i = 0; i < expected->results->count; i++) {
+		if (expected->results->items[i].graphResult.rawOffset !=
+			actual->results->items[i].graphResult.rawOffset) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void EngineIpIntelligenceTests::verifyRangeBoundaries(
+	EngineIpi *indexed,
+	fiftyoneDegreesIpType type) {
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	const int length = type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+		FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+	fiftyoneDegreesIpAddress start, first, end;
+	memset(&start, 0, sizeof(start));
+	start.type = type;
+
+	// Each range found from the graphs ends where the range of any
+	// component ends, so the first and last IP address of every range of
+	// every component is compared.
+	for (int count = 0; count < RANGE_BOUNDARIES_MAX; count++) {
+		ResultsIpi *expected = engineIpi->process(start.value, length, type);
+		ResultsIpi *actual = indexed->process(start.value, length, type);
+		EXPECT_TRUE(sameGraphResults(expected, actual)) << "The results "
+			"differ from the graphs at the start of range " << count;
+		const bool found = fiftyoneDegreesResultsIpiGetRange(
+			expected->results,
+			&first,
+			&end,
+			nullptr,
+			exception);
+		EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+		delete expected;
+		delete actual;
+		if (found == false) {
+			break;
+		}
+		EXPECT_EQ(0, memcmp(start.value, first.value, length)) << "Range " <<
+			count << " should start after the end of the previous range";
+		expected = engineIpi->process(end.value, length, type);
+		actual = indexed->process(end.value, length, type);
+		EXPECT_TRUE(sameGraphResults(expected, actual)) << "The results "
+			"differ from the graphs at the end of range " << count;
+		delete expected;
+		delete actual;
+		if (::testing::Test::HasFailure() || ipAddressIncrement(end) == false) {
+			break;
+		}
+		start = end;
+	}
+}
+
+/**
+ * Checks the data set used by the engine has the tables and index which were
+ * requested. They can only be missing if no component has range properties,
+ * as any other failure to build them fails the engine's initialisation.
+ */
+static void expectRangeIndexes(
+	EngineIpi *engineIpi,
+	bool ipv4Table,
+	bool ipv6Table,
+	bool ipv6Index) {
+	ResultsIpi *results = engineIpi->process("0.0.0.0");
+	const fiftyoneDegreesDataSetIpi *dataSet =
+		(const fiftyoneDegreesDataSetIpi*)results->results->b.dataSet;
+	const bool ranges = dataSet->rangesAvailableCount > 0;
+	EXPECT_EQ(ipv4Table && ranges, dataSet->ipv4Table != nullptr) <<
+		"The IPv4 table was not built as configured";
+	EXPECT_EQ(ipv6Table && ranges, dataSet->ipv6Table != nullptr) <<
+		"The IPv6 table was not built as configured";
+	EXPECT_EQ(ipv6Index && ranges, dataSet->ipv6Index != nullptr) <<
+		"The IPv6 prefix index was not built as configured";
+	delete results;
+}
+
+void EngineIpIntelligenceTests::verifyRangeIndexes() {
+	// The indexes are only built for data sets which are entirely in memory.
+	if (config->getConfig().b.allInMemory == false) {
+		return;
+	}
+	EngineIpi *index = createEngine([](ConfigIpi &indexConfig) {
+		indexConfig.setIpv4Table(true);
+		indexConfig.setIpv6PrefixBits(32);
+	});
+	expectRangeIndexes(index, true, false, true);
+	compareEngines((EngineIpi*)getEngine(), index);
+	delete index;
+	EngineIpi *tables = createEngine([](ConfigIpi &tableConfig) {
+		tableConfig.setIpv4Table(true);
+		tableConfig.setIpv6Table(true);
+	});
+	expectRangeIndexes(tables, true, true, false);
+	compareEngines((EngineIpi*)getEngine(), tables);
+	delete tables;
+}
+
+void EngineIpIntelligenceTests::verifyRangeBoundaries() {
+	// The indexes are only built for data sets which are entirely in memory.
+	if (config->getConfig().b.allInMemory == false) {
+		return;
+	}
+
+	// Compare the range boundaries with the tables, and the IPv6 prefix
+	// index on its own.
+	EngineIpi *tables = createEngine([](ConfigIpi &tableConfig) {
+		tableConfig.setIpv4Table(true);
+		tableConfig.setIpv6Table(true);
+	});
+	expectRangeIndexes(tables, true, true, false);
+	verifyRangeBoundaries(tables, FIFTYONE_DEGREES_IP_TYPE_IPV4);
+	verifyRangeBoundaries(tables, FIFTYONE_DEGREES_IP_TYPE_IPV6);
+	delete tables;
+	EngineIpi *index = createEngine([](ConfigIpi &indexConfig) {
+		indexConfig.setIpv6PrefixBits(32);
+	});
+	expectRangeIndexes(index, false, false, true);
+	verifyRangeBoundaries(index, FIFTYONE_DEGREES_IP_TYPE_IPV6);
+	delete index;
+}
+
+void EngineIpIntelligenceTests::verifyRangeCache() {
+	EngineIpi *cacheEngine = createEngine([](ConfigIpi &cacheConfig) {
+		cacheConfig.setRangeCacheCapacity(1024);
+	});
+
+	// Each IP address is processed twice so that the second pass is served
+	// from the range cache, and both passes must match the graphs.
+	compareEngines((EngineIpi*)getEngine(), cacheEngine, 2);
+	fiftyoneDegreesIpiRangeCacheStats stats =
+		cacheEngine->getRangeCacheStats();
+	EXPECT_EQ(1024u, stats.capacity);
+	EXPECT_GT(stats.hits, 0u) <<
+		"Repeated IP addresses should have been found in the range cache.";
+	delete cacheEngine;
+
+	// A different IP address in the range cached by the first must be
+	// answered from the cache with the same results as the graphs.
+	verifyRangeCacheOtherAddress(ipv4Address);
+	verifyRangeCacheOtherAddress(ipv6Address);
+}
+
+void EngineIpIntelligenceTests::verifyRangeCacheOtherAddress(
+	const char *ipAddress) {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	EngineIpi *cacheEngine = createEngine([](ConfigIpi &cacheConfig) {
+		cacheConfig.setRangeCacheCapacity(1024);
+	});
+	ResultsIpi *results = cacheEngine->process(ipAddress);
+	Common::Value<IpIntelligence::IpAddress> rangeStart =
+		results->getRangeStart();
+	Common::Value<IpIntelligence::IpAddress> rangeEnd =
+		results->getRangeEnd();
+	delete results;
+	IpIntelligence::IpAddress target(ipAddress);
+	const fiftyoneDegreesIpType type = target.getType();
+	const int length = type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+		FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+	const int prefixLength = type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ? 3 : 6;
+
+	// Use the next IP address, or the previous one if the IP address is the
+	// last in its range. It must share the prefix used to find the cache
+	// entry to be found in the cache.
+	fiftyoneDegreesIpAddress other;
+	memset(&other, 0, sizeof(other));
+	other.type = type;
+	memcpy(other.value, target.getIpAddress(), length);
+	if (rangeStart.hasValue() == false ||
+		memcmp(rangeStart.getValue().getIpAddress(),
+			rangeEnd.getValue().getIpAddress(), length) == 0) {
+		delete cacheEngine;
+		return;
+	}
+	if (memcmp(other.value, rangeEnd.getValue().getIpAddress(), length) != 0) {
+		ipAddressIncrement(other);
+	}
+	else {
+		ipAddressDecrement(other);
+	}
+	if (memcmp(other.value, target.getIpAddress(), prefixLength) != 0) {
+		delete cacheEngine;
+		return;
+	}
+	const uint64_t hits = cacheEngine->getRangeCacheStats().hits;
+	ResultsIpi *cached = cacheEngine->process(other.value, length, type);
+	ResultsIpi *graphs = engineIpi->process(other.value, length, type);
+	EXPECT_EQ(hits + 1, cacheEngine->getRangeCacheStats().hits) <<
+		"A different IP address in the range of " << ipAddress <<
+		" should have been found in the range cache.";
+	EXPECT_TRUE(sameGraphResults(graphs, cached));
+	compareResults(graphs, cached);
+	delete cached;
+	delete graphs;
+	delete cacheEngine;
+}
+
+void EngineIpIntelligenceTests::verifyValueIndex() {
+	// The index is only built for data sets which are entirely in memory.
+	if (config->getConfig().b.allInMemory == false) {
+		return;
+	}
+
+	// Values from the index and the resolved profile groups must match
+	// those found by searching the profiles, including the weightings of
+	// profile groups.
+	compareWithConfig([](ConfigIpi &indexConfig) {
+		indexConfig.setValueIndex(true);
+	});
+	compareWithConfig([](ConfigIpi &groupsConfig) {
+		groupsConfig.setProfileGroupsTable(true);
+	});
+	compareWithConfig([](ConfigIpi &bothConfig) {
+		bothConfig.setValueIndex(true);
+		bothConfig.setProfileGroupsTable(true);
+	});
+}
+
+void EngineIpIntelligenceTests::verifyMappedFile() {
+	// The file is only mapped for data sets which are entirely in memory.
+	if (config->getConfig().b.allInMemory == false) {
+		return;
+	}
+
+	// Results read from the mapping of the temporary copy of the data file
+	// must match those read from the copy in allocated memory.
+	compareWithConfig([](ConfigIpi &mappedConfig) {
+		mappedConfig.setMapFile(true);
+		mappedConfig.setUseTempFile(true);
+		mappedConfig.setMapHints(
+			FIFTYONE_DEGREES_IPI_MAP_POPULATE |
+			FIFTYONE_DEGREES_IPI_MAP_WILL_NEED |
+			FIFTYONE_DEGREES_IPI_MAP_HUGE_PAGES);
+		EXPECT_TRUE(mappedConfig.getMapFile());
+	});
+
+	// The data file itself is never mapped.
+	ConfigIpi directConfig(&config->getConfig());
+	directConfig.setMapFile(true);
+	directConfig.setUseTempFile(false);
+	EXPECT_THROW(
+		delete new EngineIpi(fullName, &directConfig, requiredProperties),
+		StatusCodeException) << "Mapping the data file without a temporary "
+		"copy should be refused";
+}
+
+void EngineIpIntelligenceTests::verifyInitThreads() {
+	EngineIpi *threadsEngine = createEngine([](ConfigIpi &threadsConfig) {
+		threadsConfig.setInitThreads(4);
+		threadsConfig.setIpv4Table(true);
+		threadsConfig.setIpv6Table(true);
+		threadsConfig.setIpv6PrefixBits(16);
+		threadsConfig.setRangeCacheCapacity(1024);
+		threadsConfig.setValueIndex(true);
+		threadsConfig.setProfileGroupsTable(true);
+		EXPECT_EQ(4, threadsConfig.getInitThreads());
+	});
+	fiftyoneDegreesIpiInitTimings timings = threadsEngine->getInitTimings();
+	EXPECT_GT(timings.total, 0.0);
+	EXPECT_GE(timings.total, timings.indexes);
+
+	// A data set built in parallel must give the same results as one built
+	// in sequence.
+	compareEngines((EngineIpi*)getEngine(), threadsEngine);
+	delete threadsEngine;
+}
+
+/**
+ * Number of bytes of the data file copied by verifyInitThreadsFailure. Enough
+ * for the header and the start of the first collections, but far less than
+ * any of the data files.
+ */
+#define INIT_THREADS_FAILURE_LENGTH (4 * 1024 * 1024)
+
+void EngineIpIntelligenceTests::verifyInitThreadsFailure() {
+	// Copy the start of the data file so that the header is valid but the
+	// collections can not be read. Loading every collection into memory
+	// means the tasks creating them fail.
+	const string truncatedFileName = getTempFileName("ipi");
+	ASSERT_FALSE(truncatedFileName.empty());
+	FILE *source = fopen(fullName, "rb");
+	ASSERT_NE(nullptr, source);
+	vector<char> start(INIT_THREADS_FAILURE_LENGTH);
+	start.resize(fread(start.data(), 1, start.size(), source));
+	fclose(source);
+	FILE *truncated = fopen(truncatedFileName.c_str(), "wb");
+	ASSERT_NE(nullptr, truncated);
+	ASSERT_EQ(start.size(), fwrite(start.data(), 1, start.size(), truncated));
+	fclose(truncated);
+
+	// The failure must be reported with the same status whether the tasks
+	// ran in sequence or in parallel, and without leaking the collections
+	// which were created.
+	fiftyoneDegreesStatusCode statuses[2];
+	const uint16_t threads[] = { 1, 4 };
+	for (int i = 0; i < 2; i++) {
+		fiftyoneDegreesConfigIpi failConfig =
+			fiftyoneDegreesIpiHighPerformanceConfig;
+		failConfig.initThreads = threads[i];
+		fiftyoneDegreesResourceManager manager;
+		FIFTYONE_DEGREES_EXCEPTION_CREATE;
+		statuses[i] = fiftyoneDegreesIpiInitManagerFromFile(
+			&manager,
+			&failConfig,
+			&fiftyoneDegreesPropertiesDefault,
+			truncatedFileName.c_str(),
+			exception);
+		if (statuses[i] == FIFTYONE_DEGREES_STATUS_SUCCESS) {
+			fiftyoneDegreesResourceManagerFree(&manager);
+		}
+	}
+	remove(truncatedFileName.c_str());
+	EXPECT_NE(FIFTYONE_DEGREES_STATUS_SUCCESS, statuses[0]);
+	EXPECT_EQ(statuses[0], statuses[1]) << "A task failing in parallel "
+		"should report the same status as in sequence";
+}
+
+void EngineIpIntelligenceTests::verifyRefreshAsync() {
+	EngineIpi *refreshEngine = createEngine([](ConfigIpi &) {});
+	vector<string> warmIpAddresses = {
+		ipv4Address,
+		ipv6Address };
+	for (size_t i = 0; i < ipAddresses.size() && i < 20; i++) {
+		warmIpAddresses.push_back(ipAddresses[i]);
+	}
+	uint32_t warmed = 0;
+	fiftyoneDegreesStatusCode status = FIFTYONE_DEGREES_STATUS_NOT_SET;
+	refreshEngine->refreshDataAsync(
+		nullptr,
+		warmIpAddresses,
+		true,
+		[&](const fiftyoneDegreesIpiReloadResult &result) {
+			status = result.status;
+			warmed = result.warmed;
+		});
+
+	// Processing continues with the active data set during the refresh.
+	ResultsIpi *during = refreshEngine->process(ipv4Address);
+	delete during;
+	refreshEngine->waitForRefresh();
+	EXPECT_EQ(FIFTYONE_DEGREES_STATUS_SUCCESS, status);
+	EXPECT_GT(warmed, 0u);
+	EXPECT_LE((size_t)warmed, warmIpAddresses.size());
+
+	// An exception thrown by the callback is thrown by waitForRefresh rather
+	// than on the refresh thread.
+	refreshEngine->refreshDataAsync(
+		nullptr,
+		vector<string>(),
+		false,
+		[](const fiftyoneDegreesIpiReloadResult &) {
+			throw std::runtime_error("complete");
+		});
+	EXPECT_THROW(refreshEngine->waitForRefresh(), std::runtime_error);
+
+	// The refreshed data set must give the same results.
+	compareEngines((EngineIpi*)getEngine(), refreshEngine);
+	delete refreshEngine;
+}
+
+void EngineIpIntelligenceTests::verifyRefreshFromDelta() {
+	const string delta = getTempFileName("ipd");
+	const string newFile = getTempFileName("ipn");
+	ASSERT_FALSE(delta.empty());
+	ASSERT_FALSE(newFile.empty());
+	const char *deltaFileName = delta.c_str();
+	const char *newFileName = newFile.c_str();
+
+	// Only one version of the data file is available, so the delta is from
+	// the data file to itself. This checks the data file is rebuilt from
+	// the active data set and reloaded. Finding the bytes which changed is
+	// covered by IpiDeltaTests.
+	fiftyoneDegreesIpiDeltaStats stats;
+	ASSERT_EQ(FIFTYONE_DEGREES_STATUS_SUCCESS, fiftyoneDegreesIpiDeltaCreate(
+		fullName,
+		fullName,
+		deltaFileName,
+		0,
+		&stats));
+	EngineIpi *deltaEngine = createEngine([](ConfigIpi &) {});
+	deltaEngine->refreshDataFromDelta(deltaFileName, newFileName);
+	compareEngines((EngineIpi*)getEngine(), deltaEngine);
+
+	// The data file being used must not be written over even when the path
+	// to it is written differently.
+	string activeFileName = deltaEngine->getDataFilePath();
+	const size_t separator = activeFileName.find_last_of("/\\");
+	activeFileName.insert(
+		separator == string::npos ? 0 : separator + 1,
+		"./");
+	EXPECT_THROW(
+		deltaEngine->refreshDataFromDelta(
+			deltaFileName,
+			activeFileName.c_str()),
+		StatusCodeException);
+	delete deltaEngine;
+	remove(deltaFileName);
+	remove(newFileName);
+}
+
+void EngineIpIntelligenceTests::verifyPositionalRead() {
+	// Collections are only read from the file for data sets which are not
+	// entirely in memory.
+	if (config->getConfig().b.allInMemory == true) {
+		return;
+	}
+
+	// Results read with positional reads from a single handle must match
+	// those read with handles from the file pool.
+	compareWithConfig([](ConfigIpi &positionalConfig) {
+		positionalConfig.setPositionalRead(true);
+		EXPECT_TRUE(positionalConfig.getPositionalRead());
+	});
+}
+
+void EngineIpIntelligenceTests::verifyValuesCache() {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	EngineIpi *cacheEngine = createEngine([](ConfigIpi &cacheConfig) {
+		cacheConfig.setValuesCacheCapacity(1024);
+	});
+
+	// Each IP address is processed twice so that the values for the second
+	// pass are returned from the cache, and both passes must match the
+	// values found from the profiles.
+	compareEngines(engineIpi, cacheEngine, 2);
+	ValuesCacheIpi::Stats stats = cacheEngine->getValuesCacheStats();
+	EXPECT_EQ(1024u, stats.capacity);
+	EXPECT_GT(stats.hits, 0u) <<
+		"Repeated IP addresses should have found values in the cache.";
+	EXPECT_EQ(0u, engineIpi->getValuesCacheStats().capacity);
+	delete cacheEngine;
+
+	// Checking for values before getting them must count a single miss for
+	// the request, and the values must then be returned from the cache.
+	cacheEngine = createEngine([](ConfigIpi &cacheConfig) {
+		cacheConfig.setValuesCacheCapacity(1024);
+	});
+	ResultsIpi *results = cacheEngine->process(ipv4Address);
+	for (int i = 0; i < results->getAvailableProperties(); i++) {
+		const ValuesCacheIpi::Stats before = cacheEngine->getValuesCacheStats();
+		if (results->hasValues(i)) {
+			results->getValueAsString(i);
+			const ValuesCacheIpi::Stats first =
+				cacheEngine->getValuesCacheStats();
+			EXPECT_LE(first.misses - before.misses, 1u) << "Getting the "
+				"values of a property should count at most one miss.";
+			EXPECT_EQ(first.hits, before.hits);
+			if (results->hasValues(i)) {
+				results->getValueAsString(i);
+			}
+			const ValuesCacheIpi::Stats second =
+				cacheEngine->getValuesCacheStats();
+			EXPECT_EQ(first.misses, second.misses);
+			EXPECT_EQ(
+				first.misses - before.misses,
+				second.hits - first.hits) << "Values added to the cache "
+				"should be returned from it on the next request.";
+		}
+	}
+	delete results;
+	delete cacheEngine;
+}
+
+void EngineIpIntelligenceTests::verifyMatchedRange(const char *ipAddress) {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	ResultsIpi *results = engineIpi->process(ipAddress);
+	Common::Value<IpIntelligence::IpAddress> rangeStart =
+		results->getRangeStart();
+	Common::Value<IpIntelligence::IpAddress> rangeEnd =
+		results->getRangeEnd();
+	const uint32_t rangeId = results->getRangeId();
+
+	// The range is the intersection of the range of each result which has
+	// one, and every result's range contains the IP address.
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+	fiftyoneDegreesResultsIpi *c = results->results;
+	fiftyoneDegreesIpAddress start, end;
+	int known = 0;
+	for (uint32_t i = 0; i < c->count; i++) {
+		const fiftyoneDegreesResultIpi *result =
+			fiftyoneDegreesResultsIpiGetResultRange(c, i, exception);
+		EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+		if (result == nullptr) {
+			ADD_FAILURE() << "No result at index " << i;
+			break;
+		}
+		EXPECT_TRUE(result->rangeResolved);
+		if (result->rangeId == FIFTYONE_DEGREES_IPI_NO_RANGE_ID) {
+			continue;
+		}
+		const int length = result->type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+			FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+		EXPECT_LE(memcmp(result->rangeStart.value,
+			result->targetIpAddress.value, length), 0);
+		EXPECT_LE(memcmp(result->targetIpAddress.value,
+			result->rangeEnd.value, length), 0);
+		if (known++ == 0 ||
+			memcmp(result->rangeStart.value, start.value, length) > 0) {
+			start = result->rangeStart;
+		}
+		if (known == 1 ||
+			memcmp(result->rangeEnd.value, end.value, length) < 0) {
+			end = result->rangeEnd;
+		}
+	}
+	EXPECT_EQ(known > 0, rangeStart.hasValue());
+	if (known > 0 && rangeStart.hasValue() && rangeEnd.hasValue()) {
+		const int length = start.type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+			FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+		EXPECT_EQ(0, memcmp(start.value,
+			rangeStart.getValue().getIpAddress(), length));
+		EXPECT_EQ(0, memcmp(end.value,
+			rangeEnd.getValue().getIpAddress(), length));
+	}
+	delete results;
+	if (!rangeStart.hasValue()) {
+		EXPECT_FALSE(rangeEnd.hasValue());
+		EXPECT_EQ(FIFTYONE_DEGREES_IPI_NO_RANGE_ID, rangeId);
+		return;
+	}
+	ASSERT_TRUE(rangeEnd.hasValue());
+	EXPECT_NE(FIFTYONE_DEGREES_IPI_NO_RANGE_ID, rangeId);
+
+	IpIntelligence::IpAddress target(ipAddress);
+	const fiftyoneDegreesIpType type = target.getType();
+	const int length = type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+		FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+	IpIntelligence::IpAddress bounds[] = {
+		rangeStart.getValue(),
+		rangeEnd.getValue() };
+	EXPECT_LE(memcmp(bounds[0].getIpAddress(), target.getIpAddress(), length),
+		0) << "The range should start at or before IP address: " << ipAddress;
+	EXPECT_LE(memcmp(target.getIpAddress(), bounds[1].getIpAddress(), length),
+		0) << "The range should end at or after IP address: " << ipAddress;
+
+	// The first and last IP addresses must match the same range.
+	for (IpIntelligence::IpAddress &bound : bounds) {
+		EXPECT_EQ(type, bound.getType());
+		unsigned char value[FIFTYONE_DEGREES_IPV6_LENGTH];
+		memcpy(value, bound.getIpAddress(), length);
+		ResultsIpi *boundResults = engineIpi->process(value, length, type);
+		EXPECT_EQ(rangeId, boundResults->getRangeId()) << "The bounds of the "
+			"range should have the same range id as IP address: " <<
+			ipAddress;
+		delete boundResults;
+	}
+}
+
+void EngineIpIntelligenceTests::verifyMatchedRange() {
+	verifyMatchedRange(ipv4Address);
+	verifyMatchedRange(ipv6Address);
+}
+
+/**
+ * State used when processing sorted IP addresses.
+ */
+typedef struct sorted_ip_addresses_state_t {
+	const vector<fiftyoneDegreesIpAddress> *ipAddresses; /**< IP addresses to
+														 process */
+	size_t next; /**< Index of the next IP address */
+	vector<vector<uint32_t>> offsets; /**< Graph results for each IP
+									  address */
+} sortedIpAddressesState;
+
+static bool sortedIpAddressNext(
+	void *state,
+	fiftyoneDegreesIpAddress *ipAddress) {
+	sortedIpAddressesState *sorted = (sortedIpAddressesState*)state;
+	if (sorted->next < sorted->ipAddresses->size()) {
+		*ipAddress = (*sorted->ipAddresses)[sorted->next++];
+		return true;
+	}
+	return false;
+}
+
+static bool sortedIpAddressResults(
+	void *state,
+	fiftyoneDegreesResultsIpi *results) {
+	vector<uint32_t> offsets;
+	for (uint32_t i = 0; i < results->count; i++) {
+		offsets.push_back(results->items[i].graphResult.rawOffset);
+	}
+	((sortedIpAddressesState*)state)->offsets.push_back(offsets);
+	return true;
+}
+
+void EngineIpIntelligenceTests::verifySortedIpAddresses() {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+
+	// The compare IP addresses include the first, middle and last IP address
+	// of ranges so that once sorted different consecutive IP addresses share
+	// a range and the previous results are reused for them.
+	vector<fiftyoneDegreesIpAddress> sorted = getCompareIpAddresses();
+	for (size_t i = 0; i < ipAddresses.size() && i < 100; i++) {
+		fiftyoneDegreesIpAddress ipAddress;
+		const char *value = ipAddresses[i].c_str();
+		if (fiftyoneDegreesIpAddressParse(
+			value,
+			value + ipAddresses[i].size(),
+			&ipAddress)) {
+			sorted.push_back(ipAddress);
+		}
+	}
+	std::sort(sorted.begin(), sorted.end(), [](
+		const fiftyoneDegreesIpAddress &a,
+		const fiftyoneDegreesIpAddress &b) {
+		if (a.type != b.type) {
+			return a.type < b.type;
+		}
+		return memcmp(a.value, b.value, FIFTYONE_DEGREES_IPV6_LENGTH) < 0;
+	});
+
+	// Use the results from a normal lookup to process the sorted IP
+	// addresses.
+	ResultsIpi *results = engineIpi->process(ipv4Address);
+	sortedIpAddressesState state;
+	state.ipAddresses = &sorted;
+	state.next = 0;
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+	uint32_t count = fiftyoneDegreesResultsIpiFromSortedIpAddresses(
+		results->results,
+		&state,
+		sortedIpAddressNext,
+		sortedIpAddressResults,
+		exception);
+	FIFTYONE_DEGREES_EXCEPTION_THROW;
+	delete results;
+	ASSERT_EQ(sorted.size(), count);
+	ASSERT_EQ(sorted.size(), state.offsets.size());
+
+	// Each IP address must have the same graph results as a single lookup.
+	for (size_t i = 0; i < sorted.size(); i++) {
+		const int length = sorted[i].type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+			FIFTYONE_DEGREES_IPV4_LENGTH : FIFTYONE_DEGREES_IPV6_LENGTH;
+		ResultsIpi *single = engineIpi->process(
+			sorted[i].value,
+			length,
+			sorted[i].type);
+		ASSERT_EQ(single->results->count, state.offsets[i].size());
+		for (uint32_t c = 0; c < single->results->count; c++) {
+			EXPECT_EQ(
+				single->results->items[c].graphResult.rawOffset,
+				state.offsets[i][c]) << "Sorted processing returned a "
+				"different result for IP address at index " << i;
+		}
+		delete single;
+	}
+}
+
+static uint64_t processIntoAllocations = 0;
+
+static void* processIntoCountingMalloc(size_t size) {
+	processIntoAllocations++;
+	return fiftyoneDegreesMemoryStandardMalloc(size);
+}
+
+/**
+ * Set while verifyProcessInto counts the allocations made by the C++ layer
+ * as well as those of the C API.
+ */
+static std::atomic<bool> processIntoCountingNew(false);
+static std::atomic<uint64_t> processIntoNewAllocations(0);
+
+/**
+ * Replaces the global operator new of the test executable so that the
+ * allocations of the C++ engine and results are counted while
+ * processIntoCountingNew is set. The array and nothrow forms call this one.
+ */
+void* operator new(size_t size) {
+	if (processIntoCountingNew) {
+		processIntoNewAllocations++;
+	}
+	void *ptr = malloc(size == 0 ? 1 : size);
+	if (ptr == nullptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+	free(ptr);
+}
+
+void EngineIpIntelligenceTests::verifyProcessInto() {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	vector<string> intoIpAddresses = {
+		ipv4Address,
+		ipv6Address,
+		badIpv4Address };
+	for (size_t i = 0; i < ipAddresses.size() && i < 20; i++) {
+		intoIpAddresses.push_back(ipAddresses[i]);
+	}
+
+	// The results must match those of a normal process call.
+	ResultsIpi *into = nullptr;
+	for (size_t i = 0; i < intoIpAddresses.size(); i++) {
+		into = engineIpi->processInto(into, intoIpAddresses[i].c_str());
+		ResultsIpi *results = engineIpi->process(intoIpAddresses[i].c_str());
+		compareResults(results, into);
+		delete results;
+	}
+
+	// Once the results have been used the same instance is reused and, where
+	// the data set is in memory, no memory is allocated by the lookups.
+	if (config->getConfig().b.allInMemory) {
+		ResultsIpi *first = into;
+		processIntoAllocations = 0;
+		processIntoNewAllocations = 0;
+		fiftyoneDegreesMalloc = processIntoCountingMalloc;
+		processIntoCountingNew = true;
+		for (int pass = 0; pass < 2; pass++) {
+			for (size_t i = 0; i < intoIpAddresses.size(); i++) {
+				into = engineIpi->processInto(
+					into,
+					intoIpAddresses[i].c_str());
+			}
+		}
+		processIntoCountingNew = false;
+		fiftyoneDegreesMalloc = fiftyoneDegreesMemoryStandardMalloc;
+		EXPECT_EQ(first, into) << "The results should have been reused.";
+		EXPECT_EQ(0u, processIntoAllocations) << "Processing into existing "
+			"results should not allocate memory in the C API.";
+		EXPECT_EQ(0u, processIntoNewAllocations.load()) << "Processing into "
+			"existing results should not allocate memory in the C++ API.";
+	}
+	delete into;
+}
+
+void EngineIpIntelligenceTests::verifyResultsPool() {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	ResultsPoolIpi::Stats before = engineIpi->getResultsPoolStats();
+	EXPECT_GT(before.capacity, 0u);
+
+	// Results deleted before the next are processed are returned to the
+	// pool and taken again.
+	ResultsIpi *expected = engineIpi->process(ipv4Address);
+	for (int i = 0; i < 10; i++) {
+		ResultsIpi *results = engineIpi->process(ipv4Address);
+		compareResults(expected, results);
+		delete results;
+	}
+	delete expected;
+	ResultsPoolIpi::Stats after = engineIpi->getResultsPoolStats();
+	EXPECT_GE(after.hits - before.hits, 9u) << "Results should have been "
+		"taken from the pool.";
+	EXPECT_GE(after.highWaterMark, 2u);
+
+	// More results than the pool can hold are created when needed.
+	vector<ResultsIpi*> held;
+	for (uint32_t i = 0; i <= after.capacity; i++) {
+		held.push_back(engineIpi->process(ipv6Address));
+	}
+	for (size_t i = 0; i < held.size(); i++) {
+		delete held[i];
+	}
+	EXPECT_GT(engineIpi->getResultsPoolStats().misses, after.misses);
+}
+
+void EngineIpIntelligenceTests::verifyValuesForProperties() {
+	verifyValuesForProperties((EngineIpi*)getEngine());
+}
+
+void EngineIpIntelligenceTests::verifyValuesForPropertiesIndexed() {
+	// The single pass reads values from the value index and the resolved
+	// profile groups when they are available, so must be checked with them.
+	EngineIpi *indexed = createEngine([](ConfigIpi &indexedConfig) {
+		indexedConfig.setValueIndex(true);
+		indexedConfig.setProfileGroupsTable(true);
+	});
+	verifyValuesForProperties(indexed);
+	delete indexed;
+}
+
+void EngineIpIntelligenceTests::verifyValuesForProperties(
+	EngineIpi *engineIpi) {
+	vector<string> testIpAddresses = { ipv4Address, ipv6Address };
+	for (size_t i = 0; i < ipAddresses.size() && i < 20; i++) {
+		testIpAddresses.push_back(ipAddresses[i]);
+	}
+	for (size_t i = 0; i < testIpAddresses.size(); i++) {
+		ResultsIpi *results = engineIpi->process(testIpAddresses[i].c_str());
+		fiftyoneDegreesResultsIpi *c = results->results;
+		fiftyoneDegreesDataSetIpi *dataSet =
+			(fiftyoneDegreesDataSetIpi*)c->b.dataSet;
+		const uint32_t count = dataSet->b.b.available->count;
+		vector<int> indexes(count);
+		vector<fiftyoneDegreesWeightedItemList> lists(count);
+		for (uint32_t p = 0; p < count; p++) {
+			indexes[p] = (int)p;
+			fiftyoneDegreesWeightedItemListInit(
+				&lists[p],
+				1,
+				FIFTYONE_DEGREES_WEIGHTED_ITEM_LIST_DEFAULT_LOAD_FACTOR);
+		}
+
+		// Values found in a single pass must be the same as those found one
+		// property at a time.
+		FIFTYONE_DEGREES_EXCEPTION_CREATE;
+		fiftyoneDegreesResultsIpiGetValuesForProperties(
+			c,
+			indexes.data(),
+			count,
+			lists.data(),
+			exception);
+		FIFTYONE_DEGREES_EXCEPTION_THROW;
+		uint32_t total = 0;
+		for (uint32_t p = 0; p < count; p++) {
+			const fiftyoneDegreesWeightedItem *expected =
+				fiftyoneDegreesResultsIpiGetValues(c, (int)p, exception);
+			FIFTYONE_DEGREES_EXCEPTION_THROW;
+			const uint32_t expectedCount = expected == nullptr ?
+				0 : c->values.count;
+			ASSERT_EQ(expectedCount, lists[p].count) << "Wrong number of "
+				"values for property at index " << p;
+			for (uint32_t v = 0; v < expectedCount; v++) {
+				EXPECT_EQ(
+					expected[v].rawWeighting,
+					lists[p].items[v].rawWeighting);
+				if (config->getConfig().b.allInMemory) {
+					EXPECT_EQ(
+						expected[v].item.data.ptr,
+						lists[p].items[v].item.data.ptr);
+				}
+			}
+			total += expectedCount;
+		}
+
+		// Lists owned by the results are reused by repeated calls and must
+		// hold the same values each time.
+		for (int pass = 0; pass < 2; pass++) {
+			fiftyoneDegreesWeightedItemList *owned =
+				fiftyoneDegreesResultsIpiGetPropertiesLists(
+					c,
+					count,
+					exception);
+			FIFTYONE_DEGREES_EXCEPTION_THROW;
+			ASSERT_NE(nullptr, owned);
+			fiftyoneDegreesResultsIpiGetValuesForProperties(
+				c,
+				indexes.data(),
+				count,
+				owned,
+				exception);
+			FIFTYONE_DEGREES_EXCEPTION_THROW;
+			for (uint32_t p = 0; p < count; p++) {
+				EXPECT_EQ(lists[p].count, owned[p].count) << "Wrong number "
+					"of values for property at index " << p << " when the "
+					"lists are reused";
+				fiftyoneDegreesWeightedItemListRelease(&owned[p]);
+			}
+		}
+		for (uint32_t p = 0; p < count; p++) {
+			fiftyoneDegreesWeightedItemListRelease(&lists[p]);
+			fiftyoneDegreesWeightedItemListFree(&lists[p]);
+		}
+
+		// The collection of all the values must contain every value.
+		fiftyoneDegreesWeightedValuesCollection collection =
+			fiftyoneDegreesResultsIpiGetValuesCollection(
+				c,
+				nullptr,
+				0,
+				nullptr,
+				exception);
+		FIFTYONE_DEGREES_EXCEPTION_THROW;
+		EXPECT_EQ(total, collection.itemsCount);
+		fiftyoneDegreesWeightedValuesCollectionRelease(&collection);
+		delete results;
+	}
+}
+
+void EngineIpIntelligenceTests::verifyValuesWithReason() {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	vector<string> testIpAddresses = {
+		ipv4Address,
+		ipv6Address,
+		badIpv4Address };
+	for (size_t i = 0; i < ipAddresses.size() && i < 20; i++) {
+		testIpAddresses.push_back(ipAddresses[i]);
+	}
+	for (size_t i = 0; i < testIpAddresses.size(); i++) {
+		ResultsIpi *results = engineIpi->process(testIpAddresses[i].c_str());
+		fiftyoneDegreesResultsIpi *c = results->results;
+		const int count = (int)((fiftyoneDegreesDataSetIpi*)c->b.dataSet)
+			->b.b.available->count;
+
+		// Include required property indexes which are not valid.
+		for (int p = -1; p <= count; p++) {
+			FIFTYONE_DEGREES_EXCEPTION_CREATE;
+			const bool hasValues = fiftyoneDegreesResultsIpiGetHasValues(
+				c,
+				p,
+				exception);
+			FIFTYONE_DEGREES_EXCEPTION_THROW;
+			const fiftyoneDegreesResultsNoValueReason expectedReason =
+				fiftyoneDegreesResultsIpiGetNoValueReason(c, p, exception);
+			FIFTYONE_DEGREES_EXCEPTION_THROW;
+			uint32_t expectedCount = 0;
+			if (hasValues) {
+				fiftyoneDegreesResultsIpiGetValues(c, p, exception);
+				FIFTYONE_DEGREES_EXCEPTION_THROW;
+				expectedCount = c->values.count;
+			}
+
+			fiftyoneDegreesResultsNoValueReason reason;
+			const fiftyoneDegreesWeightedItem *values =
+				fiftyoneDegreesResultsIpiGetValuesWithReason(
+					c,
+					p,
+					&reason,
+					exception);
+			FIFTYONE_DEGREES_EXCEPTION_THROW;
+			EXPECT_EQ(hasValues, values != nullptr) << "Values should be "
+				"returned if there are values for property at index " << p;
+			if (values != nullptr) {
+				EXPECT_EQ(expectedCount, c->values.count);
+			}
+			else {
+				EXPECT_EQ(expectedReason, reason) << "Wrong reason for "
+					"property at index " << p;
+			}
+		}
+		delete results;
+	}
+}
+
+void EngineIpIntelligenceTests::verifyStringViews() {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	vector<string> testIpAddresses = {
+		ipv4Address,
+		ipv6Address,
+		badIpv4Address };
+	for (size_t i = 0; i < ipAddresses.size() && i < 20; i++) {
+		testIpAddresses.push_back(ipAddresses[i]);
+	}
+	for (size_t i = 0; i < testIpAddresses.size(); i++) {
+		ResultsIpi *results = engineIpi->process(testIpAddresses[i].c_str());
+		for (int p = -1; p <= results->getAvailableProperties(); p++) {
+			Common::Value<vector<WeightedValue<string>>> expected =
+				results->getValuesAsWeightedStringList(p);
+			Common::Value<vector<WeightedStringView>> views =
+				results->getValuesAsWeightedStringViewList(p);
+			ASSERT_EQ(expected.hasValue(), views.hasValue());
+			if (expected.hasValue() == false) {
+				EXPECT_EQ(
+					expected.getNoValueReason(),
+					views.getNoValueReason());
+				continue;
+			}
+			const vector<WeightedValue<string>> &expectedValues =
+				expected.getValue();
+			const vector<WeightedStringView> &viewValues = views.getValue();
+			ASSERT_EQ(expectedValues.size(), viewValues.size());
+			for (size_t v = 0; v < expectedValues.size(); v++) {
+				EXPECT_EQ(
+					expectedValues[v].getValue(),
+					string(viewValues[v].getValue())) << "Property at "
+					"index " << p << " has a different value";
+				EXPECT_EQ(
+					expectedValues[v].getRawWeight(),
+					viewValues[v].getRawWeight());
+			}
+		}
+		delete results;
+	}
+}
+
+void EngineIpIntelligenceTests::verifyTypedValues() {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	vector<string> testIpAddresses = {
+		ipv4Address,
+		ipv6Address,
+		badIpv4Address };
+	for (size_t i = 0; i < ipAddresses.size() && i < 20; i++) {
+		testIpAddresses.push_back(ipAddresses[i]);
+	}
+	for (size_t i = 0; i < testIpAddresses.size(); i++) {
+		ResultsIpi *results = engineIpi->process(testIpAddresses[i].c_str());
+		for (int p = -1; p <= results->getAvailableProperties(); p++) {
+			FIFTYONE_DEGREES_EXCEPTION_CREATE;
+			Common::Value<vector<WeightedValue<int>>> expectedInts =
+				results->getValuesAsWeightedIntegerList(p);
+			Common::Value<vector<WeightedValue<double>>> expectedDoubles =
+				results->getValuesAsWeightedDoubleList(p);
+
+			// Get the typed values with a capacity of one first to check
+			// the total count is returned.
+			fiftyoneDegreesWeightedInt firstInt;
+			const uint32_t count =
+				fiftyoneDegreesResultsIpiGetValuesAsWeightedInts(
+					results->results, p, &firstInt, 1, exception);
+			EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+			if (expectedInts.hasValue() == false) {
+				EXPECT_EQ(0u, count);
+				continue;
+			}
+			ASSERT_EQ(expectedInts.getValue().size(), count);
+			vector<fiftyoneDegreesWeightedInt> ints(count);
+			vector<fiftyoneDegreesWeightedDouble> doubles(count);
+			EXPECT_EQ(count, fiftyoneDegreesResultsIpiGetValuesAsWeightedInts(
+				results->results, p, ints.data(), count, exception));
+			EXPECT_EQ(count,
+				fiftyoneDegreesResultsIpiGetValuesAsWeightedDoubles(
+					results->results, p, doubles.data(), count, exception));
+			EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+			for (uint32_t v = 0; v < count; v++) {
+				EXPECT_EQ(expectedInts.getValue()[v].getValue(), ints[v].value);
+				EXPECT_EQ(
+					expectedInts.getValue()[v].getRawWeight(),
+					ints[v].header.rawWeighting);
+				EXPECT_EQ(p, ints[v].header.requiredPropertyIndex);
+				EXPECT_DOUBLE_EQ(
+					expectedDoubles.getValue()[v].getValue(),
+					doubles[v].value) << "Property at index " << p <<
+					" has a different value";
+			}
+		}
+		delete results;
+	}
+}
+
+/**
+ * Writes a 2D WKB point to the stored binary value buffer provided.
+ */
+static void writeWkbPoint(
+	uint8_t *buffer,
+	bool littleEndian,
+	uint32_t geometryType,
+	double x,
+	double y) {
+	const uint16_t probe = 1;
+	const bool swap = (*(const uint8_t*)&probe == 1) != littleEndian;
+	const int16_t size = 21;
+	uint8_t *wkb = buffer + sizeof(size);
+	memcpy(buffer, &size, sizeof(size));
+	wkb[0] = littleEndian ? 1 : 0;
+	memcpy(wkb + 1, &geometryType, sizeof(geometryType));
+	memcpy(wkb + 5, &x, sizeof(x));
+	memcpy(wkb + 13, &y, sizeof(y));
+	if (swap) {
+		std::reverse(wkb + 1, wkb + 5);
+		std::reverse(wkb + 5, wkb + 13);
+		std::reverse(wkb + 13, wkb + 21);
+	}
+}
+
+/**
+ * Returns the largest difference between the number at the index in the WKT
+ * point and the value it was rounded from.
+ */
+static double getWktTolerance(const string &wktPoint, int index) {
+	const size_t open = wktPoint.find('(');
+	size_t start = wktPoint.find_first_not_of(' ', open + 1);
+	if (index > 0) {
+		start = wktPoint.find_first_not_of(' ', wktPoint.find(' ', start));
+	}
+	const size_t end = wktPoint.find_first_of(" )", start);
+	const size_t point = wktPoint.find('.', start);
+	const int decimals = point < end ? (int)(end - point - 1) : 0;
+	return 0.5 * pow(10.0, -decimals) + 1e-9;
+}
+
+void EngineIpIntelligenceTests::verifyCoordinates() {
+	fiftyoneDegreesIpiCoordinate coordinate;
+	uint8_t buffer[32];
+
+	// Points are decoded in either byte order.
+	writeWkbPoint(buffer, true, 1, -1.5, 51.25);
+	EXPECT_TRUE(fiftyoneDegreesIpiGetCoordinate(
+		(const fiftyoneDegreesStoredBinaryValue*)buffer,
+		FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB,
+		&coordinate));
+	EXPECT_DOUBLE_EQ(-1.5, coordinate.lon);
+	EXPECT_DOUBLE_EQ(51.25, coordinate.lat);
+	writeWkbPoint(buffer, false, 1, 120.125, -33.5);
+	EXPECT_TRUE(fiftyoneDegreesIpiGetCoordinate(
+		(const fiftyoneDegreesStoredBinaryValue*)buffer,
+		FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB,
+		&coordinate));
+	EXPECT_DOUBLE_EQ(120.125, coordinate.lon);
+	EXPECT_DOUBLE_EQ(-33.5, coordinate.lat);
+
+	// Other geometries are not points.
+	writeWkbPoint(buffer, true, 3, 1, 2);
+	EXPECT_FALSE(fiftyoneDegreesIpiGetCoordinate(
+		(const fiftyoneDegreesStoredBinaryValue*)buffer,
+		FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_WKB,
+		&coordinate));
+	EXPECT_TRUE(std::isnan(coordinate.lat));
+	EXPECT_TRUE(std::isnan(coordinate.lon));
+
+	// Points stored as WKT strings are parsed.
+	const char wkt[] = "POINT (2.25 -7.75)";
+	const int16_t size = (int16_t)sizeof(wkt);
+	memcpy(buffer, &size, sizeof(size));
+	memcpy(buffer + sizeof(size), wkt, sizeof(wkt));
+	EXPECT_TRUE(fiftyoneDegreesIpiGetCoordinate(
+		(const fiftyoneDegreesStoredBinaryValue*)buffer,
+		FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING,
+		&coordinate));
+	EXPECT_DOUBLE_EQ(2.25, coordinate.lon);
+	EXPECT_DOUBLE_EQ(-7.75, coordinate.lat);
+
+	// Every value of a property gets a coordinate with the same weight, and
+	// points must be at the position of the WKT they are rendered as, to
+	// within the decimal places of the WKT.
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	ResultsIpi *results = engineIpi->process(ipv4Address);
+	for (int p = 0; p < results->getAvailableProperties(); p++) {
+		Common::Value<vector<WeightedValue<string>>> expected =
+			results->getValuesAsWeightedStringList(p);
+		Common::Value<vector<WeightedValue<fiftyoneDegreesIpiCoordinate>>>
+			coordinates = results->getValuesAsWeightedCoordinateList(p);
+		ASSERT_EQ(expected.hasValue(), coordinates.hasValue());
+		if (expected.hasValue()) {
+			ASSERT_EQ(
+				expected.getValue().size(),
+				coordinates.getValue().size());
+			for (size_t v = 0; v < expected.getValue().size(); v++) {
+				EXPECT_EQ(
+					expected.getValue()[v].getRawWeight(),
+					coordinates.getValue()[v].getRawWeight());
+				double lon, lat;
+				const string &wktPoint = expected.getValue()[v].getValue();
+				if (sscanf(wktPoint.c_str(), "POINT (%lf %lf)", &lon, &lat) ==
+					2) {
+					const fiftyoneDegreesIpiCoordinate &actual =
+						coordinates.getValue()[v].getValue();
+					EXPECT_NEAR(lon, actual.lon, getWktTolerance(wktPoint, 0))
+						<< "Longitude does not match " << wktPoint;
+					EXPECT_NEAR(lat, actual.lat, getWktTolerance(wktPoint, 1))
+						<< "Latitude does not match " << wktPoint;
+				}
+			}
+		}
+	}
+	delete results;
+}
+
+/**
+ * Renders all the required properties of the results in the format provided.
+ */
+static string renderAll(
+	fiftyoneDegreesResultsIpi *results,
+	fiftyoneDegreesIpiRenderFormat format) {
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+	vector<char> buffer(200000);
+	fiftyoneDegreesStringBuilder builder = { buffer.data(), buffer.size() };
+	fiftyoneDegreesStringBuilderInit(&builder);
+	fiftyoneDegreesResultsIpiRenderAll(results, format, &builder, exception);
+	EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+	fiftyoneDegreesStringBuilderComplete(&builder);
+	EXPECT_LT(builder.added, buffer.size());
+	return string(buffer.data());
+}
+
+void EngineIpIntelligenceTests::verifyRenderAll() {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	vector<string> testIpAddresses = {
+		ipv4Address,
+		ipv6Address,
+		badIpv4Address };
+	for (size_t i = 0; i < ipAddresses.size() && i < 20; i++) {
+		testIpAddresses.push_back(ipAddresses[i]);
+	}
+	for (size_t i = 0; i < testIpAddresses.size(); i++) {
+		ResultsIpi *results = engineIpi->process(testIpAddresses[i].c_str());
+		fiftyoneDegreesResultsIpi *c = results->results;
+		const fiftyoneDegreesDataSetIpi *dataSet =
+			(const fiftyoneDegreesDataSetIpi*)c->b.dataSet;
+		const uint32_t count = dataSet->b.b.available->count;
+
+		// The pipe format is the same as adding the values of each property.
+		vector<char> buffer(200000);
+		fiftyoneDegreesStringBuilder builder = {
+			buffer.data(),
+			buffer.size() };
+		fiftyoneDegreesStringBuilderInit(&builder);
+		for (uint32_t p = 0; p < count; p++) {
+			FIFTYONE_DEGREES_EXCEPTION_CREATE;
+			const char *name = FIFTYONE_DEGREES_STRING(
+				fiftyoneDegreesPropertiesGetNameFromRequiredIndex(
+					dataSet->b.b.available,
+					(int)p));
+			if (p) {
+				fiftyoneDegreesStringBuilderAddChar(&builder, '|');
+			}
+			fiftyoneDegreesStringBuilderAddChars(
+				&builder,
+				name,
+				strlen(name));
+			fiftyoneDegreesStringBuilderAddChar(&builder, '=');
+			fiftyoneDegreesResultsIpiAddValuesString(
+				c,
+				name,
+				&builder,
+				",",
+				exception);
+			EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+		}
+		fiftyoneDegreesStringBuilderComplete(&builder);
+		EXPECT_EQ(
+			string(buffer.data()),
+			renderAll(c, FIFTYONE_DEGREES_IPI_RENDER_FORMAT_PIPE));
+
+		// The JSON format has an array for every property.
+		const string json = renderAll(c, FIFTYONE_DEGREES_IPI_RENDER_FORMAT_JSON);
+		ASSERT_FALSE(json.empty());
+		EXPECT_EQ('{', json.front());
+		EXPECT_EQ('}', json.back());
+		for (uint32_t p = 0; p < count; p++) {
+			const string key = string("\"") + FIFTYONE_DEGREES_STRING(
+				fiftyoneDegreesPropertiesGetNameFromRequiredIndex(
+					dataSet->b.b.available,
+					(int)p)) + "\":[";
+			EXPECT_NE(string::npos, json.find(key)) << "Property '" <<
+				key << "' missing from '" << json << "'";
+		}
+
+		// The CSV format has a quoted field for every property in the header.
+		const string csv = renderAll(c, FIFTYONE_DEGREES_IPI_RENDER_FORMAT_CSV);
+		ASSERT_FALSE(csv.empty());
+		EXPECT_EQ('"', csv.front());
+		EXPECT_EQ('"', csv.back());
+		fiftyoneDegreesStringBuilder header = {
+			buffer.data(),
+			buffer.size() };
+		fiftyoneDegreesStringBuilderInit(&header);
+		fiftyoneDegreesResultsIpiRenderHeader(
+			c,
+			FIFTYONE_DEGREES_IPI_RENDER_FORMAT_CSV,
+			&header);
+		fiftyoneDegreesStringBuilderComplete(&header);
+		EXPECT_EQ(
+			(size_t)count - 1,
+			(size_t)std::count(buffer.data(), buffer.data() + header.added, ','));
+		delete results;
+	}
+}
+
+/**
+ * Adds the characters to the JSON string escaping them as required.
+ */
+static void appendJsonEscaped(string &json, const char *chars, size_t length) {
+	static const char hex[] = "0123456789abcdef";
+	for (size_t i = 0; i < length; i++) {
+		const unsigned char c = (unsigned char)chars[i];
+		if (c == '"' || c == '\\') {
+			json += '\\';
+			json += (char)c;
+		}
+		else if (c < 0x20) {
+			json += "\\u00";
+			json += hex[c >> 4];
+			json += hex[c & 0x0F];
+		}
+		else {
+			json += (char)c;
+		}
+	}
+}
+
+/**
+ * Reference serializer which assembles the JSON for the results in a string
+ * one value at a time.
+ */
+static string referenceJson(fiftyoneDegreesResultsIpi *results) {
+	FIFTYONE_DEGREES_EXCEPTION_CREATE;
+	const fiftyoneDegreesDataSetIpi *dataSet =
+		(const fiftyoneDegreesDataSetIpi*)results->b.dataSet;
+	vector<char> buffer(200000);
+	string json = "{";
+	for (uint32_t p = 0; p < dataSet->b.b.available->count; p++) {
+		const char *name = FIFTYONE_DEGREES_STRING(
+			fiftyoneDegreesPropertiesGetNameFromRequiredIndex(
+				dataSet->b.b.available,
+				(int)p));
+		if (p) {
+			json += ',';
+		}
+		json += '"';
+		appendJsonEscaped(json, name, strlen(name));
+		json += "\":[";
+		const int propertyIndex =
+			fiftyoneDegreesPropertiesGetPropertyIndexFromRequiredIndex(
+				dataSet->b.b.available,
+				(int)p);
+		const fiftyoneDegreesPropertyValueType storedValueType =
+			fiftyoneDegreesPropertyGetStoredTypeByIndex(
+				dataSet->propertyTypes,
+				propertyIndex,
+				exception);
+		EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+		const fiftyoneDegreesWeightedItem *items =
+			fiftyoneDegreesResultsIpiGetValues(results, (int)p, exception);
+		EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+		const uint32_t count = items == nullptr ? 0 : results->values.count;
+		for (uint32_t v = 0; v < count; v++) {
+			const fiftyoneDegreesStoredBinaryValue *value =
+				(const fiftyoneDegreesStoredBinaryValue*)
+				items[v].item.data.ptr;
+			if (v) {
+				json += ',';
+			}
+			json += "{\"value\":\"";
+			if (storedValueType ==
+				FIFTYONE_DEGREES_PROPERTY_VALUE_TYPE_STRING) {
+				const fiftyoneDegreesString *raw =
+					(const fiftyoneDegreesString*)value;
+				size_t size = raw->size > 0 ? (size_t)raw->size : 0;
+				if (size > 0 && (&raw->value)[size - 1] == '\0') {
+					size--;
+				}
+				appendJsonEscaped(json, &raw->value, size);
+			}
+			else {
+				fiftyoneDegreesStringBuilder builder = {
+					buffer.data(),
+					buffer.size() };
+				fiftyoneDegreesStringBuilderInit(&builder);
+				fiftyoneDegreesStringBuilderAddStringValue(
+					&builder,
+					value,
+					storedValueType,
+					fiftyoneDegreesDefaultWktDecimalPlaces,
+					exception);
+				EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+				fiftyoneDegreesStringBuilderComplete(&builder);
+				appendJsonEscaped(json, buffer.data(), strlen(buffer.data()));
+			}
+			json += "\",\"weight\":";
+
+			// Weights are rounded without trailing zeros.
+			char weight[32];
+			snprintf(
+				weight,
+				sizeof(weight),
+				"%.*f",
+				(int)fiftyoneDegreesDefaultWktDecimalPlaces,
+				(double)items[v].rawWeighting /
+				(double)FIFTYONE_DEGREES_WEIGHTED_ITEM_MAX_WEIGHT);
+			string formatted = weight;
+			if (formatted.find('.') != string::npos) {
+				formatted.erase(formatted.find_last_not_of('0') + 1);
+				if (formatted.back() == '.') {
+					formatted.pop_back();
+				}
+			}
+			json += formatted;
+			json += '}';
+		}
+		json += ']';
+	}
+	json += '}';
+	return json;
+}
+
+void EngineIpIntelligenceTests::verifyJson() {
+	EngineIpi *engineIpi = (EngineIpi*)getEngine();
+	vector<string> testIpAddresses = {
+		ipv4Address,
+		ipv6Address,
+		badIpv4Address };
+	for (size_t i = 0; i < ipAddresses.size() && i < 20; i++) {
+		testIpAddresses.push_back(ipAddresses[i]);
+	}
+	for (size_t i = 0; i < testIpAddresses.size(); i++) {
+		ResultsIpi *results = engineIpi->process(testIpAddresses[i].c_str());
+		const string expected = referenceJson(results->results);
+		EXPECT_EQ(expected, results->getValuesAsJson()) << "JSON for '" <<
+			testIpAddresses[i] << "' does not match the reference";
+
+		// A buffer which is too small reports the length needed.
+		char small[8];
+		EXPECT_GE(
+			results->getValuesAsJson(small, sizeof(small)),
+			expected.size());
+		EXPECT_EQ('\0', small[sizeof(small) - 1]);
+		delete results;
+	}
+}
 
 void EngineIpIntelligenceTests::verify() {
 	EngineTests::verify();
@@ -472,6 +2109,18 @@ void EngineIpIntelligenceTests::verify() {
 	verifyWithNullIpAddress();
 	verifyWithNullEvidence();
 	verifyWithInvalidInput();
+	verifyProcessBatch();
+	verifyMatchedRange();
+	verifySortedIpAddresses();
+	verifyProcessInto();
+	verifyResultsPool();
+	verifyValuesForProperties();
+	verifyValuesWithReason();
+	verifyStringViews();
+	verifyTypedValues();
+	verifyCoordinates();
+	verifyRenderAll();
+	verifyJson();
 }
 
 bool EngineIpIntelligenceTests::validateIpAddressInternal(
@@ -25,6 +25,7 @@
 
 #include <string>
 #include <cstdlib>
+#include <functional>
 #include "Constants.hpp"
 #include "../src/common-cxx/tests/EngineTests.hpp"
 
@@ -56,6 +57,19 @@
 			} \
 		} \
 	} while(0)
+
+// Skip tests on CI which compare an in memory engine with a second engine
+// built from the same data file with other options. Two copies of the large
+// enterprise data file would exceed the memory of the CI runner.
+#define SKIP_IN_MEMORY_COMPARE_TESTS_ON_CI() \
+	do { \
+		const char* ci = std::getenv("CI"); \
+		if (ci != nullptr && std::string(ci) == "true" && \
+			config != nullptr && config->getConfig().b.allInMemory) { \
+			GTEST_SKIP() << "Skipping comparison on CI for in-memory " \
+				"config (two engines cause OOM)"; \
+		} \
+	} while(0)
 #include "../src/EngineIpi.hpp"
 #include "../src/common-cxx/textfile.h"
 
@@ -160,6 +174,34 @@ public:
 	void verifyWithNullIpAddress();
 	void verifyWithNullEvidence();
 	void verifyWithEmptyEvidence();
+	void verifyProcessBatch();
+	void verifyRangeIndexes();
+	void verifyRangeBoundaries();
+	void verifyRangeBoundaries(EngineIpi *indexed, fiftyoneDegreesIpType type);
+	void verifyRangeCache();
+	void verifyRangeCacheOtherAddress(const char *ipAddress);
+	void verifyValueIndex();
+	void verifyMappedFile();
+	void verifyInitThreads();
+	void verifyInitThreadsFailure();
+	void verifyRefreshAsync();
+	void verifyRefreshFromDelta();
+	void verifyPositionalRead();
+	void verifyValuesCache();
+	void verifyMatchedRange(const char *ipAddress);
+	void verifyMatchedRange();
+	void verifySortedIpAddresses();
+	void verifyProcessInto();
+	void verifyResultsPool();
+	void verifyValuesForProperties();
+	void verifyValuesForProperties(EngineIpi *engineIpi);
+	void verifyValuesForPropertiesIndexed();
+	void verifyValuesWithReason();
+	void verifyStringViews();
+	void verifyTypedValues();
+	void verifyCoordinates();
+	void verifyRenderAll();
+	void verifyJson();
 	static void multiThreadRandomRunThread(void* state);
 	void multiThreadRandom(uint16_t concurrency);
 	void reloadMemory();
@@ -168,8 +210,18 @@ public:
 	EngineIpi *engine;
 	IpIntelligence::ConfigIpi *config;
 protected:
+	/**
+	 * Changes a copy of the test's configuration before an engine is created
+	 * from it.
+	 */
+	typedef std::function<void(IpIntelligence::ConfigIpi &config)>
+		ConfigMutator;
 	vector<string> ipAddresses;
 	void compareResults(IpIntelligence::ResultsIpi *a, IpIntelligence::ResultsIpi *b);
+	EngineIpi *createEngine(ConfigMutator mutate);
+	vector<fiftyoneDegreesIpAddress> getCompareIpAddresses();
+	void compareEngines(EngineIpi *expected, EngineIpi *actual, int passes = 1);
+	void compareWithConfig(ConfigMutator mutate, int passes = 1);
 	bool fileReadToByteArray();
 	void verifyWithIpAddressString(const char *ipAddress);
 	void verifyWithEvidence(EvidenceIpi *evidence);
@@ -265,6 +317,51 @@ TEST_F(ENGINE_CLASS_NAME(e,t,c,p), MultiThreadRandom) { \
 	uint16_t c = config->getConcurrency(); \
 	multiThreadRandom(c == 0 ? 4 : c); } /* Use 4 threads if no concurrency */
 
+// Tests which build one or more further engines from the data file with
+// different options, and compare them with the engine of the test. They only
+// depend on the config profile, so are added once for each of the in memory
+// and file based profiles rather than for every test of the matrix.
+#define ENGINE_IP_INTELLIGENCE_CONFIG_TESTS(e,t,c,p) \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), RangeIndexes) { \
+	SKIP_IN_MEMORY_COMPARE_TESTS_ON_CI(); \
+	verifyRangeIndexes(); } \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), RangeBoundaries) { \
+	SKIP_IN_MEMORY_COMPARE_TESTS_ON_CI(); \
+	verifyRangeBoundaries(); } \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), RangeCache) { \
+	SKIP_IN_MEMORY_COMPARE_TESTS_ON_CI(); \
+	verifyRangeCache(); } \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), ValueIndex) { \
+	SKIP_IN_MEMORY_COMPARE_TESTS_ON_CI(); \
+	verifyValueIndex(); } \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), ValuesForPropertiesIndexed) { \
+	SKIP_IN_MEMORY_COMPARE_TESTS_ON_CI(); \
+	verifyValuesForPropertiesIndexed(); } \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), MappedFile) { \
+	SKIP_IN_MEMORY_COMPARE_TESTS_ON_CI(); \
+	verifyMappedFile(); } \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), InitThreads) { \
+	SKIP_IN_MEMORY_COMPARE_TESTS_ON_CI(); \
+	verifyInitThreads(); } \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), PositionalRead) { \
+	SKIP_IN_MEMORY_COMPARE_TESTS_ON_CI(); \
+	verifyPositionalRead(); } \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), ValuesCache) { \
+	SKIP_IN_MEMORY_COMPARE_TESTS_ON_CI(); \
+	verifyValuesCache(); }
+
+// Tests which only need to run once as they do not depend on the config
+// profile or the required properties, and write files of their own.
+#define ENGINE_IP_INTELLIGENCE_SINGLE_TESTS(e,t,c,p) \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), InitThreadsFailure) { \
+	verifyInitThreadsFailure(); } \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), RefreshAsync) { \
+	SKIP_IN_MEMORY_RELOAD_TESTS_ON_CI(); \
+	verifyRefreshAsync(); } \
+TEST_F(ENGINE_CLASS_NAME(e,t,c,p), RefreshFromDelta) { \
+	SKIP_IN_MEMORY_RELOAD_TESTS_ON_CI(); \
+	verifyRefreshFromDelta(); }
+
 #define ENGINE_IP_INTELLIGENCE_IP_ADDRESS_TESTS(e,t,c,p) \
 TEST_F(ENGINE_CLASS_NAME(e,t,c,p), TestIpAddress) { \
 	ipAddressPresent(ipv4Address); \
@@ -367,7 +464,10 @@ ENGINE_IP_INTELLIGENCE_CityName_TESTS(e, File, Balanced, AllEdgePropertyArray) \
 ENGINE_IP_INTELLIGENCE_CityName_TESTS(e, File, BalancedTemp, AllEdgePropertyArray) \
 ENGINE_IP_INTELLIGENCE_CityName_TESTS(e, File, InMemory, AllEdgePropertyArray) \
 ENGINE_IP_INTELLIGENCE_CityName_TESTS(e, File, Null, AllEdgePropertyStrings) \
-ENGINE_IP_INTELLIGENCE_CityName_TESTS(e, File, Null, AllEdgePropertyArray)
+ENGINE_IP_INTELLIGENCE_CityName_TESTS(e, File, Null, AllEdgePropertyArray) \
+ENGINE_IP_INTELLIGENCE_CONFIG_TESTS(e, File, InMemory, OnePropertyString) \
+ENGINE_IP_INTELLIGENCE_CONFIG_TESTS(e, File, LowMemory, OnePropertyString) \
+ENGINE_IP_INTELLIGENCE_SINGLE_TESTS(e, File, LowMemory, OnePropertyString)
 
 
 #define ENGINE_MEMORY_TESTS(e) \
@@ -66,6 +66,30 @@ public:
 			FAIL() << "Getting the manager size failed with: " <<
 				fiftyoneDegreesExceptionGetMessage(exception);
 		}
+
+		// The memory used by the resolved profile groups is included in the
+		// size of an in memory data set, so it must be larger than the same
+		// configuration without the table.
+		if (config->getConfig().b.allInMemory) {
+			ConfigIpi groupsConfig(&config->getConfig());
+			groupsConfig.setProfileGroupsTable(true);
+			ConfigIpi noGroupsConfig(&config->getConfig());
+			noGroupsConfig.setProfileGroupsTable(false);
+			const size_t sizeWithTable = fiftyoneDegreesIpiSizeManagerFromFile(
+				&groupsConfig.getConfig(),
+				requiredProperties->getConfig(),
+				fullName,
+				exception);
+			EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+			const size_t sizeWithout = fiftyoneDegreesIpiSizeManagerFromFile(
+				&noGroupsConfig.getConfig(),
+				requiredProperties->getConfig(),
+				fullName,
+				exception);
+			EXPECT_GT(sizeWithTable, sizeWithout) << "Size should include "
+				"the profile groups table";
+			EXPECT_TRUE(FIFTYONE_DEGREES_EXCEPTION_OKAY);
+		}
 	}
 };
 
@@ -0,0 +1,205 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+/**
+ * @file IpAddressKeyTests.cpp
+ * @brief Tests for the integer IP address keys used to compare IP addresses.
+ *
+ * The keys must compare in the same order as the bytes of the IP addresses,
+ * and a binary search over sorted range starts must find the same range with
+ * the keys as with a byte by byte comparison. The time taken by each search
+ * is reported by the KeyIpi example.
+ */
+
+#include "pch.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "../src/ipi.h"
+#include "../src/fiftyone.h"
+}
+
+/**
+ * Number of range starts searched.
+ */
+#define KEY_TEST_RANGES 10000
+
+/**
+ * Number of IP addresses looked up.
+ */
+#define KEY_TEST_LOOKUPS 10000
+
+/**
+ * Test fixture which creates sorted range starts and IP addresses to look up
+ * for a type of IP address.
+ */
+class IpAddressKeyTests : public ::testing::Test {
+protected:
+	std::vector<fiftyoneDegreesIpAddress> starts;
+	std::vector<fiftyoneDegreesIpAddress> targets;
+
+	static int getLength(fiftyoneDegreesIpType type) {
+		return type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+			FIFTYONE_DEGREES_IPV4_LENGTH :
+			FIFTYONE_DEGREES_IPV6_LENGTH;
+	}
+
+	static fiftyoneDegreesIpAddress createIpAddress(
+		std::mt19937 &random,
+		fiftyoneDegreesIpType type) {
+		fiftyoneDegreesIpAddress ipAddress;
+		memset(&ipAddress, 0, sizeof(ipAddress));
+		ipAddress.type = type;
+		for (int i = 0; i < getLength(type); i++) {
+			ipAddress.value[i] = (unsigned char)(random() & 0xFF);
+		}
+		return ipAddress;
+	}
+
+	/**
+	 * Compares the IP addresses byte by byte in the same way as the lookup
+	 * path did before integer keys were used.
+	 */
+	static int compareBytes(
+		const fiftyoneDegreesIpAddress *address1,
+		const fiftyoneDegreesIpAddress *address2) {
+		for (int i = 0; i < getLength(address1->type); i++) {
+			const int difference =
+				(int)address1->value[i] - (int)address2->value[i];
+			if (difference != 0) return difference;
+		}
+		return 0;
+	}
+
+	void createIpAddresses(fiftyoneDegreesIpType type) {
+		std::mt19937 random(42);
+		for (int i = 0; i < KEY_TEST_RANGES; i++) {
+			starts.push_back(createIpAddress(random, type));
+		}
+		std::sort(
+			starts.begin(),
+			starts.end(),
+			[](const fiftyoneDegreesIpAddress &a,
+				const fiftyoneDegreesIpAddress &b) {
+				return compareBytes(&a, &b) < 0;
+			});
+		for (int i = 0; i < KEY_TEST_LOOKUPS; i++) {
+			targets.push_back(createIpAddress(random, type));
+		}
+	}
+
+	/**
+	 * Returns the index of the last item which is not greater than the
+	 * target, or 0 if every item is greater.
+	 */
+	template <typename T>
+	static size_t find(
+		const std::vector<T> &items,
+		const T *target,
+		int (*compare)(const T*, const T*)) {
+		size_t lower = 0, upper = items.size() - 1;
+		while (lower < upper) {
+			const size_t middle = lower + (upper - lower + 1) / 2;
+			if (compare(&items[middle], target) <= 0) {
+				lower = middle;
+			}
+			else {
+				upper = middle - 1;
+			}
+		}
+		return lower;
+	}
+
+	/**
+	 * Checks the lookups using the byte comparison and the keys find the
+	 * same range for every IP address.
+	 */
+	void verifySearch(fiftyoneDegreesIpType type) {
+		createIpAddresses(type);
+		std::vector<fiftyoneDegreesIpiIpKey> startKeys;
+		for (size_t i = 0; i < starts.size(); i++) {
+			startKeys.push_back(
+				fiftyoneDegreesIpiIpKeyFromIpAddress(&starts[i]));
+		}
+		for (size_t i = 0; i < targets.size(); i++) {
+			const fiftyoneDegreesIpiIpKey key =
+				fiftyoneDegreesIpiIpKeyFromIpAddress(&targets[i]);
+			ASSERT_EQ(
+				find(starts, &targets[i], compareBytes),
+				find(startKeys, &key, fiftyoneDegreesIpiIpKeyCompare)) <<
+				"The keys must find the same ranges as the bytes";
+		}
+	}
+
+	/**
+	 * Checks the keys compare in the same order as the bytes.
+	 */
+	void verifyOrder(fiftyoneDegreesIpType type) {
+		std::mt19937 random(7);
+		for (int i = 0; i < 10000; i++) {
+			fiftyoneDegreesIpAddress a = createIpAddress(random, type);
+			fiftyoneDegreesIpAddress b = i % 10 == 0 ?
+				a : createIpAddress(random, type);
+			const fiftyoneDegreesIpiIpKey keyA =
+				fiftyoneDegreesIpiIpKeyFromIpAddress(&a);
+			const fiftyoneDegreesIpiIpKey keyB =
+				fiftyoneDegreesIpiIpKeyFromIpAddress(&b);
+			const int bytes = compareBytes(&a, &b);
+			const int keys = fiftyoneDegreesIpiIpKeyCompare(&keyA, &keyB);
+			EXPECT_EQ(bytes < 0, keys < 0);
+			EXPECT_EQ(bytes == 0, keys == 0);
+			EXPECT_EQ(bytes > 0, keys > 0);
+		}
+	}
+};
+
+/**
+ * Test that IPv4 keys compare in the same order as the bytes.
+ */
+TEST_F(IpAddressKeyTests, Ipv4Order) {
+	verifyOrder(FIFTYONE_DEGREES_IP_TYPE_IPV4);
+}
+
+/**
+ * Test that IPv6 keys compare in the same order as the bytes.
+ */
+TEST_F(IpAddressKeyTests, Ipv6Order) {
+	verifyOrder(FIFTYONE_DEGREES_IP_TYPE_IPV6);
+}
+
+/**
+ * Test that IPv4 lookups find the same ranges using the bytes and the keys.
+ */
+TEST_F(IpAddressKeyTests, Ipv4Search) {
+	verifySearch(FIFTYONE_DEGREES_IP_TYPE_IPV4);
+}
+
+/**
+ * Test that IPv6 lookups find the same ranges using the bytes and the keys.
+ */
+TEST_F(IpAddressKeyTests, Ipv6Search) {
+	verifySearch(FIFTYONE_DEGREES_IP_TYPE_IPV6);
+}
@@ -0,0 +1,162 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+/**
+ * @file IpAddressSortTests.cpp
+ * @brief Tests for sorting a file of IP addresses with
+ * fiftyoneDegreesIpiSortIpAddressFile.
+ *
+ * These tests check the output is in the ascending order required by
+ * fiftyoneDegreesResultsIpiFromSortedIpAddresses both when the input fits in
+ * the memory limit and when it has to be merged from temporary files.
+ */
+
+#include "pch.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "../src/ipi.h"
+#include "../src/ipi_sorted.h"
+#include "../src/fiftyone.h"
+}
+
+/**
+ * Test fixture which writes an unsorted file of IP addresses.
+ */
+class IpAddressSortTests : public ::testing::Test {
+protected:
+	const char *inputFilePath = "ipi_sort_test_input.txt";
+	const char *outputFilePath = "ipi_sort_test_output.txt";
+	size_t validCount = 0;
+
+	void SetUp() override {
+		std::ofstream input(inputFilePath);
+		for (int i = 0; i < 200; i++) {
+			// Spread the IPv4 and IPv6 addresses so they are out of order.
+			const int value = (i * 37) % 200;
+			if (i % 2 == 0) {
+				input << "10." << value << "." << (200 - value) << ".1\n";
+			}
+			else {
+				input << "  2001:db8::" << std::hex << value << std::dec <<
+					"  \n";
+			}
+			validCount++;
+		}
+		input << "not an IP address\n";
+		input << "\n";
+		input.close();
+	}
+
+	void TearDown() override {
+		remove(inputFilePath);
+		remove(outputFilePath);
+	}
+
+	/**
+	 * Reads the output file checking each IP address is valid and not lower
+	 * than the one before it.
+	 * @return the number of IP addresses in the output file
+	 */
+	size_t verifyOutput() {
+		std::ifstream output(outputFilePath);
+		std::string line;
+		size_t count = 0;
+		fiftyoneDegreesIpAddress previous;
+		memset(&previous, 0, sizeof(previous));
+		while (std::getline(output, line)) {
+			fiftyoneDegreesIpAddress current;
+			memset(&current, 0, sizeof(current));
+			EXPECT_TRUE(fiftyoneDegreesIpAddressParse(
+				line.c_str(),
+				line.c_str() + line.size(),
+				&current)) << "Invalid IP address '" << line << "'";
+			if (count > 0) {
+				EXPECT_LE(previous.type, current.type) <<
+					"IPv4 addresses should be before IPv6 addresses";
+				if (previous.type == current.type) {
+					const int length =
+						current.type == FIFTYONE_DEGREES_IP_TYPE_IPV4 ?
+						FIFTYONE_DEGREES_IPV4_LENGTH :
+						FIFTYONE_DEGREES_IPV6_LENGTH;
+					EXPECT_LE(memcmp(previous.value, current.value, length),
+						0) << "IP address '" << line << "' is out of order";
+				}
+			}
+			previous = current;
+			count++;
+		}
+		return count;
+	}
+};
+
+/**
+ * Test that a file which fits within the memory limit is sorted.
+ */
+TEST_F(IpAddressSortTests, SortInMemory) {
+	fiftyoneDegreesStatusCode status = fiftyoneDegreesIpiSortIpAddressFile(
+		inputFilePath,
+		outputFilePath,
+		1024 * 1024);
+	ASSERT_EQ(FIFTYONE_DEGREES_STATUS_SUCCESS, status);
+	EXPECT_EQ(validCount, verifyOutput());
+}
+
+/**
+ * Test that a file which is larger than the memory limit is sorted by
+ * merging multiple runs.
+ */
+TEST_F(IpAddressSortTests, SortWithRuns) {
+	fiftyoneDegreesStatusCode status = fiftyoneDegreesIpiSortIpAddressFile(
+		inputFilePath,
+		outputFilePath,
+		512);
+	ASSERT_EQ(FIFTYONE_DEGREES_STATUS_SUCCESS, status);
+	EXPECT_EQ(validCount, verifyOutput());
+}
+
+/**
+ * Test that a memory limit too small to sort with is reported.
+ */
+TEST_F(IpAddressSortTests, SortInsufficientMemory) {
+	fiftyoneDegreesStatusCode status = fiftyoneDegreesIpiSortIpAddressFile(
+		inputFilePath,
+		outputFilePath,
+		1);
+	EXPECT_EQ(FIFTYONE_DEGREES_STATUS_INSUFFICIENT_MEMORY, status);
+}
+
+/**
+ * Test that a missing input file is reported.
+ */
+TEST_F(IpAddressSortTests, SortMissingFile) {
+	fiftyoneDegreesStatusCode status = fiftyoneDegreesIpiSortIpAddressFile(
+		"ipi_sort_test_missing.txt",
+		outputFilePath,
+		1024);
+	EXPECT_NE(FIFTYONE_DEGREES_STATUS_SUCCESS, status);
+}
@@ -0,0 +1,180 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+/**
+ * @file IpiDeltaTests.cpp
+ * @brief Tests for creating and applying deltas between data files with
+ * fiftyoneDegreesIpiDeltaCreate and fiftyoneDegreesIpiDeltaApply.
+ *
+ * The data files are random bytes with records inserted, changed and
+ * removed between the versions. Only the header needs to resemble a data
+ * file, as the delta uses its tag to check it is applied to the right one.
+ */
+
+#include "pch.h"
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "../src/ipi.h"
+#include "../src/ipi_delta.h"
+#include "../src/fiftyone.h"
+}
+
+/**
+ * Test fixture which writes a previous and a new version of a data file.
+ */
+class IpiDeltaTests : public ::testing::Test {
+protected:
+	const char *sourceFilePath = "ipi_delta_test_source.ipi";
+	const char *targetFilePath = "ipi_delta_test_target.ipi";
+	const char *deltaFilePath = "ipi_delta_test.delta";
+	const char *outputFilePath = "ipi_delta_test_output.ipi";
+	std::vector<unsigned char> source;
+	std::vector<unsigned char> target;
+
+	void SetUp() override {
+		std::mt19937 random(51);
+		source.resize(256 * 1024);
+		for (size_t i = 0; i < source.size(); i++) {
+			source[i] = (unsigned char)random();
+		}
+
+		// Insert new records near the start, change one record in place,
+		// remove a block of records, and give the new version its own tag.
+		target.insert(target.end(), source.begin(), source.begin() + 4096);
+		for (int i = 0; i < 1500; i++) {
+			target.push_back((unsigned char)random());
+		}
+		target.insert(
+			target.end(),
+			source.begin() + 4096,
+			source.begin() + 100000);
+		target[50000] ^= 0xff;
+		target.insert(target.end(), source.begin() + 150000, source.end());
+		target[offsetof(fiftyoneDegreesDataSetIpiHeader, tag)] ^= 0xff;
+
+		write(sourceFilePath, source);
+		write(targetFilePath, target);
+	}
+
+	void TearDown() override {
+		remove(sourceFilePath);
+		remove(targetFilePath);
+		remove(deltaFilePath);
+		remove(outputFilePath);
+	}
+
+	static void write(
+		const char *filePath,
+		const std::vector<unsigned char> &bytes) {
+		std::ofstream file(filePath, std::ios::binary);
+		file.write((const char*)bytes.data(), bytes.size());
+	}
+
+	static std::vector<unsigned char> read(const char *filePath) {
+		std::ifstream file(filePath, std::ios::binary);
+		return std::vector<unsigned char>(
+			std::istreambuf_iterator<char>(file),
+			std::istreambuf_iterator<char>());
+	}
+
+	fiftyoneDegreesIpiDeltaStats create() {
+		fiftyoneDegreesIpiDeltaStats stats;
+		fiftyoneDegreesStatusCode status = fiftyoneDegreesIpiDeltaCreate(
+			sourceFilePath,
+			targetFilePath,
+			deltaFilePath,
+			0,
+			&stats);
+		EXPECT_EQ(FIFTYONE_DEGREES_STATUS_SUCCESS, status);
+		return stats;
+	}
+};
+
+/**
+ * Test that applying the delta to the previous version produces the new
+ * version, and that the delta only holds the bytes which changed.
+ */
+TEST_F(IpiDeltaTests, CreateAndApply) {
+	fiftyoneDegreesIpiDeltaStats stats = create();
+	EXPECT_EQ(source.size(), stats.sourceLength);
+	EXPECT_EQ(target.size(), stats.targetLength);
+	EXPECT_EQ(target.size(), stats.copied + stats.added);
+	EXPECT_GE(stats.added, (uint64_t)1500) << "The inserted records must "
+		"be found as new data";
+	EXPECT_LT(stats.added, (uint64_t)target.size() / 10);
+	EXPECT_LT(read(deltaFilePath).size(), target.size() / 10);
+
+	fiftyoneDegreesStatusCode status = fiftyoneDegreesIpiDeltaApply(
+		sourceFilePath,
+		deltaFilePath,
+		outputFilePath);
+	ASSERT_EQ(FIFTYONE_DEGREES_STATUS_SUCCESS, status);
+	EXPECT_TRUE(read(outputFilePath) == target);
+}
+
+/**
+ * Test that a delta is not applied to a data file it was not created from.
+ */
+TEST_F(IpiDeltaTests, ApplyToWrongSource) {
+	create();
+	fiftyoneDegreesStatusCode status = fiftyoneDegreesIpiDeltaApply(
+		targetFilePath,
+		deltaFilePath,
+		outputFilePath);
+	EXPECT_EQ(FIFTYONE_DEGREES_STATUS_INCORRECT_VERSION, status);
+}
+
+/**
+ * Test that a damaged delta is reported and no data file is left behind.
+ */
+TEST_F(IpiDeltaTests, ApplyCorruptDelta) {
+	create();
+	std::vector<unsigned char> delta = read(deltaFilePath);
+	delta[delta.size() - 10] ^= 0xff;
+	write(deltaFilePath, delta);
+	fiftyoneDegreesStatusCode status = fiftyoneDegreesIpiDeltaApply(
+		sourceFilePath,
+		deltaFilePath,
+		outputFilePath);
+	EXPECT_EQ(FIFTYONE_DEGREES_STATUS_CORRUPT_DATA, status);
+	std::ifstream output(outputFilePath);
+	EXPECT_FALSE(output.good());
+}
+
+/**
+ * Test that a missing delta is reported.
+ */
+TEST_F(IpiDeltaTests, ApplyMissingDelta) {
+	fiftyoneDegreesStatusCode status = fiftyoneDegreesIpiDeltaApply(
+		sourceFilePath,
+		"ipi_delta_test_missing.delta",
+		outputFilePath);
+	EXPECT_NE(FIFTYONE_DEGREES_STATUS_SUCCESS, status);
+}
@@ -0,0 +1,147 @@
+/* *********************************************************************
+ * This Original Work is copyright of 51 Degrees Mobile Experts Limited.
+ * Copyright 2026 51 Degrees Mobile Experts Limited, Davidson House,
+ * Forbury Square, Reading, Berkshire, United Kingdom RG1 3EU.
+ *
+ * This Original Work is licensed under the European Union Public Licence
+ * (EUPL) v.1.2 and is subject to its terms as set out below.
+ *
+ * If a copy of the EUPL was not distributed with this file, You can obtain
+ * one at https://opensource.org/licenses/EUPL-1.2.
+ *
+ * The 'Compatible Licences' set out in the Appendix to the EUPL (as may be
+ * amended by the European Commission) shall be deemed incompatible for
+ * the purposes of the Work and the provisions of the compatibility
+ * clause in Article 5 of the EUPL shall not apply.
+ *
+ * If using the Work as, or as part of, a network application, by
+ * including the attribution notice(s) required under Article 5 of the EUPL
+ * in the end user terms of the application under an appropriate heading,
+ * such notice(s) shall fulfill the requirements of that article.
+ * ********************************************************************* */
+
+/**
+ * @file IpiFileReaderTests.cpp
+ * @brief Tests for positional reads with fiftyoneDegreesIpiFileReaderRead.
+ *
+ * The reads are made from several threads at once sharing the same reader,
+ * and each must return the bytes at its own offset.
+ */
+
+#include "pch.h"
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include "../src/ipi.h"
+#include "../src/ipi_file_reader.h"
+#include "../src/fiftyone.h"
+}
+
+/**
+ * Test fixture which writes a file where each byte is derived from its
+ * offset.
+ */
+class IpiFileReaderTests : public ::testing::Test {
+protected:
+	const char *filePath = "ipi_file_reader_test.bin";
+	std::vector<unsigned char> content;
+
+	void SetUp() override {
+		content.resize(64 * 1024 + 7);
+		for (size_t i = 0; i < content.size(); i++) {
+			content[i] = (unsigned char)((i * 31) ^ (i >> 8));
+		}
+		std::ofstream file(filePath, std::ios::binary);
+		file.write((const char*)content.data(), content.size());
+		file.close();
+	}
+
+	void TearDown() override {
+		remove(filePath);
+	}
+};
+
+/**
+ * Test that reads from many threads sharing one reader each return the bytes
+ * at their own offset.
+ */
+TEST_F(IpiFileReaderTests, ReadFromThreads) {
+	fiftyoneDegreesIpiFileReader reader;
+	ASSERT_EQ(
+		FIFTYONE_DEGREES_STATUS_SUCCESS,
+		fiftyoneDegreesIpiFileReaderOpen(filePath, &reader));
+	EXPECT_EQ((fiftyoneDegreesFileOffset)content.size(), reader.length);
+	std::vector<std::thread> threads;
+	std::vector<int> failures(8, 0);
+	for (int t = 0; t < 8; t++) {
+		threads.push_back(std::thread([&, t]() {
+			unsigned char buffer[100];
+			for (size_t offset = t;
+				offset + sizeof(buffer) <= content.size();
+				offset += 997) {
+				if (fiftyoneDegreesIpiFileReaderRead(
+					&reader,
+					(fiftyoneDegreesFileOffset)offset,
+					buffer,
+					sizeof(buffer)) != FIFTYONE_DEGREES_STATUS_SUCCESS ||
+					memcmp(buffer, &content[offset], sizeof(buffer)) != 0) {
+					failures[t]++;
+				}
+			}
+		}));
+	}
+	for (size_t t = 0; t < threads.size(); t++) {
+		threads[t].join();
+		EXPECT_EQ(0, failures[t]) << "Thread " << t << " read wrong bytes";
+	}
+	fiftyoneDegreesIpiFileReaderClose(&reader);
+}
+
+/**
+ * Test that the last bytes of the file can be read, and that bytes beyond the
+ * end of the file are reported as out of bounds.
+ */
+TEST_F(IpiFileReaderTests, ReadBeyondEnd) {
+	fiftyoneDegreesIpiFileReader reader;
+	unsigned char buffer[16];
+	ASSERT_EQ(
+		FIFTYONE_DEGREES_STATUS_SUCCESS,
+		fiftyoneDegreesIpiFileReaderOpen(filePath, &reader));
+	const size_t last = content.size() - sizeof(buffer);
+	EXPECT_EQ(
+		FIFTYONE_DEGREES_STATUS_SUCCESS,
+		fiftyoneDegreesIpiFileReaderRead(
+			&reader,
+			(fiftyoneDegreesFileOffset)last,
+			buffer,
+			sizeof(buffer)));
+	EXPECT_EQ(0, memcmp(buffer, &content[last], sizeof(buffer)));
+	EXPECT_EQ(
+		FIFTYONE_DEGREES_STATUS_POINTER_OUT_OF_BOUNDS,
+		fiftyoneDegreesIpiFileReaderRead(
+			&reader,
+			(fiftyoneDegreesFileOffset)last + 1,
+			buffer,
+			sizeof(buffer)));
+	fiftyoneDegreesIpiFileReaderClose(&reader);
+}
+
+/**
+ * Test that a missing file is reported, and that a reader which was never
+ * opened can be closed.
+ */
+TEST_F(IpiFileReaderTests, OpenMissingFile) {
+	fiftyoneDegreesIpiFileReader reader;
+	fiftyoneDegreesIpiFileReaderReset(&reader);
+	EXPECT_NE(
+		FIFTYONE_DEGREES_STATUS_SUCCESS,
+		fiftyoneDegreesIpiFileReaderOpen(
+			"ipi_file_reader_test_missing.bin",
+			&reader));
+	fiftyoneDegreesIpiFileReaderClose(&reader);
+}